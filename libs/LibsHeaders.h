@@ -37,6 +37,7 @@
 #include "bullet/btBulletDynamicsCommon.h"
 #include "bullet/BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "bullet/BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "bullet/BulletCollision/CollisionDispatch/btGhostObject.h"
 #include "bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
 #include "bullet/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
 
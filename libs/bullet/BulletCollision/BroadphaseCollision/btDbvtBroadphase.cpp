@@ -19,6 +19,7 @@ subject to the following restrictions:
 #include "LinearMath/btThreads.h"
 #include <algorithm>
 #include <thread>
+#include <vector>
 
 btScalar gDbvtMargin = btScalar(0.05);
 //
@@ -220,6 +221,46 @@ void btDbvtBroadphase::destroyProxy(btBroadphaseProxy* absproxy,
 	m_needcleanup = true;
 }
 
+void btDbvtBroadphase::destroyProxies(btBroadphaseProxy** proxies, int count, btDispatcher* dispatcher)
+{
+	if (count <= 0)
+		return;
+
+	class RemovePairsCallback : public btOverlapCallback
+	{
+	public:
+		RemovePairsCallback(btBroadphaseProxy** proxies, int count)
+			: m_sortedProxies(proxies, proxies + count)
+		{
+			std::sort(m_sortedProxies.begin(), m_sortedProxies.end());
+		}
+		virtual bool processOverlap(btBroadphasePair& pair)
+		{
+			return std::binary_search(m_sortedProxies.begin(), m_sortedProxies.end(), pair.m_pProxy0) ||
+				   std::binary_search(m_sortedProxies.begin(), m_sortedProxies.end(), pair.m_pProxy1);
+		}
+
+	private:
+		std::vector<btBroadphaseProxy*> m_sortedProxies;
+	};
+
+	// One pass over all pairs instead of one pass per proxy.
+	RemovePairsCallback removeCallback(proxies, count);
+	m_paircache->processAllOverlappingPairs(&removeCallback, dispatcher);
+
+	for (int i = 0; i < count; ++i)
+	{
+		btDbvtProxy* proxy = (btDbvtProxy*)proxies[i];
+		if (proxy->stage == STAGECOUNT)
+			m_sets[1].remove(proxy->leaf);
+		else
+			m_sets[0].remove(proxy->leaf);
+		listremove(proxy, m_stageRoots[proxy->stage]);
+		btAlignedFree(proxy);
+	}
+	m_needcleanup = true;
+}
+
 void btDbvtBroadphase::getAabb(btBroadphaseProxy* absproxy, btVector3& aabbMin, btVector3& aabbMax) const
 {
 	btDbvtProxy* proxy = (btDbvtProxy*)absproxy;
@@ -109,6 +109,8 @@ struct btDbvtBroadphase : btBroadphaseInterface
 	/* btBroadphaseInterface Implementation	*/
 	btBroadphaseProxy* createProxy(const btVector3& aabbMin, const btVector3& aabbMax, int shapeType, void* userPtr, int collisionFilterGroup, int collisionFilterMask, btDispatcher* dispatcher);
 	virtual void destroyProxy(btBroadphaseProxy* proxy, btDispatcher* dispatcher);
+	// Beryll: destroy many proxies and remove their pairs with one pass over pair cache.
+	void destroyProxies(btBroadphaseProxy** proxies, int count, btDispatcher* dispatcher);
 	virtual void setAabb(btBroadphaseProxy* proxy, const btVector3& aabbMin, const btVector3& aabbMax, btDispatcher* dispatcher);
 	virtual void rayTest(const btVector3& rayFrom, const btVector3& rayTo, btBroadphaseRayCallback& rayCallback, const btVector3& aabbMin = btVector3(0, 0, 0), const btVector3& aabbMax = btVector3(0, 0, 0));
 	virtual void aabbTest(const btVector3& aabbMin, const btVector3& aabbMax, btBroadphaseAabbCallback& callback);
@@ -11,6 +11,7 @@
 #include "beryll/core/GameStateMachine.h"
 #include "beryll/core/EventHandler.h"
 #include "beryll/core/SoundsManager.h"
+#include "beryll/core/AssetRegistry.h"
 #include "beryll/core/RandomGenerator.h"
 #include "beryll/core/TimeStep.h"
 
@@ -37,11 +38,15 @@
 #include "beryll/GUI/SliderHorizontal.h"
 
 #include "beryll/physics/Physics.h"
+#include "beryll/physics/ProjectileSystem.h"
+#include "beryll/physics/PhysicsAllocator.h"
 
 #include "beryll/async/AsyncRun.h"
 
 #include "beryll/particleSystem/ParticleSystem.h"
 
+#include "beryll/animation/AnimationSystem.h"
+
 #include "beryll/loadingScreen/LoadingScreen.h"
 
 #include "beryll/dataBase/DataBase.h"
@@ -0,0 +1,313 @@
+#include "AnimationClip.h"
+#include "beryll/core/Log.h"
+
+namespace Beryll
+{
+    namespace
+    {
+        constexpr float quatComponentLimit = 0.70710678f; // 1 / sqrt(2). Max value of not largest component.
+        constexpr float quatComponentScale = 32767.0f;
+        constexpr float constantTrackTolerance = 0.00001f;
+
+        bool isBoneName(const char* name, const size_t length)
+        {
+            // Bones names must starts with Bone.......
+            return length > 3 && name[0] == 'B' && name[1] == 'o' && name[2] == 'n' && name[3] == 'e';
+        }
+
+        // Return index of last key with time < animationTime (or 0).
+        // Check cursor and next key first because baking moves forward in time.
+        uint32_t findKeyIndex(const aiVectorKey* keys, const uint32_t keysCount, const float animationTime, uint32_t& cursor)
+        {
+            const auto isKeyIndexValid = [&](uint32_t index) -> bool
+            {
+                return (index == 0 || animationTime > keys[index].mTime) &&
+                       (index + 1 >= keysCount || animationTime <= keys[index + 1].mTime);
+            };
+
+            if(cursor < keysCount)
+            {
+                if(isKeyIndexValid(cursor))
+                    return cursor;
+
+                if(cursor + 1 < keysCount && isKeyIndexValid(cursor + 1))
+                    return ++cursor;
+            }
+
+            const aiVectorKey* firstNotSmaller = std::lower_bound(keys, keys + keysCount, animationTime,
+                                                                  [](const aiVectorKey& key, const float time) { return key.mTime < time; });
+            const uint32_t index = static_cast<uint32_t>(firstNotSmaller - keys);
+            cursor = index > 0 ? index - 1 : 0;
+            return cursor;
+        }
+
+        glm::vec3 toGlm(const aiVector3D& v) { return glm::vec3(v.x, v.y, v.z); }
+        glm::quat toGlm(const aiQuaternion& q) { return glm::quat(q.w, q.x, q.y, q.z); }
+
+        // Normalized linear interpolation.
+        glm::quat nlerp(const glm::quat& a, glm::quat b, const float blend)
+        {
+            if(glm::dot(a, b) < 0.0f)
+                b = -b;
+
+            return glm::normalize(a * (1.0f - blend) + b * blend);
+        }
+
+        // Same sampling as was used directly on aiNodeAnim keys: interpolate between last key before time and next key.
+        // After last key interpolate to first key (loop).
+        void sampleChannel(const aiNodeAnim* nodeAnim, const float animationTime, const float duration, uint32_t& keyCursor,
+                           glm::vec3& position, glm::quat& rotation, glm::vec3& scale)
+        {
+            // Position, rotation and scaling keys have same count and times.
+            const uint32_t keysCount = nodeAnim->mNumPositionKeys;
+            const uint32_t currentFrameIndex = findKeyIndex(nodeAnim->mPositionKeys, keysCount, animationTime, keyCursor);
+
+            uint32_t nextFrameIndex = currentFrameIndex + 1;
+            if(nextFrameIndex >= keysCount)
+                nextFrameIndex = 0; // Last frame was played, jump to first again.
+
+            const float currentFrameStartTime = static_cast<float>(nodeAnim->mPositionKeys[currentFrameIndex].mTime);
+            float currentFrameEndTime = static_cast<float>(nodeAnim->mPositionKeys[nextFrameIndex].mTime);
+            if(currentFrameStartTime > currentFrameEndTime)
+                currentFrameEndTime = duration;
+
+            const float deltaTime = currentFrameEndTime - currentFrameStartTime;
+            // factor = how much time passed between current and next frame in range 0...1
+            float factor = 0.0f;
+            if(deltaTime > 0.0f)
+                factor = glm::clamp((animationTime - currentFrameStartTime) / deltaTime, 0.0f, 1.0f);
+
+            position = glm::mix(toGlm(nodeAnim->mPositionKeys[currentFrameIndex].mValue), toGlm(nodeAnim->mPositionKeys[nextFrameIndex].mValue), factor);
+            rotation = nlerp(toGlm(nodeAnim->mRotationKeys[currentFrameIndex].mValue), toGlm(nodeAnim->mRotationKeys[nextFrameIndex].mValue), factor);
+            scale = glm::mix(toGlm(nodeAnim->mScalingKeys[currentFrameIndex].mValue), toGlm(nodeAnim->mScalingKeys[nextFrameIndex].mValue), factor);
+        }
+
+        bool isConstant(const std::vector<glm::vec3>& samples)
+        {
+            for(const glm::vec3& sample : samples)
+            {
+                if(glm::distance(sample, samples.front()) > constantTrackTolerance)
+                    return false;
+            }
+
+            return true;
+        }
+
+        bool isConstant(const std::vector<QuantizedQuaternion>& samples)
+        {
+            for(const QuantizedQuaternion& sample : samples)
+            {
+                if(!(sample == samples.front()))
+                    return false;
+            }
+
+            return true;
+        }
+
+        // Append track samples to clip data. Return stride (0 = constant track with one sample).
+        template<typename T>
+        uint32_t appendSamples(const std::vector<T>& samples, std::vector<T>& clipData, uint32_t& offset)
+        {
+            offset = static_cast<uint32_t>(clipData.size());
+
+            if(isConstant(samples))
+            {
+                clipData.push_back(samples.front());
+                return 0;
+            }
+
+            clipData.insert(clipData.end(), samples.begin(), samples.end());
+            return 1;
+        }
+    }
+
+    QuantizedQuaternion QuantizedQuaternion::quantize(glm::quat q)
+    {
+        q = glm::normalize(q);
+        float components[4] = {q.x, q.y, q.z, q.w};
+
+        int largestIndex = 0;
+        for(int i = 1; i < 4; ++i)
+        {
+            if(std::abs(components[i]) > std::abs(components[largestIndex]))
+                largestIndex = i;
+        }
+
+        // q and -q are same rotation. Make dropped component positive so it can be restored with sqrt().
+        const float sign = components[largestIndex] < 0.0f ? -1.0f : 1.0f;
+
+        QuantizedQuaternion result;
+        int g = 0;
+        for(int i = 0; i < 4; ++i)
+        {
+            if(i == largestIndex)
+                continue;
+
+            const float normalized = glm::clamp((components[i] * sign) / quatComponentLimit, -1.0f, 1.0f); // -1...1
+            result.data[g] = static_cast<uint16_t>(std::lround((normalized * 0.5f + 0.5f) * quatComponentScale));
+            ++g;
+        }
+
+        result.data[0] |= static_cast<uint16_t>((largestIndex & 1) << 15);
+        result.data[1] |= static_cast<uint16_t>((largestIndex >> 1) << 15);
+
+        return result;
+    }
+
+    glm::quat QuantizedQuaternion::dequantize() const
+    {
+        const int largestIndex = (data[0] >> 15) | ((data[1] >> 15) << 1);
+
+        float components[4];
+        float sumOfSquares = 0.0f;
+        int g = 0;
+        for(int i = 0; i < 4; ++i)
+        {
+            if(i == largestIndex)
+                continue;
+
+            const float normalized = (static_cast<float>(data[g] & 0x7FFF) / quatComponentScale) * 2.0f - 1.0f;
+            components[i] = normalized * quatComponentLimit;
+            sumOfSquares += components[i] * components[i];
+            ++g;
+        }
+
+        components[largestIndex] = std::sqrt(std::max(0.0f, 1.0f - sumOfSquares));
+
+        return glm::quat(components[3], components[0], components[1], components[2]);
+    }
+
+    AnimationClip::AnimationClip(const aiAnimation* animation, const std::vector<std::string>& nodeNames, const float ticksPerSecond)
+    {
+        m_duration = static_cast<float>(animation->mDuration);
+        m_lastKeyTime = -1.0f;
+
+        // Sample with smallest key interval of source animation. Most exporters write keys with same rate for all channels
+        // so samples will be at same time as source keys.
+        float sampleInterval = std::numeric_limits<float>::max();
+        for(uint32_t i = 0; i < animation->mNumChannels; ++i)
+        {
+            const aiNodeAnim* nodeAnim = animation->mChannels[i];
+
+            for(uint32_t g = 1; g < nodeAnim->mNumPositionKeys; ++g)
+            {
+                const float interval = static_cast<float>(nodeAnim->mPositionKeys[g].mTime - nodeAnim->mPositionKeys[g - 1].mTime);
+                if(interval > 0.0f)
+                    sampleInterval = std::min(sampleInterval, interval);
+            }
+
+            if(m_lastKeyTime < 0.0f && nodeAnim->mNumPositionKeys > 0 && isBoneName(nodeAnim->mNodeName.C_Str(), nodeAnim->mNodeName.length))
+                m_lastKeyTime = static_cast<float>(nodeAnim->mPositionKeys[nodeAnim->mNumPositionKeys - 1].mTime);
+        }
+        sampleInterval = std::max(sampleInterval, ticksPerSecond / m_maxSamplesPerSecond);
+
+        uint32_t intervalsCount = 1;
+        if(m_duration > 0.0f && sampleInterval < m_duration)
+            intervalsCount = static_cast<uint32_t>(std::lround(m_duration / sampleInterval));
+        // Adjust interval so last sample is exactly at duration.
+        sampleInterval = m_duration > 0.0f ? m_duration / static_cast<float>(intervalsCount) : 1.0f;
+
+        m_sampleCount = intervalsCount + 1;
+        m_inverseSampleInterval = 1.0f / sampleInterval;
+
+        m_nodeTrackIndices.resize(nodeNames.size(), -1);
+
+        std::vector<glm::vec3> positions(m_sampleCount);
+        std::vector<QuantizedQuaternion> rotations(m_sampleCount);
+        std::vector<glm::vec3> scales(m_sampleCount);
+
+        for(uint32_t i = 0; i < nodeNames.size(); ++i)
+        {
+            const std::string& nodeName = nodeNames[i];
+            if(!isBoneName(nodeName.c_str(), nodeName.length())) // use only aiNodeAnim which belong to bones
+                continue;
+
+            const aiNodeAnim* nodeAnim = nullptr;
+            for(uint32_t g = 0; g < animation->mNumChannels; ++g)
+            {
+                if(nodeName == animation->mChannels[g]->mNodeName.C_Str())
+                {
+                    nodeAnim = animation->mChannels[g];
+                    break;
+                }
+            }
+
+            if(!nodeAnim || nodeAnim->mNumPositionKeys == 0)
+                continue;
+
+            BR_ASSERT((nodeAnim->mNumScalingKeys == nodeAnim->mNumPositionKeys), "%s", "mNumScalingKeys != mNumPositionKeys");
+            BR_ASSERT((nodeAnim->mNumScalingKeys == nodeAnim->mNumRotationKeys), "%s", "mNumScalingKeys != mNumRotationKeys");
+
+            uint32_t keyCursor = 0;
+            for(uint32_t g = 0; g < m_sampleCount; ++g)
+            {
+                const float time = std::min(static_cast<float>(g) * sampleInterval, m_duration);
+                glm::quat rotation;
+                sampleChannel(nodeAnim, time, m_duration, keyCursor, positions[g], rotation, scales[g]);
+                rotations[g] = QuantizedQuaternion::quantize(rotation);
+            }
+
+            Track track;
+            track.positionStride = appendSamples(positions, m_positions, track.positionOffset);
+            track.rotationStride = appendSamples(rotations, m_rotations, track.rotationOffset);
+            track.scaleStride = appendSamples(scales, m_scales, track.scaleOffset);
+
+            m_nodeTrackIndices[i] = static_cast<int>(m_tracks.size());
+            m_tracks.push_back(track);
+        }
+
+        m_positions.shrink_to_fit();
+        m_rotations.shrink_to_fit();
+        m_scales.shrink_to_fit();
+        m_tracks.shrink_to_fit();
+
+        BR_INFO("Baked animation: %s samples: %d tracks: %d memory: %d bytes",
+                animation->mName.C_Str(), int(m_sampleCount), int(m_tracks.size()), int(getMemorySize()));
+    }
+
+    void AnimationClip::getSamplePosition(const float animationTime, uint32_t& sampleIndex, float& blend) const
+    {
+        const float samplePosition = glm::clamp(animationTime, 0.0f, m_duration) * m_inverseSampleInterval;
+
+        sampleIndex = std::min(static_cast<uint32_t>(samplePosition), m_sampleCount - 2);
+        blend = glm::clamp(samplePosition - static_cast<float>(sampleIndex), 0.0f, 1.0f);
+    }
+
+    glm::mat4 AnimationClip::sampleNode(const int nodeIndex, const uint32_t sampleIndex, const float blend) const
+    {
+        const int trackIndex = m_nodeTrackIndices[nodeIndex];
+        if(trackIndex == -1)
+            return glm::mat4{1.0f};
+
+        const Track& track = m_tracks[trackIndex];
+
+        // Constant track has stride 0 so both samples are same.
+        const uint32_t positionIndex = track.positionOffset + sampleIndex * track.positionStride;
+        const glm::vec3 position = glm::mix(m_positions[positionIndex], m_positions[positionIndex + track.positionStride], blend);
+
+        const uint32_t scaleIndex = track.scaleOffset + sampleIndex * track.scaleStride;
+        const glm::vec3 scale = glm::mix(m_scales[scaleIndex], m_scales[scaleIndex + track.scaleStride], blend);
+
+        const uint32_t rotationIndex = track.rotationOffset + sampleIndex * track.rotationStride;
+        const glm::quat rotation = nlerp(m_rotations[rotationIndex].dequantize(), m_rotations[rotationIndex + track.rotationStride].dequantize(), blend);
+
+        // translation * rotation * scale
+        glm::mat4 result = glm::mat4_cast(rotation);
+        result[0] *= scale.x;
+        result[1] *= scale.y;
+        result[2] *= scale.z;
+        result[3] = glm::vec4(position, 1.0f);
+
+        return result;
+    }
+
+    size_t AnimationClip::getMemorySize() const
+    {
+        return sizeof(AnimationClip) +
+               m_nodeTrackIndices.size() * sizeof(int) +
+               m_tracks.size() * sizeof(Track) +
+               m_positions.size() * sizeof(glm::vec3) +
+               m_rotations.size() * sizeof(QuantizedQuaternion) +
+               m_scales.size() * sizeof(glm::vec3);
+    }
+}
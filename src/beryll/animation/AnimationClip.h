@@ -0,0 +1,69 @@
+#pragma once
+
+#include "LibsHeaders.h"
+#include "CppHeaders.h"
+
+namespace Beryll
+{
+    // Unit quaternion compressed with smallest three method.
+    // Largest component is dropped and restored from other three (x*x + y*y + z*z + w*w = 1).
+    // Other three stored in 15 bits each. Index of dropped component stored in two highest bits.
+    struct QuantizedQuaternion
+    {
+        uint16_t data[3]{0, 0, 0};
+
+        static QuantizedQuaternion quantize(glm::quat q);
+        glm::quat dequantize() const;
+
+        bool operator==(const QuantizedQuaternion& other) const
+        {
+            return data[0] == other.data[0] && data[1] == other.data[1] && data[2] == other.data[2];
+        }
+    };
+
+    // Animation baked at load time from aiAnimation. Does not use aiScene after baking.
+    // All tracks sampled with same uniform rate so sampling is direct index, without keys search.
+    // Track which has same value in all samples (constant) stores only one sample.
+    class AnimationClip
+    {
+    public:
+        // nodeNames = flattened skeleton node names. Track is created for node if aiAnimation has channel with same name.
+        AnimationClip(const aiAnimation* animation, const std::vector<std::string>& nodeNames, const float ticksPerSecond);
+        ~AnimationClip() = default;
+
+        // Find two samples around animationTime (in ticks) and blend factor between them in range 0...1.
+        void getSamplePosition(const float animationTime, uint32_t& sampleIndex, float& blend) const;
+        // Local transform of node at sample position. Identity if node is not animated in this clip.
+        glm::mat4 sampleNode(const int nodeIndex, const uint32_t sampleIndex, const float blend) const;
+
+        float getDuration() const { return m_duration; } // In ticks.
+        float getLastKeyTime() const { return m_lastKeyTime; } // In ticks.
+        uint32_t getSampleCount() const { return m_sampleCount; }
+        size_t getMemorySize() const;
+
+    private:
+        struct Track
+        {
+            uint32_t positionOffset = 0;
+            uint32_t rotationOffset = 0;
+            uint32_t scaleOffset = 0;
+            // 0 for constant track (one sample), 1 for animated track.
+            uint32_t positionStride = 0;
+            uint32_t rotationStride = 0;
+            uint32_t scaleStride = 0;
+        };
+
+        float m_duration = 0.0f;
+        float m_lastKeyTime = 0.0f;
+        float m_inverseSampleInterval = 0.0f;
+        uint32_t m_sampleCount = 0;
+
+        std::vector<int> m_nodeTrackIndices; // [node index] = index in m_tracks or -1.
+        std::vector<Track> m_tracks;
+        std::vector<glm::vec3> m_positions;
+        std::vector<QuantizedQuaternion> m_rotations;
+        std::vector<glm::vec3> m_scales;
+
+        static constexpr float m_maxSamplesPerSecond = 60.0f;
+    };
+}
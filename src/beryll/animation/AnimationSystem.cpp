@@ -0,0 +1,221 @@
+#include "AnimationSystem.h"
+#include "beryll/gameObjects/BaseAnimatedObject.h"
+#include "beryll/async/AsyncRun.h"
+#include "beryll/renderer/Camera.h"
+
+namespace Beryll
+{
+    std::vector<BaseAnimatedObject*> AnimationSystem::m_objectsToUpdate;
+    std::mutex AnimationSystem::m_objectsToUpdateMutex;
+    std::vector<BaseAnimatedObject*> AnimationSystem::m_objectsToEvaluate;
+    std::vector<BaseAnimatedObject*> AnimationSystem::m_objectsWithAttachments;
+    std::unordered_map<AnimationSystem::PoseKey, BaseAnimatedObject*, AnimationSystem::PoseKeyHash> AnimationSystem::m_poseCache;
+    std::vector<std::pair<BaseAnimatedObject*, const BaseAnimatedObject*>> AnimationSystem::m_poseCopies;
+    bool AnimationSystem::m_poseCacheEnabled = true;
+    int AnimationSystem::m_poseCacheBucketsPerSample = 4;
+    bool AnimationSystem::m_LODEnabled = true;
+    float AnimationSystem::m_LOD1ScreenSize = 0.15f;
+    float AnimationSystem::m_LOD2ScreenSize = 0.05f;
+    int AnimationSystem::m_LOD1UpdateInterval = 2;
+    int AnimationSystem::m_LOD2UpdateInterval = 4;
+    int AnimationSystem::m_offScreenUpdateInterval = 15;
+    int AnimationSystem::m_LOD2MaxNodeDepth = 4;
+    uint32_t AnimationSystem::m_frameIndex = 0;
+    int AnimationSystem::m_lastUpdateCount = 0;
+    int AnimationSystem::m_lastEvaluatedCount = 0;
+    int AnimationSystem::m_lastCalculatedPosesCount = 0;
+    float AnimationSystem::m_updateTime = 0.0f;
+    Timer AnimationSystem::m_timer;
+    std::function<void(std::vector<BaseAnimatedObject*>&, int, int)> AnimationSystem::m_updateRangeAsync;
+    std::function<void(std::vector<std::pair<BaseAnimatedObject*, const BaseAnimatedObject*>>&, int, int)> AnimationSystem::m_copyPosesRangeAsync;
+
+    void AnimationSystem::create()
+    {
+        if(m_updateRangeAsync) { return; }
+
+        m_objectsToUpdate.reserve(500);
+        m_objectsToEvaluate.reserve(500);
+        m_objectsWithAttachments.reserve(100);
+        m_poseCopies.reserve(500);
+        m_poseCache.reserve(500);
+
+        m_updateRangeAsync = [](std::vector<BaseAnimatedObject*>& v, int begin, int end) -> void // -> void = return type.
+        {
+            // Each object writes only own bones transforms. Animation clips are shared but read only.
+            for(int i = begin; i < end; ++i)
+            {
+                v[i]->calculateTransforms(v[i]->m_animationLOD == 2 ? m_LOD2MaxNodeDepth : std::numeric_limits<int>::max());
+            }
+        };
+
+        m_copyPosesRangeAsync = [](std::vector<std::pair<BaseAnimatedObject*, const BaseAnimatedObject*>>& v, int begin, int end) -> void
+        {
+            for(int i = begin; i < end; ++i)
+            {
+                v[i].first->copyTransformsFrom(v[i].second);
+            }
+        };
+    }
+
+    void AnimationSystem::update()
+    {
+        ++m_frameIndex;
+        m_lastUpdateCount = static_cast<int>(m_objectsToUpdate.size());
+        m_lastEvaluatedCount = 0;
+        m_lastCalculatedPosesCount = 0;
+
+        if(m_objectsToUpdate.empty())
+            return;
+
+        m_timer.reset();
+
+        // Keep only objects which should be updated in this frame. Camera is already updated.
+        m_objectsToEvaluate.clear();
+        m_objectsWithAttachments.clear();
+        for(BaseAnimatedObject* obj : m_objectsToUpdate)
+        {
+            // Object can move even if pose is not updated in this frame. Attachments must follow.
+            if(!obj->m_attachments.empty())
+                m_objectsWithAttachments.push_back(obj);
+
+            obj->m_animationLOD = calculateLOD(obj);
+
+            if(needUpdateInThisFrame(obj))
+            {
+                obj->updateSamplePosition();
+                m_objectsToEvaluate.push_back(obj);
+            }
+        }
+        m_objectsToUpdate.clear();
+        m_lastEvaluatedCount = static_cast<int>(m_objectsToEvaluate.size());
+
+        m_poseCopies.clear();
+        if(m_poseCacheEnabled)
+            groupByPose();
+
+        m_lastCalculatedPosesCount = static_cast<int>(m_objectsToEvaluate.size());
+
+        if(m_lastCalculatedPosesCount >= m_minCountForAsync)
+            AsyncRun::Run(m_objectsToEvaluate, m_updateRangeAsync);
+        else if(m_lastCalculatedPosesCount > 0)
+            m_updateRangeAsync(m_objectsToEvaluate, 0, m_lastCalculatedPosesCount);
+
+        // After all poses are calculated.
+        if(static_cast<int>(m_poseCopies.size()) >= m_minCountForAsync)
+            AsyncRun::Run(m_poseCopies, m_copyPosesRangeAsync);
+        else if(!m_poseCopies.empty())
+            m_copyPosesRangeAsync(m_poseCopies, 0, static_cast<int>(m_poseCopies.size()));
+
+        for(BaseAnimatedObject* obj : m_objectsWithAttachments)
+        {
+            obj->updateAttachments();
+        }
+
+        m_updateTime = m_timer.getElapsedMilliSec();
+    }
+
+    void AnimationSystem::addToUpdate(BaseAnimatedObject* obj)
+    {
+        std::scoped_lock<std::mutex> lock(m_objectsToUpdateMutex);
+        m_objectsToUpdate.push_back(obj);
+    }
+
+    void AnimationSystem::removeFromUpdate(BaseAnimatedObject* obj)
+    {
+        std::scoped_lock<std::mutex> lock(m_objectsToUpdateMutex);
+        m_objectsToUpdate.erase(std::remove(m_objectsToUpdate.begin(), m_objectsToUpdate.end(), obj), m_objectsToUpdate.end());
+    }
+
+    int AnimationSystem::calculateLOD(const BaseAnimatedObject* obj)
+    {
+        if(!m_LODEnabled || !obj->m_animationLODEnabled)
+            return 0;
+
+        // Bounds of last calculated pose with current object transforms.
+        glm::vec3 center = obj->getOrigin();
+        float radius = 0.0f;
+        if(obj->m_hasBounds)
+        {
+            obj->getBoundingSphere(center, radius);
+            if(!Camera::getIsSeeSphere(center, radius))
+                return 3;
+        }
+        else
+        {
+            if(!Camera::getIsSeeObject(center, 1.2f))
+                return 3;
+
+            // Objects without collision mesh does not have size.
+            radius = std::max(obj->m_XZRadius, obj->m_objectHeight * 0.5f);
+            if(radius <= 0.0f)
+                radius = 1.0f;
+        }
+
+        const float distance = std::max(Camera::getDistanceToObject(center), 0.001f);
+
+        const float screenSize = radius / (distance * std::tan(Camera::getFovRadians() * 0.5f));
+
+        if(screenSize >= m_LOD1ScreenSize)
+            return 0;
+        else if(screenSize >= m_LOD2ScreenSize)
+            return 1;
+        else
+            return 2;
+    }
+
+    void AnimationSystem::groupByPose()
+    {
+        m_poseCache.clear();
+
+        int calculateCount = 0;
+        for(BaseAnimatedObject* obj : m_objectsToEvaluate)
+        {
+            // LOD 2 pose depends on previous pose of same object. Can not be shared.
+            if(obj->m_animationLOD == 2 && obj->m_isPoseCalculated)
+            {
+                m_objectsToEvaluate[calculateCount] = obj;
+                ++calculateCount;
+                continue;
+            }
+
+            // Snap time to bucket. Object will be drawn with snapped time even if it calculates pose itself.
+            const float buckets = static_cast<float>(m_poseCacheBucketsPerSample);
+            const uint32_t blendBucket = static_cast<uint32_t>(std::lround(obj->m_poseBlend * buckets));
+            obj->m_poseBlend = static_cast<float>(blendBucket) / buckets;
+
+            const PoseKey key{obj->m_modelData.get(), obj->m_currentAnimIndex, obj->m_poseSampleIndex, blendBucket};
+            const auto [it, inserted] = m_poseCache.try_emplace(key, obj);
+            if(inserted)
+            {
+                m_objectsToEvaluate[calculateCount] = obj;
+                ++calculateCount;
+            }
+            else
+            {
+                m_poseCopies.emplace_back(obj, it->second);
+            }
+        }
+
+        m_objectsToEvaluate.resize(calculateCount);
+    }
+
+    bool AnimationSystem::needUpdateInThisFrame(const BaseAnimatedObject* obj)
+    {
+        if(!obj->m_isPoseCalculated)
+            return true;
+
+        int interval = 1;
+        if(obj->m_animationLOD == 1)
+            interval = m_LOD1UpdateInterval;
+        else if(obj->m_animationLOD == 2)
+            interval = m_LOD2UpdateInterval;
+        else if(obj->m_animationLOD == 3)
+            interval = m_offScreenUpdateInterval;
+
+        if(interval == 0)
+            return false; // Frozen.
+
+        // Shift by ID. Objects with same LOD are updated in different frames.
+        return (m_frameIndex + static_cast<uint32_t>(obj->getID())) % static_cast<uint32_t>(interval) == 0;
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "LibsHeaders.h"
+#include "CppHeaders.h"
+
+#include "beryll/core/Timer.h"
+
+namespace Beryll
+{
+    class BaseAnimatedObject;
+
+    // Calculates bones transforms of all animated objects in one place.
+    // Objects are collected in BaseAnimatedObject::updateAfterPhysics() (can be called from many threads)
+    // and evaluated in parallel after GameStateMachine::updateAfterPhysics() and before draw.
+    // Level of detail (LOD):
+    // 0 - big on screen. Updated every frame with full skeleton.
+    // 1 - medium on screen. Updated every m_LOD1UpdateInterval frames.
+    // 2 - small on screen. Updated every m_LOD2UpdateInterval frames. Nodes deeper than m_LOD2MaxNodeDepth are not sampled.
+    // 3 - off screen. Updated every m_offScreenUpdateInterval frames (0 = pose frozen).
+    // Frames of update are shifted by object ID so updates of many objects are spread evenly over frames.
+    // Pose cache:
+    // Objects loaded from same file which play same clip at same sample share one calculated pose.
+    // Blend factor between samples is snapped to m_poseCacheBucketsPerSample buckets so near times also share pose.
+    // Attachments:
+    // Objects attached to bones are moved in one batch after all poses are calculated (on main thread, they can have physics).
+    class AnimationSystem final
+    {
+    public:
+        AnimationSystem() = delete;
+        ~AnimationSystem() = delete;
+
+        static void setLODEnabled(bool enabled) { m_LODEnabled = enabled; }
+        // Screen size = object radius / (distance to camera * tan(fov / 2)). 1 = object fills half of screen height.
+        static void setLODScreenSizes(float LOD1ScreenSize, float LOD2ScreenSize)
+        {
+            m_LOD1ScreenSize = LOD1ScreenSize;
+            m_LOD2ScreenSize = LOD2ScreenSize;
+        }
+        // In frames.
+        static void setLODUpdateIntervals(int LOD1Interval, int LOD2Interval, int offScreenInterval)
+        {
+            m_LOD1UpdateInterval = std::max(1, LOD1Interval);
+            m_LOD2UpdateInterval = std::max(1, LOD2Interval);
+            m_offScreenUpdateInterval = std::max(0, offScreenInterval);
+        }
+        static void setLOD2MaxNodeDepth(int depth) { m_LOD2MaxNodeDepth = depth; }
+
+        static void setPoseCacheEnabled(bool enabled) { m_poseCacheEnabled = enabled; }
+        static void setPoseCacheBucketsPerSample(int buckets) { m_poseCacheBucketsPerSample = std::max(1, buckets); }
+
+        static int getLastUpdateCount() { return m_lastUpdateCount; } // Collected objects.
+        static int getLastEvaluatedCount() { return m_lastEvaluatedCount; } // Objects which were not skipped by LOD.
+        static int getLastCalculatedPosesCount() { return m_lastCalculatedPosesCount; } // Others took pose from cache.
+        static float getUpdateTime() { return m_updateTime; } // Update time in milli sec.
+
+    private:
+        friend class GameLoop;
+        friend class BaseAnimatedObject;
+        static void create();
+        static void update(); // Sync point. All bones transforms are ready after return.
+
+        static void addToUpdate(BaseAnimatedObject* obj); // Thread safe.
+        static void removeFromUpdate(BaseAnimatedObject* obj); // When object is destroyed before update().
+
+        static int calculateLOD(const BaseAnimatedObject* obj);
+        static bool needUpdateInThisFrame(const BaseAnimatedObject* obj);
+        static void groupByPose(); // Split m_objectsToEvaluate to objects which calculate pose and objects which copy it.
+
+        static std::vector<BaseAnimatedObject*> m_objectsToUpdate;
+        static std::mutex m_objectsToUpdateMutex;
+        static std::vector<BaseAnimatedObject*> m_objectsToEvaluate;
+        static std::vector<BaseAnimatedObject*> m_objectsWithAttachments;
+
+        struct PoseKey
+        {
+            const void* clips = nullptr; // Model data. Same for all objects loaded from same file.
+            int clipIndex = 0;
+            uint32_t sampleIndex = 0;
+            uint32_t blendBucket = 0;
+
+            bool operator==(const PoseKey& other) const
+            {
+                return clips == other.clips && clipIndex == other.clipIndex && sampleIndex == other.sampleIndex && blendBucket == other.blendBucket;
+            }
+        };
+        struct PoseKeyHash
+        {
+            size_t operator()(const PoseKey& key) const
+            {
+                size_t hash = std::hash<const void*>()(key.clips);
+                hash ^= std::hash<uint32_t>()((static_cast<uint32_t>(key.clipIndex) << 24) ^ (key.sampleIndex << 8) ^ key.blendBucket) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+                return hash;
+            }
+        };
+        static std::unordered_map<PoseKey, BaseAnimatedObject*, PoseKeyHash> m_poseCache; // Cleared every frame.
+        static std::vector<std::pair<BaseAnimatedObject*, const BaseAnimatedObject*>> m_poseCopies; // first copies pose from second.
+        static bool m_poseCacheEnabled;
+        static int m_poseCacheBucketsPerSample;
+
+        static bool m_LODEnabled;
+        static float m_LOD1ScreenSize;
+        static float m_LOD2ScreenSize;
+        static int m_LOD1UpdateInterval;
+        static int m_LOD2UpdateInterval;
+        static int m_offScreenUpdateInterval;
+        static int m_LOD2MaxNodeDepth;
+        static uint32_t m_frameIndex;
+
+        static int m_lastUpdateCount;
+        static int m_lastEvaluatedCount;
+        static int m_lastCalculatedPosesCount;
+        static float m_updateTime;
+        static Timer m_timer;
+
+        static std::function<void(std::vector<BaseAnimatedObject*>&, int, int)> m_updateRangeAsync;
+        static std::function<void(std::vector<std::pair<BaseAnimatedObject*, const BaseAnimatedObject*>>&, int, int)> m_copyPosesRangeAsync;
+        static constexpr int m_minCountForAsync = 4; // Less objects are faster on main thread.
+    };
+}
@@ -0,0 +1,131 @@
+#include "AssetRegistry.h"
+#include "beryll/core/Log.h"
+#include "beryll/core/EventHandler.h"
+
+namespace Beryll
+{
+    std::list<AssetRegistry::Entry> AssetRegistry::m_entries;
+    std::array<std::unordered_map<std::string, AssetRegistry::EntryIterator>, static_cast<int>(AssetType::COUNT)> AssetRegistry::m_IDs;
+    std::array<uint64_t, static_cast<int>(AssetType::COUNT)> AssetRegistry::m_memoryUsage{};
+    uint64_t AssetRegistry::m_memoryBudget = 256 * 1024 * 1024;
+
+    void AssetRegistry::addEntry(AssetType type, const std::string& ID, std::shared_ptr<void> asset, uint64_t sizeBytes)
+    {
+        BR_ASSERT((asset != nullptr), "Add empty asset: %s", ID.c_str());
+
+        remove(type, ID);
+
+        m_entries.push_front(Entry{type, ID, std::move(asset), sizeBytes});
+        m_IDs[static_cast<int>(type)].emplace(ID, m_entries.begin());
+        m_memoryUsage[static_cast<int>(type)] += sizeBytes;
+
+        evictToBudget();
+    }
+
+    void AssetRegistry::remove(AssetType type, const std::string& ID)
+    {
+        const auto search = m_IDs[static_cast<int>(type)].find(ID);
+        if(search != m_IDs[static_cast<int>(type)].end())
+            erase(search->second);
+    }
+
+    void AssetRegistry::purgeUnreferenced()
+    {
+        for(auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if(it->asset.use_count() == 1)
+                it = erase(it);
+            else
+                ++it;
+        }
+
+        BR_INFO("Assets purged. Memory usage: %d KB", static_cast<int>(getMemoryUsage() / 1024));
+    }
+
+    void AssetRegistry::purgeUnreferenced(AssetType type)
+    {
+        for(auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if(it->type == type && it->asset.use_count() == 1)
+                it = erase(it);
+            else
+                ++it;
+        }
+    }
+
+    uint64_t AssetRegistry::getMemoryUsage()
+    {
+        uint64_t total = 0;
+        for(const uint64_t usage : m_memoryUsage)
+        {
+            total += usage;
+        }
+        return total;
+    }
+
+    uint64_t AssetRegistry::getBudgetedMemoryUsage()
+    {
+        uint64_t total = 0;
+        for(int i = 0; i < static_cast<int>(AssetType::COUNT); ++i)
+        {
+            if(getIsInBudget(static_cast<AssetType>(i)))
+                total += m_memoryUsage[i];
+        }
+        return total;
+    }
+
+    void AssetRegistry::update()
+    {
+        if(EventHandler::checkEvent(EventID::APP_LOWMEMORY))
+        {
+            BR_WARN("%s", "Low memory event. Purge not referenced assets.");
+            purgeUnreferenced();
+        }
+    }
+
+    void AssetRegistry::clear()
+    {
+        m_entries.clear();
+        for(std::unordered_map<std::string, EntryIterator>& IDs : m_IDs)
+        {
+            IDs.clear();
+        }
+        m_memoryUsage.fill(0);
+
+        BR_INFO("%s", "AssetRegistry cleared.");
+    }
+
+    void AssetRegistry::evictToBudget()
+    {
+        uint64_t usage = getBudgetedMemoryUsage();
+        if(usage <= m_memoryBudget)
+            return;
+
+        // From least recently used. Most recently used (just added) asset is kept.
+        auto it = m_entries.end();
+        while(usage > m_memoryBudget && it != m_entries.begin())
+        {
+            --it;
+            if(it == m_entries.begin())
+                break;
+
+            if(getIsInBudget(it->type) && it->asset.use_count() == 1)
+            {
+                usage -= it->sizeBytes;
+                it = erase(it);
+            }
+        }
+
+        if(usage > m_memoryBudget)
+        {
+            BR_WARN("Referenced assets use more memory than budget: %d KB", static_cast<int>(usage / 1024));
+        }
+    }
+
+    AssetRegistry::EntryIterator AssetRegistry::erase(EntryIterator it)
+    {
+        m_memoryUsage[static_cast<int>(it->type)] -= it->sizeBytes;
+        m_IDs[static_cast<int>(it->type)].erase(it->ID);
+        return m_entries.erase(it); // Asset is freed here if not referenced.
+    }
+}
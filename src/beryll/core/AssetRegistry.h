@@ -0,0 +1,94 @@
+#pragma once
+
+#include "LibsHeaders.h"
+#include "CppHeaders.h"
+
+namespace Beryll
+{
+    enum class AssetType
+    {
+        TEXTURE,
+        SHADER,
+        ANIMATED_MODEL,
+        SOUND, // Owned by SoundsManager while app runs. Counted in getMemoryUsage(SOUND) but not in memory budget.
+
+        COUNT // MUST be always last.
+    };
+
+    // One cache for all loaded assets. Asset ID = file path (unique inside one AssetType).
+    // Handle = std::shared_ptr to asset. Asset is referenced while any handle outside registry is alive.
+    // Not referenced assets stay in cache for fast reloading until memory budget is exceeded.
+    // Then least recently used not referenced assets are removed. Asset must free own memory
+    // (GPU memory too) in destructor or custom deleter of shared_ptr.
+    // Asset is NOT freed when its last handle outside registry is destroyed. Call purgeUnreferenced()
+    // to free not used assets immediately (for example after level unload).
+    // All methods should be called from main (GL) thread.
+    class AssetRegistry final
+    {
+    public:
+        AssetRegistry() = delete;
+        ~AssetRegistry() = delete;
+
+        // nullptr if asset with this ID was not added or was removed. Marks asset as used.
+        template<typename T>
+        static std::shared_ptr<T> find(AssetType type, const std::string& ID)
+        {
+            std::unordered_map<std::string, EntryIterator>& IDs = m_IDs[static_cast<int>(type)];
+            const auto search = IDs.find(ID);
+            if(search == IDs.end())
+                return nullptr;
+
+            m_entries.splice(m_entries.begin(), m_entries, search->second); // Move to front = most recently used.
+            return std::static_pointer_cast<T>(search->second->asset);
+        }
+
+        // Replace asset with same ID. sizeBytes - approximate memory used by asset (CPU + GPU).
+        template<typename T>
+        static void add(AssetType type, const std::string& ID, const std::shared_ptr<T>& asset, uint64_t sizeBytes)
+        {
+            // Stored without const. find<const T>() returns it as const again.
+            addEntry(type, ID, std::const_pointer_cast<std::remove_const_t<T>>(asset), sizeBytes);
+        }
+        // Asset will freed when last handle is destroyed.
+        static void remove(AssetType type, const std::string& ID);
+
+        // Remove not referenced assets. Called by engine on low memory event.
+        static void purgeUnreferenced();
+        static void purgeUnreferenced(AssetType type);
+
+        // Assets which can not be evicted (SOUND) are not counted.
+        static void setMemoryBudget(uint64_t bytes) { m_memoryBudget = bytes; evictToBudget(); }
+        static uint64_t getMemoryBudget() { return m_memoryBudget; }
+        static uint64_t getMemoryUsage(AssetType type) { return m_memoryUsage[static_cast<int>(type)]; }
+        static uint64_t getMemoryUsage(); // All types.
+        static uint32_t getAssetsCount(AssetType type) { return m_IDs[static_cast<int>(type)].size(); }
+
+    private:
+        friend class GameLoop;
+        static void update(); // Purge on low memory event.
+        // Remove all assets. Called at shutdown while GL context exists.
+        // Assets referenced outside registry are freed by their last handle.
+        static void clear();
+
+        struct Entry
+        {
+            AssetType type;
+            std::string ID;
+            std::shared_ptr<void> asset; // use_count() == 1 means referenced only by registry.
+            uint64_t sizeBytes = 0;
+        };
+        using EntryIterator = std::list<Entry>::iterator;
+
+        static void addEntry(AssetType type, const std::string& ID, std::shared_ptr<void> asset, uint64_t sizeBytes);
+        // Remove least recently used not referenced assets until memory usage <= budget.
+        static void evictToBudget();
+        static bool getIsInBudget(AssetType type) { return type != AssetType::SOUND; }
+        static uint64_t getBudgetedMemoryUsage();
+        static EntryIterator erase(EntryIterator it);
+
+        static std::list<Entry> m_entries; // Front = most recently used.
+        static std::array<std::unordered_map<std::string, EntryIterator>, static_cast<int>(AssetType::COUNT)> m_IDs;
+        static std::array<uint64_t, static_cast<int>(AssetType::COUNT)> m_memoryUsage;
+        static uint64_t m_memoryBudget;
+    };
+}
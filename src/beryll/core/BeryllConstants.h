@@ -13,6 +13,9 @@ namespace BeryllConstants
     const std::string_view simpleObjDefaultFragmentPath = "shaders/GLES/default/SimpleObject.frag";
     const std::string_view simpleObjTwoMaterialsDefaultVertexPath = "shaders/GLES/default/SimpleObjectTwoMaterials.vert";
     const std::string_view simpleObjTwoMaterialsDefaultFragmentPath = "shaders/GLES/default/SimpleObjectTwoMaterials.frag";
+    // For compact vertex formats (BeryllUtils::VertexFormat). Same fragment shaders.
+    const std::string_view simpleObjCompactVertexPath = "shaders/GLES/default/SimpleObjectCompact.vert";
+    const std::string_view simpleObjTwoMaterialsCompactVertexPath = "shaders/GLES/default/SimpleObjectTwoMaterialsCompact.vert";
 
     const std::string_view animatedObjDefaultVertexPath = "shaders/GLES/default/AnimatedObject.vert";
     const std::string_view animatedObjDefaultFragmentPath = "shaders/GLES/default/AnimatedObject.frag";
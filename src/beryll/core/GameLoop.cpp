@@ -3,10 +3,13 @@
 #include "beryll/core/GameStateMachine.h"
 #include "beryll/core/EventHandler.h"
 #include "beryll/core/SoundsManager.h"
+#include "beryll/core/AssetRegistry.h"
 #include "beryll/GUI/MainImGUI.h"
 #include "beryll/physics/Physics.h"
+#include "beryll/physics/ProjectileSystem.h"
 #include "beryll/renderer/Camera.h"
 #include "beryll/particleSystem/ParticleSystem.h"
+#include "beryll/animation/AnimationSystem.h"
 #include "beryll/loadingScreen/LoadingScreen.h"
 #include "beryll/billingSystem/BillingSystem.h"
 #include "beryll/googleAnalytics/GoogleAnalytics.h"
@@ -46,8 +49,12 @@ namespace Beryll
 
         Physics::create();
 
+        ProjectileSystem::create();
+
         ParticleSystem::create();
 
+        AnimationSystem::create();
+
         LoadingScreen::create();
 
         BillingSystem::create();
@@ -75,6 +82,7 @@ namespace Beryll
         // Check user input.
             EventHandler::resetEvents(EventID::ALL_EVENTS);
             EventHandler::loadEvents();
+            AssetRegistry::update(); // Free not used assets on low memory event.
 
         // Update layers start.
             // First react to user input, set positions of objects, move objects: player->move().
@@ -82,6 +90,7 @@ namespace Beryll
             GameStateMachine::updateBeforePhysics();
 
             Physics::simulate();
+            ProjectileSystem::update(); // Ray casts against world after simulation. Hits are ready in updateAfterPhysics().
 
             // Read positions of objects after simulation, resolve collisions here.
             // Prefer update camera properties here.
@@ -92,6 +101,10 @@ namespace Beryll
             // Don't set any camera attributes after this call (set in updateAfterPhysics()).
             Camera::update3DCamera();
 
+        // Calculate bones transforms of animated objects collected in updateAfterPhysics() (in parallel).
+            // Sync point. All transforms are ready after this call.
+            AnimationSystem::update();
+
             m_CPUTime = m_timer.getElapsedMicroSec() - m_frameStart;
             m_GPUTimeStart = m_timer.getElapsedMicroSec();
 
@@ -124,5 +137,8 @@ namespace Beryll
         }
 
         BR_INFO("%s", "GameLoop stopped.");
+
+        // Cached GPU resources must be deleted before GL context. Window (and context) is destroyed after main() returns.
+        AssetRegistry::clear();
     }
 }
@@ -1,10 +1,12 @@
 #include "SoundsManager.h"
 #include "Log.h"
+#include "AssetRegistry.h"
+#include "beryll/utils/FileView.h"
 
 namespace Beryll
 {
     bool SoundsManager::m_created = false;
-    std::map<std::string, std::unique_ptr<Mix_Chunk, decltype(&Mix_FreeChunk)>> SoundsManager::m_WAVs;
+    std::map<std::string, std::shared_ptr<Mix_Chunk>> SoundsManager::m_WAVs;
     std::map<std::string, std::unique_ptr<Mix_Music, decltype(&Mix_FreeMusic)>> SoundsManager::m_MP3s;
 
 
@@ -34,12 +36,16 @@ namespace Beryll
         auto result =  m_WAVs.find(path);
         if(result != m_WAVs.end()) { return; }
 
-        Mix_Chunk* wavSound = Mix_LoadWAV(path.c_str());
+        // Whole sound is decoded to chunk. View can be closed after. Can be inside pack.
+        BeryllUtils::FileView file;
+        Mix_Chunk* wavSound = file.open(path) ? Mix_LoadWAV_IO(SDL_IOFromConstMem(file.getData(), file.getSize()), true) : nullptr;
         BR_ASSERT((wavSound != nullptr), "Mix_LoadWAV() failed: %s", path.c_str());
 
         Mix_VolumeChunk(wavSound, volume);
 
-        m_WAVs.insert(std::make_pair(path, std::unique_ptr<Mix_Chunk, decltype(&Mix_FreeChunk)>(wavSound, Mix_FreeChunk)));
+        std::shared_ptr<Mix_Chunk> chunk(wavSound, Mix_FreeChunk);
+        AssetRegistry::add(AssetType::SOUND, path, chunk, wavSound->alen); // Memory accounting only. Not in budget.
+        m_WAVs.insert(std::make_pair(path, std::move(chunk)));
     }
 
     void SoundsManager::playWAV(const std::string& path, int timesRepeat)
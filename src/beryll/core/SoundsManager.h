@@ -33,7 +33,8 @@ namespace Beryll
         static void create();
         static bool m_created;
 
-        static std::map<std::string, std::unique_ptr<Mix_Chunk, decltype(&Mix_FreeChunk)>> m_WAVs; // With custom deleter.
+        // With custom deleter. Also added to AssetRegistry for memory accounting. Not evicted while loaded here.
+        static std::map<std::string, std::shared_ptr<Mix_Chunk>> m_WAVs;
         static std::map<std::string, std::unique_ptr<Mix_Music, decltype(&Mix_FreeMusic)>> m_MP3s;
     };
 }
@@ -13,21 +13,15 @@ namespace Beryll
     {
         BR_INFO("Process animated colliding object: %s", filePath);
 
-        BR_ASSERT((m_scene->mNumMeshes == 2),
+        BR_ASSERT((m_modelData->meshCount == 2),
                   "Colliding animated object: %s MUST contain 2 meshes. For draw and physics simulation", filePath);
 
-        BR_ASSERT((m_scene->HasAnimations() && (m_scene->mMeshes[0]->mNumBones > 0 || m_scene->mMeshes[1]->mNumBones > 0)),
+        BR_ASSERT((!m_modelData->animationClips.empty() && m_modelData->boneCount > 0),
                   "%s", "Animated object must have animation + bone");
 
-        for(int i = 0; i < m_scene->mNumMeshes; ++i)
-        {
-            std::string meshName = m_scene->mMeshes[i]->mName.C_Str();
+        BR_ASSERT((!m_modelData->collisionVertices.empty()), "Colliding animated object: %s MUST contain Collision mesh.", filePath);
 
-            if(meshName.find("Collision") != std::string::npos)
-            {
-                loadCollisionMesh(m_scene->mMeshes[i], meshName, collisionMassKg, wantCollisionCallBack, collFlag, collGroup, collMask);
-            }
-        }
+        loadCollisionMesh(collisionMassKg, wantCollisionCallBack, collFlag, collGroup, collMask);
     }
 
     AnimatedCollidingObject::~AnimatedCollidingObject()
@@ -35,9 +29,7 @@ namespace Beryll
 
     }
 
-    void AnimatedCollidingObject::loadCollisionMesh(const aiMesh* mesh,
-                                                    const std::string& meshName,
-                                                    float mass,
+    void AnimatedCollidingObject::loadCollisionMesh(float mass,
                                                     bool wantCallBack,
                                                     CollisionFlags collFlag,
                                                     CollisionGroups collGroup,
@@ -45,25 +37,27 @@ namespace Beryll
     {
         // Collect collision mesh dimensions.
         // Model should be created in Blender where up axis = +Z.
-        for(int g = 0; g < mesh->mNumVertices; ++g)
+        // Collision mesh data was extracted from file at load and shared between objects loaded from same file.
+        const std::vector<glm::vec3>& vertices = m_modelData->collisionVertices;
+        for(const glm::vec3& vertex : vertices)
         {
             // Top and bottom points must be taken from Z axis.
-            if(mesh->mVertices[g].z < m_mostBottomVertex)
-                m_mostBottomVertex = mesh->mVertices[g].z;
-            if(mesh->mVertices[g].z > m_mostTopVertex)
-                m_mostTopVertex = mesh->mVertices[g].z;
+            if(vertex.z < m_mostBottomVertex)
+                m_mostBottomVertex = vertex.z;
+            if(vertex.z > m_mostTopVertex)
+                m_mostTopVertex = vertex.z;
 
-            if(mesh->mVertices[g].x < m_smallestX)
-                m_smallestX = mesh->mVertices[g].x;
-            if(mesh->mVertices[g].x > m_biggestX)
-                m_biggestX = mesh->mVertices[g].x;
+            if(vertex.x < m_smallestX)
+                m_smallestX = vertex.x;
+            if(vertex.x > m_biggestX)
+                m_biggestX = vertex.x;
 
             // Z dimensions should be taken from Y axis.
             // In Blender Y axis is horizontal and will replaced by Z after exporting.
-            if(mesh->mVertices[g].y < m_smallestZ)
-                m_smallestZ = mesh->mVertices[g].y;
-            if(mesh->mVertices[g].y > m_biggestZ)
-                m_biggestZ = mesh->mVertices[g].y;
+            if(vertex.y < m_smallestZ)
+                m_smallestZ = vertex.y;
+            if(vertex.y > m_biggestZ)
+                m_biggestZ = vertex.y;
         }
 
         // Colliding object described by collision mesh.
@@ -82,13 +76,7 @@ namespace Beryll
         m_collisionMask = collMask;
         m_collisionMass = mass;
 
-        glm::mat4 collisionTransforms{1.0f};
-
-        const aiNode* node = BeryllUtils::Common::findAinodeForAimesh(m_scene, m_scene->mRootNode, mesh->mName);
-        if(node)
-        {
-            collisionTransforms = BeryllUtils::Matrix::aiToGlm(node->mTransformation);
-        }
+        const glm::mat4& collisionTransforms = m_modelData->collisionTransforms;
         // Check scale. Should be 1.
         glm::vec3 scale = BeryllUtils::Matrix::getScaleFrom4x4Glm(collisionTransforms);
         BR_ASSERT((scale.x > 0.9999f && scale.x < 1.0001f &&
@@ -103,22 +91,6 @@ namespace Beryll
         m_hasCollisionObject = true;
         m_isEnabledInPhysicsSimulation = true;
 
-        std::vector<glm::vec3> vertices;
-        vertices.reserve(mesh->mNumVertices);
-        for(int i = 0; i < mesh->mNumVertices; ++i)
-        {
-            vertices.emplace_back(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
-        }
-
-        std::vector<uint32_t> indices;
-        indices.reserve(mesh->mNumFaces * 3);
-        for(int i = 0; i < mesh->mNumFaces; ++i)
-        {
-            indices.emplace_back(mesh->mFaces[i].mIndices[0]);
-            indices.emplace_back(mesh->mFaces[i].mIndices[1]);
-            indices.emplace_back(mesh->mFaces[i].mIndices[2]);
-        }
-
-        Physics::addObject(vertices, indices, collisionTransforms, meshName, m_ID, mass, wantCallBack, collFlag, collGroup, collMask);
+        Physics::addObject(vertices, m_modelData->collisionIndices, collisionTransforms, m_modelData->collisionMeshName, m_ID, mass, wantCallBack, collFlag, collGroup, collMask);
     }
 }
@@ -30,9 +30,7 @@ namespace Beryll
         ~AnimatedCollidingObject() override;
 
     private:
-        void loadCollisionMesh(const aiMesh* mesh,
-                               const std::string& meshName,
-                               float mass,
+        void loadCollisionMesh(float mass,
                                bool wantCallBack,
                                CollisionFlags collFlag,
                                CollisionGroups collGroup,
@@ -8,8 +8,8 @@ namespace Beryll
     {
         BR_INFO("Process animated object: %s", filePath);
 
-        BR_ASSERT((m_scene->mNumMeshes == 1), "Animated object: %s MUST contain only 1 mesh.", filePath);
-        BR_ASSERT((m_scene->HasAnimations() && m_scene->mMeshes[0]->mNumBones > 0), "%s", "Animated object must have animation + bone.");
+        BR_ASSERT((m_modelData->meshCount == 1), "Animated object: %s MUST contain only 1 mesh.", filePath);
+        BR_ASSERT((!m_modelData->animationClips.empty() && m_modelData->boneCount > 0), "%s", "Animated object must have animation + bone.");
     }
 
     AnimatedObject::~AnimatedObject()
@@ -1,73 +1,156 @@
 #include "BaseAnimatedObject.h"
 #include "beryll/core/TimeStep.h"
-#include "beryll/utils/Quaternion.h"
 #include "beryll/renderer/Camera.h"
-#include "beryll/utils/File.h"
+#include "beryll/utils/FileView.h"
 #include "beryll/renderer/Renderer.h"
 #include "beryll/core/RandomGenerator.h"
+#include "beryll/animation/AnimationSystem.h"
+#include "beryll/core/AssetRegistry.h"
 
 namespace Beryll
 {
-    std::map<const std::string, std::pair<std::shared_ptr<Assimp::Importer>, const aiScene*>> BaseAnimatedObject::m_importersScenes;
-
     BaseAnimatedObject::BaseAnimatedObject(const char* filePath,
                                            SceneObjectGroups sceneGroup) : m_modelPath(filePath)
     {
-        const auto search = m_importersScenes.find(m_modelPath);
-        if(search != m_importersScenes.end())
+        m_modelData = AssetRegistry::find<const AnimatedModelData>(AssetType::ANIMATED_MODEL, m_modelPath);
+        if(m_modelData)
         {
-            // Scene from same file already was loaded. use it.
+            // Model from same file already was loaded. use it.
             BR_INFO("Use loaded before animated object: %s", filePath);
-            m_scene = search->second.second;
         }
         else
         {
-            BR_INFO("Load animated object: %s", filePath);
-
-            const std::string path = filePath;
-            const size_t lastDotPos = path.find_last_of('.');
-            BR_ASSERT(lastDotPos != std::string::npos, "%s", "File does not have extension.");
-            const std::string fileExtension = path.substr(lastDotPos + 1);
-            BR_ASSERT((fileExtension == "fbx" || fileExtension == "dae"), "%s", "File extension must be fbx or dae.");
-
-            uint32_t bufferSize = 0;
-            char *buffer = BeryllUtils::File::readToBuffer(filePath, &bufferSize);
-
-            std::shared_ptr<Assimp::Importer> importer = std::make_shared<Assimp::Importer>();
-            const aiScene* scene = nullptr;
-            scene = importer->ReadFileFromMemory(buffer, bufferSize,
-                                                 aiProcess_Triangulate | aiProcess_FlipUVs |
-                                                 aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace,
-                                                 fileExtension.c_str());
-            delete[] buffer;
-            if(!scene || !scene->mRootNode || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE)
-            {
-                 BR_ASSERT(false, "Scene loading error for file: %s", filePath);
-            }
-
-            m_scene = scene;
-            m_importersScenes.emplace(m_modelPath, std::make_pair(importer, scene));
+            m_modelData = loadModelData(m_modelPath);
+            AssetRegistry::add(AssetType::ANIMATED_MODEL, m_modelPath, m_modelData, m_modelData->memorySize);
         }
 
         m_sceneObjectGroup = sceneGroup;
         m_isAnimatedObject = true;
 
-        m_globalInverseMatrix = m_scene->mRootNode->mTransformation;
-        m_globalInverseMatrix.Inverse();
+        // Buffers are shared. Vertex array, shader and material are own for each object.
+        m_vertexPosBuffer = m_modelData->vertexPosBuffer;
+        m_vertexNormalsBuffer = m_modelData->vertexNormalsBuffer;
+        m_textureCoordsBuffer = m_modelData->textureCoordsBuffer;
+        m_boneIDsBuffer = m_modelData->boneIDsBuffer;
+        m_boneWeightsBuffer = m_modelData->boneWeightsBuffer;
+        m_indexBuffer = m_modelData->indexBuffer;
+        m_addToUVCoords = m_modelData->addToUVCoords;
+        m_UVCoordsMultiplier = m_modelData->UVCoordsMultiplier;
+
+        m_vertexArray = Renderer::createVertexArray();
+        m_vertexArray->addVertexBuffer(m_vertexPosBuffer);
+        m_vertexArray->addVertexBuffer(m_vertexNormalsBuffer);
+        m_vertexArray->addVertexBuffer(m_textureCoordsBuffer);
+        m_vertexArray->addVertexBuffer(m_boneIDsBuffer);
+        m_vertexArray->addVertexBuffer(m_boneWeightsBuffer);
+        // Tangents buffer will added if model has normal map.
+        m_vertexArray->setIndexBuffer(m_indexBuffer);
+
+        m_internalShader = Renderer::createShader(BeryllConstants::animatedObjDefaultVertexPath.data(),
+                                                  BeryllConstants::animatedObjDefaultFragmentPath.data());
+        m_internalShader->bind();
+
+        // Load Material 1. At least diffuse texture of material 1 must exist.
+        m_material1 = BeryllUtils::Common::loadMaterial1(m_modelData->diffuseTexturePath,
+                                                         m_modelData->specularTexturePath,
+                                                         m_modelData->normalMapTexturePath);
+
+        m_internalShader->activateDiffuseTextureMat1();
+
+        if(m_material1.specTexture)
+            m_internalShader->activateSpecularTextureMat1();
+
+        if(m_material1.normalMapTexture)
+        {
+            m_internalShader->activateNormalMapTextureMat1();
+
+            m_vertexTangentsBuffer = m_modelData->vertexTangentsBuffer;
+            m_vertexArray->addVertexBuffer(m_vertexTangentsBuffer);
+        }
+
+        if(m_modelData->hasMeshTransforms)
+        {
+            m_totalRotation = m_modelData->meshRotation;
+            m_origin = m_modelData->meshOrigin;
+        }
+
+        m_animStartTimeInSec = std::max(0.0f, TimeStep::getSecFromStart() - (RandomGenerator::getFloat() * 2.0f));
+
+        m_boneFinalMatrices.resize(m_modelData->boneCount, glm::mat4{1.0f});
+        m_nodeGlobalTransforms.resize(m_modelData->skeletonNodes.size());
+        m_nodeLocalTransforms.resize(m_modelData->skeletonNodes.size(), glm::mat4{1.0f});
+    }
+
+    void BaseAnimatedObject::clearCachedModels()
+    {
+        AssetRegistry::purgeUnreferenced(AssetType::ANIMATED_MODEL);
+    }
+
+    std::shared_ptr<const BaseAnimatedObject::AnimatedModelData> BaseAnimatedObject::loadModelData(const std::string& filePath)
+    {
+        BR_INFO("Load animated object: %s", filePath.c_str());
+
+        const size_t lastDotPos = filePath.find_last_of('.');
+        BR_ASSERT(lastDotPos != std::string::npos, "%s", "File does not have extension.");
+        const std::string fileExtension = filePath.substr(lastDotPos + 1);
+        BR_ASSERT((fileExtension == "fbx" || fileExtension == "dae"), "%s", "File extension must be fbx or dae.");
+
+        BeryllUtils::FileView file;
+        const bool opened = file.open(filePath);
+        BR_ASSERT(opened, "File reading error: %s", filePath.c_str());
+
+        // Importer owns aiScene. Both are released when this function returns.
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFileFromMemory(file.getData(), file.getSize(),
+                                                           aiProcess_Triangulate | aiProcess_FlipUVs |
+                                                           aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace,
+                                                           fileExtension.c_str());
+        file.close();
+        if(!scene || !scene->mRootNode || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE)
+        {
+             BR_ASSERT(false, "Scene loading error for file: %s", filePath.c_str());
+        }
+
+        std::shared_ptr<AnimatedModelData> data = std::make_shared<AnimatedModelData>();
+        data->meshCount = scene->mNumMeshes;
 
-        for(int i = 0; i < m_scene->mNumMeshes; ++i)
+        aiMatrix4x4 globalInverseMatrix = scene->mRootNode->mTransformation;
+        globalInverseMatrix.Inverse();
+        data->globalInverseMatrix = BeryllUtils::Matrix::aiToGlm(globalInverseMatrix);
+
+        for(int i = 0; i < scene->mNumMeshes; ++i)
         {
-            std::string meshName = m_scene->mMeshes[i]->mName.C_Str();
+            const aiMesh* mesh = scene->mMeshes[i];
+            std::string meshName = mesh->mName.C_Str();
 
             if(meshName.find("Collision") != std::string::npos)
             {
-                // CollisionMesh will loaded in subclass AnimatedCollidingObject.
+                // Will be added to physics in subclass AnimatedCollidingObject.
+                data->collisionMeshName = meshName;
+                data->collisionVertices.reserve(mesh->mNumVertices);
+                for(int g = 0; g < mesh->mNumVertices; ++g)
+                {
+                    data->collisionVertices.emplace_back(mesh->mVertices[g].x, mesh->mVertices[g].y, mesh->mVertices[g].z);
+                }
+
+                data->collisionIndices.reserve(mesh->mNumFaces * 3);
+                for(int g = 0; g < mesh->mNumFaces; ++g)
+                {
+                    data->collisionIndices.emplace_back(mesh->mFaces[g].mIndices[0]);
+                    data->collisionIndices.emplace_back(mesh->mFaces[g].mIndices[1]);
+                    data->collisionIndices.emplace_back(mesh->mFaces[g].mIndices[2]);
+                }
+
+                const aiNode* node = BeryllUtils::Common::findAinodeForAimesh(scene, scene->mRootNode, mesh->mName);
+                if(node)
+                {
+                    data->collisionTransforms = BeryllUtils::Matrix::aiToGlm(node->mTransformation);
+                }
                 continue;
             }
 
-            BR_ASSERT((m_scene->HasAnimations() && m_scene->mMeshes[i]->mNumBones > 0),
-                      "Colliding animated object must have animation + bone:%s" , m_scene->mMeshes[i]->mName.C_Str());
-
+            BR_ASSERT((scene->HasAnimations() && mesh->mNumBones > 0),
+                      "Colliding animated object must have animation + bone:%s" , mesh->mName.C_Str());
             // Prepare vectors.
             std::vector<glm::vec3> vertices;
             std::vector<glm::vec3> normals;
@@ -76,13 +159,13 @@ namespace Beryll
             std::vector<glm::ivec4> boneIDs;
             std::vector<glm::vec4> boneWeights;
             std::vector<uint32_t> indices;
-            vertices.reserve(m_scene->mMeshes[i]->mNumVertices);
-            normals.reserve(m_scene->mMeshes[i]->mNumVertices);
-            tangents.reserve(m_scene->mMeshes[i]->mNumVertices);
-            textureCoords.reserve(m_scene->mMeshes[i]->mNumVertices);
-            boneIDs.resize(m_scene->mMeshes[i]->mNumVertices, glm::ivec4{-1, -1, -1, -1}); // NUM_BONES_PER_VERTEX
-            boneWeights.resize(m_scene->mMeshes[i]->mNumVertices,glm::vec4{-1.0f, -1.0f, -1.0f, -1.0f}); // NUM_BONES_PER_VERTEX
-            indices.reserve(m_scene->mMeshes[i]->mNumFaces * 3);
+            vertices.reserve(mesh->mNumVertices);
+            normals.reserve(mesh->mNumVertices);
+            tangents.reserve(mesh->mNumVertices);
+            textureCoords.reserve(mesh->mNumVertices);
+            boneIDs.resize(mesh->mNumVertices, glm::ivec4{-1, -1, -1, -1}); // NUM_BONES_PER_VERTEX
+            boneWeights.resize(mesh->mNumVertices,glm::vec4{-1.0f, -1.0f, -1.0f, -1.0f}); // NUM_BONES_PER_VERTEX
+            indices.reserve(mesh->mNumFaces * 3);
 
             float UVSmallestX = std::numeric_limits<float>::max();
             float UVBiggestX = std::numeric_limits<float>::min();
@@ -90,17 +173,17 @@ namespace Beryll
             float UVBiggestY = std::numeric_limits<float>::min();
 
             // Vertices.
-            for(int g = 0; g < m_scene->mMeshes[i]->mNumVertices; ++g)
+            for(int g = 0; g < mesh->mNumVertices; ++g)
             {
-                vertices.emplace_back(m_scene->mMeshes[i]->mVertices[g].x,
-                                      m_scene->mMeshes[i]->mVertices[g].y,
-                                      m_scene->mMeshes[i]->mVertices[g].z);
+                vertices.emplace_back(mesh->mVertices[g].x,
+                                      mesh->mVertices[g].y,
+                                      mesh->mVertices[g].z);
 
-                if(m_scene->mMeshes[i]->mNormals)
+                if(mesh->mNormals)
                 {
-                    glm::vec3 normal = glm::vec3(m_scene->mMeshes[i]->mNormals[g].x,
-                                                 m_scene->mMeshes[i]->mNormals[g].y,
-                                                 m_scene->mMeshes[i]->mNormals[g].z);
+                    glm::vec3 normal = glm::vec3(mesh->mNormals[g].x,
+                                                 mesh->mNormals[g].y,
+                                                 mesh->mNormals[g].z);
 
                     normals.emplace_back(glm::normalize(normal));
                 }
@@ -109,11 +192,11 @@ namespace Beryll
                     normals.emplace_back(0.0f, 0.0f, 0.0f);
                 }
 
-                if(m_scene->mMeshes[i]->mTangents)
+                if(mesh->mTangents)
                 {
-                    glm::vec3 tangent = glm::vec3(m_scene->mMeshes[i]->mTangents[g].x,
-                                                  m_scene->mMeshes[i]->mTangents[g].y,
-                                                  m_scene->mMeshes[i]->mTangents[g].z);
+                    glm::vec3 tangent = glm::vec3(mesh->mTangents[g].x,
+                                                  mesh->mTangents[g].y,
+                                                  mesh->mTangents[g].z);
 
                     tangents.emplace_back(glm::normalize(tangent));
                 }
@@ -123,20 +206,20 @@ namespace Beryll
                 }
 
                 // Use only first set of texture coordinates.
-                if(m_scene->mMeshes[i]->mTextureCoords[0])
+                if(mesh->mTextureCoords[0])
                 {
-                    textureCoords.emplace_back(m_scene->mMeshes[i]->mTextureCoords[0][g].x,
-                                               m_scene->mMeshes[i]->mTextureCoords[0][g].y);
-
-                    if(m_scene->mMeshes[i]->mTextureCoords[0][g].x < UVSmallestX)
-                        UVSmallestX = m_scene->mMeshes[i]->mTextureCoords[0][g].x;
-                    if(m_scene->mMeshes[i]->mTextureCoords[0][g].x > UVBiggestX)
-                        UVBiggestX = m_scene->mMeshes[i]->mTextureCoords[0][g].x;
-
-                    if(m_scene->mMeshes[i]->mTextureCoords[0][g].y < UVSmallestY)
-                        UVSmallestY = m_scene->mMeshes[i]->mTextureCoords[0][g].y;
-                    if(m_scene->mMeshes[i]->mTextureCoords[0][g].y > UVBiggestY)
-                        UVBiggestY = m_scene->mMeshes[i]->mTextureCoords[0][g].y;
+                    textureCoords.emplace_back(mesh->mTextureCoords[0][g].x,
+                                               mesh->mTextureCoords[0][g].y);
+
+                    if(mesh->mTextureCoords[0][g].x < UVSmallestX)
+                        UVSmallestX = mesh->mTextureCoords[0][g].x;
+                    if(mesh->mTextureCoords[0][g].x > UVBiggestX)
+                        UVBiggestX = mesh->mTextureCoords[0][g].x;
+
+                    if(mesh->mTextureCoords[0][g].y < UVSmallestY)
+                        UVSmallestY = mesh->mTextureCoords[0][g].y;
+                    if(mesh->mTextureCoords[0][g].y > UVBiggestY)
+                        UVBiggestY = mesh->mTextureCoords[0][g].y;
                 }
                 else
                 {
@@ -144,52 +227,51 @@ namespace Beryll
                 }
             }
             BR_INFO("Vertex count: %d", vertices.size());
-            m_vertexPosBuffer = Renderer::createStaticVertexBuffer(vertices);
-            m_vertexNormalsBuffer = Renderer::createStaticVertexBuffer(normals);
-            m_textureCoordsBuffer = Renderer::createStaticVertexBuffer(textureCoords);
+            data->vertexPosBuffer = Renderer::createStaticVertexBuffer(vertices);
+            data->vertexNormalsBuffer = Renderer::createStaticVertexBuffer(normals);
+            data->textureCoordsBuffer = Renderer::createStaticVertexBuffer(textureCoords);
             // Tangents buffer will created if model has normal map.
 
             float UVXRange = glm::distance(UVSmallestX, UVBiggestX);
             float UVYRange = glm::distance(UVSmallestY, UVBiggestY);
             if(UVXRange < UVYRange)
             {
-                m_addToUVCoords = std::abs(UVSmallestY);
-                m_UVCoordsMultiplier = 1.0f / UVYRange;
+                data->addToUVCoords = std::abs(UVSmallestY);
+                data->UVCoordsMultiplier = 1.0f / UVYRange;
             }
             else
             {
-                m_addToUVCoords = std::abs(UVSmallestX);
-                m_UVCoordsMultiplier = 1.0f / UVXRange;
+                data->addToUVCoords = std::abs(UVSmallestX);
+                data->UVCoordsMultiplier = 1.0f / UVXRange;
             }
 
             // Bones.
-            m_boneCount = m_scene->mMeshes[i]->mNumBones;
-            m_bonesMatrices.reserve(m_boneCount);
-            m_boneNameIndex.reserve(m_boneCount);
+            data->boneCount = mesh->mNumBones;
+            data->boneOffsetMatrices.reserve(data->boneCount);
+            data->boneNameIndex.reserve(data->boneCount);
 
-            for(int g = 0; g < m_boneCount; ++g)
+            for(int g = 0; g < data->boneCount; ++g)
             {
-                std::string boneName = m_scene->mMeshes[i]->mBones[g]->mName.C_Str();
+                std::string boneName = mesh->mBones[g]->mName.C_Str();
                 BR_ASSERT((boneName.length() > 3 &&
                            boneName[0] == 'B' &&
                            boneName[1] == 'o' &&
                            boneName[2] == 'n' &&
                            boneName[3] == 'e'), "%s", "Bone name must starts with Bone......");
 
-                for(const std::pair<std::string, uint32_t>& element : m_boneNameIndex)
+                for(const std::pair<std::string, uint32_t>& element : data->boneNameIndex)
                 {
-                    BR_ASSERT((element.first != boneName), "Many bones have same name in one model: %s", filePath);
+                    BR_ASSERT((element.first != boneName), "Many bones have same name in one model: %s", filePath.c_str());
                 }
 
-                m_bonesMatrices.emplace_back(); // add empty element to back
-                m_bonesMatrices.back().offsetMatrix = m_scene->mMeshes[i]->mBones[g]->mOffsetMatrix;
-                m_boneNameIndex.emplace_back(boneName, g);
+                data->boneOffsetMatrices.emplace_back(BeryllUtils::Matrix::aiToGlm(mesh->mBones[g]->mOffsetMatrix));
+                data->boneNameIndex.emplace_back(boneName, g);
 
                 // Collect all vertices to which bone has impact.
-                for(int j = 0; j < m_scene->mMeshes[i]->mBones[g]->mNumWeights; ++j)
+                for(int j = 0; j < mesh->mBones[g]->mNumWeights; ++j)
                 {
-                    uint32_t vertexIndex = m_scene->mMeshes[i]->mBones[g]->mWeights[j].mVertexId;
-                    float weight = m_scene->mMeshes[i]->mBones[g]->mWeights[j].mWeight;
+                    uint32_t vertexIndex = mesh->mBones[g]->mWeights[j].mVertexId;
+                    float weight = mesh->mBones[g]->mWeights[j].mWeight;
 
                     if(weight > 0.0f)
                     {
@@ -231,74 +313,92 @@ namespace Beryll
                     }
                 }
             }
-            m_boneIDsBuffer = Renderer::createStaticVertexBuffer(boneIDs);
-            m_boneWeightsBuffer = Renderer::createStaticVertexBuffer(boneWeights);
+            // Bones bounding spheres. Center = center of affected vertices AABB, radius = farthest affected vertex.
+            std::vector<glm::vec3> boneMin(data->boneCount, glm::vec3{std::numeric_limits<float>::max()});
+            std::vector<glm::vec3> boneMax(data->boneCount, glm::vec3{std::numeric_limits<float>::lowest()});
+            for(int g = 0; g < boneIDs.size(); ++g)
+            {
+                for(int k = 0; k < NUM_BONES_PER_VERTEX; ++k)
+                {
+                    if(boneIDs[g][k] == -1 || boneWeights[g][k] <= 0.0f) { continue; }
 
-            // Indices.
-            for(int g = 0; g < m_scene->mMeshes[i]->mNumFaces; ++g) // Every face MUST be a triangle !!!!
+                    boneMin[boneIDs[g][k]] = glm::min(boneMin[boneIDs[g][k]], vertices[g]);
+                    boneMax[boneIDs[g][k]] = glm::max(boneMax[boneIDs[g][k]], vertices[g]);
+                }
+            }
+
+            data->boneBoundingSpheres.resize(data->boneCount, glm::vec4{0.0f, 0.0f, 0.0f, -1.0f});
+            for(int g = 0; g < data->boneCount; ++g)
             {
-                indices.emplace_back(m_scene->mMeshes[i]->mFaces[g].mIndices[0]);
-                indices.emplace_back(m_scene->mMeshes[i]->mFaces[g].mIndices[1]);
-                indices.emplace_back(m_scene->mMeshes[i]->mFaces[g].mIndices[2]);
+                if(boneMin[g].x <= boneMax[g].x)
+                    data->boneBoundingSpheres[g] = glm::vec4((boneMin[g] + boneMax[g]) * 0.5f, 0.0f);
             }
-            BR_INFO("Indices count: %d", indices.size());
-            m_indexBuffer = Renderer::createStaticIndexBuffer(indices);
-
-            m_vertexArray = Renderer::createVertexArray();
-            m_vertexArray->addVertexBuffer(m_vertexPosBuffer);
-            m_vertexArray->addVertexBuffer(m_vertexNormalsBuffer);
-            m_vertexArray->addVertexBuffer(m_textureCoordsBuffer);
-            m_vertexArray->addVertexBuffer(m_boneIDsBuffer);
-            m_vertexArray->addVertexBuffer(m_boneWeightsBuffer);
-            // Tangents buffer will added if model has normal map.
-            m_vertexArray->setIndexBuffer(m_indexBuffer);
-
-            m_internalShader = Renderer::createShader(BeryllConstants::animatedObjDefaultVertexPath.data(),
-                                                      BeryllConstants::animatedObjDefaultFragmentPath.data());
-            m_internalShader->bind();
+            for(int g = 0; g < boneIDs.size(); ++g)
+            {
+                for(int k = 0; k < NUM_BONES_PER_VERTEX; ++k)
+                {
+                    if(boneIDs[g][k] == -1 || boneWeights[g][k] <= 0.0f) { continue; }
+
+                    glm::vec4& sphere = data->boneBoundingSpheres[boneIDs[g][k]];
+                    sphere.w = std::max(sphere.w, glm::distance(glm::vec3(sphere), vertices[g]));
+                }
+            }
+
+            data->boneIDsBuffer = Renderer::createStaticVertexBuffer(boneIDs);
+            data->boneWeightsBuffer = Renderer::createStaticVertexBuffer(boneWeights);
 
-            // Load Material 1. At least diffuse texture of material 1 must exist.
-            if(m_scene->mMeshes[i]->mMaterialIndex >= 0)
+            // Indices.
+            for(int g = 0; g < mesh->mNumFaces; ++g) // Every face MUST be a triangle !!!!
             {
-                m_material1 = BeryllUtils::Common::loadMaterial1(m_scene->mMaterials[m_scene->mMeshes[i]->mMaterialIndex], filePath);
+                indices.emplace_back(mesh->mFaces[g].mIndices[0]);
+                indices.emplace_back(mesh->mFaces[g].mIndices[1]);
+                indices.emplace_back(mesh->mFaces[g].mIndices[2]);
+            }
+            BR_INFO("Indices count: %d", indices.size());
+            const bool indices16 = BeryllUtils::VertexQuantization::getCanUseIndices16(vertices.size());
+            if(indices16)
+                data->indexBuffer = Renderer::createStaticIndexBuffer(BeryllUtils::VertexQuantization::encodeIndices16(indices.data(), indices.size()));
+            else
+                data->indexBuffer = Renderer::createStaticIndexBuffer(indices);
 
-                m_internalShader->activateDiffuseTextureMat1();
+            data->memorySize += vertices.size() * (sizeof(glm::vec3) * 2 + sizeof(glm::vec2) + sizeof(glm::ivec4) + sizeof(glm::vec4)) +
+                                indices.size() * (indices16 ? sizeof(uint16_t) : sizeof(uint32_t));
 
-                if(m_material1.specTexture)
-                    m_internalShader->activateSpecularTextureMat1();
+            // Material 1 textures. Loaded for each object.
+            if(mesh->mMaterialIndex >= 0)
+            {
+                const aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+                data->diffuseTexturePath = BeryllUtils::Common::getMaterialTexturePath(material, aiTextureType_DIFFUSE, filePath);
+                data->specularTexturePath = BeryllUtils::Common::getMaterialTexturePath(material, aiTextureType_SPECULAR, filePath);
+                data->normalMapTexturePath = BeryllUtils::Common::getMaterialTexturePath(material, aiTextureType_NORMALS, filePath);
 
-                if(m_material1.normalMapTexture)
+                if(!data->normalMapTexturePath.empty())
                 {
-                    m_internalShader->activateNormalMapTextureMat1();
-
                     BR_INFO("%s", "Create tangents buffer because model has normal map.");
-                    m_vertexTangentsBuffer = Renderer::createStaticVertexBuffer(tangents);
-
-                    m_vertexArray->addVertexBuffer(m_vertexTangentsBuffer);
+                    data->vertexTangentsBuffer = Renderer::createStaticVertexBuffer(tangents);
+                    data->memorySize += tangents.size() * sizeof(glm::vec3);
                 }
             }
 
             // Animations.
-            for(int g = 0; g < m_scene->mNumAnimations; ++g)
+            for(int g = 0; g < scene->mNumAnimations; ++g)
             {
-                std::string animName = m_scene->mAnimations[g]->mName.C_Str();
+                std::string animName = scene->mAnimations[g]->mName.C_Str();
                 std::string::size_type startNameIndex = animName.find_last_of('|');
                 if(startNameIndex != std::string::npos)
                 {
                     animName = animName.substr(startNameIndex + 1);
                 }
 
-                m_animationNameIndex.emplace_back(animName, g);
-                BR_INFO("Animation index: %d Name: %s Duration: %f", g, animName.c_str(), m_scene->mAnimations[g]->mDuration);
+                data->animationNameIndex.emplace_back(animName, g);
+                BR_INFO("Animation index: %d Name: %s Duration: %f", g, animName.c_str(), scene->mAnimations[g]->mDuration);
             }
 
-            m_animStartTimeInSec = std::max(0.0f, TimeStep::getSecFromStart() - (RandomGenerator::getFloat() * 2.0f));
-
-            m_ticksPerSecond = static_cast<float>(m_scene->mAnimations[0]->mTicksPerSecond);
-            if(m_ticksPerSecond == 0.0f)
-                m_ticksPerSecond = 24.0f;
+            data->ticksPerSecond = static_cast<float>(scene->mAnimations[0]->mTicksPerSecond);
+            if(data->ticksPerSecond == 0.0f)
+                data->ticksPerSecond = 24.0f;
 
-            const aiNode *node = BeryllUtils::Common::findAinodeForAimesh(m_scene, m_scene->mRootNode, m_scene->mMeshes[i]->mName);
+            const aiNode *node = BeryllUtils::Common::findAinodeForAimesh(scene, scene->mRootNode, mesh->mName);
             if(node)
             {
                 glm::mat4 modelMatrix = BeryllUtils::Matrix::aiToGlm(node->mTransformation);
@@ -308,14 +408,37 @@ namespace Beryll
                            scale.y > 0.9999f && scale.y < 1.0001f &&
                            scale.z > 0.9999f && scale.z < 1.0001f), "%s", "Scale should be baked to 1 in modeling tool.");
 
-                m_totalRotation = BeryllUtils::Matrix::getRotationFrom4x4Glm(modelMatrix);
-                m_origin = BeryllUtils::Matrix::getTranslationFrom4x4Glm(modelMatrix);
+                data->hasMeshTransforms = true;
+                data->meshRotation = BeryllUtils::Matrix::getRotationFrom4x4Glm(modelMatrix);
+                data->meshOrigin = BeryllUtils::Matrix::getTranslationFrom4x4Glm(modelMatrix);
             }
         }
+
+        // Runtime data is resolved by node index. Names are needed only for baking.
+        std::vector<std::string> nodeNames;
+        data->boneNodeIndices.resize(data->boneCount, -1);
+        flattenNodeHierarchy(scene->mRootNode, -1, *data, nodeNames);
+        for(int i = 0; i < data->boneCount; ++i)
+        {
+            BR_ASSERT((data->boneNodeIndices[i] != -1), "Bone does not have node in hierarchy: %s", data->boneNameIndex[i].first.c_str());
+        }
+
+        data->animationClips.reserve(scene->mNumAnimations);
+        for(int i = 0; i < scene->mNumAnimations; ++i)
+        {
+            data->animationClips.emplace_back(scene->mAnimations[i], nodeNames, data->ticksPerSecond);
+            data->memorySize += data->animationClips.back().getMemorySize();
+        }
+
+        data->memorySize += data->collisionVertices.size() * sizeof(glm::vec3) + data->collisionIndices.size() * sizeof(uint32_t) +
+                            data->skeletonNodes.size() * sizeof(SkeletonNode) + data->boneOffsetMatrices.size() * sizeof(glm::mat4);
+
+        return data;
     }
 
     BaseAnimatedObject::~BaseAnimatedObject()
     {
+        AnimationSystem::removeFromUpdate(this);
         disableForEver();
     }
 
@@ -334,10 +457,10 @@ namespace Beryll
             m_origin = m_physicsTransforms.origin;
         }
 
-        // Should be here. Can be called in multi threading way. draw() will be called in single thread.
+        // Transforms are calculated for all collected objects in parallel before draw.
         if(getIsEnabledDraw())
         {
-            calculateTransforms();
+            AnimationSystem::addToUpdate(this);
         }
     }
 
@@ -347,14 +470,7 @@ namespace Beryll
         {
             m_internalShader->bind();
             m_internalShader->setMatrix4x4Float("MVPMatrix", Camera::getViewProjection() * getModelMatrix());
-
-            for(int i = 0; i < m_boneCount; ++i)
-            {
-                m_boneMatrixNameInShader = "bonesMatrices[";
-                m_boneMatrixNameInShader += std::to_string(i);
-                m_boneMatrixNameInShader += "]";
-                m_internalShader->setMatrix4x4Float(m_boneMatrixNameInShader.c_str(), m_bonesMatrices[i].finalWorldTransform);
-            }
+            m_internalShader->setMatrix4x4FloatArray("bonesMatrices", m_boneFinalMatrices.data(), m_modelData->boneCount);
 
             if(m_material2) // If material 2 exist we need that to return UV into 0...1 range for blend texture.
             {
@@ -375,10 +491,10 @@ namespace Beryll
         m_vertexArray->draw();
     }
     
-    void BaseAnimatedObject::calculateTransforms()
+    void BaseAnimatedObject::updateSamplePosition()
     {
-        float timeInTicks = (TimeStep::getSecFromStart() - m_animStartTimeInSec) * m_ticksPerSecond;
-        float animTime = std::fmodf(timeInTicks, static_cast<float>(m_scene->mAnimations[m_currentAnimIndex]->mDuration));
+        float timeInTicks = (TimeStep::getSecFromStart() - m_animStartTimeInSec) * m_modelData->ticksPerSecond;
+        float animTime = std::fmodf(timeInTicks, m_modelData->animationClips[m_currentAnimIndex].getDuration());
 
         if(m_playAnimOneTime)
         {
@@ -387,221 +503,226 @@ namespace Beryll
                 m_playAnimOneTime = false;
                 // Prepare default animation.
                 m_currentAnimIndex = m_defaultAnimIndex;
+                m_isPoseCalculated = false; // Sample all nodes of new animation.
                 m_animStartTimeInSec = TimeStep::getSecFromStart();
                 timeInTicks = 0.0f;
                 animTime = 0.0f;
             }
         }
 
-        aiMatrix4x4 identity;
-        readNodeHierarchy(animTime, m_scene->mRootNode, identity);
+        m_modelData->animationClips[m_currentAnimIndex].getSamplePosition(animTime, m_poseSampleIndex, m_poseBlend);
     }
 
-    void BaseAnimatedObject::readNodeHierarchy(const float animationTime, const aiNode* node, const aiMatrix4x4& parentTransform)
+    void BaseAnimatedObject::calculateTransforms(const int maxSampledNodeDepth)
     {
-        aiMatrix4x4 nodeTransform; // identity
+        const AnimationClip& clip = m_modelData->animationClips[m_currentAnimIndex];
 
-        const aiNodeAnim* nodeAnim = findNodeAnimByName(m_scene->mAnimations[m_currentAnimIndex], node->mName);
-
-        if(nodeAnim)
+        // Parent is always before child so its global transform is ready.
+        for(int i = 0; i < m_modelData->skeletonNodes.size(); ++i)
         {
-            BR_ASSERT((nodeAnim->mNumScalingKeys == nodeAnim->mNumPositionKeys), "%s", "mNumScalingKeys != mNumPositionKeys");
-            BR_ASSERT((nodeAnim->mNumScalingKeys == nodeAnim->mNumRotationKeys), "%s", "mNumScalingKeys != mNumRotationKeys");
+            const SkeletonNode& node = m_modelData->skeletonNodes[i];
 
-            uint32_t currentFrameIndex = 0;
-            for(int i = nodeAnim->mNumPositionKeys - 1; i >= 0; --i)
-            {
-                if(animationTime > nodeAnim->mPositionKeys[i].mTime || i == 0)
-                {
-                    currentFrameIndex = i;
-                    break;
-                }
-            }
-
-            uint32_t nextFrameIndex = currentFrameIndex + 1;
-            if(nextFrameIndex >= nodeAnim->mNumPositionKeys)
-                nextFrameIndex = 0; // Last frame was played, jump to first again.
+            if(node.depth <= maxSampledNodeDepth || !m_isPoseCalculated)
+                m_nodeLocalTransforms[i] = clip.sampleNode(i, m_poseSampleIndex, m_poseBlend);
 
-            float currentFrameStartTime = static_cast<float>(nodeAnim->mPositionKeys[currentFrameIndex].mTime);
-            float currentFrameEndTime = static_cast<float>(nodeAnim->mPositionKeys[nextFrameIndex].mTime);
-            if(currentFrameStartTime > currentFrameEndTime)
-                currentFrameEndTime = static_cast<float>(m_scene->mAnimations[m_currentAnimIndex]->mDuration);
+            if(node.parentIndex == -1)
+                m_nodeGlobalTransforms[i] = m_nodeLocalTransforms[i];
+            else
+                m_nodeGlobalTransforms[i] = m_nodeGlobalTransforms[node.parentIndex] * m_nodeLocalTransforms[i];
 
-            BR_ASSERT((animationTime >= currentFrameStartTime && animationTime <= currentFrameEndTime),
-                      "animationTime must be between currentFrameStartTime and currentFrameEndTime animationTime: %f, currentFrameStartTime: %f, currentFrameEndTime: %f",
-                      animationTime, currentFrameStartTime, currentFrameEndTime);
+            if(node.boneIndex != -1)
+                m_boneFinalMatrices[node.boneIndex] = m_modelData->globalInverseMatrix * m_nodeGlobalTransforms[i] * m_modelData->boneOffsetMatrices[node.boneIndex];
+        }
 
-            float deltaTime = currentFrameEndTime - currentFrameStartTime;
-            // factor = how much time passed between current and next frame in range 0...1
-            float factor = (animationTime - static_cast<float>(nodeAnim->mPositionKeys[currentFrameIndex].mTime)) / deltaTime;
+        m_isPoseCalculated = true;
+        calculateBounds();
+    }
 
-            aiMatrix4x4 scalingMatr = interpolateScaling(nodeAnim, currentFrameIndex, nextFrameIndex, factor);
-            aiMatrix4x4 rotationMatr = interpolateRotation(nodeAnim, currentFrameIndex, nextFrameIndex, factor);
-            aiMatrix4x4 translationMatr = interpolatePosition(nodeAnim, currentFrameIndex, nextFrameIndex, factor);
+    void BaseAnimatedObject::calculateBounds()
+    {
+        glm::vec3 boundsMin{std::numeric_limits<float>::max()};
+        glm::vec3 boundsMax{std::numeric_limits<float>::lowest()};
 
-            nodeTransform = translationMatr * rotationMatr * scalingMatr;
-        }
+        // One pass over contiguous arrays. Vertex affected by many bones lies between their transformed positions
+        // so union of bones spheres covers skinned mesh.
+        const std::vector<glm::vec4>& spheres = m_modelData->boneBoundingSpheres;
+        for(int i = 0; i < spheres.size(); ++i)
+        {
+            if(spheres[i].w < 0.0f) { continue; }
 
-        aiMatrix4x4 globalTransform = parentTransform * nodeTransform;
+            const glm::mat4& m = m_boneFinalMatrices[i];
+            const glm::vec3 center = glm::vec3(m * glm::vec4(spheres[i].x, spheres[i].y, spheres[i].z, 1.0f));
+            // Bone can be scaled by animation. Take biggest axis scale.
+            const float maxScaleSquared = std::max(glm::dot(glm::vec3(m[0]), glm::vec3(m[0])),
+                                                   std::max(glm::dot(glm::vec3(m[1]), glm::vec3(m[1])), glm::dot(glm::vec3(m[2]), glm::vec3(m[2]))));
+            const float radius = spheres[i].w * std::sqrt(maxScaleSquared);
 
-        // node_name = bone_name = animation->chanel->node_name(nodeAnim contains node_name of affected node)
-        for(const std::pair<std::string, uint32_t>& element : m_boneNameIndex)
-        {
-            if(element.first == node->mName.C_Str())
-            {
-                // element.second = boneIndex
-                m_bonesMatrices[element.second].finalWorldTransform = m_globalInverseMatrix * globalTransform * m_bonesMatrices[element.second].offsetMatrix;
-                break;
-            }
+            boundsMin = glm::min(boundsMin, center - radius);
+            boundsMax = glm::max(boundsMax, center + radius);
         }
 
-        for(int i = 0; i < node->mNumChildren; ++i)
+        m_hasBounds = boundsMin.x <= boundsMax.x;
+        if(m_hasBounds)
         {
-            readNodeHierarchy(animationTime, node->mChildren[i], globalTransform);
+            m_boundsMin = boundsMin;
+            m_boundsMax = boundsMax;
         }
     }
 
-    const aiNodeAnim* BaseAnimatedObject::findNodeAnimByName(const aiAnimation* animation, const aiString& nodeName)
+    void BaseAnimatedObject::getBoundingBox(glm::vec3& worldMin, glm::vec3& worldMax) const
     {
-        // channel in animation it is aiNodeAnim (aiNodeAnim has transformation for node/bone with same name)
-        // contains 3 arrays (scale/rotations/translations) for transform one node/bone in all frames
-        // sequential frame number is index for these arrays
-        // nodeAnim->mScalingKeys[0].mValue = scaling transform for frame 0 for node/bone named same as nodeAnim->mNodeName
-        // numChannels == numBones
-
-        if(nodeName.length < 4 || // use only aiNodeAnim which belong to bones
-           nodeName.data[0] != 'B' || // Bones names must starts with Bone.......
-           nodeName.data[1] != 'o' ||
-           nodeName.data[2] != 'n' ||
-           nodeName.data[3] != 'e')
-        {
-            return nullptr;
-        }
+        // Transform center and extents instead of 8 corners.
+        const glm::mat4 modelMatrix = getModelMatrix();
+        const glm::vec3 center = glm::vec3(modelMatrix * glm::vec4((m_boundsMin + m_boundsMax) * 0.5f, 1.0f));
+        const glm::vec3 extents = (m_boundsMax - m_boundsMin) * 0.5f;
+        const glm::mat3 absRotation{glm::abs(glm::vec3(modelMatrix[0])), glm::abs(glm::vec3(modelMatrix[1])), glm::abs(glm::vec3(modelMatrix[2]))};
+        const glm::vec3 worldExtents = absRotation * extents;
+
+        worldMin = center - worldExtents;
+        worldMax = center + worldExtents;
+    }
 
-        for(int i = 0; i < animation->mNumChannels; ++i)
-        {
-            const aiNodeAnim* nodeAnim = animation->mChannels[i];
-            if(nodeAnim->mNodeName == nodeName)
-            {
-                return nodeAnim;
-            }
-        }
+    void BaseAnimatedObject::getBoundingSphere(glm::vec3& worldCenter, float& radius) const
+    {
+        glm::vec3 worldMin;
+        glm::vec3 worldMax;
+        getBoundingBox(worldMin, worldMax);
 
-        return nullptr;
+        worldCenter = (worldMin + worldMax) * 0.5f;
+        radius = glm::distance(worldMin, worldMax) * 0.5f;
     }
 
-    const aiNodeAnim* BaseAnimatedObject::findNodeAnimAny(const aiAnimation* animation)
+    bool BaseAnimatedObject::getIsSeenByCamera() const
     {
-        for(int i = 0; i < animation->mNumChannels; ++i)
-        {
-            const aiNodeAnim* nodeAnim = animation->mChannels[i];
-
-            if(nodeAnim->mNodeName.data[0] == 'B' &&
-               nodeAnim->mNodeName.data[1] == 'o' &&
-               nodeAnim->mNodeName.data[2] == 'n' &&
-               nodeAnim->mNodeName.data[3] == 'e')
-            {
-                return nodeAnim;
-            }
-        }
+        if(!m_hasBounds)
+            return Camera::getIsSeeObject(m_origin, 1.2f);
 
-        return nullptr;
+        glm::vec3 center;
+        float radius = 0.0f;
+        getBoundingSphere(center, radius);
+        return Camera::getIsSeeSphere(center, radius);
     }
 
-    aiMatrix4x4 BaseAnimatedObject::interpolatePosition(const aiNodeAnim* nodeAnim, const uint32_t currentFrameIndex, const uint32_t nextFrameIndex, const float factor)
+    void BaseAnimatedObject::copyTransformsFrom(const BaseAnimatedObject* other)
     {
-        aiMatrix4x4 posMatr;
+        BR_ASSERT((m_modelData == other->m_modelData), "%s", "Pose can be copied only from object loaded from same file.");
 
-        if(nodeAnim->mNumPositionKeys == 1)
-        {
-            aiMatrix4x4::Translation(nodeAnim->mPositionKeys[0].mValue, posMatr);
-            return posMatr;
-        }
+        std::copy(other->m_nodeLocalTransforms.begin(), other->m_nodeLocalTransforms.end(), m_nodeLocalTransforms.begin());
+        std::copy(other->m_nodeGlobalTransforms.begin(), other->m_nodeGlobalTransforms.end(), m_nodeGlobalTransforms.begin());
+        std::copy(other->m_boneFinalMatrices.begin(), other->m_boneFinalMatrices.end(), m_boneFinalMatrices.begin());
+        m_boundsMin = other->m_boundsMin;
+        m_boundsMax = other->m_boundsMax;
+        m_hasBounds = other->m_hasBounds;
 
-        if(nodeAnim->mPositionKeys[currentFrameIndex].mValue == nodeAnim->mPositionKeys[nextFrameIndex].mValue)
+        m_isPoseCalculated = true;
+    }
+
+    int BaseAnimatedObject::getBoneIndex(const std::string& boneName) const
+    {
+        for(const std::pair<std::string, uint32_t>& element : m_modelData->boneNameIndex)
         {
-            // Dont need interpolate.
-            aiMatrix4x4::Translation(nodeAnim->mPositionKeys[currentFrameIndex].mValue, posMatr);
-            return posMatr;
+            if(element.first == boneName)
+                return static_cast<int>(element.second);
         }
 
-        const aiVector3D& start = nodeAnim->mPositionKeys[currentFrameIndex].mValue;
-        const aiVector3D& end = nodeAnim->mPositionKeys[nextFrameIndex].mValue;
-        const aiVector3D deltaVector = end - start;
+        return -1;
+    }
 
-        aiMatrix4x4::Translation(start + deltaVector * factor, posMatr);
-        return posMatr;
+    glm::mat4 BaseAnimatedObject::getBoneWorldMatrix(const int boneIndex) const
+    {
+        BR_ASSERT((boneIndex >= 0 && boneIndex < m_modelData->boneCount), "Wrong bone index: %d", boneIndex);
+
+        // Node global transform already calculated for pose. No hierarchy walk here.
+        return getModelMatrix() * m_modelData->globalInverseMatrix * m_nodeGlobalTransforms[m_modelData->boneNodeIndices[boneIndex]];
     }
 
-    aiMatrix4x4 BaseAnimatedObject::interpolateRotation(const aiNodeAnim* nodeAnim, const uint32_t currentFrameIndex, const uint32_t nextFrameIndex, const float factor)
+    void BaseAnimatedObject::attachObject(const std::shared_ptr<SceneObject>& obj, const int boneIndex,
+                                          const glm::vec3& offsetPosition, const glm::quat& offsetRotation)
     {
-        if(nodeAnim->mNumRotationKeys == 1)
-            return aiMatrix4x4(nodeAnim->mRotationKeys[0].mValue.GetMatrix());
+        BR_ASSERT((obj && obj.get() != this), "%s", "Can not attach nullptr or object to itself.");
+        BR_ASSERT((boneIndex >= 0 && boneIndex < m_modelData->boneCount), "Wrong bone index: %d", boneIndex);
 
-        if(nodeAnim->mRotationKeys[currentFrameIndex].mValue == nodeAnim->mRotationKeys[nextFrameIndex].mValue)
-        {
-            // Dont need interpolate.
-            return aiMatrix4x4(nodeAnim->mRotationKeys[currentFrameIndex].mValue.GetMatrix());
-        }
+        detachObject(obj);
 
-        const aiQuaternion& start = nodeAnim->mRotationKeys[currentFrameIndex].mValue;
-        const aiQuaternion& end = nodeAnim->mRotationKeys[nextFrameIndex].mValue;
+        Attachment attachment;
+        attachment.object = obj;
+        attachment.boneIndex = boneIndex;
+        attachment.offset = glm::translate(glm::mat4{1.0f}, offsetPosition) * glm::toMat4(glm::normalize(offsetRotation));
+        m_attachments.push_back(std::move(attachment));
+    }
 
-        BR_ASSERT((((start.x * start.x + start.y * start.y + start.z * start.z + start.w * start.w) > 0.9999f) &&
-                   ((start.x * start.x + start.y * start.y + start.z * start.z + start.w * start.w) < 1.0001f)), "%s", "start quaternion must be unit");
-        BR_ASSERT((((end.x * end.x + end.y * end.y + end.z * end.z + end.w * end.w) > 0.9999f) &&
-                   ((end.x * end.x + end.y * end.y + end.z * end.z + end.w * end.w) < 1.0001f)), "%s", "end quaternion must be unit");
-        return aiMatrix4x4(BeryllUtils::Quaternion::nlerp(start, end, factor).GetMatrix());
+    void BaseAnimatedObject::detachObject(const std::shared_ptr<SceneObject>& obj)
+    {
+        m_attachments.erase(std::remove_if(m_attachments.begin(), m_attachments.end(),
+                                           [&obj](const Attachment& att) { return att.object == obj; }),
+                            m_attachments.end());
     }
 
-    aiMatrix4x4 BaseAnimatedObject::interpolateScaling(const aiNodeAnim* nodeAnim, const uint32_t currentFrameIndex, const uint32_t nextFrameIndex, const float factor)
+    void BaseAnimatedObject::updateAttachments()
     {
-        aiMatrix4x4 scaleMatrix;
+        // Same for all attachments of this object.
+        const glm::mat4 modelMatrix = getModelMatrix() * m_modelData->globalInverseMatrix;
 
-        if(nodeAnim->mNumScalingKeys == 1)
+        for(const Attachment& att : m_attachments)
         {
-            aiMatrix4x4::Scaling(nodeAnim->mScalingKeys[0].mValue, scaleMatrix);
-            return scaleMatrix;
+            const glm::mat4 world = modelMatrix * m_nodeGlobalTransforms[m_modelData->boneNodeIndices[att.boneIndex]] * att.offset;
+
+            att.object->setOrigin(BeryllUtils::Matrix::getTranslationFrom4x4Glm(world));
+            const glm::quat rotation = BeryllUtils::Matrix::getRotationFrom4x4Glm(world);
+            att.object->addToRotation(rotation * glm::inverse(att.object->getTotalRotation()));
         }
+    }
+
+    void BaseAnimatedObject::flattenNodeHierarchy(const aiNode* node, const int parentIndex, AnimatedModelData& data, std::vector<std::string>& nodeNames)
+    {
+        // Called once at load. Recursion here is fine.
+        const int nodeIndex = static_cast<int>(data.skeletonNodes.size());
+        data.skeletonNodes.emplace_back();
+        data.skeletonNodes.back().parentIndex = parentIndex;
+        if(parentIndex != -1)
+            data.skeletonNodes.back().depth = data.skeletonNodes[parentIndex].depth + 1;
 
-        if(nodeAnim->mScalingKeys[currentFrameIndex].mValue == nodeAnim->mScalingKeys[nextFrameIndex].mValue)
+        // node_name = bone_name = animation->chanel->node_name(nodeAnim contains node_name of affected node)
+        for(const std::pair<std::string, uint32_t>& element : data.boneNameIndex)
         {
-            // Dont need interpolate.
-            aiMatrix4x4::Scaling(nodeAnim->mScalingKeys[currentFrameIndex].mValue, scaleMatrix);
-            return scaleMatrix;
+            if(element.first == node->mName.C_Str())
+            {
+                data.skeletonNodes.back().boneIndex = static_cast<int>(element.second);
+                data.boneNodeIndices[element.second] = nodeIndex;
+                break;
+            }
         }
 
-        const aiVector3D& start = nodeAnim->mScalingKeys[currentFrameIndex].mValue;
-        const aiVector3D& end = nodeAnim->mScalingKeys[nextFrameIndex].mValue;
-        aiVector3D deltaVector = end - start;
+        nodeNames.emplace_back(node->mName.C_Str());
 
-        aiMatrix4x4::Scaling(start + deltaVector * factor, scaleMatrix);
-        return scaleMatrix;
+        for(int i = 0; i < node->mNumChildren; ++i)
+        {
+            flattenNodeHierarchy(node->mChildren[i], nodeIndex, data, nodeNames);
+        }
     }
 
     void BaseAnimatedObject::setCurrentAnimationByName(const char* name, bool playOneTime, bool startEvenIfSameAnimPlaying, bool randomizeAnimStartTime)
     {
         if(m_currentAnimName == name && !startEvenIfSameAnimPlaying) { return; }
 
-        for(const std::pair<std::string, int>& anim : m_animationNameIndex)
+        for(const std::pair<std::string, int>& anim : m_modelData->animationNameIndex)
         {
             if(anim.first == name)
             {
                 m_currentAnimIndex = anim.second;
                 m_currentAnimName = name;
+                m_isPoseCalculated = false;
                 m_playAnimOneTime = playOneTime;
                 if(m_playAnimOneTime)
                 {
-                    const aiNodeAnim* nodeAnim = findNodeAnimAny(m_scene->mAnimations[m_currentAnimIndex]);
-                    BR_ASSERT((nodeAnim != nullptr), "%s", "Can not find any node anim.");
-                    BR_ASSERT((nodeAnim->mNumPositionKeys  > 0), "%s", "Node anim does not have keys.");
-                    m_animOneTimeLastFrameTime = nodeAnim->mPositionKeys[nodeAnim->mNumPositionKeys - 1].mTime;
+                    m_animOneTimeLastFrameTime = m_modelData->animationClips[m_currentAnimIndex].getLastKeyTime();
+                    BR_ASSERT((m_animOneTimeLastFrameTime >= 0.0f), "%s", "Can not find any node anim with keys.");
                 }
                 m_animStartTimeInSec = TimeStep::getSecFromStart();
                 if(randomizeAnimStartTime)
                     m_animStartTimeInSec = std::max(0.0f, TimeStep::getSecFromStart() - (RandomGenerator::getFloat() * 2.0f));
 
-                m_animTimeInSec = static_cast<float>(m_scene->mAnimations[m_currentAnimIndex]->mDuration) / m_ticksPerSecond;
+                m_animTimeInSec = m_modelData->animationClips[m_currentAnimIndex].getDuration() / m_modelData->ticksPerSecond;
                 return;
             }
         }
@@ -611,32 +732,31 @@ namespace Beryll
 
     void BaseAnimatedObject::setCurrentAnimationByIndex(int index, bool playOneTime, bool startEvenIfSameAnimPlaying, bool randomizeAnimStartTime)
     {
-        BR_ASSERT((index >= 0 && index < m_animationNameIndex.size()), "Animation with index does not exists: %d", index);
+        BR_ASSERT((index >= 0 && index < m_modelData->animationNameIndex.size()), "Animation with index does not exists: %d", index);
 
         if(m_currentAnimIndex == index && !startEvenIfSameAnimPlaying) { return; }
 
-        if(index >= 0 && index < m_animationNameIndex.size())
+        if(index >= 0 && index < m_modelData->animationNameIndex.size())
         {
             m_currentAnimIndex = index;
+            m_isPoseCalculated = false;
             m_playAnimOneTime = playOneTime;
             if(m_playAnimOneTime)
             {
-                const aiNodeAnim* nodeAnim = findNodeAnimAny(m_scene->mAnimations[m_currentAnimIndex]);
-                BR_ASSERT((nodeAnim != nullptr), "%s", "Can not find any node anim.");
-                BR_ASSERT((nodeAnim->mNumPositionKeys  > 0), "%s", "Node anim does not have keys.");
-                m_animOneTimeLastFrameTime = nodeAnim->mPositionKeys[nodeAnim->mNumPositionKeys - 1].mTime;
+                m_animOneTimeLastFrameTime = m_modelData->animationClips[m_currentAnimIndex].getLastKeyTime();
+                BR_ASSERT((m_animOneTimeLastFrameTime >= 0.0f), "%s", "Can not find any node anim with keys.");
             }
             m_animStartTimeInSec = TimeStep::getSecFromStart();
             if(randomizeAnimStartTime)
                 m_animStartTimeInSec = std::max(0.0f, TimeStep::getSecFromStart() - (RandomGenerator::getFloat() * 2.0f));
 
-            m_animTimeInSec = static_cast<float>(m_scene->mAnimations[m_currentAnimIndex]->mDuration) / m_ticksPerSecond;
+            m_animTimeInSec = m_modelData->animationClips[m_currentAnimIndex].getDuration() / m_modelData->ticksPerSecond;
         }
     }
 
     void BaseAnimatedObject::setDefaultAnimationByName(const char* name)
     {
-        for(const std::pair<std::string, int>& anim : m_animationNameIndex)
+        for(const std::pair<std::string, int>& anim : m_modelData->animationNameIndex)
         {
             if(anim.first == name)
             {
@@ -650,9 +770,9 @@ namespace Beryll
 
     void BaseAnimatedObject::setDefaultAnimationByIndex(int index)
     {
-        BR_ASSERT((index >= 0 && index < m_animationNameIndex.size()), "Animation with index does not exists: %d", index);
+        BR_ASSERT((index >= 0 && index < m_modelData->animationNameIndex.size()), "Animation with index does not exists: %d", index);
 
-        if(index >= 0 && index < m_animationNameIndex.size())
+        if(index >= 0 && index < m_modelData->animationNameIndex.size())
         {
             m_defaultAnimIndex = index;
         }
@@ -1,16 +1,65 @@
 #pragma once
 
 #include "SceneObject.h"
+#include "beryll/animation/AnimationClip.h"
 
 namespace Beryll
 {
     class BaseAnimatedObject : public SceneObject
     {
     protected:
-        struct BoneMatrix // store loaded transforms for bone and final transform after frame interpolation
+        struct SkeletonNode // aiNode tree flattened in topological order (parent always before child)
         {
-            aiMatrix4x4 offsetMatrix{};
-            aiMatrix4x4 finalWorldTransform{};
+            int parentIndex = -1; // -1 for root
+            int boneIndex = -1; // Index in m_boneFinalMatrices or -1 if node is not bone
+            int depth = 0; // 0 for root
+        };
+
+        // Everything animated object needs after loading. Extracted from aiScene once per file.
+        // aiScene + Assimp::Importer are released right after extraction.
+        // Shared (read only) between all objects loaded from same file.
+        struct AnimatedModelData
+        {
+            uint32_t meshCount = 0; // Including collision mesh.
+
+            // Graphics. Vertex array and shader are created per object.
+            std::shared_ptr<VertexBuffer> vertexPosBuffer;
+            std::shared_ptr<VertexBuffer> vertexNormalsBuffer;
+            std::shared_ptr<VertexBuffer> vertexTangentsBuffer; // nullptr if model does not have normal map.
+            std::shared_ptr<VertexBuffer> textureCoordsBuffer;
+            std::shared_ptr<VertexBuffer> boneIDsBuffer;
+            std::shared_ptr<VertexBuffer> boneWeightsBuffer;
+            std::shared_ptr<IndexBuffer> indexBuffer;
+            std::string diffuseTexturePath;
+            std::string specularTexturePath; // Can be empty.
+            std::string normalMapTexturePath; // Can be empty.
+            float addToUVCoords = 0.0f;
+            float UVCoordsMultiplier = 1.0f;
+            bool hasMeshTransforms = false;
+            glm::quat meshRotation{1.0f, 0.0f, 0.0f, 0.0f};
+            glm::vec3 meshOrigin{0.0f};
+
+            // Animation.
+            uint32_t boneCount = 0;
+            std::vector<std::pair<std::string, uint32_t>> boneNameIndex;
+            std::vector<glm::mat4> boneOffsetMatrices; // Inverse bind pose.
+            std::vector<int> boneNodeIndices; // [bone index] = index in skeletonNodes.
+            // Sphere around vertices affected by bone. xyz = center in mesh space (bind pose), w = radius.
+            // w < 0 if bone does not affect any vertex.
+            std::vector<glm::vec4> boneBoundingSpheres;
+            std::vector<SkeletonNode> skeletonNodes;
+            std::vector<std::pair<std::string, int>> animationNameIndex;
+            std::vector<AnimationClip> animationClips; // Same indices as animationNameIndex.
+            glm::mat4 globalInverseMatrix{1.0f};
+            float ticksPerSecond = 24.0f;
+
+            // Mesh with "Collision" in name. Empty if model does not have it.
+            std::string collisionMeshName;
+            std::vector<glm::vec3> collisionVertices;
+            std::vector<uint32_t> collisionIndices;
+            glm::mat4 collisionTransforms{1.0f};
+
+            uint64_t memorySize = 0; // Approximate. GPU buffers + animation data. For AssetRegistry.
         };
 
     public:
@@ -21,8 +70,8 @@ namespace Beryll
         void updateAfterPhysics() override;
         void draw() override;
 
-        uint32_t getBoneCount() { return m_boneCount; }
-        const std::vector<BoneMatrix>& getBoneMatrices() { return m_bonesMatrices; }
+        uint32_t getBoneCount() { return m_modelData->boneCount; }
+        const std::vector<glm::mat4>& getBoneMatrices() { return m_boneFinalMatrices; } // Contiguous. Ready after AnimationSystem update.
         bool getIsOneTimeAnimationFinished() { return !m_playAnimOneTime; }
 
         void setCurrentAnimationByName(const char* name, bool playOneTime, bool startEvenIfSameAnimPlaying, bool randomizeAnimStartTime = false);
@@ -30,50 +79,90 @@ namespace Beryll
         void setDefaultAnimationByName(const char* name);
         void setDefaultAnimationByIndex(int index);
 
+        // Disable for objects which must be animated every frame with full skeleton (player).
+        void setAnimationLODEnabled(bool enabled) { m_animationLODEnabled = enabled; }
+        int getAnimationLOD() { return m_animationLOD; } // Chosen by AnimationSystem in last frame.
+
+        // Bounds of current pose built from bones bounding spheres. Ready after AnimationSystem update.
+        // Before first pose is calculated bounds are point at origin.
+        bool getHasBounds() { return m_hasBounds; }
+        void getBoundingBox(glm::vec3& worldMin, glm::vec3& worldMax) const; // World space AABB.
+        void getBoundingSphere(glm::vec3& worldCenter, float& radius) const; // Sphere around world space AABB.
+        bool getIsSeenByCamera() const;
+
+        // Resolve bone once and keep index. -1 if bone does not exist.
+        int getBoneIndex(const std::string& boneName) const;
+        // Bone transforms in world space for last calculated pose.
+        glm::mat4 getBoneWorldMatrix(const int boneIndex) const;
+        // Attached object follows bone. Its origin and rotation are set by AnimationSystem after all poses are calculated.
+        // offsetPosition, offsetRotation - transforms of attached object relative to bone.
+        void attachObject(const std::shared_ptr<SceneObject>& obj, const int boneIndex,
+                          const glm::vec3& offsetPosition = glm::vec3{0.0f},
+                          const glm::quat& offsetRotation = glm::quat{1.0f, 0.0f, 0.0f, 0.0f});
+        void detachObject(const std::shared_ptr<SceneObject>& obj);
+        void detachAllObjects() { m_attachments.clear(); }
+
         // Call it sometimes between game levels/maps to free some memory.
         // Or dont call if you will load same models again. They will be taken from cache for faster loading.
-        static void clearCachedModels() { m_importersScenes.clear(); };
+        // Models of alive objects stay in cache. Not used models are also evicted by AssetRegistry when memory budget is exceeded.
+        static void clearCachedModels();
 
     protected:
         BaseAnimatedObject(const char* filePath,
                            SceneObjectGroups sceneGroup);
 
-        // aiScene + Assimp::Importer lifetime for animated object should be same as animated object.
-        // aiScene + Assimp::Importer has big size in memory.
-        // This map will cache animated objects and reuse them if you load again from same file.
-        // If many of AnimatedCollidingObject load model from same file(id = file path) it will get pointer to aiScene from this map after first loading.
-        // id = file path.
-        static std::map<const std::string, std::pair<std::shared_ptr<Assimp::Importer>, const aiScene*>> m_importersScenes;
+        // Model data is cached in AssetRegistry. ID = file path.
+        // If many objects load model from same file they will get shared model data from cache after first loading.
+        // Import file with Assimp, extract model data and release aiScene.
+        static std::shared_ptr<const AnimatedModelData> loadModelData(const std::string& filePath);
+        static void flattenNodeHierarchy(const aiNode* node, const int parentIndex, AnimatedModelData& data, std::vector<std::string>& nodeNames);
 
-        const std::string m_modelPath; // Object ID in m_importersScenes map.
+        const std::string m_modelPath; // Model ID in AssetRegistry.
+        std::shared_ptr<const AnimatedModelData> m_modelData;
 
         // Animation data.
         static constexpr uint32_t NUM_BONES_PER_VERTEX = 4; // One vertex can be affected maximum by 4 bones.
-        uint32_t m_boneCount = 0;
-        std::vector<std::pair<std::string, uint32_t>> m_boneNameIndex;
-        std::vector<BoneMatrix> m_bonesMatrices;
-        std::string m_boneMatrixNameInShader;
-        std::vector<std::pair<std::string, int>> m_animationNameIndex;
+        std::vector<glm::mat4> m_boneFinalMatrices; // Final transforms after frame interpolation. Written by AnimationSystem.
         int m_currentAnimIndex = 0;
         int m_defaultAnimIndex = 0;
         std::string m_currentAnimName;
         float m_animStartTimeInSec = 0.0f;
         float m_animTimeInSec = 0.0f;
-        float m_ticksPerSecond = 0.0f;
         bool m_playAnimOneTime = false; // Anim will play once and then default anim will start automatically.
         float m_animOneTimeLastFrameTime = 0.0f; // If anim played once keep time of last frame.
 
-        void calculateTransforms();
-        void readNodeHierarchy(const float animationTime, const aiNode* node, const aiMatrix4x4& parentTransform);
-        const aiNodeAnim* findNodeAnimByName(const aiAnimation* animation, const aiString& nodeName);
-        const aiNodeAnim* findNodeAnimAny(const aiAnimation* animation);
-        aiMatrix4x4 interpolatePosition(const aiNodeAnim* nodeAnim, const uint32_t currentFrameIndex, const uint32_t nextFrameIndex, const float factor);
-        aiMatrix4x4 interpolateRotation(const aiNodeAnim* nodeAnim, const uint32_t currentFrameIndex, const uint32_t nextFrameIndex, const float factor);
-        aiMatrix4x4 interpolateScaling(const aiNodeAnim* nodeAnim, const uint32_t currentFrameIndex, const uint32_t nextFrameIndex, const float factor);
+        // Skeleton is flattened once at load so per frame evaluation does not compare strings.
+        std::vector<glm::mat4> m_nodeGlobalTransforms; // Same size as m_modelData->skeletonNodes. Reused every frame
+        std::vector<glm::mat4> m_nodeLocalTransforms; // Last sampled. Reused for nodes skipped by LOD
 
-        aiMatrix4x4 m_globalInverseMatrix;
-        // Animation data end.
+        friend class AnimationSystem;
+        // Called by AnimationSystem on main thread. Advance animation time and find sample position in current clip.
+        void updateSamplePosition();
+        // Called by AnimationSystem, can be called from worker thread.
+        // Nodes deeper than maxSampledNodeDepth keep last sampled local transform (follow parent).
+        void calculateTransforms(const int maxSampledNodeDepth);
+        // Take pose calculated by other object loaded from same file (pose cache).
+        void copyTransformsFrom(const BaseAnimatedObject* other);
+        uint32_t m_poseSampleIndex = 0;
+        float m_poseBlend = 0.0f;
+        bool m_animationLODEnabled = true;
+        int m_animationLOD = 0;
+        bool m_isPoseCalculated = false; // First pose is calculated with full skeleton regardless of LOD.
+        // Transform bones bounding spheres by m_boneFinalMatrices. Called after pose is calculated.
+        void calculateBounds();
+        glm::vec3 m_boundsMin{0.0f}; // Model space. Before object rotation and origin.
+        glm::vec3 m_boundsMax{0.0f};
+        bool m_hasBounds = false;
 
-        const aiScene* m_scene = nullptr;
+        struct Attachment
+        {
+            std::shared_ptr<SceneObject> object;
+            int boneIndex = -1;
+            glm::mat4 offset{1.0f};
+        };
+        std::vector<Attachment> m_attachments;
+        // Called by AnimationSystem on main thread after poses are calculated.
+        void updateAttachments();
+        // Animation data end.
     };
 }
@@ -1,9 +1,23 @@
 #include "BaseSimpleObject.h"
 #include "beryll/renderer/Renderer.h"
 #include "beryll/renderer/Camera.h"
+#include "beryll/utils/File.h"
 
 namespace Beryll
 {
+    BeryllUtils::VertexFormat BaseSimpleObject::m_loadingVertexFormat = BeryllUtils::VertexFormat::FLOAT;
+
+    namespace
+    {
+        // Internal shaders are game assets. Compact formats can be used only if game has shaders which decode them.
+        bool getIsCompactShadersExist()
+        {
+            static const bool exist = BeryllUtils::File::exists(BeryllConstants::simpleObjCompactVertexPath.data()) &&
+                                      BeryllUtils::File::exists(BeryllConstants::simpleObjTwoMaterialsCompactVertexPath.data());
+            return exist;
+        }
+    }
+
     BaseSimpleObject::~BaseSimpleObject()
     {
         disableForEver();
@@ -37,6 +51,12 @@ namespace Beryll
                 m_internalShader->set1Float("addToUVCoords", m_addToUVCoords);
                 m_internalShader->set1Float("UVCoordsMultiplier", m_UVCoordsMultiplier);
             }
+
+            if(m_vertexFormat != BeryllUtils::VertexFormat::FLOAT)
+            {
+                m_internalShader->set3Float("positionScale", m_positionScale);
+                m_internalShader->set3Float("positionBias", m_positionBias);
+            }
         }
 
         if(useInternalMaterials)
@@ -51,146 +71,95 @@ namespace Beryll
         m_vertexArray->draw();
     }
 
-    void BaseSimpleObject::loadGraphicsMesh(const std::string& filePath, const aiScene* scene, const aiMesh* graphicsMesh)
+    void BaseSimpleObject::loadGraphicsMesh(const BeryllUtils::MeshView& graphicsMesh)
     {
-        BR_INFO("Graphics mesh name: %s", graphicsMesh->mName.C_Str());
-
-        // Prepare vectors.
-        std::vector<glm::vec3> vertices;
-        std::vector<glm::vec3> normals;
-        std::vector<glm::vec3> tangents;
-        std::vector<glm::vec2> textureCoords;
-        std::vector<uint32_t> indices;
-        vertices.reserve(graphicsMesh->mNumVertices);
-        normals.reserve(graphicsMesh->mNumVertices);
-        tangents.reserve(graphicsMesh->mNumVertices);
-        textureCoords.reserve(graphicsMesh->mNumVertices);
-        indices.reserve(graphicsMesh->mNumFaces * 3);
-
-        float UVSmallestX = std::numeric_limits<float>::max();
-        float UVBiggestX = std::numeric_limits<float>::min();
-        float UVSmallestY = std::numeric_limits<float>::max();
-        float UVBiggestY = std::numeric_limits<float>::min();
-
-        // Vertices.
-        for(int i = 0; i < graphicsMesh->mNumVertices; ++i)
-        {
-            vertices.emplace_back(graphicsMesh->mVertices[i].x,
-                                  graphicsMesh->mVertices[i].y,
-                                  graphicsMesh->mVertices[i].z);
+        BR_INFO("Graphics mesh name: %s", graphicsMesh.name.c_str());
+        BR_ASSERT((!graphicsMesh.isCollision && graphicsMesh.normals && graphicsMesh.textureCoords),
+                  "Mesh can not be used for draw: %s", graphicsMesh.name.c_str());
 
-            if(graphicsMesh->mNormals)
-            {
-                glm::vec3 normal = glm::vec3(graphicsMesh->mNormals[i].x,
-                                             graphicsMesh->mNormals[i].y,
-                                             graphicsMesh->mNormals[i].z);
+        m_vertexFormat = m_loadingVertexFormat;
+        if(m_vertexFormat != BeryllUtils::VertexFormat::FLOAT && !getIsCompactShadersExist())
+        {
+            BR_WARN("Shaders for compact vertex format not found: %s. FLOAT format is used.", BeryllConstants::simpleObjCompactVertexPath.data());
+            m_vertexFormat = BeryllUtils::VertexFormat::FLOAT;
+        }
+        const std::string_view vertexShaderPath = m_vertexFormat == BeryllUtils::VertexFormat::FLOAT ? BeryllConstants::simpleObjDefaultVertexPath
+                                                                                                      : BeryllConstants::simpleObjCompactVertexPath;
+        m_internalShader = Renderer::createShader(vertexShaderPath.data(), BeryllConstants::simpleObjDefaultFragmentPath.data());
+        m_internalShader->bind();
 
-                normals.emplace_back(glm::normalize(normal));
-            }
-            else
+        // Load Material 1. At least diffuse texture of material 1 must exist.
+        // Before vertex buffer because tangents are added to vertices only if model has normal map.
+        m_material1 = BeryllUtils::Common::loadMaterial1(graphicsMesh.diffuseTexturePath,
+                                                         graphicsMesh.specularTexturePath,
+                                                         graphicsMesh.normalMapTexturePath);
+
+        m_internalShader->activateDiffuseTextureMat1();
+
+        if(m_material1.specTexture)
+            m_internalShader->activateSpecularTextureMat1();
+
+        if(m_material1.normalMapTexture)
+            m_internalShader->activateNormalMapTextureMat1();
+
+        // All attributes in one interleaved buffer: position, normal, UV, tangent (if model has normal map).
+        // layout(location = ...) are same as in separate buffers.
+        BR_INFO("Vertex count: %d", graphicsMesh.vertexCount);
+        std::vector<VertexStream> streams;
+        std::vector<glm::u16vec4> positions;
+        std::vector<glm::i16vec2> normals;
+        std::vector<glm::u16vec2> textureCoords;
+        std::vector<glm::i16vec2> tangents;
+        if(m_vertexFormat == BeryllUtils::VertexFormat::FLOAT)
+        {
+            streams.push_back({graphicsMesh.vertices, VertexAttribType::FLOAT, VertexAttribSize::THREE});
+            streams.push_back({graphicsMesh.normals, VertexAttribType::FLOAT, VertexAttribSize::THREE});
+            streams.push_back({graphicsMesh.textureCoords, VertexAttribType::FLOAT, VertexAttribSize::TWO});
+            if(m_material1.normalMapTexture)
+                streams.push_back({graphicsMesh.tangents, VertexAttribType::FLOAT, VertexAttribSize::THREE});
+        }
+        else
+        {
+            positions = BeryllUtils::VertexQuantization::encodePositions(graphicsMesh.vertices, graphicsMesh.vertexCount,
+                                                                         m_vertexFormat, m_positionScale, m_positionBias);
+            normals = BeryllUtils::VertexQuantization::encodeDirections(graphicsMesh.normals, graphicsMesh.vertexCount);
+            textureCoords = BeryllUtils::VertexQuantization::encodeTextureCoords(graphicsMesh.textureCoords, graphicsMesh.vertexCount);
+
+            const VertexAttribType positionType = m_vertexFormat == BeryllUtils::VertexFormat::COMPACT_HALF ? VertexAttribType::HALF_FLOAT
+                                                                                                              : VertexAttribType::SHORT_NORMALIZED;
+            streams.push_back({positions.data(), positionType, VertexAttribSize::FOUR});
+            streams.push_back({normals.data(), VertexAttribType::SHORT_NORMALIZED, VertexAttribSize::TWO});
+            streams.push_back({textureCoords.data(), VertexAttribType::HALF_FLOAT, VertexAttribSize::TWO});
+            if(m_material1.normalMapTexture)
             {
-                normals.emplace_back(0.0f, 0.0f, 0.0f);
+                tangents = BeryllUtils::VertexQuantization::encodeDirections(graphicsMesh.tangents, graphicsMesh.vertexCount);
+                streams.push_back({tangents.data(), VertexAttribType::SHORT_NORMALIZED, VertexAttribSize::TWO});
             }
+        }
+        m_vertexBuffer = Renderer::createInterleavedVertexBuffer(streams, graphicsMesh.vertexCount);
 
-            if(graphicsMesh->mTangents)
-            {
-                glm::vec3 tangent = glm::vec3(graphicsMesh->mTangents[i].x,
-                                              graphicsMesh->mTangents[i].y,
-                                              graphicsMesh->mTangents[i].z);
-
-                tangents.emplace_back(glm::normalize(tangent));
-            }
-            else
-            {
-                tangents.emplace_back(0.0f, 0.0f, 0.0f);
-            }
+        m_addToUVCoords = graphicsMesh.addToUVCoords;
+        m_UVCoordsMultiplier = graphicsMesh.UVCoordsMultiplier;
 
-            // Use only first set of texture coordinates.
-            if(graphicsMesh->mTextureCoords[0])
-            {
-                textureCoords.emplace_back(graphicsMesh->mTextureCoords[0][i].x,
-                                           graphicsMesh->mTextureCoords[0][i].y);
-
-                if(graphicsMesh->mTextureCoords[0][i].x < UVSmallestX)
-                    UVSmallestX = graphicsMesh->mTextureCoords[0][i].x;
-                if(graphicsMesh->mTextureCoords[0][i].x > UVBiggestX)
-                    UVBiggestX = graphicsMesh->mTextureCoords[0][i].x;
-
-                if(graphicsMesh->mTextureCoords[0][i].y < UVSmallestY)
-                    UVSmallestY = graphicsMesh->mTextureCoords[0][i].y;
-                if(graphicsMesh->mTextureCoords[0][i].y > UVBiggestY)
-                    UVBiggestY = graphicsMesh->mTextureCoords[0][i].y;
-            }
-            else
-            {
-                textureCoords.emplace_back(0.0f, 0.0f);
-            }
-        }
-        BR_INFO("Vertex count: %d", vertices.size());
-        m_vertexPosBuffer = Renderer::createStaticVertexBuffer(vertices);
-        m_vertexNormalsBuffer = Renderer::createStaticVertexBuffer(normals);
-        m_textureCoordsBuffer = Renderer::createStaticVertexBuffer(textureCoords);
-        // Tangents buffer will created if model has normal map.
-
-        float UVXRange = glm::distance(UVSmallestX, UVBiggestX);
-        float UVYRange = glm::distance(UVSmallestY, UVBiggestY);
-        if(UVXRange < UVYRange)
+        BR_INFO("Indices count: %d", graphicsMesh.indexCount);
+        // 16 bit indices do not need shader changes. Used for all formats.
+        if(BeryllUtils::VertexQuantization::getCanUseIndices16(graphicsMesh.vertexCount))
         {
-            m_addToUVCoords = std::abs(UVSmallestY);
-            m_UVCoordsMultiplier = 1.0f / UVYRange;
+            const std::vector<uint16_t> indices = BeryllUtils::VertexQuantization::encodeIndices16(graphicsMesh.indices, graphicsMesh.indexCount);
+            m_indexBuffer = Renderer::createSharedIndexBuffer(indices.data(), graphicsMesh.indexCount);
         }
         else
         {
-            m_addToUVCoords = std::abs(UVSmallestX);
-            m_UVCoordsMultiplier = 1.0f / UVXRange;
-        }
-
-        // Indices.
-        for(int i = 0; i < graphicsMesh->mNumFaces; ++i) // Every face MUST be a triangle !!!!
-        {
-            indices.emplace_back(graphicsMesh->mFaces[i].mIndices[0]);
-            indices.emplace_back(graphicsMesh->mFaces[i].mIndices[1]);
-            indices.emplace_back(graphicsMesh->mFaces[i].mIndices[2]);
+            m_indexBuffer = Renderer::createSharedIndexBuffer(graphicsMesh.indices, graphicsMesh.indexCount);
         }
-        BR_INFO("Indices count: %d", indices.size());
-        m_indexBuffer = Renderer::createStaticIndexBuffer(indices);
 
         m_vertexArray = Renderer::createVertexArray();
-        m_vertexArray->addVertexBuffer(m_vertexPosBuffer);
-        m_vertexArray->addVertexBuffer(m_vertexNormalsBuffer);
-        m_vertexArray->addVertexBuffer(m_textureCoordsBuffer);
-        // Tangents buffer will added if model has normal map.
+        m_vertexArray->addVertexBuffer(m_vertexBuffer);
         m_vertexArray->setIndexBuffer(m_indexBuffer);
 
-        m_internalShader = Renderer::createShader(BeryllConstants::simpleObjDefaultVertexPath.data(),
-                                                  BeryllConstants::simpleObjDefaultFragmentPath.data());
-        m_internalShader->bind();
-
-        // Load Material 1. At least diffuse texture of material 1 must exist.
-        if(graphicsMesh->mMaterialIndex >= 0)
-        {
-            m_material1 = BeryllUtils::Common::loadMaterial1(scene->mMaterials[graphicsMesh->mMaterialIndex], filePath);
-
-            m_internalShader->activateDiffuseTextureMat1();
-
-            if(m_material1.specTexture)
-                m_internalShader->activateSpecularTextureMat1();
-
-            if(m_material1.normalMapTexture)
-            {
-                m_internalShader->activateNormalMapTextureMat1();
-
-                BR_INFO("%s", "Create tangents buffer because model has normal map.");
-                m_vertexTangentsBuffer = Renderer::createStaticVertexBuffer(tangents);
-
-                m_vertexArray->addVertexBuffer(m_vertexTangentsBuffer);
-            }
-        }
-
-        const aiNode* node = BeryllUtils::Common::findAinodeForAimesh(scene, scene->mRootNode, graphicsMesh->mName);
-        if(node)
+        if(graphicsMesh.hasNodeTransforms)
         {
-            glm::mat4 modelMatrix = BeryllUtils::Matrix::aiToGlm(node->mTransformation);
+            const glm::mat4& modelMatrix = graphicsMesh.nodeTransforms;
             // Check scale. Should be 1.
             glm::vec3 scale = BeryllUtils::Matrix::getScaleFrom4x4Glm(modelMatrix);
             BR_ASSERT((scale.x > 0.9999f && scale.x < 1.0001f &&
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SceneObject.h"
+#include "beryll/utils/MeshFile.h"
 
 namespace Beryll
 {
@@ -13,7 +14,16 @@ namespace Beryll
         void updateAfterPhysics() override;
         void draw() override;
 
+        // Format of vertex buffers of objects loaded after call. Default FLOAT.
+        // Compact formats need shaders which decode them (docs/requirements/Shaders.txt).
+        // If game does not have them (BeryllConstants::simpleObjCompactVertexPath...) objects are loaded in FLOAT format.
+        static void setVertexFormat(BeryllUtils::VertexFormat format) { m_loadingVertexFormat = format; }
+
     protected:
-        void loadGraphicsMesh(const std::string& filePath, const aiScene* scene, const aiMesh* graphicsMesh);
+        // Mesh data can be freed after call.
+        void loadGraphicsMesh(const BeryllUtils::MeshView& graphicsMesh);
+
+    private:
+        static BeryllUtils::VertexFormat m_loadingVertexFormat;
     };
 }
@@ -27,6 +27,11 @@ namespace Beryll
             m_internalShader = Renderer::createShader(BeryllConstants::animatedObjTwoMaterialsDefaultVertexPath.data(),
                                                       BeryllConstants::animatedObjTwoMaterialsDefaultFragmentPath.data());
         }
+        else if(m_vertexFormat != BeryllUtils::VertexFormat::FLOAT)
+        {
+            m_internalShader = Renderer::createShader(BeryllConstants::simpleObjTwoMaterialsCompactVertexPath.data(),
+                                                      BeryllConstants::simpleObjTwoMaterialsDefaultFragmentPath.data());
+        }
         else
         {
             m_internalShader = Renderer::createShader(BeryllConstants::simpleObjTwoMaterialsDefaultVertexPath.data(),
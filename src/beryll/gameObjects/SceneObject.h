@@ -6,6 +6,7 @@
 #include "beryll/renderer/Shader.h"
 #include "beryll/renderer/Buffer.h"
 #include "beryll/renderer/VertexArray.h"
+#include "beryll/utils/VertexQuantization.h"
 
 namespace Beryll
 {
@@ -368,6 +369,7 @@ namespace Beryll
         const CollisionFlags getCollisionFlag() const { return m_collisionFlag; }
         const SceneObjectGroups getSceneObjectGroup() const { return m_sceneObjectGroup; }
         const bool getIsAnimatedObject() const { return m_isAnimatedObject; }
+        const glm::quat& getTotalRotation() const { return m_totalRotation; }
         const glm::vec3 getFaceDirXYZ() const
         {
             return glm::normalize(glm::vec3(m_totalRotation * m_sceneObjectFaceDir));
@@ -453,6 +455,26 @@ namespace Beryll
         const float getAddToUVCoords() const { return m_addToUVCoords; }
         const float getUVCoordsMultiplier() const { return m_UVCoordsMultiplier; }
 
+        // Objects with compact vertex format have positions in -1...1 range. Decoded: inPosition.xyz * positionScale + positionBias.
+        // Renderer::drawObject() with custom shader and shadow map include getPositionDecodeMatrix() in MVPMatrix.
+        // Custom shader which needs normals or world position (M_matrix) must decode them (docs/requirements/Shaders.txt).
+        BeryllUtils::VertexFormat getVertexFormat() const { return m_vertexFormat; }
+        const glm::vec3& getPositionScale() const { return m_positionScale; }
+        const glm::vec3& getPositionBias() const { return m_positionBias; }
+        // Identity for FLOAT format.
+        glm::mat4 getPositionDecodeMatrix() const
+        {
+            glm::mat4 decodeMatrix{1.0f};
+            if(m_vertexFormat != BeryllUtils::VertexFormat::FLOAT)
+            {
+                decodeMatrix[0][0] = m_positionScale.x;
+                decodeMatrix[1][1] = m_positionScale.y;
+                decodeMatrix[2][2] = m_positionScale.z;
+                decodeMatrix[3] = glm::vec4(m_positionBias, 1.0f);
+            }
+            return decodeMatrix;
+        }
+
         bool useInternalShader = true;
         bool useInternalMaterials = true;
 
@@ -476,6 +498,7 @@ namespace Beryll
         bool m_isAnimatedObject = false;
 
         // Graphics data.
+        std::shared_ptr<VertexBuffer> m_vertexBuffer; // Interleaved. All attributes of static mesh.
         std::shared_ptr<VertexBuffer> m_vertexPosBuffer;
         std::shared_ptr<VertexBuffer> m_vertexNormalsBuffer;
         std::shared_ptr<VertexBuffer> m_vertexTangentsBuffer;
@@ -491,6 +514,9 @@ namespace Beryll
         // Shader code example: vec2 blendTextureUV = (inUV + m_addToUVCoords) * m_UVCoordsMultiplier;
         float m_addToUVCoords = 0.0f;
         float m_UVCoordsMultiplier = 0.0f;
+        BeryllUtils::VertexFormat m_vertexFormat = BeryllUtils::VertexFormat::FLOAT;
+        glm::vec3 m_positionScale{1.0f};
+        glm::vec3 m_positionBias{0.0f};
         // Graphics data end.
 
         // Collider data.
@@ -1,5 +1,4 @@
 #include "SimpleCollidingObject.h"
-#include "beryll/utils/File.h"
 
 namespace Beryll
 {
@@ -13,57 +12,35 @@ namespace Beryll
     {
         BR_INFO("Loading simple colliding object: %s", filePath);
 
-        const std::string path = filePath;
-        const size_t lastDotPos = path.find_last_of('.');
-        BR_ASSERT(lastDotPos != std::string::npos, "%s", "File does not have extension.");
-        const std::string fileExtension = path.substr(lastDotPos + 1);
-        BR_ASSERT((fileExtension == "fbx" || fileExtension == "dae"), "%s", "File extension must be fbx or dae.");
-
-        uint32_t bufferSize = 0;
-        char* buffer = BeryllUtils::File::readToBuffer(filePath, &bufferSize);
-
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFileFromMemory(buffer, bufferSize,
-                                                           aiProcess_Triangulate | aiProcess_FlipUVs |
-                                                           aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace,
-                                                           fileExtension.c_str());
-        delete[] buffer;
-        if(!scene || !scene->mRootNode || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE)
-        {
-            BR_ASSERT(false, "Scene loading error for file: %s", filePath);
-        }
+        const BeryllUtils::LoadedModel model = BeryllUtils::MeshFile::loadModel(filePath);
 
-        BR_ASSERT((scene->mNumMeshes == 2), "Colliding simple object: %s MUST contain 2 meshes. For draw and physics simulation", filePath);
+        BR_ASSERT((model.meshes.size() == 2), "Colliding simple object: %s MUST contain 2 meshes. For draw and physics simulation", filePath);
 
         m_sceneObjectGroup = sceneGroup;
 
-        for(int i = 0; i < scene->mNumMeshes; ++i)
+        for(const BeryllUtils::MeshView& mesh : model.meshes)
         {
-            std::string meshName = scene->mMeshes[i]->mName.C_Str();
-
-            if(meshName.find("Collision") != std::string::npos)
-                loadCollisionMesh(scene, scene->mMeshes[i], meshName, collisionMassKg, wantCollisionCallBack, collFlag, collGroup, collMask);
+            if(mesh.isCollision)
+                loadCollisionMesh(mesh, collisionMassKg, wantCollisionCallBack, collFlag, collGroup, collMask, true);
             else
-                loadGraphicsMesh(filePath, scene, scene->mMeshes[i]);
+                loadGraphicsMesh(mesh);
         }
     }
 
-    SimpleCollidingObject::SimpleCollidingObject(const std::string& filePath,
-                                                 const aiScene* scene,
-                                                 const aiMesh* graphicsMesh,
-                                                 const aiMesh* collisionMesh,
-                                                 const std::string& collisionMeshName,
+    SimpleCollidingObject::SimpleCollidingObject(const BeryllUtils::MeshView& graphicsMesh,
+                                                 const BeryllUtils::MeshView& collisionMesh,
                                                  float collisionMassKg,
                                                  bool wantCollisionCallBack,
                                                  CollisionFlags collFlag,
                                                  CollisionGroups collGroup,
                                                  CollisionGroups collMask,
-                                                 SceneObjectGroups sceneGroup)
+                                                 SceneObjectGroups sceneGroup,
+                                                 bool addCollisionToPhysics)
     {
         m_sceneObjectGroup = sceneGroup;
 
-        loadGraphicsMesh(filePath, scene, graphicsMesh);
-        loadCollisionMesh(scene, collisionMesh, collisionMeshName, collisionMassKg, wantCollisionCallBack, collFlag, collGroup, collMask);
+        loadGraphicsMesh(graphicsMesh);
+        loadCollisionMesh(collisionMesh, collisionMassKg, wantCollisionCallBack, collFlag, collGroup, collMask, addCollisionToPhysics);
     }
 
     SimpleCollidingObject::~SimpleCollidingObject()
@@ -71,38 +48,37 @@ namespace Beryll
 
     }
 
-    void SimpleCollidingObject::loadCollisionMesh(const aiScene* scene,
-                                                  const aiMesh* collisionMesh,
-                                                  const std::string& meshName,
+    void SimpleCollidingObject::loadCollisionMesh(const BeryllUtils::MeshView& collisionMesh,
                                                   float mass,
                                                   bool wantCallBack,
                                                   CollisionFlags collFlag,
                                                   CollisionGroups collGroup,
-                                                  CollisionGroups collMask)
+                                                  CollisionGroups collMask,
+                                                  bool addToPhysics)
     {
-        BR_INFO("Collision mesh name: %s", collisionMesh->mName.C_Str());
+        BR_INFO("Collision mesh name: %s", collisionMesh.name.c_str());
 
         // Collect collision mesh dimensions.
         // Model should be created in Blender where up axis = +Z.
-        for (int g = 0; g < collisionMesh->mNumVertices; ++g)
+        for(uint32_t g = 0; g < collisionMesh.vertexCount; ++g)
         {
             // Top and bottom points must be taken from Z axis.
-            if (collisionMesh->mVertices[g].z < m_mostBottomVertex)
-                m_mostBottomVertex = collisionMesh->mVertices[g].z;
-            if (collisionMesh->mVertices[g].z > m_mostTopVertex)
-                m_mostTopVertex = collisionMesh->mVertices[g].z;
+            if(collisionMesh.vertices[g].z < m_mostBottomVertex)
+                m_mostBottomVertex = collisionMesh.vertices[g].z;
+            if(collisionMesh.vertices[g].z > m_mostTopVertex)
+                m_mostTopVertex = collisionMesh.vertices[g].z;
 
-            if (collisionMesh->mVertices[g].x < m_smallestX)
-                m_smallestX = collisionMesh->mVertices[g].x;
-            if (collisionMesh->mVertices[g].x > m_biggestX)
-                m_biggestX = collisionMesh->mVertices[g].x;
+            if(collisionMesh.vertices[g].x < m_smallestX)
+                m_smallestX = collisionMesh.vertices[g].x;
+            if(collisionMesh.vertices[g].x > m_biggestX)
+                m_biggestX = collisionMesh.vertices[g].x;
 
             // Z dimensions should be taken from Y axis.
             // In Blender Y axis is horizontal and will replaced by Z after exporting.
-            if (collisionMesh->mVertices[g].y < m_smallestZ)
-                m_smallestZ = collisionMesh->mVertices[g].y;
-            if (collisionMesh->mVertices[g].y > m_biggestZ)
-                m_biggestZ = collisionMesh->mVertices[g].y;
+            if(collisionMesh.vertices[g].y < m_smallestZ)
+                m_smallestZ = collisionMesh.vertices[g].y;
+            if(collisionMesh.vertices[g].y > m_biggestZ)
+                m_biggestZ = collisionMesh.vertices[g].y;
         }
 
         // Colliding object described by collision mesh.
@@ -121,13 +97,7 @@ namespace Beryll
         m_collisionMask = collMask;
         m_collisionMass = mass;
 
-        glm::mat4 collisionTransforms{1.0f};
-
-        const aiNode* node = BeryllUtils::Common::findAinodeForAimesh(scene, scene->mRootNode, collisionMesh->mName);
-        if(node)
-        {
-            collisionTransforms = BeryllUtils::Matrix::aiToGlm(node->mTransformation);
-        }
+        const glm::mat4& collisionTransforms = collisionMesh.nodeTransforms;
         // Check scale. Should be 1.
         glm::vec3 scale = BeryllUtils::Matrix::getScaleFrom4x4Glm(collisionTransforms);
         BR_ASSERT((scale.x > 0.9999f && scale.x < 1.0001f &&
@@ -135,29 +105,19 @@ namespace Beryll
                    scale.z > 0.9999f && scale.z < 1.0001f), "%s", "Scale should be baked to 1 in modeling tool.");
 
         // Dont add collider to simulation if collGroup == NONE. It have no sense.
-        if(collGroup == CollisionGroups::NONE)
+        // Collider can be added later as part of merged mesh.
+        if(collGroup == CollisionGroups::NONE || !addToPhysics)
             return;
 
         m_hasCollisionObject = true;
         m_isEnabledInPhysicsSimulation = true;
 
-        std::vector<glm::vec3> vertices;
-        vertices.reserve(collisionMesh->mNumVertices);
-        for(int i = 0; i < collisionMesh->mNumVertices; ++i)
-        {
-            vertices.emplace_back(collisionMesh->mVertices[i].x, collisionMesh->mVertices[i].y, collisionMesh->mVertices[i].z);
-        }
+        // Physics copies data. Mesh can be freed after.
+        const std::vector<glm::vec3> vertices(collisionMesh.vertices, collisionMesh.vertices + collisionMesh.vertexCount);
+        const std::vector<uint32_t> indices(collisionMesh.indices, collisionMesh.indices + collisionMesh.indexCount);
+        const std::vector<char> serializedBvh(collisionMesh.collisionBvh, collisionMesh.collisionBvh + collisionMesh.collisionBvhSize);
 
-        std::vector<uint32_t> indices;
-        indices.reserve(collisionMesh->mNumFaces * 3);
-        for(int i = 0; i < collisionMesh->mNumFaces; ++i)
-        {
-            indices.emplace_back(collisionMesh->mFaces[i].mIndices[0]);
-            indices.emplace_back(collisionMesh->mFaces[i].mIndices[1]);
-            indices.emplace_back(collisionMesh->mFaces[i].mIndices[2]);
-        }
-
-        Physics::addObject(vertices, indices, collisionTransforms, meshName, m_ID, mass, wantCallBack, collFlag, collGroup, collMask);
+        Physics::addObject(vertices, indices, collisionTransforms, collisionMesh.name, m_ID, mass, wantCallBack, collFlag, collGroup, collMask, serializedBvh);
     }
 
     std::vector<std::shared_ptr<SimpleCollidingObject>> SimpleCollidingObject::loadManyModelsFromOneFile(const char* filePath,
@@ -166,79 +126,106 @@ namespace Beryll
                                                                                                          CollisionFlags collFlag,
                                                                                                          CollisionGroups collGroup,
                                                                                                          CollisionGroups collMask,
-                                                                                                         SceneObjectGroups sceneGroup)
+                                                                                                         SceneObjectGroups sceneGroup,
+                                                                                                         float mergeCellSize)
     {
         std::vector<std::shared_ptr<SimpleCollidingObject>> objects;
         std::shared_ptr<SimpleCollidingObject> obj;
 
         BR_INFO("Load many colliding simple objects from one file: %s", filePath);
 
-        const std::string path = filePath;
-        const size_t lastDotPos = path.find_last_of('.');
-        BR_ASSERT(lastDotPos != std::string::npos, "%s", "File does not have extension.");
-        const std::string fileExtension = path.substr(lastDotPos + 1);
-        BR_ASSERT((fileExtension == "fbx" || fileExtension == "dae"), "%s", "File extension must be fbx or dae.");
-
-        uint32_t bufferSize = 0;
-        char* buffer = BeryllUtils::File::readToBuffer(filePath, &bufferSize);
-
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFileFromMemory(buffer, bufferSize,
-                                                           aiProcess_Triangulate | aiProcess_FlipUVs |
-                                                           aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace,
-                                                           fileExtension.c_str());
-        delete[] buffer;
-        if(!scene || !scene->mRootNode || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE)
-        {
-            BR_ASSERT(false, "Scene loading error for file: %s", filePath);
-        }
-
-        BR_ASSERT((scene->mNumMeshes % 2 == 0), "Not all meshes have collider in file: %s", filePath);
-        BR_INFO("Total objects count in file: %d", scene->mNumMeshes / 2);
+        const BeryllUtils::LoadedModel model = BeryllUtils::MeshFile::loadModel(filePath);
 
-        std::string graphicsMeshName;
-        std::string collisionMeshName;
+        BR_ASSERT((model.meshes.size() % 2 == 0), "Not all meshes have collider in file: %s", filePath);
+        BR_INFO("Total objects count in file: %d", model.meshes.size() / 2);
 
-        for(int i = 0; i < scene->mNumMeshes; ++i)
+        // Static concave colliders merged per cell. All objects of file have same wantCollisionCallBack, collGroup, collMask.
+        struct MergedCell
         {
-            graphicsMeshName = scene->mMeshes[i]->mName.C_Str();
-            if(graphicsMeshName.find("Collision") != std::string::npos)
+            std::vector<glm::vec3> vertices; // World space.
+            std::vector<uint32_t> indices;
+            std::vector<int> triangleObjectIDs;
+        };
+        std::map<std::pair<int, int>, MergedCell> mergedCells;
+        const bool canMerge = mergeCellSize > 0.0f && collFlag == CollisionFlags::STATIC && collisionMassKg == 0.0f &&
+                              collGroup != CollisionGroups::NONE;
+
+        // Colliders of all objects will be built in parallel and inserted in physics world together.
+        Physics::beginAddBatch(model.meshes.size() / 2);
+
+        for(const BeryllUtils::MeshView& graphicsMesh : model.meshes)
+        {
+            if(graphicsMesh.isCollision)
                 continue;
 
-            // Found graphics mesh.
-            const aiMesh* graphicsMesh = scene->mMeshes[i];
-            const aiMesh* collisionMesh = nullptr;
-
-            // Look for collision mesh for found graphics mesh.
-            for(int j = 0; j < scene->mNumMeshes; ++j)
+            // Found graphics mesh. Look for collision mesh for it.
+            const BeryllUtils::MeshView* collisionMesh = nullptr;
+            for(const BeryllUtils::MeshView& mesh : model.meshes)
             {
-                collisionMeshName = scene->mMeshes[j]->mName.C_Str();
-
-                std::string::size_type collisionWordIndex = collisionMeshName.find("Collision");
-                if(collisionWordIndex != std::string::npos)
+                std::string::size_type collisionWordIndex = mesh.name.find("Collision");
+                if(collisionWordIndex != std::string::npos && graphicsMesh.name == mesh.name.substr(0, collisionWordIndex))
                 {
-                    if(graphicsMeshName == collisionMeshName.substr(0, collisionWordIndex))
-                    {
-                        collisionMesh = scene->mMeshes[j];
-                        break;
-                    }
+                    collisionMesh = &mesh;
+                    break;
                 }
             }
 
-            BR_ASSERT((graphicsMesh != nullptr && collisionMesh != nullptr), "Collision mesh not found for graphics mesh: %s", graphicsMeshName.c_str());
+            BR_ASSERT((collisionMesh != nullptr), "Collision mesh not found for graphics mesh: %s", graphicsMesh.name.c_str());
+            if(!collisionMesh)
+                continue;
+
+            const bool mergeCollider = canMerge && collisionMesh->name.find("CollisionConcaveMesh") != std::string::npos;
 
-            obj = std::make_shared<SimpleCollidingObject>(filePath,
-                                                          scene,
-                                                          graphicsMesh,
-                                                          collisionMesh,
-                                                          collisionMeshName,
+            obj = std::make_shared<SimpleCollidingObject>(graphicsMesh,
+                                                          *collisionMesh,
                                                           collisionMassKg,
                                                           wantCollisionCallBack,
                                                           collFlag,
                                                           collGroup,
                                                           collMask,
-                                                          sceneGroup);
+                                                          sceneGroup,
+                                                          !mergeCollider);
             objects.push_back(obj);
+
+            if(!mergeCollider)
+                continue;
+
+            const glm::mat4& collisionTransforms = collisionMesh->nodeTransforms;
+
+            // Cell selected by object origin.
+            const glm::vec3 objectOrigin = BeryllUtils::Matrix::getTranslationFrom4x4Glm(collisionTransforms);
+            const std::pair<int, int> cellKey{static_cast<int>(std::floor(objectOrigin.x / mergeCellSize)),
+                                              static_cast<int>(std::floor(objectOrigin.z / mergeCellSize))};
+            MergedCell& cell = mergedCells[cellKey];
+
+            const uint32_t indexOffset = static_cast<uint32_t>(cell.vertices.size());
+            for(uint32_t v = 0; v < collisionMesh->vertexCount; ++v)
+            {
+                cell.vertices.emplace_back(collisionTransforms * glm::vec4(collisionMesh->vertices[v], 1.0f));
+            }
+
+            for(uint32_t f = 0; f + 2 < collisionMesh->indexCount; f += 3)
+            {
+                cell.indices.emplace_back(collisionMesh->indices[f] + indexOffset);
+                cell.indices.emplace_back(collisionMesh->indices[f + 1] + indexOffset);
+                cell.indices.emplace_back(collisionMesh->indices[f + 2] + indexOffset);
+                cell.triangleObjectIDs.emplace_back(obj->getID());
+            }
+        }
+
+        Physics::endAddBatch();
+
+        for(std::pair<const std::pair<int, int>, MergedCell>& cell : mergedCells)
+        {
+            BR_INFO("Merged static concave colliders in cell X: %d, Z: %d, triangles: %d",
+                    cell.first.first, cell.first.second, int(cell.second.triangleObjectIDs.size()));
+
+            Physics::addMergedStaticConcaveMesh(cell.second.vertices,
+                                                cell.second.indices,
+                                                std::move(cell.second.triangleObjectIDs),
+                                                wantCollisionCallBack,
+                                                collGroup,
+                                                collMask);
         }
 
         return objects;
@@ -10,7 +10,7 @@ namespace Beryll
     public:
         SimpleCollidingObject() = delete;
         /*
-         * filePath - path to model file (.DAE or .FBX). start path from first folder inside assets/
+         * filePath - path to model file (.DAE, .FBX or cooked .bmesh). start path from first folder inside assets/
          * collisionMassKg - mass of this object for physics simulation. 0 for static objects
          * wantCollisionCallBack - drop performance too much because call back use std::scoped_lock<std::mutex>
          *                         if true Physics module will store actual collisions for this object,
@@ -27,37 +27,38 @@ namespace Beryll
                               CollisionGroups collGroup,
                               CollisionGroups collMask,
                               SceneObjectGroups sceneGroup);
-        SimpleCollidingObject(const std::string& filePath,
-                              const aiScene* scene,
-                              const aiMesh* graphicsMesh,
-                              const aiMesh* collisionMesh,
-                              const std::string& collisionMeshName,
+        SimpleCollidingObject(const BeryllUtils::MeshView& graphicsMesh,
+                              const BeryllUtils::MeshView& collisionMesh,
                               float collisionMassKg,
                               bool wantCollisionCallBack,
                               CollisionFlags collFlag,
                               CollisionGroups collGroup,
                               CollisionGroups collMask,
-                              SceneObjectGroups sceneGroup);
+                              SceneObjectGroups sceneGroup,
+                              bool addCollisionToPhysics = true);
         ~SimpleCollidingObject() override;
 
         // All loaded objects will have same parameters(mass, flags, groups, ...).
+        // mergeCellSize > 0 - static concave collision meshes will be merged in one BVH mesh per cell (XZ plane, meters).
+        //                     Ray hits and collisions still return ID of original object.
+        //                     Merged objects can not be moved or removed from physics separately (getHasCollisionMesh() == false).
         static std::vector<std::shared_ptr<SimpleCollidingObject>> loadManyModelsFromOneFile(const char* filePath,
                                                                                              float collisionMassKg,
                                                                                              bool wantCollisionCallBack,
                                                                                              CollisionFlags collFlag,
                                                                                              CollisionGroups collGroup,
                                                                                              CollisionGroups collMask,
-                                                                                             SceneObjectGroups sceneGroup);
+                                                                                             SceneObjectGroups sceneGroup,
+                                                                                             float mergeCellSize = 0.0f);
 
 
     private:
-        void loadCollisionMesh(const aiScene* scene,
-                               const aiMesh* collisionMesh,
-                               const std::string& meshName,
+        void loadCollisionMesh(const BeryllUtils::MeshView& collisionMesh,
                                float mass,
                                bool wantCallBack,
                                CollisionFlags collFlag,
                                CollisionGroups collGroup,
-                               CollisionGroups collMask);
+                               CollisionGroups collMask,
+                               bool addToPhysics);
     };
 }
@@ -1,5 +1,4 @@
 #include "SimpleObject.h"
-#include "beryll/utils/File.h"
 
 namespace Beryll
 {
@@ -8,41 +7,21 @@ namespace Beryll
     {
         BR_INFO("Loading simple object: %s", filePath);
 
-        const std::string path = filePath;
-        const size_t lastDotPos = path.find_last_of('.');
-        BR_ASSERT(lastDotPos != std::string::npos, "%s", "File does not have extension.");
-        const std::string fileExtension = path.substr(lastDotPos + 1);
-        BR_ASSERT((fileExtension == "fbx" || fileExtension == "dae"), "%s", "File extension must be fbx or dae.");
+        const BeryllUtils::LoadedModel model = BeryllUtils::MeshFile::loadModel(filePath);
 
-        uint32_t bufferSize = 0;
-        char* buffer = BeryllUtils::File::readToBuffer(filePath, &bufferSize);
-
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFileFromMemory(buffer, bufferSize,
-                                                           aiProcess_Triangulate | aiProcess_FlipUVs |
-                                                           aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace,
-                                                           fileExtension.c_str());
-        delete[] buffer;
-        if(!scene || !scene->mRootNode || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE)
-        {
-            BR_ASSERT(false, "Scene loading error for file: %s", filePath);
-        }
-
-        BR_ASSERT((scene->mNumMeshes == 1), "Simple object: %s MUST contain only 1 mesh.", filePath);
+        BR_ASSERT((model.meshes.size() == 1), "Simple object: %s MUST contain only 1 mesh.", filePath);
 
         m_sceneObjectGroup = sceneGroup;
 
-        loadGraphicsMesh(filePath, scene, scene->mMeshes[0]);
+        loadGraphicsMesh(model.meshes[0]);
     }
 
-    SimpleObject::SimpleObject(const std::string& filePath,
-                               const aiScene* scene,
-                               const aiMesh* graphicsMesh,
+    SimpleObject::SimpleObject(const BeryllUtils::MeshView& graphicsMesh,
                                SceneObjectGroups sceneGroup)
     {
         m_sceneObjectGroup = sceneGroup;
 
-        loadGraphicsMesh(filePath, scene, graphicsMesh);
+        loadGraphicsMesh(graphicsMesh);
     }
 
     SimpleObject::~SimpleObject()
@@ -57,31 +36,13 @@ namespace Beryll
 
         BR_INFO("Load many simple objects from one file: %s", filePath);
 
-        const std::string path = filePath;
-        const size_t lastDotPos = path.find_last_of('.');
-        BR_ASSERT(lastDotPos != std::string::npos, "%s", "File does not have extension.");
-        const std::string fileExtension = path.substr(lastDotPos + 1);
-        BR_ASSERT((fileExtension == "fbx" || fileExtension == "dae"), "%s", "File extension must be fbx or dae.");
-
-        uint32_t bufferSize = 0;
-        char* buffer = BeryllUtils::File::readToBuffer(filePath, &bufferSize);
-
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFileFromMemory(buffer, bufferSize,
-                                                           aiProcess_Triangulate | aiProcess_FlipUVs |
-                                                           aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace,
-                                                           fileExtension.c_str());
-        delete[] buffer;
-        if(!scene || !scene->mRootNode || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE)
-        {
-            BR_ASSERT(false, "Scene loading error for file: %s", filePath);
-        }
+        const BeryllUtils::LoadedModel model = BeryllUtils::MeshFile::loadModel(filePath);
 
-        BR_INFO("Total objects count in file: %d", scene->mNumMeshes);
+        BR_INFO("Total objects count in file: %d", model.meshes.size());
 
-        for(int i = 0; i < scene->mNumMeshes; ++i)
+        for(const BeryllUtils::MeshView& mesh : model.meshes)
         {
-            obj = std::make_shared<SimpleObject>(filePath, scene, scene->mMeshes[i], sceneGroup);
+            obj = std::make_shared<SimpleObject>(mesh, sceneGroup);
             objects.push_back(obj);
         }
 
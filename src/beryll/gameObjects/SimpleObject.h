@@ -10,14 +10,12 @@ namespace Beryll
     public:
         SimpleObject() = delete;
         /*
-         * filePath - path to model file (.DAE or .FBX). start path from first folder inside assets/
+         * filePath - path to model file (.DAE, .FBX or cooked .bmesh). start path from first folder inside assets/
          * sceneGroup - game specific group to which this scene object belong
          */
         SimpleObject(const char* filePath,
                      SceneObjectGroups sceneGroup);
-        SimpleObject(const std::string& filePath,
-                     const aiScene* scene,
-                     const aiMesh* graphicsMesh,
+        SimpleObject(const BeryllUtils::MeshView& graphicsMesh,
                      SceneObjectGroups sceneGroup);
         ~SimpleObject() override;
 
@@ -1,9 +1,210 @@
 #include "Physics.h"
 #include "beryll/core/Log.h"
 #include "beryll/utils/Matrix.h"
+#include "beryll/utils/CommonUtils.h"
+#include "beryll/async/AsyncRun.h"
+#include "beryll/physics/PhysicsAllocator.h"
 
 namespace Beryll
 {
+    namespace
+    {
+        // Before btOptimizedBvh serialized in place. In place data is memory image of Bullet class.
+        struct SerializedBvhHeader
+        {
+            uint32_t magic = 0;
+            uint32_t bvhClassSize = 0; // sizeof(btQuantizedBvh). Differs for 32 and 64 bit platforms.
+            uint32_t scalarSize = 0;
+            uint32_t triangleCount = 0; // Of mesh BVH was built for.
+        };
+        constexpr uint32_t serializedBvhMagic = 0x48564242; // "BBVH"
+
+        // Return nullptr if BVH was cooked for other platform or mesh.
+        std::shared_ptr<btOptimizedBvh> loadConcaveMeshBvh(const std::vector<char>& serializedBvh, uint32_t triangleCount)
+        {
+            SerializedBvhHeader header;
+            if(serializedBvh.size() <= sizeof(SerializedBvhHeader))
+                return nullptr;
+
+            std::memcpy(&header, serializedBvh.data(), sizeof(SerializedBvhHeader));
+            if(header.magic != serializedBvhMagic || header.bvhClassSize != sizeof(btQuantizedBvh) ||
+               header.scalarSize != sizeof(btScalar) || header.triangleCount != triangleCount)
+            {
+                BR_WARN("%s", "Cooked BVH does not match platform or mesh. Build it at runtime.");
+                return nullptr;
+            }
+
+            // Deserialized in place. Memory must be aligned, writable and live as long as shape.
+            const unsigned int size = static_cast<unsigned int>(serializedBvh.size() - sizeof(SerializedBvhHeader));
+            void* buffer = PhysicsAllocator::allocate(size);
+            std::memcpy(buffer, serializedBvh.data() + sizeof(SerializedBvhHeader), size);
+            btOptimizedBvh* bvh = btOptimizedBvh::deSerializeInPlace(buffer, size, false);
+            if(!bvh)
+            {
+                PhysicsAllocator::deallocate(buffer);
+                return nullptr;
+            }
+
+            return std::shared_ptr<btOptimizedBvh>(bvh, [](btOptimizedBvh* ptr)
+            {
+                ptr->~btOptimizedBvh(); // Node arrays point inside buffer and are not freed.
+                PhysicsAllocator::deallocate(ptr);
+            }, PhysicsAllocator::StlAllocator<btOptimizedBvh>());
+        }
+
+        // Ray casts read RigidBodyData from user pointer. Triggers dont have it.
+        bool isTrigger(const btBroadphaseProxy* proxy)
+        {
+            return static_cast<const btCollisionObject*>(proxy->m_clientObject)->getInternalType() == btCollisionObject::CO_GHOST_OBJECT;
+        }
+
+        // Also keep triangle index of hit. Merged static meshes use it to find original object ID.
+        struct ClosestRayIgnoreTriggersCallback : public btCollisionWorld::ClosestRayResultCallback
+        {
+            ClosestRayIgnoreTriggersCallback(const btVector3& from, const btVector3& to)
+            : btCollisionWorld::ClosestRayResultCallback(from, to) {}
+
+            bool needsCollision(btBroadphaseProxy* proxy0) const override
+            {
+                return btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy0) && !isTrigger(proxy0);
+            }
+
+            btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override
+            {
+                // Called only for hits closer than previous.
+                hitTriangleIndex = rayResult.m_localShapeInfo ? rayResult.m_localShapeInfo->m_triangleIndex : -1;
+                return btCollisionWorld::ClosestRayResultCallback::addSingleResult(rayResult, normalInWorldSpace);
+            }
+
+            int hitTriangleIndex = -1;
+        };
+
+        struct AllHitsRayIgnoreTriggersCallback : public btCollisionWorld::AllHitsRayResultCallback
+        {
+            AllHitsRayIgnoreTriggersCallback(const btVector3& from, const btVector3& to)
+            : btCollisionWorld::AllHitsRayResultCallback(from, to) {}
+
+            bool needsCollision(btBroadphaseProxy* proxy0) const override
+            {
+                return btCollisionWorld::AllHitsRayResultCallback::needsCollision(proxy0) && !isTrigger(proxy0);
+            }
+
+            btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override
+            {
+                hitTriangleIndices.push_back(rayResult.m_localShapeInfo ? rayResult.m_localShapeInfo->m_triangleIndex : -1);
+                return btCollisionWorld::AllHitsRayResultCallback::addSingleResult(rayResult, normalInWorldSpace);
+            }
+
+            std::vector<int> hitTriangleIndices;
+        };
+
+        // All queries return original object IDs. Body of merged static mesh resolves them by triangle index.
+        int getObjectID(const btCollisionObject* ob, const int triangleIndex)
+        {
+            const RigidBodyData* data = static_cast<const RigidBodyData*>(ob->getUserPointer());
+            if(data && !data->triangleObjectIDs.empty())
+                return data->getObjectID(triangleIndex);
+
+            return ob->beryllEngineObjectID;
+        }
+
+        // Contact point indices are stored in order of manifold bodies.
+        int getObjectIDOnA(const btPersistentManifold* manifold, const btManifoldPoint& pt)
+        {
+            return getObjectID(manifold->getBody0(), pt.m_index0);
+        }
+
+        int getObjectIDOnB(const btPersistentManifold* manifold, const btManifoldPoint& pt)
+        {
+            return getObjectID(manifold->getBody1(), pt.m_index1);
+        }
+
+        bool getIsMerged(const btCollisionObject* ob)
+        {
+            const RigidBodyData* data = static_cast<const RigidBodyData*>(ob->getUserPointer());
+            return data && !data->triangleObjectIDs.empty();
+        }
+
+        void addPointAndNormal(const btManifoldPoint& pt, std::vector<std::pair<glm::vec3, glm::vec3>>& pointsAndNormals)
+        {
+            const btVector3& ptB = pt.getPositionWorldOnB();
+            btVector3 normalOnB = pt.m_normalWorldOnB;
+            normalOnB.normalize();
+
+            pointsAndNormals.emplace_back(glm::vec3(ptB.getX(), ptB.getY(), ptB.getZ()), // Point.
+                                          glm::normalize(glm::vec3(normalOnB.getX(), normalOnB.getY(), normalOnB.getZ()))); // Normal.
+        }
+
+        // Collect IDs of overlapped objects. Many for merged mesh.
+        struct TriggerContactCallback : public btCollisionWorld::ContactResultCallback
+        {
+            TriggerContactCallback(const btCollisionObject* g, std::vector<int>& ids) : ghost(g), overlappingIDs(ids) {}
+
+            btScalar addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* colObj0Wrap, int partId0, int index0,
+                                                          const btCollisionObjectWrapper* colObj1Wrap, int partId1, int index1) override
+            {
+                if(cp.getDistance() <= 0.0f)
+                {
+                    if(colObj0Wrap->getCollisionObject() == ghost)
+                        overlappingIDs.push_back(getObjectID(colObj1Wrap->getCollisionObject(), index1));
+                    else
+                        overlappingIDs.push_back(getObjectID(colObj0Wrap->getCollisionObject(), index0));
+                }
+
+                return 0.0f;
+            }
+
+            const btCollisionObject* ghost = nullptr;
+            std::vector<int>& overlappingIDs;
+        };
+
+        // Access to world arrays for batch removal.
+        class BeryllDynamicsWorldMt : public btDiscreteDynamicsWorldMt
+        {
+        public:
+            using btDiscreteDynamicsWorldMt::btDiscreteDynamicsWorldMt;
+
+            // Same as removeRigidBody() for each body but with one pass over non static bodies and pair cache.
+            void removeRigidBodies(std::vector<btRigidBody*>& bodies)
+            {
+                std::sort(bodies.begin(), bodies.end());
+
+                int aliveCount = 0;
+                for(int i = 0; i < m_nonStaticRigidBodies.size(); ++i)
+                {
+                    if(!std::binary_search(bodies.begin(), bodies.end(), m_nonStaticRigidBodies[i]))
+                        m_nonStaticRigidBodies[aliveCount++] = m_nonStaticRigidBodies[i];
+                }
+                m_nonStaticRigidBodies.resize(aliveCount);
+
+                std::vector<btBroadphaseProxy*> proxies;
+                proxies.reserve(bodies.size());
+                for(btRigidBody* body : bodies)
+                {
+                    if(body->getBroadphaseHandle())
+                    {
+                        proxies.push_back(body->getBroadphaseHandle());
+                        body->setBroadphaseHandle(nullptr);
+                    }
+                }
+                static_cast<btDbvtBroadphase*>(getBroadphase())->destroyProxies(proxies.data(), static_cast<int>(proxies.size()), m_dispatcher1);
+
+                for(btRigidBody* body : bodies)
+                {
+                    const int index = body->getWorldArrayIndex();
+                    if(index >= 0 && index < m_collisionObjects.size())
+                    {
+                        m_collisionObjects.swap(index, m_collisionObjects.size() - 1);
+                        m_collisionObjects.pop_back();
+                        if(index < m_collisionObjects.size())
+                            m_collisionObjects[index]->setWorldArrayIndex(index);
+                    }
+                    body->setWorldArrayIndex(-1);
+                }
+            }
+        };
+    }
+
     Timer Physics::m_timer;
     float Physics::m_timeStep = 0.0f;
     float Physics::m_minAcceptableFPS = 5.0f;
@@ -16,8 +217,13 @@ namespace Beryll
 
     std::vector<std::shared_ptr<btCollisionShape>> Physics::m_collisionShapes;
     std::vector<std::shared_ptr<btTriangleMesh>> Physics::m_triangleMeshes;
+    std::vector<std::shared_ptr<btOptimizedBvh>> Physics::m_concaveMeshBvhs;
     std::vector<std::shared_ptr<btDefaultMotionState>> Physics::m_motionStates;
     std::map<const int, std::shared_ptr<RigidBodyData>> Physics::m_rigidBodiesMap;
+    std::unordered_map<int, int> Physics::m_mergedObjectIDs;
+    std::map<const int, std::shared_ptr<TriggerData>> Physics::m_triggersMap;
+    std::unique_ptr<btGhostPairCallback> Physics::m_ghostPairCallback = nullptr;
+    const std::vector<int> Physics::m_emptyIDs;
 
     std::unique_ptr<btDefaultCollisionConfiguration> Physics::m_collisionConfiguration = nullptr;
     std::unique_ptr<btCollisionDispatcherMt> Physics::m_dispatcherMT = nullptr;
@@ -26,10 +232,17 @@ namespace Beryll
     std::unique_ptr<btSequentialImpulseConstraintSolverMt> Physics::m_constraintSolverMT = nullptr;
     std::unique_ptr<btDiscreteDynamicsWorldMt> Physics::m_dynamicsWorldMT = nullptr;
 
+    std::vector<Physics::PendingObject> Physics::m_pendingObjects;
+    int Physics::m_addBatchDepth = 0;
+    std::vector<int> Physics::m_pendingRemoveIDs;
+    int Physics::m_removeBatchDepth = 0;
+
     void Physics::create()
     {
         if(m_dynamicsWorldMT) { return; }
 
+        PhysicsAllocator::create(); // Before any Bullet allocation.
+
         btSetTaskScheduler(btCreateTaskSchedulerForBeryll());
 
         BR_INFO("Number of available threads for TaskScheduler: %d", btGetTaskScheduler()->getNumThreads());
@@ -43,17 +256,22 @@ namespace Beryll
         // Let pool of solvers be 2 times more than available threads on device.
         m_solverPoolMT = std::make_unique<btConstraintSolverPoolMt>(btGetTaskScheduler()->getNumThreads() * 2);
         m_constraintSolverMT = std::make_unique<btSequentialImpulseConstraintSolverMt>();
-        m_dynamicsWorldMT = std::make_unique<btDiscreteDynamicsWorldMt>(m_dispatcherMT.get(),
-                                                                        m_broadPhase.get(),
-                                                                        m_solverPoolMT.get(),
-                                                                        m_constraintSolverMT.get(),
-                                                                        m_collisionConfiguration.get());
+        m_dynamicsWorldMT = std::make_unique<BeryllDynamicsWorldMt>(m_dispatcherMT.get(),
+                                                                    m_broadPhase.get(),
+                                                                    m_solverPoolMT.get(),
+                                                                    m_constraintSolverMT.get(),
+                                                                    m_collisionConfiguration.get());
 
         m_dynamicsWorldMT->setGravity(btVector3(0.0f, -10.0f, 0.0f));
 
         // Set collisions call backs to bullet.
         gContactAddedCallback = collisionsCallBack;
 
+        // Ghost objects (triggers) keep own pair cache. Skip them in narrow phase of world.
+        m_ghostPairCallback = std::make_unique<btGhostPairCallback>();
+        m_broadPhase->getOverlappingPairCache()->setInternalGhostPairCallback(m_ghostPairCallback.get());
+        m_dispatcherMT->setNearCallback(nearCallbackSkipTriggers);
+
         m_collisionPairs.reserve(10000);
     }
 
@@ -80,6 +298,8 @@ namespace Beryll
                                           m_resolutionFactor + 1,
                                           m_timeStep / static_cast<float>(m_resolutionFactor));
 
+        updateTriggers();
+
         m_simulationTime = m_timer.getElapsedMilliSec();
         //BR_INFO("m_dynamicsWorldMT objects count: %d", m_dynamicsWorldMT->getNumCollisionObjects());
         //BR_INFO("m_rigidBodiesMap objects count : %d", m_rigidBodiesMap.size());
@@ -95,78 +315,121 @@ namespace Beryll
                             bool wantCallBack,
                             CollisionFlags collFlag,
                             CollisionGroups collGroup,
-                            CollisionGroups collMask)
+                            CollisionGroups collMask,
+                            const std::vector<char>& serializedBvh)
     {
         BR_INFO("Physics::addObject name: %s, mass: %f, ID: %d", meshName.c_str(), mass, objectID);
 
-        if(meshName.find("CollisionConcaveMesh") != std::string::npos)
-        {
-            addConcaveMesh(vertices, indices, transforms, objectID, mass, wantCallBack, collFlag, collGroup, collMask);
-        }
-        else if(meshName.find("CollisionConvexMesh") != std::string::npos)
-        {
-            addConvexMesh(vertices, indices, transforms, objectID, mass, wantCallBack, collFlag, collGroup, collMask);
-        }
-        else if(meshName.find("CollisionBox") != std::string::npos)
+        if(m_addBatchDepth > 0)
         {
-            addBoxShape(vertices, transforms, objectID, mass, wantCallBack, collFlag, collGroup, collMask);
-        }
-        else if(meshName.find("CollisionSphere") != std::string::npos)
-        {
-            addSphereShape(vertices, transforms, objectID, mass, wantCallBack, collFlag, collGroup, collMask);
+            // Will be built in parallel and inserted in endAddBatch().
+            m_pendingObjects.push_back(PendingObject{vertices, indices, transforms, meshName, objectID, mass,
+                                                     wantCallBack, collFlag, collGroup, collMask, serializedBvh, BuiltObject{}});
+            return;
         }
-        else if(meshName.find("CollisionCapsule") != std::string::npos)
+
+        BuiltObject built = buildObject(vertices, indices, transforms, meshName, mass, collFlag, serializedBvh);
+        built.rigidBodyData = createBody(built, objectID, mass, wantCallBack, collFlag, collGroup, collMask);
+        insertBuiltObject(built);
+    }
+
+    void Physics::beginAddBatch(int expectedCount)
+    {
+        if(m_addBatchDepth == 0)
+            m_pendingObjects.reserve(expectedCount);
+
+        ++m_addBatchDepth;
+    }
+
+    void Physics::endAddBatch()
+    {
+        BR_ASSERT((m_addBatchDepth > 0), "%s", "endAddBatch() called without beginAddBatch().");
+
+        --m_addBatchDepth;
+        if(m_addBatchDepth > 0 || m_pendingObjects.empty())
+            return;
+
+        Timer timer;
+
+        // Shapes and motion states dont touch world or containers during build. Safe in parallel.
+        if(m_pendingObjects.size() > 1)
         {
-            addCapsuleShape(vertices, transforms, objectID, mass, wantCallBack, collFlag, collGroup, collMask);
+            AsyncRun::Run(m_pendingObjects, std::function<void(std::vector<PendingObject>&, int, int)>(
+                [](std::vector<PendingObject>& v, int begin, int end) -> void // -> void = return type.
+                {
+                    for(int i = begin; i < end; ++i)
+                    {
+                        v[i].built = Physics::buildObject(v[i].vertices, v[i].indices, v[i].transforms, v[i].meshName, v[i].mass, v[i].collFlag,
+                                                      v[i].serializedBvh);
+                    }
+                }));
         }
-        else if(meshName.find("CollisionCylinder") != std::string::npos)
+        else
         {
-            addCylinderShape(vertices, transforms, objectID, mass, wantCallBack, collFlag, collGroup, collMask);
+            PendingObject& obj = m_pendingObjects[0];
+            obj.built = buildObject(obj.vertices, obj.indices, obj.transforms, obj.meshName, obj.mass, obj.collFlag, obj.serializedBvh);
         }
-        else
+
+        // IDs are generated in increasing order. Sorted insert lets map use end() hint.
+        std::sort(m_pendingObjects.begin(), m_pendingObjects.end(),
+                  [](const PendingObject& a, const PendingObject& b) { return a.objectID < b.objectID; });
+
+        m_collisionShapes.reserve(m_collisionShapes.size() + m_pendingObjects.size());
+        m_motionStates.reserve(m_motionStates.size() + m_pendingObjects.size());
+
+        for(PendingObject& obj : m_pendingObjects)
         {
-            BR_ASSERT(false, "Collision shape not supported: %s", meshName.c_str());
+            obj.built.rigidBodyData = createBody(obj.built, obj.objectID, obj.mass, obj.wantCallBack, obj.collFlag, obj.collGroup, obj.collMask);
+            insertBuiltObject(obj.built);
         }
+
+        // Many new proxies were inserted one by one. Rebuild broad phase trees once.
+        if(m_pendingObjects.size() >= m_minBatchSizeForBroadPhaseOptimize)
+            m_broadPhase->optimize();
+
+        BR_INFO("Physics::endAddBatch objects: %d, time millisec: %f", int(m_pendingObjects.size()), timer.getElapsedMilliSec());
+
+        m_pendingObjects.clear();
+        m_pendingObjects.shrink_to_fit(); // Release copied vertices.
     }
 
-    void Physics::addConcaveMesh(const std::vector<glm::vec3>& vertices,
-                                 const std::vector<uint32_t>& indices,
-                                 const glm::mat4& transforms,
-                                 const int objectID,
-                                 float mass,
-                                 bool wantCallBack,
-                                 CollisionFlags collFlag,
-                                 CollisionGroups collGroup,
-                                 CollisionGroups collMask)
+    Physics::BuiltObject Physics::buildObject(const std::vector<glm::vec3>& vertices,
+                                              const std::vector<uint32_t>& indices,
+                                              const glm::mat4& transforms,
+                                              const std::string& meshName,
+                                              float mass,
+                                              CollisionFlags collFlag,
+                                              const std::vector<char>& serializedBvh)
     {
-        BR_ASSERT((mass == 0.0f), "%s", "ConcaveMesh can be only static or kinematic. mass = 0.");
-        BR_ASSERT((collFlag != CollisionFlags::DYNAMIC), "%s", "ConcaveMesh can be only static or kinematic.");
         BR_ASSERT((vertices.empty() == false), "%s", "Vertices empty.");
 
-        glm::vec3 vertex1;
-        glm::vec3 vertex2;
-        glm::vec3 vertex3;
-
-        std::shared_ptr<btTriangleMesh> triangleMesh = std::make_shared<btTriangleMesh>();
-        m_triangleMeshes.push_back(triangleMesh);
-        triangleMesh->preallocateVertices(indices.size());
+        BuiltObject built;
 
-        for(int i = 0; i < indices.size(); )
+        if(meshName.find("CollisionConcaveMesh") != std::string::npos)
         {
-            vertex1 = vertices[indices[i]];
-            ++i;
-            vertex2 = vertices[indices[i]];
-            ++i;
-            vertex3 = vertices[indices[i]];
-            ++i;
+            BR_ASSERT((mass == 0.0f), "%s", "ConcaveMesh can be only static or kinematic. mass = 0.");
+            BR_ASSERT((collFlag != CollisionFlags::DYNAMIC), "%s", "ConcaveMesh can be only static or kinematic.");
 
-            triangleMesh->addTriangle(btVector3(vertex1.x, vertex1.y, vertex1.z),
-                                      btVector3(vertex2.x, vertex2.y, vertex2.z),
-                                      btVector3(vertex3.x, vertex3.y, vertex3.z));
+            built.shape = createConcaveMeshShape(vertices, indices, serializedBvh, built.triangleMesh, built.bvh);
+        }
+        else
+        {
+            BR_ASSERT(((mass == 0.0f && collFlag != CollisionFlags::DYNAMIC) ||
+                       (mass > 0.0f && collFlag == CollisionFlags::DYNAMIC)), "Wrong parameters for shape: %s", meshName.c_str());
+
+            if(meshName.find("CollisionConvexMesh") != std::string::npos)
+                built.shape = createConvexMeshShape(vertices, indices);
+            else if(meshName.find("CollisionBox") != std::string::npos)
+                built.shape = createBoxShape(vertices);
+            else if(meshName.find("CollisionSphere") != std::string::npos)
+                built.shape = createSphereShape(vertices);
+            else if(meshName.find("CollisionCapsule") != std::string::npos)
+                built.shape = createCapsuleShape(vertices);
+            else if(meshName.find("CollisionCylinder") != std::string::npos)
+                built.shape = createCylinderShape(vertices);
+            else
+                BR_ASSERT(false, "Collision shape not supported: %s", meshName.c_str());
         }
-
-        std::shared_ptr<btBvhTriangleMeshShape> shape = std::make_shared<btBvhTriangleMeshShape>(triangleMesh.get(), true, true);
-        m_collisionShapes.push_back(shape);
 
         glm::vec3 transl = BeryllUtils::Matrix::getTranslationFrom4x4Glm(transforms);
         glm::quat rot = BeryllUtils::Matrix::getRotationFrom4x4Glm(transforms);
@@ -175,100 +438,145 @@ namespace Beryll
         startTransform.setOrigin(btVector3(transl.x, transl.y, transl.z));
         startTransform.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
 
-        btVector3 localInertia(0, 0, 0);
         if(mass != 0.0f)
-            shape->calculateLocalInertia(mass, localInertia);
+            built.shape->calculateLocalInertia(mass, built.localInertia);
 
-        std::shared_ptr<btDefaultMotionState> motionState = std::make_shared<btDefaultMotionState>(startTransform);
-        m_motionStates.push_back(motionState);
-        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState.get(), shape.get(), localInertia);
-        std::shared_ptr<btRigidBody> body = std::make_shared<btRigidBody>(rbInfo, objectID);
+        built.motionState = PhysicsAllocator::makeShared<btDefaultMotionState>(startTransform);
+
+        return built;
+    }
+
+    std::shared_ptr<RigidBodyData> Physics::createBody(const BuiltObject& built,
+                                                       const int objectID,
+                                                       float mass,
+                                                       bool wantCallBack,
+                                                       CollisionFlags collFlag,
+                                                       CollisionGroups collGroup,
+                                                       CollisionGroups collMask)
+    {
+        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, built.motionState.get(), built.shape.get(), built.localInertia);
+        std::shared_ptr<btRigidBody> body = PhysicsAllocator::makeShared<btRigidBody>(rbInfo, objectID);
 
-        std::shared_ptr<RigidBodyData> rigidBodyData = std::make_shared<RigidBodyData>(objectID, body, true, collGroup, collMask, collFlag, mass);
+        std::shared_ptr<RigidBodyData> rigidBodyData = PhysicsAllocator::makeShared<RigidBodyData>(objectID, body, true, collGroup, collMask, collFlag, mass);
         body->setUserPointer(rigidBodyData.get()); // Then we can fetch this rigidBodyData from CollisionObject->getUserPointer().
 
         if(collFlag == CollisionFlags::STATIC && mass == 0.0f)
             body->setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT);
         else if(collFlag == CollisionFlags::KINEMATIC && mass == 0.0f)
             body->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
+        else if(collFlag == CollisionFlags::DYNAMIC && mass > 0.0f)
+            body->setCollisionFlags(btCollisionObject::CF_DYNAMIC_OBJECT);
 
         if(wantCallBack)
             body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
 
-        m_rigidBodiesMap.insert(std::make_pair(objectID, rigidBodyData));
-        m_dynamicsWorldMT->addRigidBody(body.get(), static_cast<int>(collGroup), static_cast<int>(collMask));
+        return rigidBodyData;
     }
 
-    void Physics::addConvexMesh(const std::vector<glm::vec3>& vertices,
-                                const std::vector<uint32_t>& indices,
-                                const glm::mat4& transforms,
-                                const int objectID,
-                                float mass,
-                                bool wantCallBack,
-                                CollisionFlags collFlag,
-                                CollisionGroups collGroup,
-                                CollisionGroups collMask)
+    void Physics::insertBuiltObject(const BuiltObject& built)
     {
-        BR_ASSERT(((mass == 0.0f && collFlag != CollisionFlags::DYNAMIC) ||
-                   (mass > 0.0f && collFlag == CollisionFlags::DYNAMIC)), "%s", "Wrong parameters for convex mesh.");
-        BR_ASSERT((vertices.empty() == false), "%s", "Vertices empty.");
+        if(built.triangleMesh)
+            m_triangleMeshes.push_back(built.triangleMesh);
+        if(built.bvh)
+            m_concaveMeshBvhs.push_back(built.bvh);
+        m_collisionShapes.push_back(built.shape);
+        m_motionStates.push_back(built.motionState);
+
+        const RigidBodyData& data = *built.rigidBodyData;
+        m_rigidBodiesMap.emplace_hint(m_rigidBodiesMap.end(), data.bodyID, built.rigidBodyData);
+        m_dynamicsWorldMT->addRigidBody(data.rb.get(), static_cast<int>(data.collGroup), static_cast<int>(data.collMask));
+    }
 
-        // btConvexHullShape should have less that 100 vertices for better performance.
-        std::shared_ptr<btConvexHullShape> shape = std::make_shared<btConvexHullShape>();
-        m_collisionShapes.push_back(shape);
+    std::shared_ptr<btCollisionShape> Physics::createConcaveMeshShape(const std::vector<glm::vec3>& vertices,
+                                                                      const std::vector<uint32_t>& indices,
+                                                                      const std::vector<char>& serializedBvh,
+                                                                      std::shared_ptr<btTriangleMesh>& triangleMesh,
+                                                                      std::shared_ptr<btOptimizedBvh>& bvh)
+    {
+        glm::vec3 vertex1;
+        glm::vec3 vertex2;
+        glm::vec3 vertex3;
 
-        for(int i = 0; i < indices.size(); ++i)
+        triangleMesh = PhysicsAllocator::makeShared<btTriangleMesh>();
+        triangleMesh->preallocateVertices(indices.size());
+
+        for(int i = 0; i < indices.size(); )
         {
-            shape->addPoint(btVector3(vertices[indices[i]].x, vertices[indices[i]].y, vertices[indices[i]].z), false);
+            vertex1 = vertices[indices[i]];
+            ++i;
+            vertex2 = vertices[indices[i]];
+            ++i;
+            vertex3 = vertices[indices[i]];
+            ++i;
+
+            triangleMesh->addTriangle(btVector3(vertex1.x, vertex1.y, vertex1.z),
+                                      btVector3(vertex2.x, vertex2.y, vertex2.z),
+                                      btVector3(vertex3.x, vertex3.y, vertex3.z));
         }
-        shape->recalcLocalAabb();
 
-        glm::vec3 transl = BeryllUtils::Matrix::getTranslationFrom4x4Glm(transforms);
-        glm::quat rot = BeryllUtils::Matrix::getRotationFrom4x4Glm(transforms);
-        btTransform startTransform;
-        startTransform.setIdentity();
-        startTransform.setOrigin(btVector3(transl.x, transl.y, transl.z));
-        startTransform.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
+        if(!serializedBvh.empty())
+            bvh = loadConcaveMeshBvh(serializedBvh, static_cast<uint32_t>(indices.size() / 3));
 
-        btVector3 localInertia(0, 0, 0);
-        if(mass != 0.0f)
-            shape->calculateLocalInertia(mass, localInertia);
+        if(bvh)
+        {
+            // Cooked from same triangles. Building BVH is skipped.
+            std::shared_ptr<btBvhTriangleMeshShape> shape = PhysicsAllocator::makeShared<btBvhTriangleMeshShape>(triangleMesh.get(), true, false);
+            shape->setOptimizedBvh(bvh.get());
+            return shape;
+        }
 
-        std::shared_ptr<btDefaultMotionState> motionState = std::make_shared<btDefaultMotionState>(startTransform);
-        m_motionStates.push_back(motionState);
-        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState.get(), shape.get(), localInertia);
-        std::shared_ptr<btRigidBody> body = std::make_shared<btRigidBody>(rbInfo, objectID);
+        return PhysicsAllocator::makeShared<btBvhTriangleMeshShape>(triangleMesh.get(), true, true);
+    }
 
-        std::shared_ptr<RigidBodyData> rigidBodyData = std::make_shared<RigidBodyData>(objectID, body, true, collGroup, collMask, collFlag, mass);
-        body->setUserPointer(rigidBodyData.get()); // Then we can fetch this rigidBodyData from CollisionObject->getUserPointer().
+    std::vector<char> Physics::serializeConcaveMeshBvh(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices)
+    {
+        std::shared_ptr<btTriangleMesh> triangleMesh;
+        std::shared_ptr<btOptimizedBvh> loadedBvh;
+        const std::shared_ptr<btCollisionShape> shape = createConcaveMeshShape(vertices, indices, {}, triangleMesh, loadedBvh);
+        const btOptimizedBvh* bvh = static_cast<btBvhTriangleMeshShape*>(shape.get())->getOptimizedBvh();
+        if(!bvh)
+            return {};
+
+        SerializedBvhHeader header;
+        header.magic = serializedBvhMagic;
+        header.bvhClassSize = sizeof(btQuantizedBvh);
+        header.scalarSize = sizeof(btScalar);
+        header.triangleCount = static_cast<uint32_t>(indices.size() / 3);
+
+        // serializeInPlace() needs aligned memory.
+        const unsigned int size = bvh->calculateSerializeBufferSize();
+        void* buffer = PhysicsAllocator::allocate(size);
+        const bool isSerialized = bvh->serializeInPlace(buffer, size, false);
+
+        std::vector<char> serializedBvh;
+        if(isSerialized)
+        {
+            serializedBvh.resize(sizeof(SerializedBvhHeader) + size);
+            std::memcpy(serializedBvh.data(), &header, sizeof(SerializedBvhHeader));
+            std::memcpy(serializedBvh.data() + sizeof(SerializedBvhHeader), buffer, size);
+        }
+        PhysicsAllocator::deallocate(buffer);
 
-        if(collFlag == CollisionFlags::STATIC && mass == 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT);
-        else if(collFlag == CollisionFlags::KINEMATIC && mass == 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
-        else if(collFlag == CollisionFlags::DYNAMIC && mass > 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_DYNAMIC_OBJECT);
+        return serializedBvh;
+    }
 
-        if(wantCallBack)
-            body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
+    std::shared_ptr<btCollisionShape> Physics::createConvexMeshShape(const std::vector<glm::vec3>& vertices,
+                                                                     const std::vector<uint32_t>& indices)
+    {
+        // btConvexHullShape should have less that 100 vertices for better performance.
+        std::shared_ptr<btConvexHullShape> shape = PhysicsAllocator::makeShared<btConvexHullShape>();
 
-        m_rigidBodiesMap.insert(std::make_pair(objectID, rigidBodyData));
-        m_dynamicsWorldMT->addRigidBody(body.get(), static_cast<int>(collGroup), static_cast<int>(collMask));
+        for(int i = 0; i < indices.size(); ++i)
+        {
+            shape->addPoint(btVector3(vertices[indices[i]].x, vertices[indices[i]].y, vertices[indices[i]].z), false);
+        }
+        shape->recalcLocalAabb();
+
+        return shape;
     }
 
-    void Physics::addBoxShape(const std::vector<glm::vec3>& vertices,
-                              const glm::mat4& transforms,
-                              const int objectID,
-                              float mass,
-                              bool wantCallBack,
-                              CollisionFlags collFlag,
-                              CollisionGroups collGroup,
-                              CollisionGroups collMask)
+    std::shared_ptr<btCollisionShape> Physics::createBoxShape(const std::vector<glm::vec3>& vertices)
     {
-        BR_ASSERT(((mass == 0.0f && collFlag != CollisionFlags::DYNAMIC) ||
-                   (mass > 0.0f && collFlag == CollisionFlags::DYNAMIC)), "%s", "Wrong parameters for box shape.");
-        BR_ASSERT((vertices.empty() == false), "%s", "Vertices empty.");
-
         float bottomX = std::numeric_limits<float>::max();
         float topX = std::numeric_limits<float>::min();
         float bottomY = std::numeric_limits<float>::max();
@@ -292,106 +600,18 @@ namespace Beryll
         float ySize = topY - bottomY;
         float zSize = topZ - bottomZ;
 
-        std::shared_ptr<btBoxShape> boxShape = std::make_shared<btBoxShape>(btVector3(xSize / 2.0f, ySize / 2.0f, zSize / 2.0f));
-        m_collisionShapes.push_back(boxShape);
-
-        glm::vec3 transl = BeryllUtils::Matrix::getTranslationFrom4x4Glm(transforms);
-        glm::quat rot = BeryllUtils::Matrix::getRotationFrom4x4Glm(transforms);
-        btTransform startTransform;
-        startTransform.setIdentity();
-        startTransform.setOrigin(btVector3(transl.x, transl.y, transl.z));
-        startTransform.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
-
-        btVector3 localInertia(0, 0, 0);
-        if(mass != 0.0f)
-            boxShape->calculateLocalInertia(mass, localInertia);
-
-        std::shared_ptr<btDefaultMotionState> motionState = std::make_shared<btDefaultMotionState>(startTransform);
-        m_motionStates.push_back(motionState);
-        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState.get(), boxShape.get(), localInertia);
-        std::shared_ptr<btRigidBody> body = std::make_shared<btRigidBody>(rbInfo, objectID);
-
-        std::shared_ptr<RigidBodyData> rigidBodyData = std::make_shared<RigidBodyData>(objectID, body, true, collGroup, collMask, collFlag, mass);
-        body->setUserPointer(rigidBodyData.get()); // Then we can fetch this rigidBodyData from CollisionObject->getUserPointer().
-
-        if(collFlag == CollisionFlags::STATIC && mass == 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT);
-        else if(collFlag == CollisionFlags::KINEMATIC && mass == 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
-        else if(collFlag == CollisionFlags::DYNAMIC && mass > 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_DYNAMIC_OBJECT);
-
-        if(wantCallBack)
-            body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
-
-        m_rigidBodiesMap.insert(std::make_pair(objectID, rigidBodyData));
-        m_dynamicsWorldMT->addRigidBody(body.get(), static_cast<int>(collGroup), static_cast<int>(collMask));
+        return PhysicsAllocator::makeShared<btBoxShape>(btVector3(xSize / 2.0f, ySize / 2.0f, zSize / 2.0f));
     }
 
-    void Physics::addSphereShape(const std::vector<glm::vec3>& vertices,
-                        const glm::mat4& transforms,
-                        const int objectID,
-                        float mass,
-                        bool wantCallBack,
-                        CollisionFlags collFlag,
-                        CollisionGroups collGroup,
-                        CollisionGroups collMask)
+    std::shared_ptr<btCollisionShape> Physics::createSphereShape(const std::vector<glm::vec3>& vertices)
     {
-        BR_ASSERT(((mass == 0.0f && collFlag != CollisionFlags::DYNAMIC) ||
-                   (mass > 0.0f && collFlag == CollisionFlags::DYNAMIC)), "%s", "Wrong parameters for sphere shape.");
-        BR_ASSERT((vertices.empty() == false), "%s", "Vertices empty.");
-
         float radius = glm::length(vertices[0]);
 
-        std::shared_ptr<btSphereShape> sphereShape = std::make_shared<btSphereShape>(radius);
-        m_collisionShapes.push_back(sphereShape);
-
-        glm::vec3 transl = BeryllUtils::Matrix::getTranslationFrom4x4Glm(transforms);
-        glm::quat rot = BeryllUtils::Matrix::getRotationFrom4x4Glm(transforms);
-        btTransform startTransform;
-        startTransform.setIdentity();
-        startTransform.setOrigin(btVector3(transl.x, transl.y, transl.z));
-        startTransform.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
-
-        btVector3 localInertia(0, 0, 0);
-        if(mass != 0.0f)
-            sphereShape->calculateLocalInertia(mass, localInertia);
-
-        std::shared_ptr<btDefaultMotionState> motionState = std::make_shared<btDefaultMotionState>(startTransform);
-        m_motionStates.push_back(motionState);
-        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState.get(), sphereShape.get(), localInertia);
-        std::shared_ptr<btRigidBody> body = std::make_shared<btRigidBody>(rbInfo, objectID);
-
-        std::shared_ptr<RigidBodyData> rigidBodyData = std::make_shared<RigidBodyData>(objectID, body, true, collGroup, collMask, collFlag, mass);
-        body->setUserPointer(rigidBodyData.get()); // Then we can fetch this rigidBodyData from CollisionObject->getUserPointer().
-
-        if(collFlag == CollisionFlags::STATIC && mass == 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT);
-        else if(collFlag == CollisionFlags::KINEMATIC && mass == 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
-        else if(collFlag == CollisionFlags::DYNAMIC && mass > 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_DYNAMIC_OBJECT);
-
-        if(wantCallBack)
-            body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
-
-        m_rigidBodiesMap.insert(std::make_pair(objectID, rigidBodyData));
-        m_dynamicsWorldMT->addRigidBody(body.get(), static_cast<int>(collGroup), static_cast<int>(collMask));
+        return PhysicsAllocator::makeShared<btSphereShape>(radius);
     }
 
-    void Physics::addCapsuleShape(const std::vector<glm::vec3>& vertices,
-                                const glm::mat4& transforms,
-                                const int objectID,
-                                float mass,
-                                bool wantCallBack,
-                                CollisionFlags collFlag,
-                                CollisionGroups collGroup,
-                                CollisionGroups collMask)
+    std::shared_ptr<btCollisionShape> Physics::createCapsuleShape(const std::vector<glm::vec3>& vertices)
     {
-        BR_ASSERT(((mass == 0.0f && collFlag != CollisionFlags::DYNAMIC) ||
-                   (mass > 0.0f && collFlag == CollisionFlags::DYNAMIC)), "%s", "Wrong parameters for capsule shape.");
-        BR_ASSERT((vertices.empty() == false), "%s", "Vertices empty.");
-
         float bottomX = std::numeric_limits<float>::max();
         float topX = std::numeric_limits<float>::min();
         float bottomZ = std::numeric_limits<float>::max();
@@ -412,55 +632,11 @@ namespace Beryll
 
         // Originally capsule should be created in Blender around Z axis.
         // Next you can rotate it and move to desired position.
-        std::shared_ptr<btCapsuleShapeZ> capsuleShape = std::make_shared<btCapsuleShapeZ>(radius, (totalHeight - radius * 2.0f));
-        m_collisionShapes.push_back(capsuleShape);
-
-        glm::vec3 transl = BeryllUtils::Matrix::getTranslationFrom4x4Glm(transforms);
-        glm::quat rot = BeryllUtils::Matrix::getRotationFrom4x4Glm(transforms);
-        btTransform startTransform;
-        startTransform.setIdentity();
-        startTransform.setOrigin(btVector3(transl.x, transl.y, transl.z));
-        startTransform.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
-
-        btVector3 localInertia(0, 0, 0);
-        if(mass != 0.0f)
-            capsuleShape->calculateLocalInertia(mass, localInertia);
-
-        std::shared_ptr<btDefaultMotionState> motionState = std::make_shared<btDefaultMotionState>(startTransform);
-        m_motionStates.push_back(motionState);
-        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState.get(), capsuleShape.get(), localInertia);
-        std::shared_ptr<btRigidBody> body = std::make_shared<btRigidBody>(rbInfo, objectID);
-
-        std::shared_ptr<RigidBodyData> rigidBodyData = std::make_shared<RigidBodyData>(objectID, body, true, collGroup, collMask, collFlag, mass);
-        body->setUserPointer(rigidBodyData.get()); // Then we can fetch this rigidBodyData from CollisionObject->getUserPointer().
-
-        if(collFlag == CollisionFlags::STATIC && mass == 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT);
-        else if(collFlag == CollisionFlags::KINEMATIC && mass == 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
-        else if(collFlag == CollisionFlags::DYNAMIC && mass > 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_DYNAMIC_OBJECT);
-
-        if(wantCallBack)
-            body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
-
-        m_rigidBodiesMap.insert(std::make_pair(objectID, rigidBodyData));
-        m_dynamicsWorldMT->addRigidBody(body.get(), static_cast<int>(collGroup), static_cast<int>(collMask));
+        return PhysicsAllocator::makeShared<btCapsuleShapeZ>(radius, (totalHeight - radius * 2.0f));
     }
 
-    void Physics::addCylinderShape(const std::vector<glm::vec3>& vertices,
-                                   const glm::mat4& transforms,
-                                   const int objectID,
-                                   float mass,
-                                   bool wantCallBack,
-                                   CollisionFlags collFlag,
-                                   CollisionGroups collGroup,
-                                   CollisionGroups collMask)
+    std::shared_ptr<btCollisionShape> Physics::createCylinderShape(const std::vector<glm::vec3>& vertices)
     {
-        BR_ASSERT(((mass == 0.0f && collFlag != CollisionFlags::DYNAMIC) ||
-                   (mass > 0.0f && collFlag == CollisionFlags::DYNAMIC)), "%s", "Wrong parameters for capsule shape.");
-        BR_ASSERT((vertices.empty() == false), "%s", "Vertices empty.");
-
         float bottomX = std::numeric_limits<float>::max();
         float topX = std::numeric_limits<float>::min();
         float bottomY = std::numeric_limits<float>::max();
@@ -486,40 +662,65 @@ namespace Beryll
 
         // Originally cylinder should be created in Blender around Z axis.
         // Next you can rotate it and move to desired position.
-        std::shared_ptr<btCylinderShapeZ> cylinderShape = std::make_shared<btCylinderShapeZ>(btVector3(xSize / 2.0f, ySize / 2.0f, zSize / 2.0f));
-        m_collisionShapes.push_back(cylinderShape);
+        return PhysicsAllocator::makeShared<btCylinderShapeZ>(btVector3(xSize / 2.0f, ySize / 2.0f, zSize / 2.0f));
+    }
+
+    int Physics::addMergedStaticConcaveMesh(const std::vector<glm::vec3>& vertices,
+                                            const std::vector<uint32_t>& indices,
+                                            std::vector<int> triangleObjectIDs,
+                                            bool wantCallBack,
+                                            CollisionGroups collGroup,
+                                            CollisionGroups collMask)
+    {
+        BR_ASSERT((vertices.empty() == false), "%s", "Vertices empty.");
+        BR_ASSERT((indices.size() / 3 == triangleObjectIDs.size()), "%s", "Each triangle should have object ID.");
+        // Quantized BVH stores triangle index in 21 bits.
+        BR_ASSERT((triangleObjectIDs.size() < (1 << 21)), "Too many triangles in merged mesh: %d. Decrease cell size.", int(triangleObjectIDs.size()));
+
+        const int mergedID = BeryllUtils::Common::generateID();
+
+        std::shared_ptr<btTriangleMesh> triangleMesh = PhysicsAllocator::makeShared<btTriangleMesh>();
+        m_triangleMeshes.push_back(triangleMesh);
+        triangleMesh->preallocateVertices(indices.size());
+
+        for(int i = 0; i < indices.size(); i += 3)
+        {
+            const glm::vec3& vertex1 = vertices[indices[i]];
+            const glm::vec3& vertex2 = vertices[indices[i + 1]];
+            const glm::vec3& vertex3 = vertices[indices[i + 2]];
+
+            triangleMesh->addTriangle(btVector3(vertex1.x, vertex1.y, vertex1.z),
+                                      btVector3(vertex2.x, vertex2.y, vertex2.z),
+                                      btVector3(vertex3.x, vertex3.y, vertex3.z));
+        }
+
+        std::shared_ptr<btBvhTriangleMeshShape> shape = PhysicsAllocator::makeShared<btBvhTriangleMeshShape>(triangleMesh.get(), true, true);
+        m_collisionShapes.push_back(shape);
 
-        glm::vec3 transl = BeryllUtils::Matrix::getTranslationFrom4x4Glm(transforms);
-        glm::quat rot = BeryllUtils::Matrix::getRotationFrom4x4Glm(transforms);
         btTransform startTransform;
         startTransform.setIdentity();
-        startTransform.setOrigin(btVector3(transl.x, transl.y, transl.z));
-        startTransform.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
-
-        btVector3 localInertia(0, 0, 0);
-        if(mass != 0.0f)
-            cylinderShape->calculateLocalInertia(mass, localInertia);
 
-        std::shared_ptr<btDefaultMotionState> motionState = std::make_shared<btDefaultMotionState>(startTransform);
+        std::shared_ptr<btDefaultMotionState> motionState = PhysicsAllocator::makeShared<btDefaultMotionState>(startTransform);
         m_motionStates.push_back(motionState);
-        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, motionState.get(), cylinderShape.get(), localInertia);
-        std::shared_ptr<btRigidBody> body = std::make_shared<btRigidBody>(rbInfo, objectID);
+        btRigidBody::btRigidBodyConstructionInfo rbInfo(0.0f, motionState.get(), shape.get(), btVector3(0, 0, 0));
+        std::shared_ptr<btRigidBody> body = PhysicsAllocator::makeShared<btRigidBody>(rbInfo, mergedID);
 
-        std::shared_ptr<RigidBodyData> rigidBodyData = std::make_shared<RigidBodyData>(objectID, body, true, collGroup, collMask, collFlag, mass);
+        std::shared_ptr<RigidBodyData> rigidBodyData = PhysicsAllocator::makeShared<RigidBodyData>(mergedID, body, true, collGroup, collMask, CollisionFlags::STATIC, 0.0f);
+        rigidBodyData->triangleObjectIDs = std::move(triangleObjectIDs);
         body->setUserPointer(rigidBodyData.get()); // Then we can fetch this rigidBodyData from CollisionObject->getUserPointer().
-
-        if(collFlag == CollisionFlags::STATIC && mass == 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT);
-        else if(collFlag == CollisionFlags::KINEMATIC && mass == 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_KINEMATIC_OBJECT);
-        else if(collFlag == CollisionFlags::DYNAMIC && mass > 0.0f)
-            body->setCollisionFlags(btCollisionObject::CF_DYNAMIC_OBJECT);
-
+        body->setCollisionFlags(btCollisionObject::CF_STATIC_OBJECT);
         if(wantCallBack)
             body->setCollisionFlags(body->getCollisionFlags() | btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK);
 
-        m_rigidBodiesMap.insert(std::make_pair(objectID, rigidBodyData));
+        for(const int objectID : rigidBodyData->triangleObjectIDs)
+        {
+            m_mergedObjectIDs[objectID] = mergedID;
+        }
+
+        m_rigidBodiesMap.insert(std::make_pair(mergedID, rigidBodyData));
         m_dynamicsWorldMT->addRigidBody(body.get(), static_cast<int>(collGroup), static_cast<int>(collMask));
+
+        return mergedID;
     }
 
     // Called from MANY threads !!!!!
@@ -529,11 +730,16 @@ namespace Beryll
         if(ob1->getCollisionObject()->beryllEngineObjectID == ob2->getCollisionObject()->beryllEngineObjectID)
             return false;
 
+        // Triggers check precise overlap with contactPairTest(). It is not collision.
+        if(ob1->getCollisionObject()->getInternalType() == btCollisionObject::CO_GHOST_OBJECT ||
+           ob2->getCollisionObject()->getInternalType() == btCollisionObject::CO_GHOST_OBJECT)
+            return false;
+
         {
             ScopedSpinlock lock{m_spinLock};
 
-            m_collisionPairs.emplace_back(ob1->getCollisionObject()->beryllEngineObjectID,
-                                          ob2->getCollisionObject()->beryllEngineObjectID);
+            m_collisionPairs.emplace_back(getObjectID(ob1->getCollisionObject(), index1),
+                                          getObjectID(ob2->getCollisionObject(), index2));
         }
 
         return false;
@@ -557,14 +763,15 @@ namespace Beryll
 
     bool Physics::getIsCollisionWithGroup(const int ID, const CollisionGroups group)
     {
-        for(int i = 0; i < m_dynamicsWorldMT->getNumCollisionObjects(); ++i)
+        for(const std::pair<const int, const int>& pair : m_collisionPairs)
         {
-            if(m_dynamicsWorldMT->getCollisionObjectArray()[i]->getBroadphaseHandle()->m_collisionFilterGroup & static_cast<int>(group))
+            if(pair.first == pair.second)
+                continue;
+
+            if((pair.first == ID && getIsObjectInGroup(pair.second, group)) ||
+               (pair.second == ID && getIsObjectInGroup(pair.first, group)))
             {
-                if(getIsCollision(ID, m_dynamicsWorldMT->getCollisionObjectArray()[i]->beryllEngineObjectID))
-                {
-                    return true;
-                }
+                return true;
             }
         }
 
@@ -586,9 +793,9 @@ namespace Beryll
         return 0;
     }
 
-    std::vector<const int> Physics::getAllCollisionsForID(const int ID)
+    std::vector<int> Physics::getAllCollisionsForID(const int ID)
     {
-        std::vector<const int> ids;
+        std::vector<int> ids;
 
         for(const std::pair<const int, const int>& pair : m_collisionPairs)
         {
@@ -602,25 +809,50 @@ namespace Beryll
         return ids;
     }
 
-    std::vector<const int> Physics::getAllCollisionsForIDWithGroup(const int ID, const CollisionGroups group)
+    std::vector<int> Physics::getAllCollisionsForIDWithGroup(const int ID, const CollisionGroups group)
     {
-        std::vector<const int> ids;
+        std::vector<int> ids;
         ids.reserve(5);
 
-        for(int i = 0; i < m_dynamicsWorldMT->getNumCollisionObjects(); ++i)
+        for(const std::pair<const int, const int>& pair : m_collisionPairs)
         {
-            if(m_dynamicsWorldMT->getCollisionObjectArray()[i]->getBroadphaseHandle()->m_collisionFilterGroup & static_cast<int>(group))
-            {
-                if(getIsCollision(ID, m_dynamicsWorldMT->getCollisionObjectArray()[i]->beryllEngineObjectID))
-                {
-                    ids.push_back(m_dynamicsWorldMT->getCollisionObjectArray()[i]->beryllEngineObjectID);
-                }
-            }
+            if(pair.first == pair.second)
+                continue;
+
+            int otherID = 0;
+            if(pair.first == ID)
+                otherID = pair.second;
+            else if(pair.second == ID)
+                otherID = pair.first;
+            else
+                continue;
+
+            // Many contacts of same pair are stored.
+            if(std::find(ids.begin(), ids.end(), otherID) == ids.end() && getIsObjectInGroup(otherID, group))
+                ids.push_back(otherID);
         }
 
         return ids;
     }
 
+    bool Physics::getIsObjectInGroup(const int ID, const CollisionGroups group)
+    {
+        auto iter = m_rigidBodiesMap.find(ID);
+        if(iter == m_rigidBodiesMap.end())
+        {
+            // Object can be part of merged static mesh.
+            auto mergedIter = m_mergedObjectIDs.find(ID);
+            if(mergedIter == m_mergedObjectIDs.end())
+                return false;
+
+            iter = m_rigidBodiesMap.find(mergedIter->second);
+            if(iter == m_rigidBodiesMap.end())
+                return false;
+        }
+
+        return getIsCollisionGroupContainsOther(iter->second->collGroup, group);
+    }
+
     std::vector<std::pair<glm::vec3, glm::vec3>> Physics::getAllCollisionPoints(const int ID1, const int ID2)
     {
         if(ID1 == ID2) { return {}; }
@@ -635,20 +867,23 @@ namespace Beryll
             const btCollisionObject* obA = contactManifold->getBody0();
             const btCollisionObject* obB = contactManifold->getBody1();
 
-            if((obA->beryllEngineObjectID == ID1 && obB->beryllEngineObjectID == ID2) ||
-               (obA->beryllEngineObjectID == ID2 && obB->beryllEngineObjectID == ID1))
-            {
-                // We found contact point between 2 objects.
-                for(int j = 0; j < contactManifold->getNumContacts(); j++)
-                {
-                    const btManifoldPoint& pt = contactManifold->getContactPoint(j);
+            // Merged mesh contains many objects. Check them per contact point.
+            const bool mayContainA = obA->beryllEngineObjectID == ID1 || obA->beryllEngineObjectID == ID2 || getIsMerged(obA);
+            const bool mayContainB = obB->beryllEngineObjectID == ID1 || obB->beryllEngineObjectID == ID2 || getIsMerged(obB);
+            if(!mayContainA || !mayContainB)
+                continue;
 
-                    const btVector3& ptB = pt.getPositionWorldOnB();
-                    btVector3 normalOnB = pt.m_normalWorldOnB;
-                    normalOnB.normalize();
+            for(int j = 0; j < contactManifold->getNumContacts(); j++)
+            {
+                const btManifoldPoint& pt = contactManifold->getContactPoint(j);
+                const int objectA_ID = getObjectIDOnA(contactManifold, pt);
+                const int objectB_ID = getObjectIDOnB(contactManifold, pt);
 
-                    pointsAndNormals.emplace_back(glm::vec3(ptB.getX(), ptB.getY(), ptB.getZ()), // Point.
-                                                  glm::normalize(glm::vec3(normalOnB.getX(), normalOnB.getY(), normalOnB.getZ()))); // Normal.
+                if((objectA_ID == ID1 && objectB_ID == ID2) ||
+                   (objectA_ID == ID2 && objectB_ID == ID1))
+                {
+                    // We found contact point between 2 objects.
+                    addPointAndNormal(pt, pointsAndNormals);
                 }
             }
         }
@@ -656,7 +891,7 @@ namespace Beryll
         return pointsAndNormals;
     }
 
-    std::vector<std::pair<glm::vec3, glm::vec3>> Physics::getAllCollisionPoints(const int ID1, const std::vector<const int>& IDs)
+    std::vector<std::pair<glm::vec3, glm::vec3>> Physics::getAllCollisionPoints(const int ID1, const std::vector<int>& IDs)
     {
         std::vector<std::pair<glm::vec3, glm::vec3>> pointsAndNormals;
         pointsAndNormals.reserve(5);
@@ -668,37 +903,21 @@ namespace Beryll
             const btCollisionObject* obA = contactManifold->getBody0();
             const btCollisionObject* obB = contactManifold->getBody1();
 
-            bool obA_ID_existInIDs = false;
-            bool obB_ID_existInIDs = false;
-            for(const int id : IDs)
-            {
-                if(id == obA->beryllEngineObjectID)
-                {
-                    obA_ID_existInIDs = true;
-                    break;
-                }
-
-                if(id == obB->beryllEngineObjectID)
-                {
-                    obB_ID_existInIDs = true;
-                    break;
-                }
-            }
+            // Skip manifolds which can not contain ID1.
+            if(obA->beryllEngineObjectID != ID1 && obB->beryllEngineObjectID != ID1 && !getIsMerged(obA) && !getIsMerged(obB))
+                continue;
 
-            if((obA->beryllEngineObjectID == ID1 && obB_ID_existInIDs) ||
-               (obB->beryllEngineObjectID == ID1 && obA_ID_existInIDs))
+            for(int j = 0; j < contactManifold->getNumContacts(); j++)
             {
-                // We found collision between 2 objects.
-                for(int j = 0; j < contactManifold->getNumContacts(); j++)
-                {
-                    const btManifoldPoint& pt = contactManifold->getContactPoint(j);
+                const btManifoldPoint& pt = contactManifold->getContactPoint(j);
+                const int objectA_ID = getObjectIDOnA(contactManifold, pt);
+                const int objectB_ID = getObjectIDOnB(contactManifold, pt);
 
-                    const btVector3& ptB = pt.getPositionWorldOnB();
-                    btVector3 normalOnB = pt.m_normalWorldOnB;
-                    normalOnB.normalize();
-
-                    pointsAndNormals.emplace_back(glm::vec3(ptB.getX(), ptB.getY(), ptB.getZ()), // point
-                                                  glm::normalize(glm::vec3(normalOnB.getX(), normalOnB.getY(), normalOnB.getZ()))); // normal
+                if((objectA_ID == ID1 && std::find(IDs.begin(), IDs.end(), objectB_ID) != IDs.end()) ||
+                   (objectB_ID == ID1 && std::find(IDs.begin(), IDs.end(), objectA_ID) != IDs.end()))
+                {
+                    // We found collision between 2 objects.
+                    addPointAndNormal(pt, pointsAndNormals);
                 }
             }
         }
@@ -806,7 +1025,11 @@ namespace Beryll
 
         if(iter != m_rigidBodiesMap.end() && iter->second->existInDynamicWorld) // Found object by ID and it exist in world.
         {
-            m_dynamicsWorldMT->removeRigidBody(iter->second->rb.get());
+            if(m_removeBatchDepth > 0)
+                m_pendingRemoveIDs.push_back(ID); // Will be removed in endRemoveBatch().
+            else
+                m_dynamicsWorldMT->removeRigidBody(iter->second->rb.get());
+
             iter->second->existInDynamicWorld = false;
         }
     }
@@ -820,6 +1043,17 @@ namespace Beryll
 
         if(iter != m_rigidBodiesMap.end() && !iter->second->existInDynamicWorld)
         {
+            // Removed during current batch. Still in world.
+            auto pendingIter = std::find(m_pendingRemoveIDs.begin(), m_pendingRemoveIDs.end(), ID);
+            if(pendingIter != m_pendingRemoveIDs.end())
+            {
+                m_pendingRemoveIDs.erase(pendingIter);
+                iter->second->existInDynamicWorld = true;
+                resetVelocitiesForObject(iter->second->rb, resetVelocities);
+                iter->second->rb->activate(true);
+                return;
+            }
+
             resetVelocitiesForObject(iter->second->rb, resetVelocities);
 
             iter->second->rb->activate(true);
@@ -844,24 +1078,65 @@ namespace Beryll
             m_motionStates.pop_back();
         }
 
-        // In reverse order.
-        for(auto revIter = m_rigidBodiesMap.rbegin(); revIter != m_rigidBodiesMap.rend(); ++revIter)
+        std::vector<btRigidBody*> bodies;
+        bodies.reserve(m_rigidBodiesMap.size());
+        for(const std::pair<const int, std::shared_ptr<RigidBodyData>>& body : m_rigidBodiesMap)
         {
-            if(revIter->second->existInDynamicWorld)
+            if(body.second->existInDynamicWorld || std::find(m_pendingRemoveIDs.begin(), m_pendingRemoveIDs.end(), body.first) != m_pendingRemoveIDs.end())
             {
-                m_dynamicsWorldMT->removeRigidBody(revIter->second->rb.get());
-                revIter->second->existInDynamicWorld = false;
+                bodies.push_back(body.second->rb.get());
+                body.second->existInDynamicWorld = false;
             }
         }
+        m_pendingRemoveIDs.clear();
+        removeBodiesFromWorld(bodies);
 
         m_rigidBodiesMap.clear();
+        m_mergedObjectIDs.clear();
         m_collisionShapes.clear();
         m_triangleMeshes.clear();
+        m_concaveMeshBvhs.clear();
+
+        removeAllTriggers();
 
         BR_INFO("m_dynamicsWorldMT count after hard delete: %d", m_dynamicsWorldMT->getNumCollisionObjects());
         BR_INFO("m_rigidBodiesMap count after hard delete: %d", m_rigidBodiesMap.size());
     }
 
+    void Physics::beginRemoveBatch()
+    {
+        ++m_removeBatchDepth;
+    }
+
+    void Physics::endRemoveBatch()
+    {
+        BR_ASSERT((m_removeBatchDepth > 0), "%s", "endRemoveBatch() called without beginRemoveBatch().");
+
+        --m_removeBatchDepth;
+        if(m_removeBatchDepth > 0 || m_pendingRemoveIDs.empty())
+            return;
+
+        std::vector<btRigidBody*> bodies;
+        bodies.reserve(m_pendingRemoveIDs.size());
+        for(const int ID : m_pendingRemoveIDs)
+        {
+            auto iter = m_rigidBodiesMap.find(ID);
+            if(iter != m_rigidBodiesMap.end())
+                bodies.push_back(iter->second->rb.get());
+        }
+        m_pendingRemoveIDs.clear();
+
+        removeBodiesFromWorld(bodies);
+    }
+
+    void Physics::removeBodiesFromWorld(std::vector<btRigidBody*>& bodies)
+    {
+        if(bodies.empty())
+            return;
+
+        static_cast<BeryllDynamicsWorldMt*>(m_dynamicsWorldMT.get())->removeRigidBodies(bodies);
+    }
+
     void Physics::activateObject(const int ID, bool resetVelocities)
     {
         auto iter = m_rigidBodiesMap.find(ID);
@@ -1019,7 +1294,7 @@ namespace Beryll
     {
         btVector3 fr(from.x, from.y, from.z);
         btVector3 t(to.x, to.y, to.z);
-        btCollisionWorld::ClosestRayResultCallback closestResults(fr, t);
+        ClosestRayIgnoreTriggersCallback closestResults(fr, t);
         closestResults.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
         closestResults.m_flags |= btTriangleRaycastCallback::kF_UseGjkConvexCastRaytest;
         closestResults.m_collisionFilterGroup = static_cast<int>(collGroup);
@@ -1038,7 +1313,7 @@ namespace Beryll
                 transforms = closestResults.m_collisionObject->getWorldTransform();
 
             return RayClosestHit{true,
-                                 static_cast<RigidBodyData*>(closestResults.m_collisionObject->getUserPointer())->bodyID,
+                                 static_cast<RigidBodyData*>(closestResults.m_collisionObject->getUserPointer())->getObjectID(closestResults.hitTriangleIndex),
                                  static_cast<RigidBodyData*>(closestResults.m_collisionObject->getUserPointer())->collFlag,
                                  static_cast<RigidBodyData*>(closestResults.m_collisionObject->getUserPointer())->collGroup,
                                  static_cast<RigidBodyData*>(closestResults.m_collisionObject->getUserPointer())->mass,
@@ -1059,7 +1334,7 @@ namespace Beryll
     {
         btVector3 fr(from.x, from.y, from.z);
         btVector3 t(to.x, to.y, to.z);
-        btCollisionWorld::AllHitsRayResultCallback allResults(fr, t);
+        AllHitsRayIgnoreTriggersCallback allResults(fr, t);
         allResults.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
         allResults.m_flags |= btTriangleRaycastCallback::kF_UseGjkConvexCastRaytest;
         allResults.m_collisionFilterGroup = static_cast<int>(collGroup);
@@ -1090,7 +1365,7 @@ namespace Beryll
                 else
                     transforms = allResults.m_collisionObjects[i]->getWorldTransform();
 
-                res.hittedObjectsID.emplace_back(static_cast<RigidBodyData*>(allResults.m_collisionObjects[i]->getUserPointer())->bodyID);
+                res.hittedObjectsID.emplace_back(static_cast<RigidBodyData*>(allResults.m_collisionObjects[i]->getUserPointer())->getObjectID(allResults.hitTriangleIndices[i]));
                 res.hittedObjectsCollFlags.emplace_back(static_cast<RigidBodyData*>(allResults.m_collisionObjects[i]->getUserPointer())->collFlag);
                 res.hittedObjectsCollGroups.emplace_back(static_cast<RigidBodyData*>(allResults.m_collisionObjects[i]->getUserPointer())->collGroup);
                 res.hittedObjectsMass.emplace_back(static_cast<RigidBodyData*>(allResults.m_collisionObjects[i]->getUserPointer())->mass);
@@ -1163,4 +1438,159 @@ namespace Beryll
             iter->second->rb->setDamping(linDamping, angDamping);
         }
     }
+
+    int Physics::addTriggerBox(const glm::vec3& halfExtents, const glm::mat4& transforms, CollisionGroups collGroup, CollisionGroups collMask)
+    {
+        std::shared_ptr<btBoxShape> boxShape = PhysicsAllocator::makeShared<btBoxShape>(btVector3(halfExtents.x, halfExtents.y, halfExtents.z));
+        return addTrigger(boxShape, transforms, collGroup, collMask);
+    }
+
+    int Physics::addTriggerSphere(float radius, const glm::mat4& transforms, CollisionGroups collGroup, CollisionGroups collMask)
+    {
+        std::shared_ptr<btSphereShape> sphereShape = PhysicsAllocator::makeShared<btSphereShape>(radius);
+        return addTrigger(sphereShape, transforms, collGroup, collMask);
+    }
+
+    int Physics::addTriggerConvex(const std::vector<glm::vec3>& vertices, const glm::mat4& transforms, CollisionGroups collGroup, CollisionGroups collMask)
+    {
+        BR_ASSERT((vertices.empty() == false), "%s", "Vertices empty.");
+
+        std::shared_ptr<btConvexHullShape> convexShape = PhysicsAllocator::makeShared<btConvexHullShape>();
+        for(const glm::vec3& vert : vertices)
+        {
+            convexShape->addPoint(btVector3(vert.x, vert.y, vert.z), false);
+        }
+        convexShape->recalcLocalAabb();
+
+        return addTrigger(convexShape, transforms, collGroup, collMask);
+    }
+
+    int Physics::addTrigger(const std::shared_ptr<btCollisionShape>& shape, const glm::mat4& transforms, CollisionGroups collGroup, CollisionGroups collMask)
+    {
+        const int triggerID = BeryllUtils::Common::generateID();
+
+        glm::vec3 transl = BeryllUtils::Matrix::getTranslationFrom4x4Glm(transforms);
+        glm::quat rot = BeryllUtils::Matrix::getRotationFrom4x4Glm(transforms);
+        btTransform startTransform;
+        startTransform.setIdentity();
+        startTransform.setOrigin(btVector3(transl.x, transl.y, transl.z));
+        startTransform.setRotation(btQuaternion(rot.x, rot.y, rot.z, rot.w));
+
+        std::shared_ptr<btPairCachingGhostObject> ghost = PhysicsAllocator::makeShared<btPairCachingGhostObject>();
+        ghost->setCollisionShape(shape.get());
+        ghost->setWorldTransform(startTransform);
+        ghost->setCollisionFlags(btCollisionObject::CF_NO_CONTACT_RESPONSE);
+        ghost->beryllEngineObjectID = triggerID;
+
+        m_triggersMap.insert(std::make_pair(triggerID, PhysicsAllocator::makeShared<TriggerData>(triggerID, ghost, shape)));
+        m_dynamicsWorldMT->addCollisionObject(ghost.get(), static_cast<int>(collGroup), static_cast<int>(collMask));
+
+        return triggerID;
+    }
+
+    void Physics::removeTrigger(const int triggerID)
+    {
+        auto iter = m_triggersMap.find(triggerID);
+        if(iter != m_triggersMap.end())
+        {
+            m_dynamicsWorldMT->removeCollisionObject(iter->second->ghost.get());
+            m_triggersMap.erase(iter);
+        }
+    }
+
+    void Physics::removeAllTriggers()
+    {
+        for(const std::pair<const int, std::shared_ptr<TriggerData>>& trigger : m_triggersMap)
+        {
+            m_dynamicsWorldMT->removeCollisionObject(trigger.second->ghost.get());
+        }
+
+        m_triggersMap.clear();
+    }
+
+    void Physics::setTriggerOrigin(const int triggerID, const glm::vec3& orig)
+    {
+        auto iter = m_triggersMap.find(triggerID);
+        if(iter != m_triggersMap.end())
+        {
+            btTransform t = iter->second->ghost->getWorldTransform();
+            t.setOrigin(btVector3(orig.x, orig.y, orig.z));
+            iter->second->ghost->setWorldTransform(t);
+        }
+    }
+
+    const std::vector<int>& Physics::getTriggerOverlapping(const int triggerID)
+    {
+        auto iter = m_triggersMap.find(triggerID);
+        if(iter != m_triggersMap.end())
+            return iter->second->overlappingIDs;
+
+        return m_emptyIDs;
+    }
+
+    const std::vector<int>& Physics::getTriggerEntered(const int triggerID)
+    {
+        auto iter = m_triggersMap.find(triggerID);
+        if(iter != m_triggersMap.end())
+            return iter->second->enteredIDs;
+
+        return m_emptyIDs;
+    }
+
+    const std::vector<int>& Physics::getTriggerExited(const int triggerID)
+    {
+        auto iter = m_triggersMap.find(triggerID);
+        if(iter != m_triggersMap.end())
+            return iter->second->exitedIDs;
+
+        return m_emptyIDs;
+    }
+
+    void Physics::updateTriggers()
+    {
+        std::vector<int> newOverlapping;
+
+        for(const std::pair<const int, std::shared_ptr<TriggerData>>& trigger : m_triggersMap)
+        {
+            TriggerData& data = *trigger.second;
+            btPairCachingGhostObject* ghost = data.ghost.get();
+            newOverlapping.clear();
+
+            // Broad phase pairs of this ghost only. Confirm each with precise shape test.
+            btBroadphasePairArray& pairs = ghost->getOverlappingPairCache()->getOverlappingPairArray();
+            for(int i = 0; i < pairs.size(); ++i)
+            {
+                btCollisionObject* obj0 = static_cast<btCollisionObject*>(pairs[i].m_pProxy0->m_clientObject);
+                btCollisionObject* obj1 = static_cast<btCollisionObject*>(pairs[i].m_pProxy1->m_clientObject);
+                btCollisionObject* other = (obj0 == ghost) ? obj1 : obj0;
+
+                if(btRigidBody::upcast(other) == nullptr)
+                    continue; // Other triggers.
+
+                TriggerContactCallback contactResult(ghost, newOverlapping);
+                m_dynamicsWorldMT->contactPairTest(ghost, other, contactResult);
+            }
+
+            std::sort(newOverlapping.begin(), newOverlapping.end());
+            newOverlapping.erase(std::unique(newOverlapping.begin(), newOverlapping.end()), newOverlapping.end());
+
+            data.enteredIDs.clear();
+            data.exitedIDs.clear();
+            std::set_difference(newOverlapping.begin(), newOverlapping.end(),
+                                data.overlappingIDs.begin(), data.overlappingIDs.end(),
+                                std::back_inserter(data.enteredIDs));
+            std::set_difference(data.overlappingIDs.begin(), data.overlappingIDs.end(),
+                                newOverlapping.begin(), newOverlapping.end(),
+                                std::back_inserter(data.exitedIDs));
+            data.overlappingIDs.swap(newOverlapping);
+        }
+    }
+
+    void Physics::nearCallbackSkipTriggers(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo)
+    {
+        if(isTrigger(collisionPair.m_pProxy0) || isTrigger(collisionPair.m_pProxy1))
+            return;
+
+        btCollisionDispatcher::defaultNearCallback(collisionPair, dispatcher, dispatchInfo);
+    }
 }
@@ -89,6 +89,35 @@ namespace Beryll
 
         CollisionFlags collFlag = CollisionFlags::NONE;
         float mass = -1.0f;
+
+        // Only for merged static meshes. Triangle index -> ID of original object.
+        std::vector<int> triangleObjectIDs;
+
+        int getObjectID(const int triangleIndex) const
+        {
+            if(triangleIndex >= 0 && triangleIndex < static_cast<int>(triangleObjectIDs.size()))
+                return triangleObjectIDs[triangleIndex];
+
+            return bodyID;
+        }
+    };
+
+    // Trigger volume. Ghost object without contact response. Never generate solver contacts.
+    // Overlaps are taken from ghost pair cache after each simulation step.
+    struct TriggerData
+    {
+        TriggerData(int id,
+                    const std::shared_ptr<btPairCachingGhostObject>& g,
+                    const std::shared_ptr<btCollisionShape>& s)
+        : triggerID(id), ghost(g), shape(s)  {}
+
+        const int triggerID;
+        const std::shared_ptr<btPairCachingGhostObject> ghost;
+        const std::shared_ptr<btCollisionShape> shape;
+
+        std::vector<int> overlappingIDs; // Sorted.
+        std::vector<int> enteredIDs; // Started overlap during last step.
+        std::vector<int> exitedIDs; // Finished overlap during last step.
     };
 
     struct PhysicsTransforms
@@ -114,7 +143,7 @@ namespace Beryll
     struct RayAllHits
     {
         bool isHit = false;
-        std::vector<const int> hittedObjectsID; // All hitted.
+        std::vector<int> hittedObjectsID; // All hitted.
         std::vector<CollisionFlags> hittedObjectsCollFlags;
         std::vector<CollisionGroups> hittedObjectsCollGroups;
         std::vector<float> hittedObjectsMass;
@@ -217,6 +246,19 @@ namespace Beryll
 
         static void hardRemoveAllObjects(); // Remove from everywhere.
 
+        // Batch add. Colliding objects created between begin/end are built in parallel and inserted in world at endAddBatch().
+        // Dont access physics of these objects before endAddBatch(). Calls can be nested.
+        static void beginAddBatch(int expectedCount);
+        static void endAddBatch();
+        // Batch remove. Objects disabled between begin/end are removed from world with one pass at endRemoveBatch().
+        static void beginRemoveBatch();
+        static void endRemoveBatch();
+
+        // Quantized BVH of concave collision mesh (name contains "CollisionConcaveMesh") serialized in place for beryllCook.
+        // Built from same triangle mesh as at runtime. Stored in .bmesh, then BVH is not built when object is added.
+        // In place layout depends on platform (pointer size, btScalar). Not matching BVH is ignored and built again.
+        static std::vector<char> serializeConcaveMeshBvh(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices);
+
         static bool getIsCollisionGroupContainsOther(CollisionGroups gr1, CollisionGroups gr2)
         {
             // Return true if gr1 contains gr2.
@@ -227,12 +269,12 @@ namespace Beryll
         static bool getIsCollisionWithGroup(const int ID, const CollisionGroups group);
 
         static int getAnyCollisionForID(const int ID); // Return first found ID colliding with. Or 0 if no collisions.
-        static std::vector<const int> getAllCollisionsForID(const int ID);
+        static std::vector<int> getAllCollisionsForID(const int ID);
 
-        static std::vector<const int> getAllCollisionsForIDWithGroup(const int id, const CollisionGroups group); // Return IDs of all colliding objects in specific group.
+        static std::vector<int> getAllCollisionsForIDWithGroup(const int id, const CollisionGroups group); // Return IDs of all colliding objects in specific group.
         static std::vector<std::pair<const int, const int>>& getAllCollisions() { return m_collisionPairs; }
         static std::vector<std::pair<glm::vec3, glm::vec3>> getAllCollisionPoints(const int ID1, const int ID2); // Return point + his normal.
-        static std::vector<std::pair<glm::vec3, glm::vec3>> getAllCollisionPoints(const int ID1, const std::vector<const int>& IDs); // Return point + his normal.
+        static std::vector<std::pair<glm::vec3, glm::vec3>> getAllCollisionPoints(const int ID1, const std::vector<int>& IDs); // Return point + his normal.
 
         static void setGravity(const glm::vec3& grav) { BR_ASSERT(false, "%s", "Change gravity for specific objects. Not for all world."); }
 
@@ -244,8 +286,24 @@ namespace Beryll
         static RayClosestHit castRayClosestHit(const glm::vec3& from, const glm::vec3& to, CollisionGroups collGroup, CollisionGroups collMask);
         static RayAllHits castRayAllHits(const glm::vec3& from, const glm::vec3& to, CollisionGroups collGroup, CollisionGroups collMask);
 
+        // Trigger volumes. Return trigger ID.
+        // Detect objects which belong to collMask. Ray casts and projectiles ignore triggers.
+        // Broad phase filter works in both directions: detected objects should also have collGroup of trigger in their mask.
+        static int addTriggerBox(const glm::vec3& halfExtents, const glm::mat4& transforms, CollisionGroups collGroup, CollisionGroups collMask);
+        static int addTriggerSphere(float radius, const glm::mat4& transforms, CollisionGroups collGroup, CollisionGroups collMask);
+        static int addTriggerConvex(const std::vector<glm::vec3>& vertices, const glm::mat4& transforms, CollisionGroups collGroup, CollisionGroups collMask);
+        static void removeTrigger(const int triggerID);
+        static void removeAllTriggers();
+        static void setTriggerOrigin(const int triggerID, const glm::vec3& orig);
+        // Object IDs. Updated after each simulation step.
+        static const std::vector<int>& getTriggerOverlapping(const int triggerID);
+        static const std::vector<int>& getTriggerEntered(const int triggerID);
+        static const std::vector<int>& getTriggerExited(const int triggerID);
+
     private:
         friend class GameLoop;
+        friend class ProjectileSystem;
+        friend struct PhysicsTestAccess; // Host tests (tools/beryllCook/tests) create and simulate world without GameLoop.
         static void create();
         static void simulate();
 
@@ -269,8 +327,19 @@ namespace Beryll
         // Keep pointers from destroying.
         static std::vector<std::shared_ptr<btCollisionShape>> m_collisionShapes;
         static std::vector<std::shared_ptr<btTriangleMesh>> m_triangleMeshes;
+        static std::vector<std::shared_ptr<btOptimizedBvh>> m_concaveMeshBvhs; // Loaded from .bmesh. Not owned by shapes.
         static std::vector<std::shared_ptr<btDefaultMotionState>> m_motionStates;
         static std::map<const int, std::shared_ptr<RigidBodyData>> m_rigidBodiesMap;
+        static std::unordered_map<int, int> m_mergedObjectIDs; // Original object ID -> ID of merged static body.
+        static bool getIsObjectInGroup(const int ID, const CollisionGroups group); // Also for objects in merged meshes.
+
+        // Triggers are not rigid bodies and stored separately.
+        static std::map<const int, std::shared_ptr<TriggerData>> m_triggersMap;
+        static std::unique_ptr<btGhostPairCallback> m_ghostPairCallback;
+        static const std::vector<int> m_emptyIDs;
+        static int addTrigger(const std::shared_ptr<btCollisionShape>& shape, const glm::mat4& transforms, CollisionGroups collGroup, CollisionGroups collMask);
+        static void updateTriggers();
+        static void nearCallbackSkipTriggers(btBroadphasePair& collisionPair, btCollisionDispatcher& dispatcher, const btDispatcherInfo& dispatchInfo);
 
         // Increase resolution if your ball penetrate wall but you want collision.
         // Physics engine will do more small iteration during one simulation.
@@ -335,62 +404,80 @@ namespace Beryll
                               bool wantCallBack,
                               CollisionFlags collFlag,
                               CollisionGroups collGroup,
-                              CollisionGroups collMask);
-
-        static void addConcaveMesh(const std::vector<glm::vec3>& vertices,
-                                   const std::vector<uint32_t>& indices,
-                                   const glm::mat4& transforms,
-                                   const int objectID,
-                                   float mass,
-                                   bool wantCallBack,
-                                   CollisionFlags collFlag,
-                                   CollisionGroups collGroup,
-                                   CollisionGroups collMask); // vognutaja
-
-        static void addConvexMesh(const std::vector<glm::vec3>& vertices,
-                                  const std::vector<uint32_t>& indices,
-                                  const glm::mat4& transforms,
-                                  const int objectID,
-                                  float mass,
-                                  bool wantCallBack,
-                                  CollisionFlags collFlag,
-                                  CollisionGroups collGroup,
-                                  CollisionGroups collMask); // vypuklaja
-
-        static void addBoxShape(const std::vector<glm::vec3>& vertices,
-                                  const glm::mat4& transforms,
-                                  const int objectID,
-                                  float mass,
-                                  bool wantCallBack,
-                                  CollisionFlags collFlag,
-                                  CollisionGroups collGroup,
-                                  CollisionGroups collMask);
-
-        static void addSphereShape(const std::vector<glm::vec3>& vertices,
-                                    const glm::mat4& transforms,
-                                    const int objectID,
-                                    float mass,
-                                    bool wantCallBack,
-                                    CollisionFlags collFlag,
-                                    CollisionGroups collGroup,
-                                    CollisionGroups collMask);
-
-        static void addCapsuleShape(const std::vector<glm::vec3>& vertices,
-                                    const glm::mat4& transforms,
-                                    const int objectID,
-                                    float mass,
-                                    bool wantCallBack,
-                                    CollisionFlags collFlag,
-                                    CollisionGroups collGroup,
-                                    CollisionGroups collMask);
-
-        static void addCylinderShape(const std::vector<glm::vec3>& vertices,
-                                    const glm::mat4& transforms,
-                                    const int objectID,
-                                    float mass,
-                                    bool wantCallBack,
-                                    CollisionFlags collFlag,
-                                    CollisionGroups collGroup,
-                                    CollisionGroups collMask);
+                              CollisionGroups collMask,
+                              const std::vector<char>& serializedBvh = {}); // Cooked BVH of concave mesh. See serializeConcaveMeshBvh().
+
+        // Build shape and motion state without touching world or containers. Can be called from many threads.
+        struct BuiltObject
+        {
+            std::shared_ptr<btCollisionShape> shape;
+            std::shared_ptr<btTriangleMesh> triangleMesh; // Only for concave mesh.
+            std::shared_ptr<btOptimizedBvh> bvh; // Only for concave mesh with cooked BVH.
+            std::shared_ptr<btDefaultMotionState> motionState;
+            btVector3 localInertia{0.0f, 0.0f, 0.0f};
+            std::shared_ptr<RigidBodyData> rigidBodyData; // Set by createBody().
+        };
+        static BuiltObject buildObject(const std::vector<glm::vec3>& vertices,
+                                       const std::vector<uint32_t>& indices,
+                                       const glm::mat4& transforms,
+                                       const std::string& meshName,
+                                       float mass,
+                                       CollisionFlags collFlag,
+                                       const std::vector<char>& serializedBvh);
+        // Only main thread. btRigidBody constructor increments not synchronized static counter inside Bullet.
+        static std::shared_ptr<RigidBodyData> createBody(const BuiltObject& built,
+                                                         const int objectID,
+                                                         float mass,
+                                                         bool wantCallBack,
+                                                         CollisionFlags collFlag,
+                                                         CollisionGroups collGroup,
+                                                         CollisionGroups collMask);
+        static void insertBuiltObject(const BuiltObject& built); // Only main thread.
+
+        static std::shared_ptr<btCollisionShape> createConcaveMeshShape(const std::vector<glm::vec3>& vertices,
+                                                                        const std::vector<uint32_t>& indices,
+                                                                        const std::vector<char>& serializedBvh,
+                                                                        std::shared_ptr<btTriangleMesh>& triangleMesh,
+                                                                        std::shared_ptr<btOptimizedBvh>& bvh); // vognutaja
+        static std::shared_ptr<btCollisionShape> createConvexMeshShape(const std::vector<glm::vec3>& vertices,
+                                                                       const std::vector<uint32_t>& indices); // vypuklaja
+        static std::shared_ptr<btCollisionShape> createBoxShape(const std::vector<glm::vec3>& vertices);
+        static std::shared_ptr<btCollisionShape> createSphereShape(const std::vector<glm::vec3>& vertices);
+        static std::shared_ptr<btCollisionShape> createCapsuleShape(const std::vector<glm::vec3>& vertices);
+        static std::shared_ptr<btCollisionShape> createCylinderShape(const std::vector<glm::vec3>& vertices);
+
+        // Objects added between beginAddBatch() and endAddBatch().
+        struct PendingObject
+        {
+            std::vector<glm::vec3> vertices;
+            std::vector<uint32_t> indices;
+            glm::mat4 transforms{1.0f};
+            std::string meshName;
+            int objectID = 0;
+            float mass = 0.0f;
+            bool wantCallBack = false;
+            CollisionFlags collFlag = CollisionFlags::NONE;
+            CollisionGroups collGroup = CollisionGroups::NONE;
+            CollisionGroups collMask = CollisionGroups::NONE;
+            std::vector<char> serializedBvh;
+            BuiltObject built;
+        };
+        static std::vector<PendingObject> m_pendingObjects;
+        static int m_addBatchDepth;
+        static std::vector<int> m_pendingRemoveIDs;
+        static int m_removeBatchDepth;
+        static constexpr int m_minBatchSizeForBroadPhaseOptimize = 64;
+        static void removeBodiesFromWorld(std::vector<btRigidBody*>& bodies); // One pass over world arrays and pair cache.
+
+        // Many static concave meshes merged in one BVH mesh. Vertices in world space.
+        // triangleObjectIDs keeps original object ID for each triangle. Ray hits and collisions return original ID.
+        // All merged objects must have same wantCallBack, collGroup and collMask.
+        // Return ID of merged body.
+        static int addMergedStaticConcaveMesh(const std::vector<glm::vec3>& vertices,
+                                              const std::vector<uint32_t>& indices,
+                                              std::vector<int> triangleObjectIDs,
+                                              bool wantCallBack,
+                                              CollisionGroups collGroup,
+                                              CollisionGroups collMask);
     };
 }
@@ -0,0 +1,245 @@
+#include "PhysicsAllocator.h"
+#include "beryll/core/Log.h"
+
+namespace Beryll
+{
+    namespace
+    {
+        constexpr uint32_t headerSize = 16; // Keep 16 bytes alignment of returned memory.
+        constexpr uint32_t headerMagic = 0xBE5A110C;
+        constexpr uint32_t bigBlockClass = PhysicsAllocator::sizeClassesCount; // Last stats slot.
+        constexpr uint32_t smallestBlockSize = 32;
+        constexpr uint32_t chunkSize = 64 * 1024; // Pool grows by chunks.
+
+        struct BlockHeader
+        {
+            uint32_t magic;
+            uint32_t sizeClass;
+            uint64_t requestedSize;
+        };
+        static_assert(sizeof(BlockHeader) <= headerSize, "Header does not fit.");
+
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        uint32_t getBlockSize(uint32_t sizeClass) { return smallestBlockSize << sizeClass; }
+
+        int getSizeClass(size_t fullSize)
+        {
+            for(int i = 0; i < PhysicsAllocator::sizeClassesCount; ++i)
+            {
+                if(fullSize <= getBlockSize(i))
+                    return i;
+            }
+
+            return -1;
+        }
+
+        // Chunks are never returned to system.
+        std::mutex poolMutex;
+        FreeBlock* poolFreeLists[PhysicsAllocator::sizeClassesCount] = {};
+        int64_t poolReservedBytes[PhysicsAllocator::sizeClassesCount] = {};
+
+        std::atomic<int64_t> statsLiveCount[PhysicsAllocator::sizeClassesCount + 1];
+        std::atomic<int64_t> statsLiveBytes[PhysicsAllocator::sizeClassesCount + 1];
+        std::atomic<int64_t> statsTotalAllocations[PhysicsAllocator::sizeClassesCount + 1];
+
+        // Called under poolMutex.
+        void growPool(int sizeClass)
+        {
+            const uint32_t blockSize = getBlockSize(sizeClass);
+            char* chunk = static_cast<char*>(std::malloc(chunkSize));
+            BR_ASSERT((chunk != nullptr), "%s", "PhysicsAllocator out of memory.");
+            poolReservedBytes[sizeClass] += chunkSize;
+
+            for(uint32_t offset = 0; offset + blockSize <= chunkSize; offset += blockSize)
+            {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + offset);
+                block->next = poolFreeLists[sizeClass];
+                poolFreeLists[sizeClass] = block;
+            }
+        }
+
+        constexpr uint32_t magazineBatch = 32; // Blocks moved between thread and pool under one lock.
+        constexpr uint32_t magazineMaxCount = magazineBatch * 2;
+
+        // Free blocks of one thread. Taken and returned without lock.
+        // Threads are short (AsyncRun and Bullet tasks start new thread for each call),
+        // so destructor returns all blocks to pool when thread ends.
+        struct ThreadMagazines
+        {
+            FreeBlock* freeLists[PhysicsAllocator::sizeClassesCount] = {};
+            uint32_t counts[PhysicsAllocator::sizeClassesCount] = {};
+
+            ~ThreadMagazines();
+
+            FreeBlock* pop(int sizeClass)
+            {
+                if(!freeLists[sizeClass])
+                    refill(sizeClass);
+
+                FreeBlock* block = freeLists[sizeClass];
+                freeLists[sizeClass] = block->next;
+                --counts[sizeClass];
+                return block;
+            }
+
+            void push(int sizeClass, FreeBlock* block)
+            {
+                block->next = freeLists[sizeClass];
+                freeLists[sizeClass] = block;
+                ++counts[sizeClass];
+
+                if(counts[sizeClass] > magazineMaxCount)
+                    release(sizeClass, magazineBatch);
+            }
+
+            void refill(int sizeClass)
+            {
+                std::scoped_lock<std::mutex> lock(poolMutex);
+                for(uint32_t i = 0; i < magazineBatch; ++i)
+                {
+                    if(!poolFreeLists[sizeClass])
+                        growPool(sizeClass);
+
+                    FreeBlock* block = poolFreeLists[sizeClass];
+                    poolFreeLists[sizeClass] = block->next;
+                    block->next = freeLists[sizeClass];
+                    freeLists[sizeClass] = block;
+                }
+                counts[sizeClass] += magazineBatch;
+            }
+
+            void release(int sizeClass, uint32_t count)
+            {
+                std::scoped_lock<std::mutex> lock(poolMutex);
+                for(uint32_t i = 0; i < count && freeLists[sizeClass]; ++i)
+                {
+                    FreeBlock* block = freeLists[sizeClass];
+                    freeLists[sizeClass] = block->next;
+                    block->next = poolFreeLists[sizeClass];
+                    poolFreeLists[sizeClass] = block;
+                    --counts[sizeClass];
+                }
+            }
+        };
+
+        // Set when magazines of thread are destroyed. Bullet can still free memory later
+        // from destructors of other thread_local or static objects. Such blocks go to pool directly.
+        thread_local bool isMagazinesDestroyed = false;
+        thread_local ThreadMagazines threadMagazines;
+
+        ThreadMagazines::~ThreadMagazines()
+        {
+            for(int i = 0; i < PhysicsAllocator::sizeClassesCount; ++i)
+            {
+                release(i, counts[i]);
+            }
+            isMagazinesDestroyed = true;
+        }
+    }
+
+    void PhysicsAllocator::create()
+    {
+        btAlignedAllocSetCustom(PhysicsAllocator::allocate, PhysicsAllocator::deallocate);
+    }
+
+    void* PhysicsAllocator::allocate(size_t size)
+    {
+        const size_t fullSize = size + headerSize;
+        const int sizeClass = getSizeClass(fullSize);
+
+        char* memory = nullptr;
+        if(sizeClass < 0)
+        {
+            memory = static_cast<char*>(std::malloc(fullSize));
+            BR_ASSERT((memory != nullptr), "%s", "PhysicsAllocator out of memory.");
+        }
+        else if(!isMagazinesDestroyed)
+        {
+            memory = reinterpret_cast<char*>(threadMagazines.pop(sizeClass));
+        }
+        else
+        {
+            std::scoped_lock<std::mutex> lock(poolMutex);
+            if(!poolFreeLists[sizeClass])
+                growPool(sizeClass);
+
+            FreeBlock* block = poolFreeLists[sizeClass];
+            poolFreeLists[sizeClass] = block->next;
+            memory = reinterpret_cast<char*>(block);
+        }
+
+        const uint32_t statsSlot = sizeClass < 0 ? bigBlockClass : static_cast<uint32_t>(sizeClass);
+        BlockHeader* header = reinterpret_cast<BlockHeader*>(memory);
+        header->magic = headerMagic;
+        header->sizeClass = statsSlot;
+        header->requestedSize = size;
+
+        statsLiveCount[statsSlot].fetch_add(1, std::memory_order_relaxed);
+        statsLiveBytes[statsSlot].fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+        statsTotalAllocations[statsSlot].fetch_add(1, std::memory_order_relaxed);
+
+        return memory + headerSize;
+    }
+
+    void PhysicsAllocator::deallocate(void* ptr)
+    {
+        if(!ptr)
+            return;
+
+        char* memory = static_cast<char*>(ptr) - headerSize;
+        BlockHeader* header = reinterpret_cast<BlockHeader*>(memory);
+        BR_ASSERT((header->magic == headerMagic), "%s", "PhysicsAllocator::deallocate() memory was not allocated by PhysicsAllocator.");
+
+        const uint32_t statsSlot = header->sizeClass;
+        statsLiveCount[statsSlot].fetch_sub(1, std::memory_order_relaxed);
+        statsLiveBytes[statsSlot].fetch_sub(static_cast<int64_t>(header->requestedSize), std::memory_order_relaxed);
+        header->magic = 0;
+
+        if(statsSlot == bigBlockClass)
+        {
+            std::free(memory);
+            return;
+        }
+
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(memory);
+        if(!isMagazinesDestroyed)
+        {
+            threadMagazines.push(static_cast<int>(statsSlot), block);
+            return;
+        }
+
+        std::scoped_lock<std::mutex> lock(poolMutex);
+        block->next = poolFreeLists[statsSlot];
+        poolFreeLists[statsSlot] = block;
+    }
+
+    std::vector<PhysicsAllocator::SizeClassStats> PhysicsAllocator::getStats()
+    {
+        std::vector<SizeClassStats> stats(sizeClassesCount + 1);
+
+        std::scoped_lock<std::mutex> lock(poolMutex);
+        for(int i = 0; i <= sizeClassesCount; ++i)
+        {
+            stats[i].blockSize = i == bigBlockClass ? 0 : getBlockSize(i);
+            stats[i].liveCount = statsLiveCount[i].load(std::memory_order_relaxed);
+            stats[i].liveBytes = statsLiveBytes[i].load(std::memory_order_relaxed);
+            stats[i].totalAllocations = statsTotalAllocations[i].load(std::memory_order_relaxed);
+            stats[i].reservedBytes = i == bigBlockClass ? stats[i].liveBytes : poolReservedBytes[i];
+        }
+
+        return stats;
+    }
+
+    void PhysicsAllocator::logStats()
+    {
+        for(const SizeClassStats& st : getStats())
+        {
+            BR_INFO("Physics memory block: %d, live: %d, live bytes: %d, total allocations: %d, reserved bytes: %d",
+                    int(st.blockSize), int(st.liveCount), int(st.liveBytes), int(st.totalAllocations), int(st.reservedBytes));
+        }
+    }
+}
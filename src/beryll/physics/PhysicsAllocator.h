@@ -0,0 +1,72 @@
+#pragma once
+
+#include "LibsHeaders.h"
+#include "CppHeaders.h"
+
+namespace Beryll
+{
+    // Memory allocator for Bullet physics.
+    // Used by Bullet internal allocations (set with btAlignedAllocSetCustom()) and by makeShared() for
+    // shapes, meshes, motion states, bodies and RigidBodyData created in Physics.
+    // Small blocks are taken from pools of fixed size classes.
+    // Every thread keeps own free blocks (thread_local magazines) and takes/returns them from/to
+    // shared pool in batches under one mutex. Magazines are returned to pool when thread ends.
+    // Big blocks go to malloc.
+    class PhysicsAllocator final
+    {
+    public:
+        PhysicsAllocator() = delete;
+        ~PhysicsAllocator() = delete;
+
+        struct SizeClassStats
+        {
+            uint32_t blockSize = 0; // 0 = big blocks allocated with malloc.
+            int64_t liveCount = 0; // Allocated now.
+            int64_t liveBytes = 0; // Requested bytes allocated now.
+            int64_t totalAllocations = 0; // Since start.
+            int64_t reservedBytes = 0; // Memory taken by pool from system.
+        };
+
+        static std::vector<SizeClassStats> getStats();
+        static void logStats();
+
+        static void* allocate(size_t size);
+        static void deallocate(void* ptr);
+
+        static constexpr int sizeClassesCount = 8; // 32, 64, ... 4096 bytes.
+        static constexpr size_t alignment = 16;
+
+        template<typename T>
+        struct StlAllocator
+        {
+            using value_type = T;
+
+            StlAllocator() = default;
+            template<typename U>
+            StlAllocator(const StlAllocator<U>&) {}
+
+            T* allocate(size_t count)
+            {
+                static_assert(alignof(T) <= alignment, "Type needs bigger alignment.");
+                return static_cast<T*>(PhysicsAllocator::allocate(count * sizeof(T)));
+            }
+            void deallocate(T* ptr, size_t) { PhysicsAllocator::deallocate(ptr); }
+
+            template<typename U>
+            bool operator==(const StlAllocator<U>&) const { return true; }
+            template<typename U>
+            bool operator!=(const StlAllocator<U>&) const { return false; }
+        };
+
+        // Object and control block in one pool allocation. std::make_shared would use general allocator.
+        template<typename T, typename... Args>
+        static std::shared_ptr<T> makeShared(Args&&... args)
+        {
+            return std::allocate_shared<T>(StlAllocator<T>(), std::forward<Args>(args)...);
+        }
+
+    private:
+        friend class Physics;
+        static void create(); // Must be called before any Bullet allocation.
+    };
+}
@@ -0,0 +1,303 @@
+#include "ProjectileSystem.h"
+#include "beryll/core/TimeStep.h"
+#include "beryll/async/AsyncRun.h"
+
+namespace Beryll
+{
+    namespace
+    {
+        // Skip owner of projectile and everything what is not rigid body (ghost objects, ...).
+        // Bodies without RigidBodyData (not created by Physics) can not be reported. Skipped before they can hide real target.
+        bool projectileNeedsCollision(const btBroadphaseProxy* proxy, const int ownerID)
+        {
+            const btCollisionObject* obj = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+            return obj->beryllEngineObjectID != ownerID && btRigidBody::upcast(obj) != nullptr && obj->getUserPointer() != nullptr;
+        }
+
+        struct ProjectileRayCallback : public btCollisionWorld::ClosestRayResultCallback
+        {
+            ProjectileRayCallback(const btVector3& from, const btVector3& to, const int owner)
+            : btCollisionWorld::ClosestRayResultCallback(from, to), ownerID(owner) {}
+
+            bool needsCollision(btBroadphaseProxy* proxy0) const override
+            {
+                return btCollisionWorld::ClosestRayResultCallback::needsCollision(proxy0) && projectileNeedsCollision(proxy0, ownerID);
+            }
+
+            btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult, bool normalInWorldSpace) override
+            {
+                hitTriangleIndex = rayResult.m_localShapeInfo ? rayResult.m_localShapeInfo->m_triangleIndex : -1;
+                return btCollisionWorld::ClosestRayResultCallback::addSingleResult(rayResult, normalInWorldSpace);
+            }
+
+            const int ownerID;
+            int hitTriangleIndex = -1; // For merged static meshes.
+        };
+
+        struct ProjectileSweepCallback : public btCollisionWorld::ClosestConvexResultCallback
+        {
+            ProjectileSweepCallback(const btVector3& from, const btVector3& to, const int owner)
+            : btCollisionWorld::ClosestConvexResultCallback(from, to), ownerID(owner) {}
+
+            bool needsCollision(btBroadphaseProxy* proxy0) const override
+            {
+                return btCollisionWorld::ClosestConvexResultCallback::needsCollision(proxy0) && projectileNeedsCollision(proxy0, ownerID);
+            }
+
+            btScalar addSingleResult(btCollisionWorld::LocalConvexResult& convexResult, bool normalInWorldSpace) override
+            {
+                hitTriangleIndex = convexResult.m_localShapeInfo ? convexResult.m_localShapeInfo->m_triangleIndex : -1;
+                return btCollisionWorld::ClosestConvexResultCallback::addSingleResult(convexResult, normalInWorldSpace);
+            }
+
+            const int ownerID;
+            int hitTriangleIndex = -1; // For merged static meshes.
+        };
+    }
+
+    std::vector<glm::vec3> ProjectileSystem::m_positions;
+    std::vector<glm::vec3> ProjectileSystem::m_velocities;
+    std::vector<glm::vec3> ProjectileSystem::m_gravities;
+    std::vector<float> ProjectileSystem::m_lifeTimesLeft;
+    std::vector<float> ProjectileSystem::m_radiuses;
+    std::vector<int> ProjectileSystem::m_IDs;
+    std::vector<int> ProjectileSystem::m_ownerIDs;
+    std::vector<CollisionGroups> ProjectileSystem::m_collGroups;
+    std::vector<CollisionGroups> ProjectileSystem::m_collMasks;
+    std::vector<uint8_t> ProjectileSystem::m_isDead;
+    std::vector<ProjectileHit> ProjectileSystem::m_hitSlots;
+    std::vector<ProjectileHit> ProjectileSystem::m_hits;
+    int ProjectileSystem::m_maxCount = 20000;
+    int ProjectileSystem::m_nextID = 0;
+    float ProjectileSystem::m_updateTime = 0.0f;
+    Timer ProjectileSystem::m_timer;
+    std::function<void(std::vector<glm::vec3>&, int, int)> ProjectileSystem::m_updateRangeAsync;
+    float ProjectileSystem::m_currentTimeStep = 0.0f;
+
+    void ProjectileSystem::create()
+    {
+        if(m_updateRangeAsync) { return; }
+
+        m_positions.reserve(m_maxCount);
+        m_velocities.reserve(m_maxCount);
+        m_gravities.reserve(m_maxCount);
+        m_lifeTimesLeft.reserve(m_maxCount);
+        m_radiuses.reserve(m_maxCount);
+        m_IDs.reserve(m_maxCount);
+        m_ownerIDs.reserve(m_maxCount);
+        m_collGroups.reserve(m_maxCount);
+        m_collMasks.reserve(m_maxCount);
+        m_isDead.reserve(m_maxCount);
+        m_hitSlots.reserve(m_maxCount);
+        m_hits.reserve(1000);
+
+        m_updateRangeAsync = [](std::vector<glm::vec3>& v, int begin, int end) -> void // -> void = return type.
+        {
+            ProjectileSystem::updateRange(begin, end, ProjectileSystem::m_currentTimeStep);
+        };
+    }
+
+    int ProjectileSystem::spawn(const glm::vec3& pos,
+                                const glm::vec3& velocity,
+                                const glm::vec3& gravity,
+                                float lifeTimeSec,
+                                float radius,
+                                const int ownerID,
+                                CollisionGroups collGroup,
+                                CollisionGroups collMask)
+    {
+        if(static_cast<int>(m_positions.size()) >= m_maxCount)
+        {
+            BR_WARN("ProjectileSystem max count reached: %d", m_maxCount);
+            return -1;
+        }
+
+        const int ID = m_nextID++;
+
+        m_positions.push_back(pos);
+        m_velocities.push_back(velocity);
+        m_gravities.push_back(gravity);
+        m_lifeTimesLeft.push_back(lifeTimeSec);
+        m_radiuses.push_back(radius);
+        m_IDs.push_back(ID);
+        m_ownerIDs.push_back(ownerID);
+        m_collGroups.push_back(collGroup);
+        m_collMasks.push_back(collMask);
+        m_isDead.push_back(0);
+        m_hitSlots.emplace_back();
+
+        return ID;
+    }
+
+    void ProjectileSystem::removeAll()
+    {
+        m_positions.clear();
+        m_velocities.clear();
+        m_gravities.clear();
+        m_lifeTimesLeft.clear();
+        m_radiuses.clear();
+        m_IDs.clear();
+        m_ownerIDs.clear();
+        m_collGroups.clear();
+        m_collMasks.clear();
+        m_isDead.clear();
+        m_hitSlots.clear();
+        m_hits.clear();
+    }
+
+    void ProjectileSystem::update()
+    {
+        m_hits.clear();
+
+        if(m_positions.empty())
+            return;
+
+        m_timer.reset();
+
+        m_currentTimeStep = TimeStep::getTimeStepSec();
+
+        // Physics world is not changed here so ray casts from many threads are safe.
+        if(static_cast<int>(m_positions.size()) >= m_minCountForAsync)
+            AsyncRun::Run(m_positions, m_updateRangeAsync);
+        else
+            updateRange(0, static_cast<int>(m_positions.size()), m_currentTimeStep);
+
+        removeDeadAndCollectHits();
+
+        m_updateTime = m_timer.getElapsedMilliSec();
+    }
+
+    void ProjectileSystem::updateRange(int begin, int end, float timeStep)
+    {
+        const btCollisionWorld* world = Physics::m_dynamicsWorldMT.get();
+        btTransform fromTransform;
+        fromTransform.setIdentity();
+        btTransform toTransform;
+        toTransform.setIdentity();
+
+        for(int i = begin; i < end; ++i)
+        {
+            m_lifeTimesLeft[i] -= timeStep;
+            if(m_lifeTimesLeft[i] <= 0.0f)
+            {
+                m_isDead[i] = 1;
+                continue;
+            }
+
+            const glm::vec3 previousPos = m_positions[i];
+            m_velocities[i] += m_gravities[i] * timeStep;
+            m_positions[i] += m_velocities[i] * timeStep;
+
+            if(previousPos == m_positions[i])
+                continue;
+
+            const btVector3 from(previousPos.x, previousPos.y, previousPos.z);
+            const btVector3 to(m_positions[i].x, m_positions[i].y, m_positions[i].z);
+
+            const btCollisionObject* hittedObject = nullptr;
+            int hitTriangleIndex = -1;
+            btVector3 hitPoint;
+            btVector3 hitNormal;
+
+            if(m_radiuses[i] > 0.0f)
+            {
+                btSphereShape sphere(m_radiuses[i]);
+                ProjectileSweepCallback sweepResult(from, to, m_ownerIDs[i]);
+                sweepResult.m_collisionFilterGroup = static_cast<int>(m_collGroups[i]);
+                sweepResult.m_collisionFilterMask = static_cast<int>(m_collMasks[i]);
+
+                fromTransform.setOrigin(from);
+                toTransform.setOrigin(to);
+                world->convexSweepTest(&sphere, fromTransform, toTransform, sweepResult);
+
+                if(sweepResult.hasHit())
+                {
+                    hittedObject = sweepResult.m_hitCollisionObject;
+                    hitTriangleIndex = sweepResult.hitTriangleIndex;
+                    hitPoint = sweepResult.m_hitPointWorld;
+                    hitNormal = sweepResult.m_hitNormalWorld;
+                }
+            }
+            else
+            {
+                ProjectileRayCallback rayResult(from, to, m_ownerIDs[i]);
+                rayResult.m_flags |= btTriangleRaycastCallback::kF_FilterBackfaces;
+                rayResult.m_collisionFilterGroup = static_cast<int>(m_collGroups[i]);
+                rayResult.m_collisionFilterMask = static_cast<int>(m_collMasks[i]);
+
+                world->rayTest(from, to, rayResult);
+
+                if(rayResult.hasHit())
+                {
+                    hittedObject = rayResult.m_collisionObject;
+                    hitTriangleIndex = rayResult.hitTriangleIndex;
+                    hitPoint = rayResult.m_hitPointWorld;
+                    hitNormal = rayResult.m_hitNormalWorld;
+                }
+            }
+
+            if(hittedObject)
+            {
+                const RigidBodyData* data = static_cast<const RigidBodyData*>(hittedObject->getUserPointer());
+
+                m_isDead[i] = 1;
+                m_positions[i] = glm::vec3(hitPoint.x(), hitPoint.y(), hitPoint.z());
+
+                ProjectileHit& hit = m_hitSlots[i];
+                hit.projectileID = m_IDs[i];
+                hit.ownerID = m_ownerIDs[i];
+                hit.hittedObjectID = data->getObjectID(hitTriangleIndex);
+                hit.hittedCollGroup = data->collGroup;
+                hit.hitPoint = m_positions[i];
+                hit.hitNormal = glm::vec3(hitNormal.x(), hitNormal.y(), hitNormal.z());
+                hit.velocity = m_velocities[i];
+            }
+        }
+    }
+
+    void ProjectileSystem::removeDeadAndCollectHits()
+    {
+        // One pass. Keep order of alive projectiles.
+        const int count = static_cast<int>(m_positions.size());
+        int aliveCount = 0;
+        for(int i = 0; i < count; ++i)
+        {
+            if(m_isDead[i])
+            {
+                if(m_hitSlots[i].hittedObjectID != -1)
+                    m_hits.push_back(m_hitSlots[i]);
+
+                continue;
+            }
+
+            if(aliveCount != i)
+            {
+                m_positions[aliveCount] = m_positions[i];
+                m_velocities[aliveCount] = m_velocities[i];
+                m_gravities[aliveCount] = m_gravities[i];
+                m_lifeTimesLeft[aliveCount] = m_lifeTimesLeft[i];
+                m_radiuses[aliveCount] = m_radiuses[i];
+                m_IDs[aliveCount] = m_IDs[i];
+                m_ownerIDs[aliveCount] = m_ownerIDs[i];
+                m_collGroups[aliveCount] = m_collGroups[i];
+                m_collMasks[aliveCount] = m_collMasks[i];
+                m_isDead[aliveCount] = 0;
+                m_hitSlots[aliveCount] = m_hitSlots[i];
+            }
+
+            ++aliveCount;
+        }
+
+        m_positions.resize(aliveCount);
+        m_velocities.resize(aliveCount);
+        m_gravities.resize(aliveCount);
+        m_lifeTimesLeft.resize(aliveCount);
+        m_radiuses.resize(aliveCount);
+        m_IDs.resize(aliveCount);
+        m_ownerIDs.resize(aliveCount);
+        m_collGroups.resize(aliveCount);
+        m_collMasks.resize(aliveCount);
+        m_isDead.resize(aliveCount);
+        m_hitSlots.resize(aliveCount);
+    }
+}
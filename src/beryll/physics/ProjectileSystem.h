@@ -0,0 +1,90 @@
+#pragma once
+
+#include "LibsHeaders.h"
+#include "CppHeaders.h"
+
+#include "beryll/physics/Physics.h"
+
+namespace Beryll
+{
+    // Compact hit event. Projectile is removed after hit.
+    struct ProjectileHit
+    {
+        int projectileID = -1;
+        int ownerID = -1; // Object which fired projectile.
+        int hittedObjectID = -1;
+        CollisionGroups hittedCollGroup = CollisionGroups::NONE;
+        glm::vec3 hitPoint{0.0f};
+        glm::vec3 hitNormal{0.0f};
+        glm::vec3 velocity{0.0f}; // Projectile velocity at hit moment.
+    };
+
+    // Lightweight projectiles (bullets, arrows, ...) without rigid body in physics world.
+    // Stored as structure of arrays. Moved with simple ballistics and check hits with
+    // ray (radius = 0) or sphere sweep (radius > 0) from previous to new position.
+    // Updated after Physics::simulate() and before GameStateMachine::updateAfterPhysics().
+    class ProjectileSystem final
+    {
+    public:
+        ProjectileSystem() = delete;
+        ~ProjectileSystem() = delete;
+
+        // Return projectile ID or -1 if max count reached.
+        static int spawn(const glm::vec3& pos,
+                         const glm::vec3& velocity,
+                         const glm::vec3& gravity,
+                         float lifeTimeSec,
+                         float radius,
+                         const int ownerID,
+                         CollisionGroups collGroup,
+                         CollisionGroups collMask);
+
+        static void removeAll(); // Call it before you exit game state/level.
+
+        // Hits from last update. Valid until next frame.
+        static const std::vector<ProjectileHit>& getHits() { return m_hits; }
+
+        // Use for draw. Index in range 0...getActiveCount().
+        static int getActiveCount() { return static_cast<int>(m_positions.size()); }
+        static const std::vector<glm::vec3>& getPositions() { return m_positions; }
+        static const std::vector<glm::vec3>& getVelocities() { return m_velocities; }
+        static const std::vector<int>& getIDs() { return m_IDs; }
+
+        static void setMaxCount(int count) { if(count > 0) { m_maxCount = count; } }
+        static float getUpdateTime() { return m_updateTime; } // Update time in milli sec.
+
+    private:
+        friend class GameLoop;
+        friend struct PhysicsTestAccess; // Host benchmark (tools/beryllCook/tests) updates projectiles without GameLoop.
+        static void create();
+        static void update();
+
+        static void updateRange(int begin, int end, float timeStep);
+        static void removeDeadAndCollectHits();
+
+        // Structure of arrays. All vectors have same size.
+        static std::vector<glm::vec3> m_positions;
+        static std::vector<glm::vec3> m_velocities;
+        static std::vector<glm::vec3> m_gravities;
+        static std::vector<float> m_lifeTimesLeft;
+        static std::vector<float> m_radiuses;
+        static std::vector<int> m_IDs;
+        static std::vector<int> m_ownerIDs;
+        static std::vector<CollisionGroups> m_collGroups;
+        static std::vector<CollisionGroups> m_collMasks;
+        // Written by worker threads. One slot per projectile, so no locks needed.
+        static std::vector<uint8_t> m_isDead; // Hit or life time is over. Not std::vector<bool> because it is not thread safe for write.
+        static std::vector<ProjectileHit> m_hitSlots;
+
+        static std::vector<ProjectileHit> m_hits;
+
+        static int m_maxCount;
+        static int m_nextID;
+        static float m_updateTime;
+        static Timer m_timer;
+
+        static std::function<void(std::vector<glm::vec3>&, int, int)> m_updateRangeAsync;
+        static float m_currentTimeStep;
+        static constexpr int m_minCountForAsync = 256; // Less projectiles are faster on main thread.
+    };
+}
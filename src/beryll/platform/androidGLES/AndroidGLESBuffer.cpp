@@ -5,29 +5,161 @@
 
 namespace Beryll
 {
+    std::vector<std::weak_ptr<AndroidGLESBufferArena>> AndroidGLESBufferArena::m_vertexArenas;
+    std::vector<std::weak_ptr<AndroidGLESBufferArena>> AndroidGLESBufferArena::m_indexArenas;
+
+    // Buffer arena
+    AndroidGLESBufferArena::AndroidGLESBufferArena(uint64_t sizeBytes)
+    {
+        // GL_COPY_WRITE_BUFFER does not change GL_ELEMENT_ARRAY_BUFFER of bound VAO.
+        glGenBuffers(1, &m_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, sizeBytes, nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        m_freeRanges.emplace(0, sizeBytes);
+    }
+
+    AndroidGLESBufferArena::~AndroidGLESBufferArena()
+    {
+        glDeleteBuffers(1, &m_buffer);
+    }
+
+    std::shared_ptr<AndroidGLESBufferArena> AndroidGLESBufferArena::allocateVertices(const void* data, uint64_t sizeBytes, uint64_t& offsetBytes)
+    {
+        return allocate(m_vertexArenas, data, sizeBytes, offsetBytes);
+    }
+
+    std::shared_ptr<AndroidGLESBufferArena> AndroidGLESBufferArena::allocateIndices(const void* data, uint64_t sizeBytes, uint64_t& offsetBytes)
+    {
+        return allocate(m_indexArenas, data, sizeBytes, offsetBytes);
+    }
+
+    std::shared_ptr<AndroidGLESBufferArena> AndroidGLESBufferArena::allocate(std::vector<std::weak_ptr<AndroidGLESBufferArena>>& arenas,
+                                                                             const void* data, uint64_t sizeBytes, uint64_t& offsetBytes)
+    {
+        // Deleted arenas (all parts returned) are removed here.
+        arenas.erase(std::remove_if(arenas.begin(), arenas.end(), [](const std::weak_ptr<AndroidGLESBufferArena>& a) { return a.expired(); }),
+                     arenas.end());
+
+        std::shared_ptr<AndroidGLESBufferArena> arena;
+        for(const std::weak_ptr<AndroidGLESBufferArena>& weakArena : arenas)
+        {
+            std::shared_ptr<AndroidGLESBufferArena> candidate = weakArena.lock();
+            if(candidate->allocateRange(sizeBytes, offsetBytes))
+            {
+                arena = std::move(candidate);
+                break;
+            }
+        }
+
+        if(!arena)
+        {
+            arena = std::shared_ptr<AndroidGLESBufferArena>(new AndroidGLESBufferArena(std::max(sizeBytes, m_arenaSizeBytes)));
+            arena->allocateRange(sizeBytes, offsetBytes);
+            arenas.push_back(arena);
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, arena->m_buffer);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, offsetBytes, sizeBytes, data);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        return arena;
+    }
+
+    bool AndroidGLESBufferArena::allocateRange(uint64_t sizeBytes, uint64_t& offsetBytes)
+    {
+        // First fit. Range starts are always aligned because sizes are rounded up.
+        const uint64_t alignedSize = (sizeBytes + m_alignment - 1) & ~(m_alignment - 1);
+        for(auto it = m_freeRanges.begin(); it != m_freeRanges.end(); ++it)
+        {
+            if(it->second < alignedSize)
+                continue;
+
+            offsetBytes = it->first;
+            const uint64_t restSize = it->second - alignedSize;
+            m_freeRanges.erase(it);
+            if(restSize > 0)
+                m_freeRanges.emplace(offsetBytes + alignedSize, restSize);
+            return true;
+        }
+        return false;
+    }
+
+    void AndroidGLESBufferArena::free(uint64_t offsetBytes, uint64_t sizeBytes)
+    {
+        uint64_t start = offsetBytes;
+        uint64_t size = (sizeBytes + m_alignment - 1) & ~(m_alignment - 1);
+
+        auto next = m_freeRanges.lower_bound(start);
+        if(next != m_freeRanges.end() && start + size == next->first)
+        {
+            size += next->second;
+            next = m_freeRanges.erase(next);
+        }
+        if(next != m_freeRanges.begin())
+        {
+            auto previous = std::prev(next);
+            if(previous->first + previous->second == start)
+            {
+                start = previous->first;
+                size += previous->second;
+                m_freeRanges.erase(previous);
+            }
+        }
+
+        m_freeRanges.emplace(start, size);
+    }
+
     // Static vertex buffer
     AndroidGLESStaticVertexBuffer::AndroidGLESStaticVertexBuffer(const std::vector<glm::vec2>& data)
+        : AndroidGLESStaticVertexBuffer(data.data(), data.size())
+    {
+
+    }
+
+    AndroidGLESStaticVertexBuffer::AndroidGLESStaticVertexBuffer(const std::vector<glm::vec3>& data)
+        : AndroidGLESStaticVertexBuffer(data.data(), data.size())
+    {
+
+    }
+
+    AndroidGLESStaticVertexBuffer::AndroidGLESStaticVertexBuffer(const glm::vec2* data, uint32_t count)
     {
         glGenBuffers(1, &m_VBO);
         glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(glm::vec2), data.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, count * sizeof(glm::vec2), data, GL_STATIC_DRAW);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
 
         m_vertAttribType = VertexAttribType::FLOAT;
         m_vertAttribSize = VertexAttribSize::TWO;
     }
 
-    AndroidGLESStaticVertexBuffer::AndroidGLESStaticVertexBuffer(const std::vector<glm::vec3>& data)
+    AndroidGLESStaticVertexBuffer::AndroidGLESStaticVertexBuffer(const glm::vec3* data, uint32_t count)
     {
         glGenBuffers(1, &m_VBO);
         glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-        glBufferData(GL_ARRAY_BUFFER, data.size() * sizeof(glm::vec3), data.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, count * sizeof(glm::vec3), data, GL_STATIC_DRAW);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
 
         m_vertAttribType = VertexAttribType::FLOAT;
         m_vertAttribSize = VertexAttribSize::THREE;
     }
 
+    AndroidGLESStaticVertexBuffer::AndroidGLESStaticVertexBuffer(const void* data, uint32_t count, VertexAttribType type, VertexAttribSize size)
+    {
+        const uint32_t vertexBytes = getVertexAttribBytes(type, size);
+        BR_ASSERT((vertexBytes != 0), "%s", "Unknown vertex buffer data type or size.");
+
+        glGenBuffers(1, &m_VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+        glBufferData(GL_ARRAY_BUFFER, count * vertexBytes, data, GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_vertAttribType = type;
+        m_vertAttribSize = size;
+    }
+
     AndroidGLESStaticVertexBuffer::AndroidGLESStaticVertexBuffer(const std::vector<glm::vec4>& data)
     {
         glGenBuffers(1, &m_VBO);
@@ -76,6 +208,32 @@ namespace Beryll
         glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
+    // Interleaved vertex buffer
+    AndroidGLESInterleavedVertexBuffer::AndroidGLESInterleavedVertexBuffer(const void* data, uint32_t count, uint32_t stride,
+                                                                           const std::vector<VertexAttribute>& attributes)
+        : m_sizeBytes(uint64_t(count) * stride)
+    {
+        m_arena = AndroidGLESBufferArena::allocateVertices(data, m_sizeBytes, m_offsetBytes);
+
+        m_attributes = attributes;
+        m_stride = stride;
+    }
+
+    AndroidGLESInterleavedVertexBuffer::~AndroidGLESInterleavedVertexBuffer()
+    {
+        m_arena->free(m_offsetBytes, m_sizeBytes);
+    }
+
+    void AndroidGLESInterleavedVertexBuffer::bind()
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_arena->getBufferID());
+    }
+
+    void AndroidGLESInterleavedVertexBuffer::unBind()
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
     // Dynamic vertex buffer
     AndroidGLESDynamicVertexBuffer::AndroidGLESDynamicVertexBuffer(VertexAttribType type, VertexAttribSize size, uint32_t maxSizeBytes)
         : m_originalSizeBytes(maxSizeBytes)
@@ -141,14 +299,31 @@ namespace Beryll
     }
 
     // Index buffer
-    AndroidGLESStaticIndexBuffer::AndroidGLESStaticIndexBuffer(const std::vector<uint32_t>& indices) : m_originalCount(indices.size())
+    AndroidGLESStaticIndexBuffer::AndroidGLESStaticIndexBuffer(const std::vector<uint32_t>& indices)
+        : AndroidGLESStaticIndexBuffer(indices.data(), indices.size())
+    {
+
+    }
+
+    AndroidGLESStaticIndexBuffer::AndroidGLESStaticIndexBuffer(const uint32_t* indices, uint32_t count) : m_originalCount(count)
+    {
+        glGenBuffers(1, &m_EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        m_count = count;
+    }
+
+    AndroidGLESStaticIndexBuffer::AndroidGLESStaticIndexBuffer(const uint16_t* indices, uint32_t count) : m_originalCount(count)
     {
         glGenBuffers(1, &m_EBO);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint16_t), indices, GL_STATIC_DRAW);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-        m_count = indices.size();
+        m_count = count;
+        m_indexType = IndexType::UNSIGNED_SHORT;
     }
 
     AndroidGLESStaticIndexBuffer::~AndroidGLESStaticIndexBuffer()
@@ -172,4 +347,44 @@ namespace Beryll
 
         m_count = count;
     }
+
+    // Shared index buffer
+    AndroidGLESSharedIndexBuffer::AndroidGLESSharedIndexBuffer(const uint32_t* indices, uint32_t count)
+        : m_sizeBytes(uint64_t(count) * sizeof(uint32_t)), m_originalCount(count)
+    {
+        m_arena = AndroidGLESBufferArena::allocateIndices(indices, m_sizeBytes, m_offsetBytes);
+
+        m_count = count;
+    }
+
+    AndroidGLESSharedIndexBuffer::AndroidGLESSharedIndexBuffer(const uint16_t* indices, uint32_t count)
+        : m_sizeBytes(uint64_t(count) * sizeof(uint16_t)), m_originalCount(count)
+    {
+        m_arena = AndroidGLESBufferArena::allocateIndices(indices, m_sizeBytes, m_offsetBytes);
+
+        m_count = count;
+        m_indexType = IndexType::UNSIGNED_SHORT;
+    }
+
+    AndroidGLESSharedIndexBuffer::~AndroidGLESSharedIndexBuffer()
+    {
+        m_arena->free(m_offsetBytes, m_sizeBytes);
+    }
+
+    void AndroidGLESSharedIndexBuffer::bind()
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_arena->getBufferID());
+    }
+
+    void AndroidGLESSharedIndexBuffer::unBind()
+    {
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    void AndroidGLESSharedIndexBuffer::setCount(uint32_t count)
+    {
+        BR_ASSERT((count <= m_originalCount), "%s", "New count can not be more that original size");
+
+        m_count = count;
+    }
 }
\ No newline at end of file
@@ -5,6 +5,37 @@
 
 namespace Beryll
 {
+    // Big GL buffer shared by meshes. Meshes allocate part of it and return part on destruction.
+    // Arena is deleted when last part is returned.
+    class AndroidGLESBufferArena final
+    {
+    public:
+        AndroidGLESBufferArena() = delete;
+        ~AndroidGLESBufferArena();
+
+        // Part of any arena which has free space. New arena is created if needed. Data is copied to part.
+        static std::shared_ptr<AndroidGLESBufferArena> allocateVertices(const void* data, uint64_t sizeBytes, uint64_t& offsetBytes);
+        static std::shared_ptr<AndroidGLESBufferArena> allocateIndices(const void* data, uint64_t sizeBytes, uint64_t& offsetBytes);
+        void free(uint64_t offsetBytes, uint64_t sizeBytes);
+
+        uint32_t getBufferID() const { return m_buffer; }
+
+    private:
+        explicit AndroidGLESBufferArena(uint64_t sizeBytes);
+
+        static std::shared_ptr<AndroidGLESBufferArena> allocate(std::vector<std::weak_ptr<AndroidGLESBufferArena>>& arenas,
+                                                                const void* data, uint64_t sizeBytes, uint64_t& offsetBytes);
+        bool allocateRange(uint64_t sizeBytes, uint64_t& offsetBytes);
+
+        uint32_t m_buffer = 0;
+        std::map<uint64_t, uint64_t> m_freeRanges; // Offset, size. Neighbour ranges are merged.
+
+        static constexpr uint64_t m_arenaSizeBytes = 4 * 1024 * 1024; // Bigger meshes get own arena.
+        static constexpr uint64_t m_alignment = 16;
+        static std::vector<std::weak_ptr<AndroidGLESBufferArena>> m_vertexArenas;
+        static std::vector<std::weak_ptr<AndroidGLESBufferArena>> m_indexArenas;
+    };
+
     class AndroidGLESStaticVertexBuffer : public VertexBuffer
     {
     public:
@@ -35,6 +66,10 @@ namespace Beryll
         AndroidGLESStaticVertexBuffer(const std::vector<glm::vec4>& data);
         AndroidGLESStaticVertexBuffer(const std::vector<glm::ivec4>& data);
         AndroidGLESStaticVertexBuffer(const std::vector<glm::mat4>& data);
+        AndroidGLESStaticVertexBuffer(const glm::vec2* data, uint32_t count);
+        AndroidGLESStaticVertexBuffer(const glm::vec3* data, uint32_t count);
+        // Any format. count of vertices.
+        AndroidGLESStaticVertexBuffer(const void* data, uint32_t count, VertexAttribType type, VertexAttribSize size);
 
         uint32_t m_VBO = 0;
     };
@@ -62,6 +97,38 @@ namespace Beryll
         const uint32_t m_originalSizeBytes = 0;
     };
 
+    // All attributes of mesh in one buffer. Part of AndroidGLESBufferArena.
+    class AndroidGLESInterleavedVertexBuffer : public VertexBuffer
+    {
+    public:
+        AndroidGLESInterleavedVertexBuffer() = delete;
+        ~AndroidGLESInterleavedVertexBuffer() override;
+
+        void bind() override; // Must be called only inside VAO
+        void unBind() override; // Must be called only inside VAO
+
+        void setDynamicBufferData(const std::vector<glm::vec3>& data, uint32_t elementsCount) override
+        {
+            BR_ASSERT(false, "%s", "Can not set data into interleaved vertex buffer");
+        };
+        void setDynamicBufferData(const std::vector<glm::vec4>& data, uint32_t elementsCount) override
+        {
+            BR_ASSERT(false, "%s", "Can not set data into interleaved vertex buffer");
+        };
+        void setDynamicBufferData(const std::vector<glm::mat4>& data, uint32_t elementsCount) override
+        {
+            BR_ASSERT(false, "%s", "Can not set data into interleaved vertex buffer");
+        };
+
+    private:
+        friend class Renderer;
+        // data - count vertices of stride bytes.
+        AndroidGLESInterleavedVertexBuffer(const void* data, uint32_t count, uint32_t stride, const std::vector<VertexAttribute>& attributes);
+
+        std::shared_ptr<AndroidGLESBufferArena> m_arena;
+        uint64_t m_sizeBytes = 0;
+    };
+
     // Dynamic index buffer can be achieved by changing m_count inside setCount(uint32_t count)
     class AndroidGLESStaticIndexBuffer : public IndexBuffer
     {
@@ -76,8 +143,31 @@ namespace Beryll
     private:
         friend class Renderer;
         AndroidGLESStaticIndexBuffer(const std::vector<uint32_t>& indices);
+        AndroidGLESStaticIndexBuffer(const uint32_t* indices, uint32_t count);
+        AndroidGLESStaticIndexBuffer(const uint16_t* indices, uint32_t count);
 
         uint32_t m_EBO = 0;
         const uint32_t m_originalCount = 0;
     };
+
+    // Part of AndroidGLESBufferArena.
+    class AndroidGLESSharedIndexBuffer : public IndexBuffer
+    {
+    public:
+        AndroidGLESSharedIndexBuffer() = delete;
+        ~AndroidGLESSharedIndexBuffer() override;
+
+        void bind() override;
+        void unBind() override;
+
+        void setCount(uint32_t count) override;
+    private:
+        friend class Renderer;
+        AndroidGLESSharedIndexBuffer(const uint32_t* indices, uint32_t count);
+        AndroidGLESSharedIndexBuffer(const uint16_t* indices, uint32_t count);
+
+        std::shared_ptr<AndroidGLESBufferArena> m_arena;
+        uint64_t m_sizeBytes = 0;
+        const uint32_t m_originalCount = 0;
+    };
 }
\ No newline at end of file
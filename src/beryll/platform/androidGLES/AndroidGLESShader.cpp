@@ -1,6 +1,7 @@
 #include "AndroidGLESShader.h"
 #include "beryll/core/Log.h"
-#include "beryll/utils/File.h"
+#include "beryll/utils/FileView.h"
+#include "beryll/core/AssetRegistry.h"
 #include "beryll/platform/androidGLES/AndroidGLESGlobal.h"
 
 #include <GLES3/gl32.h>
@@ -8,33 +9,40 @@
 
 namespace Beryll
 {
-    std::map<const std::string, std::shared_ptr<uint32_t>> AndroidGLESShader::m_shaderPrograms;
-
     AndroidGLESShader::AndroidGLESShader(const char* vertexPath, const char* fragmentPath)
     {
         m_ID = vertexPath;
         m_ID += fragmentPath;
 
-        auto result =  m_shaderPrograms.find(m_ID);
-        if(result != m_shaderPrograms.end())
+        m_program = AssetRegistry::find<const GPUProgram>(AssetType::SHADER, m_ID);
+        if(m_program)
         {
             // Shaders with given source was compiled and added before.
             // Use it.
             //BR_INFO("%s", "shaders with given source was compiled and added before");
-            m_shaderProgramID = result->second; // Copy shared pointer.
+            m_shaderProgramID = m_program->openGLID;
             return;
         }
 
-        const char* vertexShaderCode = BeryllUtils::File::readToBuffer(vertexPath);
-        const char* fragmentShaderCode = BeryllUtils::File::readToBuffer(fragmentPath);
+        BeryllUtils::FileView vertexFile;
+        BeryllUtils::FileView fragmentFile;
+        const bool vertexOpened = vertexFile.open(vertexPath);
+        const bool fragmentOpened = fragmentFile.open(fragmentPath);
+        BR_ASSERT(vertexOpened, "File reading error: %s", vertexPath);
+        BR_ASSERT(fragmentOpened, "File reading error: %s", fragmentPath);
 
         GLuint vertexShaderID = glCreateShader(GL_VERTEX_SHADER);
         GLuint fragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
 
-        glShaderSource(vertexShaderID, 1, &vertexShaderCode, 0);
-        delete[] vertexShaderCode;
-        glShaderSource(fragmentShaderID, 1, &fragmentShaderCode, 0);
-        delete[] fragmentShaderCode;
+        // File views are not null terminated. Pass lengths.
+        const char* vertexShaderCode = vertexFile.getData();
+        const GLint vertexShaderLength = static_cast<GLint>(vertexFile.getSize());
+        glShaderSource(vertexShaderID, 1, &vertexShaderCode, &vertexShaderLength);
+        vertexFile.close();
+        const char* fragmentShaderCode = fragmentFile.getData();
+        const GLint fragmentShaderLength = static_cast<GLint>(fragmentFile.getSize());
+        glShaderSource(fragmentShaderID, 1, &fragmentShaderCode, &fragmentShaderLength);
+        fragmentFile.close();
 
         glCompileShader(vertexShaderID);
         GLint compiled;
@@ -65,57 +73,57 @@ namespace Beryll
             BR_ASSERT(false, "%s", "Fragment Shader failed");
         }
 
-        m_shaderProgramID = std::make_shared<uint32_t>();
-
-        *m_shaderProgramID = glCreateProgram();
-        glAttachShader(*m_shaderProgramID, vertexShaderID);
-        glAttachShader(*m_shaderProgramID, fragmentShaderID);
+        std::shared_ptr<GPUProgram> program = std::make_shared<GPUProgram>();
+        program->openGLID = glCreateProgram();
+        m_shaderProgramID = program->openGLID;
+        glAttachShader(m_shaderProgramID, vertexShaderID);
+        glAttachShader(m_shaderProgramID, fragmentShaderID);
 
-        glLinkProgram(*m_shaderProgramID);
+        glLinkProgram(m_shaderProgramID);
 
-        glDetachShader(*m_shaderProgramID, vertexShaderID);
-        glDetachShader(*m_shaderProgramID, fragmentShaderID);
+        glDetachShader(m_shaderProgramID, vertexShaderID);
+        glDetachShader(m_shaderProgramID, fragmentShaderID);
         glDeleteShader(vertexShaderID);     // Only mark for delete in future if was not detached !!!
         glDeleteShader(fragmentShaderID);   // Will be deleted during call glDeleteProgram(programID);
                                                    // or deleted now if was detached.
 
-        m_shaderPrograms.insert(std::make_pair(m_ID, m_shaderProgramID));
+        // Size of program binary as approximate memory used by driver.
+        GLint binarySize = 0;
+        glGetProgramiv(m_shaderProgramID, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+
+        m_program = program;
+        AssetRegistry::add(AssetType::SHADER, m_ID, program, static_cast<uint64_t>(std::max(binarySize, 0)));
     }
 
     AndroidGLESShader::~AndroidGLESShader()
     {
-        if(m_shaderProgramID.use_count() <= 2)
-        {
-            // use_count() <= 2 means only shared_ptr in this class left and in map.
-            // If we destroy this m_shaderProgramID (last copy except copy in map) also delete from OpenGL and map.
-            auto result =  m_shaderPrograms.find(m_ID);
-            if(result != m_shaderPrograms.end())
-            {
-                if(GLESStateVariables::currentShaderProgram == *m_shaderProgramID)
-                {
-                    GLESStateVariables::currentShaderProgram = 0;
-                }
+        // Program stays in AssetRegistry for reuse. Deleted when evicted and not used by other objects.
+    }
 
-                glDeleteProgram(*m_shaderProgramID);
-                m_shaderPrograms.erase(result);
-            }
+    AndroidGLESShader::GPUProgram::~GPUProgram()
+    {
+        if(GLESStateVariables::currentShaderProgram == openGLID)
+        {
+            GLESStateVariables::currentShaderProgram = 0;
         }
+
+        glDeleteProgram(openGLID);
     }
 
     void AndroidGLESShader::bind()
     {
-        if(GLESStateVariables::currentShaderProgram != *m_shaderProgramID)
+        if(GLESStateVariables::currentShaderProgram != m_shaderProgramID)
         {
             //BR_INFO("%s", "bind shader");
-            glUseProgram(*m_shaderProgramID);
-            GLESStateVariables::currentShaderProgram = *m_shaderProgramID;
+            glUseProgram(m_shaderProgramID);
+            GLESStateVariables::currentShaderProgram = m_shaderProgramID;
         }
     }
 
     void AndroidGLESShader::unBind()
     {
         // This object can unbind only his own shader program.
-        if(GLESStateVariables::currentShaderProgram == *m_shaderProgramID)
+        if(GLESStateVariables::currentShaderProgram == m_shaderProgramID)
         {
             glUseProgram(0);
             GLESStateVariables::currentShaderProgram = 0;
@@ -133,7 +141,7 @@ namespace Beryll
             }
         }
         
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniform1f(id, x);
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
     }
@@ -149,7 +157,7 @@ namespace Beryll
             }
         }
         
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniform2f(id, vec.x, vec.y);
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
     }
@@ -165,7 +173,7 @@ namespace Beryll
             }
         }
         
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniform3f(id, vec.x, vec.y, vec.z);
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
     }
@@ -181,7 +189,7 @@ namespace Beryll
             }
         }
         
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniform4f(id, vec.x, vec.y, vec.z, vec.w);
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
     }
@@ -197,7 +205,7 @@ namespace Beryll
             }
         }
         
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniform1i(id, x);
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
     }
@@ -213,7 +221,7 @@ namespace Beryll
             }
         }
         
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniform2i(id, x, y);
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
     }
@@ -229,7 +237,7 @@ namespace Beryll
             }
         }
 
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniform3i(id, x, y, z);
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
     }
@@ -245,7 +253,7 @@ namespace Beryll
             }
         }
 
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniform4i(id, x, y, z, w);
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
     }
@@ -261,7 +269,7 @@ namespace Beryll
             }
         }
 
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniformMatrix4fv(id, 1, GL_FALSE, glm::value_ptr(value));
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
     }
@@ -278,7 +286,7 @@ namespace Beryll
             }
         }
 
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniformMatrix4fv(id, 1, GL_TRUE,
                            reinterpret_cast<float*>(const_cast<aiMatrix4x4*>(&value)));
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
@@ -295,53 +303,70 @@ namespace Beryll
             }
         }
 
-        int id = glGetUniformLocation(*m_shaderProgramID, name);
+        int id = glGetUniformLocation(m_shaderProgramID, name);
         glUniformMatrix3fv(id, 1, GL_FALSE, glm::value_ptr(value));
         m_uniformsNameID.emplace_back(UniformsLocations{name, id});
     }
 
+    void AndroidGLESShader::setMatrix4x4FloatArray(const char* name, const glm::mat4* values, const uint32_t count)
+    {
+        for(const UniformsLocations& uniforms : m_uniformsNameID)
+        {
+            if(uniforms.name == name)
+            {
+                glUniformMatrix4fv(uniforms.id, count, GL_FALSE, glm::value_ptr(values[0]));
+                return;
+            }
+        }
+
+        // Location of array = location of first element.
+        int id = glGetUniformLocation(m_shaderProgramID, name);
+        glUniformMatrix4fv(id, count, GL_FALSE, glm::value_ptr(values[0]));
+        m_uniformsNameID.emplace_back(UniformsLocations{name, id});
+    }
+
     void AndroidGLESShader::activateDiffuseTextureMat1()
     {
-        glUniform1i(glGetUniformLocation(*m_shaderProgramID, "diffuseTexture"), 0);
+        glUniform1i(glGetUniformLocation(m_shaderProgramID, "diffuseTexture"), 0);
     }
 
     void AndroidGLESShader::activateSpecularTextureMat1()
     {
-        glUniform1i(glGetUniformLocation(*m_shaderProgramID, "specularTexture"), 1);
+        glUniform1i(glGetUniformLocation(m_shaderProgramID, "specularTexture"), 1);
     }
 
     void AndroidGLESShader::activateNormalMapTextureMat1()
     {
-        glUniform1i(glGetUniformLocation(*m_shaderProgramID, "normalMapTexture"), 2);
+        glUniform1i(glGetUniformLocation(m_shaderProgramID, "normalMapTexture"), 2);
     }
 
     void AndroidGLESShader::activateDiffuseTextureMat2()
     {
-        glUniform1i(glGetUniformLocation(*m_shaderProgramID, "diffuseTextureMat2"), 3);
+        glUniform1i(glGetUniformLocation(m_shaderProgramID, "diffuseTextureMat2"), 3);
     }
 
     void AndroidGLESShader::activateSpecularTextureMat2()
     {
-        glUniform1i(glGetUniformLocation(*m_shaderProgramID, "specularTextureMat2"), 4);
+        glUniform1i(glGetUniformLocation(m_shaderProgramID, "specularTextureMat2"), 4);
     }
 
     void AndroidGLESShader::activateNormalMapTextureMat2()
     {
-        glUniform1i(glGetUniformLocation(*m_shaderProgramID, "normalMapTextureMat2"), 5);
+        glUniform1i(glGetUniformLocation(m_shaderProgramID, "normalMapTextureMat2"), 5);
     }
 
     void AndroidGLESShader::activateBlendTextureMat2()
     {
-        glUniform1i(glGetUniformLocation(*m_shaderProgramID, "blendTextureMat2"), 6);
+        glUniform1i(glGetUniformLocation(m_shaderProgramID, "blendTextureMat2"), 6);
     }
 
     void AndroidGLESShader::activateSkyBoxTexture()
     {
-        glUniform1i(glGetUniformLocation(*m_shaderProgramID, "skyBoxTexture"), 7);
+        glUniform1i(glGetUniformLocation(m_shaderProgramID, "skyBoxTexture"), 7);
     }
 
     void AndroidGLESShader::activateShadowMapTexture()
     {
-        glUniform1i(glGetUniformLocation(*m_shaderProgramID, "shadowMapTexture"), 8);
+        glUniform1i(glGetUniformLocation(m_shaderProgramID, "shadowMapTexture"), 8);
     }
 }
@@ -26,6 +26,7 @@ namespace Beryll
         void setMatrix4x4Float(const char* name, const glm::mat4& value) override;
         void setMatrix4x4Float(const char* name, const aiMatrix4x4& value) override;
         void setMatrix3x3Float(const char* name, const glm::mat3& value) override;
+        void setMatrix4x4FloatArray(const char* name, const glm::mat4* values, const uint32_t count) override;
 
         // Material 1.
         void activateDiffuseTextureMat1() override;
@@ -49,15 +50,19 @@ namespace Beryll
          */
         AndroidGLESShader(const char* vertexPath, const char* fragmentPath);
 
-        // keep shaders in static map and reuse them
-        // key = vertexPath + fragmentPath
-        // value = shader program
-        static std::map<const std::string, std::shared_ptr<uint32_t>> m_shaderPrograms;
+        // Shared by all objects with same m_ID. Cached in AssetRegistry (key = m_ID) for reuse.
+        // Deleted from GPU when registry evicts it and no object uses it.
+        struct GPUProgram
+        {
+            ~GPUProgram();
+
+            uint32_t openGLID = 0;
+        };
 
-        std::string m_ID; // ID in static map = vertexPath + fragmentPath
+        std::string m_ID; // ID in AssetRegistry = vertexPath + fragmentPath
                           // if many objects load same shader, shader ID will same for all of them
-        std::shared_ptr<uint32_t> m_shaderProgramID; // ID in OpenGL
-                                                     // will copied across all objects with same m_ID
+        std::shared_ptr<const GPUProgram> m_program;
+        uint32_t m_shaderProgramID = 0; // ID in OpenGL. Copy of m_program->openGLID
 
         struct UniformsLocations
         {
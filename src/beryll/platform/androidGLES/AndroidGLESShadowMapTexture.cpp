@@ -107,7 +107,8 @@ namespace Beryll
             {
                 if(so->getIsEnabledDraw())
                 {
-                    m_shaderSimple->setMatrix4x4Float("MVPMatrix", VPLightMatrix * so->getModelMatrix());
+                    // Shadow map shader does not decode compact positions.
+                    m_shaderSimple->setMatrix4x4Float("MVPMatrix", VPLightMatrix * so->getModelMatrix() * so->getPositionDecodeMatrix());
                     so->useInternalShader = false;
                     so->useInternalMaterials = false;
                     so->draw();
@@ -120,21 +121,13 @@ namespace Beryll
         if(!animatedObj.empty())
         {
             m_shaderAnimated->bind();
-            std::string boneMatrixNameInShader;
             for(const std::shared_ptr<Beryll::BaseAnimatedObject>& ao: animatedObj)
             {
                 if(ao->getIsEnabledDraw())
                 {
                     m_shaderAnimated->setMatrix4x4Float("MVPMatrix", VPLightMatrix * ao->getModelMatrix());
 
-                    uint32_t boneCount = ao->getBoneCount();
-                    for(int i = 0; i < boneCount; ++i)
-                    {
-                        boneMatrixNameInShader = "bonesMatrices[";
-                        boneMatrixNameInShader += std::to_string(i);
-                        boneMatrixNameInShader += "]";
-                        m_shaderAnimated->setMatrix4x4Float(boneMatrixNameInShader.c_str(), ao->getBoneMatrices()[i].finalWorldTransform);
-                    }
+                    m_shaderAnimated->setMatrix4x4FloatArray("bonesMatrices", ao->getBoneMatrices().data(), ao->getBoneCount());
                     ao->useInternalShader = false;
                     ao->useInternalMaterials = false;
                     ao->draw();
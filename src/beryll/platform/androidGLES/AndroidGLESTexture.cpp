@@ -1,87 +1,383 @@
 #include "AndroidGLESTexture.h"
 #include "beryll/core/Log.h"
 #include "beryll/platform/androidGLES/AndroidGLESGlobal.h"
+#include "beryll/utils/KTXFile.h"
+#include "beryll/utils/MipChain.h"
+#include "beryll/utils/File.h"
+#include "beryll/async/AsyncRun.h"
+#include "beryll/core/AssetRegistry.h"
 
 #include <GLES3/gl32.h>
 #include <GLES3/gl3ext.h>
 
 namespace Beryll
 {
-    std::map<const std::string, std::shared_ptr<uint32_t>> AndroidGLESTexture::m_textures;
+    std::vector<int> AndroidGLESTexture::m_supportedCompressedFormats;
+    bool AndroidGLESTexture::m_supportedCompressedFormatsQueried = false;
+    std::unordered_map<std::string, bool> AndroidGLESTexture::m_fileExistsCache;
+    std::mutex AndroidGLESTexture::m_fileExistsCacheMutex;
 
     AndroidGLESTexture::AndroidGLESTexture(const char* path, TextureType type) : m_ID(path)
     {
         m_type = type;
 
-        auto result =  m_textures.find(m_ID);
-        if(result != m_textures.end())
+        m_GPUTexture = AssetRegistry::find<const GPUTexture>(AssetType::TEXTURE, m_ID);
+        if(m_GPUTexture)
         {
-            // Texture was created before, use it.
+            // Texture was created or preloaded before, use it.
             //BR_INFO("%s", "Texture was created before.");
-            m_openGLID = result->second; // Copy shared pointer.
+            m_openGLID = m_GPUTexture->openGLID;
+            m_width = m_GPUTexture->width;
+            m_height = m_GPUTexture->height;
             return;
         }
 
-        BR_ASSERT((m_ID.find_last_of('.') != std::string::npos), "Texture does not have extension: %s", m_ID.c_str());
-
-        BR_ASSERT(((m_ID.substr(m_ID.find_last_of('.')) == ".png") ||
-                   (m_ID.substr(m_ID.find_last_of('.')) == ".jpg")),
-                  "Supported only .png or .jpg textures: %s", m_ID.c_str());
-
         BR_ASSERT((type == TextureType::DIFFUSE_TEXTURE_MAT_1 || type == TextureType::SPECULAR_TEXTURE_MAT_1 || type == TextureType::NORMAL_MAP_TEXTURE_MAT_1 ||
                    type == TextureType::DIFFUSE_TEXTURE_MAT_2 || type == TextureType::SPECULAR_TEXTURE_MAT_2 || type == TextureType::NORMAL_MAP_TEXTURE_MAT_2 ||
                    type == TextureType::BLEND_TEXTURE_MAT_2), "%s", "Wrong texture type");
 
-        SDL_IOStream* rw = SDL_IOFromFile(m_ID.c_str(), "rb");
-        BR_ASSERT((rw != nullptr), "Load texture failed: %s", m_ID.c_str());
+        querySupportedCompressedFormats();
+
+        TextureStaging staging;
+        staging.ID = m_ID;
+        staging.type = type;
+        decode(staging);
+        BR_ASSERT(staging.decoded, "Texture format is not supported by device and .png/.jpg with same name not found: %s", m_ID.c_str());
+        if(!staging.decoded)
+            return; // Texture stays empty (ID 0).
+
+        m_GPUTexture = upload(staging);
+        m_openGLID = m_GPUTexture->openGLID;
+        m_width = m_GPUTexture->width;
+        m_height = m_GPUTexture->height;
+        //BR_INFO("%s", "Texture created.");
+    }
+
+    void AndroidGLESTexture::preload(const std::vector<std::pair<std::string, TextureType>>& textures)
+    {
+        // Skip cached and repeated paths. Only first type of repeated path is used as in constructor.
+        std::vector<TextureStaging> stagings;
+        stagings.reserve(textures.size());
+        for(const std::pair<std::string, TextureType>& texture : textures)
+        {
+            if(AssetRegistry::find<const GPUTexture>(AssetType::TEXTURE, texture.first) ||
+               std::any_of(stagings.begin(), stagings.end(), [&texture](const TextureStaging& s) { return s.ID == texture.first; }))
+                continue;
+
+            stagings.emplace_back();
+            stagings.back().ID = texture.first;
+            stagings.back().type = texture.second;
+        }
+
+        if(stagings.empty())
+            return;
+
+        // Worker threads dont call GL. List of formats must be ready before them.
+        querySupportedCompressedFormats();
+
+        // File reading, image decoding and mip generation. Stagings are independent. Safe in parallel.
+        if(stagings.size() > 1)
+        {
+            AsyncRun::Run(stagings, std::function<void(std::vector<TextureStaging>&, int, int)>(
+                [](std::vector<TextureStaging>& v, int begin, int end) -> void // -> void = return type.
+                {
+                    for(int i = begin; i < end; ++i)
+                    {
+                        decode(v[i]);
+                    }
+                }));
+        }
+        else
+        {
+            decode(stagings[0]);
+        }
+
+        // Upload on GL thread. Staging memory is freed after each texture.
+        // Preloaded textures are not referenced until created. Registry can evict them if budget is too small.
+        for(TextureStaging& staging : stagings)
+        {
+            BR_ASSERT(staging.decoded, "Texture format is not supported by device and .png/.jpg with same name not found: %s", staging.ID.c_str());
+            if(staging.decoded)
+                upload(staging);
+
+            staging = TextureStaging();
+        }
+    }
+
+    void AndroidGLESTexture::decode(TextureStaging& staging)
+    {
+        const std::string& ID = staging.ID;
+        BR_ASSERT((ID.find_last_of('.') != std::string::npos), "Texture does not have extension: %s", ID.c_str());
+
+        const std::string basePath = ID.substr(0, ID.find_last_of('.'));
+        const std::string extension = ID.substr(ID.find_last_of('.'));
+        BR_ASSERT((extension == ".png" || extension == ".jpg" || BeryllUtils::KTXFile::isKTXFile(ID)),
+                  "Supported only .png, .jpg, .ktx or .ktx2 textures: %s", ID.c_str());
+
+        // Compressed texture is preferred. Requested file is loaded without existence check to keep error on missing file.
+        std::vector<std::string> paths;
+        if(BeryllUtils::KTXFile::isKTXFile(ID))
+            paths = {ID, basePath + ".png", basePath + ".jpg"};
+        else
+            paths = {basePath + ".ktx2", basePath + ".ktx", ID};
+
+        for(const std::string& path : paths)
+        {
+            if(path != ID && !getIsFileExists(path))
+                continue;
+
+            if(BeryllUtils::KTXFile::isKTXFile(path))
+            {
+                staging.decoded = decodeKTX(path, staging);
+            }
+            else
+            {
+                staging.decoded = decodeImage(path, staging);
+            }
+
+            if(staging.decoded)
+                break;
+        }
+    }
+
+    bool AndroidGLESTexture::getIsFileExists(const std::string& path)
+    {
+        {
+            std::scoped_lock<std::mutex> lock(m_fileExistsCacheMutex);
+            auto iter = m_fileExistsCache.find(path);
+            if(iter != m_fileExistsCache.end())
+                return iter->second;
+        }
+
+        // Not under lock. Other threads can probe other files at same time.
+        const bool exists = BeryllUtils::File::exists(path.c_str());
+
+        std::scoped_lock<std::mutex> lock(m_fileExistsCacheMutex);
+        m_fileExistsCache[path] = exists;
+        return exists;
+    }
+
+    bool AndroidGLESTexture::decodeKTX(const std::string& path, TextureStaging& staging)
+    {
+        BeryllUtils::TextureFileData& texture = staging.file;
+        if(!BeryllUtils::KTXFile::load(path, texture))
+            return false;
+
+        const bool isCompressed = BeryllUtils::KTXFile::getIsCompressed(texture.format);
+        const bool GPUSupport = !isCompressed || getIsCompressedFormatSupported(texture.glInternalFormat);
+        if(!GPUSupport && !BeryllUtils::KTXFile::canDecode(texture.format))
+        {
+            BR_WARN("Compressed format 0x%X is not supported by device: %s", texture.glInternalFormat, path.c_str());
+            texture = BeryllUtils::TextureFileData();
+            return false;
+        }
+
+        staging.width = static_cast<int>(texture.width);
+        staging.height = static_cast<int>(texture.height);
+
+        if(GPUSupport)
+            return true; // Levels are uploaded from file buffer.
+
+        // Fallback. Decoded on CPU. Uses 4 bytes per pixel on GPU.
+        staging.levels.resize(texture.levels.size());
+        for(uint32_t i = 0; i < texture.levels.size(); ++i)
+        {
+            staging.levels[i].width = texture.levels[i].width;
+            staging.levels[i].height = texture.levels[i].height;
+            BeryllUtils::KTXFile::decodeLevel(texture, i, staging.levels[i].pixels);
+        }
+        staging.levelsInternalFormat = texture.isSRGB ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+        staging.levelsFormat = GL_RGBA;
+        texture = BeryllUtils::TextureFileData(); // Free file buffer.
+
+        return true;
+    }
+
+    bool AndroidGLESTexture::decodeImage(const std::string& path, TextureStaging& staging)
+    {
+        // Can run on worker thread. Errors must not crash in release where BR_ASSERT is empty.
+        BeryllUtils::FileView file;
+        if(!file.open(path))
+        {
+            BR_ERROR("Load texture failed: %s", path.c_str());
+            return false;
+        }
+
+        SDL_IOStream* rw = SDL_IOFromConstMem(file.getData(), file.getSize());
+        SDL_Surface* loadedSurface = rw ? IMG_Load_IO(rw, true) : nullptr;
+        if(loadedSurface == nullptr)
+        {
+            BR_ERROR("Create surface failed: %s", path.c_str());
+            return false;
+        }
+
+        // Converted to RGBA8 first. Also converts palette images which can not be uploaded directly.
+        // Palette (tRNS) and color key transparency appear only in converted alpha.
+        const bool isOneBytePerPixel = SDL_BYTESPERPIXEL(loadedSurface->format) == 1;
+        SDL_Surface* surface = SDL_ConvertSurface(loadedSurface, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(loadedSurface);
+        if(surface == nullptr || surface->pitch != surface->w * 4)
+        {
+            BR_ERROR("Convert surface to RGBA failed: %s", path.c_str());
+            if(surface)
+                SDL_DestroySurface(surface);
+            return false;
+        }
+
+        staging.width = surface->w;
+        staging.height = surface->h;
+
+        const unsigned char* rgba = static_cast<const unsigned char*>(surface->pixels);
+        const size_t pixelCount = size_t(surface->w) * surface->h;
+        const bool isNormalMap = staging.type == TextureType::NORMAL_MAP_TEXTURE_MAT_1 || staging.type == TextureType::NORMAL_MAP_TEXTURE_MAT_2;
+
+        // Source channel layout is kept on GPU. RGB without alpha uses 3 bytes per pixel, grayscale 1.
+        const uint32_t channels = BeryllUtils::MipChain::getChannelsToKeep(rgba, pixelCount, isOneBytePerPixel, isNormalMap);
+        const bool hasAlpha = channels == 4;
+
+        // beryll_cook uses same settings for usage of texture in model materials.
+        BeryllUtils::MipSettings settings;
+        if(isNormalMap)
+        {
+            settings.isNormalMap = true;
+        }
+        else if(staging.type == TextureType::DIFFUSE_TEXTURE_MAT_1 || staging.type == TextureType::DIFFUSE_TEXTURE_MAT_2)
+        {
+            settings.isSRGB = true;
+            settings.alphaCoverageReference = hasAlpha ? m_alphaTestReference : 0.0f;
+        }
+        else
+        {
+            settings.isSRGB = false; // Specular and blend masks are linear.
+        }
 
-        SDL_Surface* surface = IMG_Load_IO(rw, true);
-        BR_ASSERT((surface != nullptr), "Create surface failed: %s", m_ID.c_str());
+        std::vector<unsigned char> packed;
+        if(channels != 4)
+        {
+            packed = BeryllUtils::MipChain::packChannels(rgba, pixelCount, channels);
+            rgba = packed.data();
+        }
 
-        BR_ASSERT((SDL_BYTESPERPIXEL(surface->format) > 0 && SDL_BYTESPERPIXEL(surface->format) <= 4), "Load texture failed: %s. Depth = 0 or > 4", m_ID.c_str());
+        // Instead of glGenerateMipmap(). Filtered in linear space and with alpha coverage on CPU.
+        staging.levels = BeryllUtils::MipChain::generate(rgba, surface->w, surface->h, channels, settings);
+        SDL_DestroySurface(surface);
 
-        int pixelFormat = GL_RGB;
-        if(SDL_BYTESPERPIXEL(surface->format) == 4) pixelFormat = GL_RGBA;
-        else if(SDL_BYTESPERPIXEL(surface->format) == 1) pixelFormat = GL_RED;
+        if(channels == 1)
+        {
+            staging.levelsInternalFormat = GL_R8;
+            staging.levelsFormat = GL_RED;
+        }
+        else if(channels == 3)
+        {
+            staging.levelsInternalFormat = GL_RGB8;
+            staging.levelsFormat = GL_RGB;
+        }
+        else
+        {
+            staging.levelsInternalFormat = GL_RGBA8;
+            staging.levelsFormat = GL_RGBA;
+        }
 
-        m_openGLID = std::make_shared<uint32_t>();
-        m_width = surface->w;
-        m_height = surface->h;
+        return true;
+    }
 
-        glGenTextures(1, m_openGLID.get());
-        glBindTexture(GL_TEXTURE_2D, *m_openGLID);
+    std::shared_ptr<const AndroidGLESTexture::GPUTexture> AndroidGLESTexture::upload(const TextureStaging& staging)
+    {
+        std::shared_ptr<GPUTexture> texture = std::make_shared<GPUTexture>();
+        texture->width = staging.width;
+        texture->height = staging.height;
 
-        glTexImage2D(GL_TEXTURE_2D, 0, pixelFormat, surface->w, surface->h, 0, pixelFormat, GL_UNSIGNED_BYTE, surface->pixels);
+        glGenTextures(1, &texture->openGLID);
+        glBindTexture(GL_TEXTURE_2D, texture->openGLID);
 
-        glGenerateMipmap(GL_TEXTURE_2D);
+        // Mip levels from file or CPU. Without them texture would be incomplete with mipmap filtering.
+        uint64_t sizeBytes = 0;
+        int levelCount = 0;
+        if(!staging.levels.empty())
+        {
+            // Rows of 1 and 3 channels levels are not aligned to 4 bytes.
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            levelCount = static_cast<int>(staging.levels.size());
+            for(int i = 0; i < levelCount; ++i)
+            {
+                const BeryllUtils::MipLevel& level = staging.levels[i];
+                glTexImage2D(GL_TEXTURE_2D, i, staging.levelsInternalFormat, level.width, level.height, 0, staging.levelsFormat, GL_UNSIGNED_BYTE, level.pixels.data());
+                sizeBytes += level.pixels.size();
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+        else
+        {
+            const BeryllUtils::TextureFileData& file = staging.file;
+            const bool isCompressed = BeryllUtils::KTXFile::getIsCompressed(file.format);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // R8 and RGB8 rows from .ktx2 are not padded.
+            levelCount = static_cast<int>(file.levels.size());
+            for(int i = 0; i < levelCount; ++i)
+            {
+                const BeryllUtils::TextureFileData::Level& level = file.levels[i];
+                if(isCompressed)
+                    glCompressedTexImage2D(GL_TEXTURE_2D, i, file.glInternalFormat, level.width, level.height, 0, level.size, level.data);
+                else
+                    glTexImage2D(GL_TEXTURE_2D, i, file.glInternalFormat, level.width, level.height, 0, file.glFormat, GL_UNSIGNED_BYTE, level.data);
+                sizeBytes += level.size;
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, levelCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
         glBindTexture(GL_TEXTURE_2D, 0);
 
-        SDL_DestroySurface(surface);
-        m_textures.insert(std::make_pair(m_ID, m_openGLID)); // Add to map.
-        //BR_INFO("%s", "Texture created.");
+        // Added only after complete upload. ID never points to not loaded texture.
+        AssetRegistry::add(AssetType::TEXTURE, staging.ID, texture, sizeBytes);
+        return texture;
     }
 
-    AndroidGLESTexture::~AndroidGLESTexture()
+    AndroidGLESTexture::GPUTexture::~GPUTexture()
     {
-        if(m_openGLID.use_count() <= 2)
+        // Texture can be bound to any unit by objects which used it before.
+        for(unsigned int* boundID : {&GLESStateVariables::currentDiffuseTextureMat1ID0, &GLESStateVariables::currentSpecularTextureMat1ID1,
+                                     &GLESStateVariables::currentNormalMapTextureMat1ID2, &GLESStateVariables::currentDiffuseTextureMat2ID3,
+                                     &GLESStateVariables::currentSpecularTextureMat2ID4, &GLESStateVariables::currentNormalMapTextureMat2ID5,
+                                     &GLESStateVariables::currentBlendTextureMat2ID6})
         {
-            // use_count() <= 2 means only shared_ptr in this class left and in map.
-            // If we destroy this m_openGLID (last copy except copy in map) also delete from OpenGL and map.
-            auto result =  m_textures.find(m_ID);
-            if(result != m_textures.end())
-            {
-                unBindNotVirtual();
-
-                glDeleteTextures(1, m_openGLID.get());
-                m_textures.erase(result);
-                //BR_INFO("%s", "Texture destroyed.");
-            }
+            if(*boundID == openGLID)
+                *boundID = 0; // glDeleteTextures() unbinds it.
         }
+
+        glDeleteTextures(1, &openGLID);
+        //BR_INFO("%s", "Texture destroyed.");
+    }
+
+    void AndroidGLESTexture::querySupportedCompressedFormats()
+    {
+        if(m_supportedCompressedFormatsQueried)
+            return;
+
+        m_supportedCompressedFormatsQueried = true;
+
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+        m_supportedCompressedFormats.resize(count);
+        if(count > 0)
+            glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, m_supportedCompressedFormats.data());
+    }
+
+    bool AndroidGLESTexture::getIsCompressedFormatSupported(uint32_t glInternalFormat)
+    {
+        BR_ASSERT(m_supportedCompressedFormatsQueried, "%s", "Call querySupportedCompressedFormats() on GL thread first.");
+
+        return std::find(m_supportedCompressedFormats.begin(), m_supportedCompressedFormats.end(),
+                         static_cast<int>(glInternalFormat)) != m_supportedCompressedFormats.end();
+    }
+
+    AndroidGLESTexture::~AndroidGLESTexture()
+    {
+        // GPU texture stays in AssetRegistry for reuse. Deleted when evicted and not used by other objects.
     }
 
     void AndroidGLESTexture::bind()
@@ -89,72 +385,72 @@ namespace Beryll
         // Dont bind if m_openGLID already bound.
         if(m_type == TextureType::DIFFUSE_TEXTURE_MAT_1) // DONT combine two if() here. Most objects will have one diffuse texture
         {                                                // and if/else chain should stop checks in first if().
-            if(GLESStateVariables::currentDiffuseTextureMat1ID0 != *m_openGLID)
+            if(GLESStateVariables::currentDiffuseTextureMat1ID0 != m_openGLID)
             {
                 //BR_INFO("%s", "DIFFUSE_TEXTURE_MAT_1");
                 glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, *m_openGLID);
-                GLESStateVariables::currentDiffuseTextureMat1ID0 = *m_openGLID;
+                glBindTexture(GL_TEXTURE_2D, m_openGLID);
+                GLESStateVariables::currentDiffuseTextureMat1ID0 = m_openGLID;
             }
         }
         else if(m_type == TextureType::SPECULAR_TEXTURE_MAT_1)
         {
-            if(GLESStateVariables::currentSpecularTextureMat1ID1 != *m_openGLID)
+            if(GLESStateVariables::currentSpecularTextureMat1ID1 != m_openGLID)
             {
                 //BR_INFO("%s", "SPECULAR_TEXTURE_MAT_1");
                 glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, *m_openGLID);
-                GLESStateVariables::currentSpecularTextureMat1ID1 = *m_openGLID;
+                glBindTexture(GL_TEXTURE_2D, m_openGLID);
+                GLESStateVariables::currentSpecularTextureMat1ID1 = m_openGLID;
             }
         }
         else if(m_type == TextureType::NORMAL_MAP_TEXTURE_MAT_1)
         {
-            if(GLESStateVariables::currentNormalMapTextureMat1ID2 != *m_openGLID)
+            if(GLESStateVariables::currentNormalMapTextureMat1ID2 != m_openGLID)
             {
                 //BR_INFO("%s", "NORMAL_MAP_TEXTURE_MAT_1");
                 glActiveTexture(GL_TEXTURE2);
-                glBindTexture(GL_TEXTURE_2D, *m_openGLID);
-                GLESStateVariables::currentNormalMapTextureMat1ID2 = *m_openGLID;
+                glBindTexture(GL_TEXTURE_2D, m_openGLID);
+                GLESStateVariables::currentNormalMapTextureMat1ID2 = m_openGLID;
             }
         }
         else if(m_type == TextureType::DIFFUSE_TEXTURE_MAT_2)
         {
-            if(GLESStateVariables::currentDiffuseTextureMat2ID3 != *m_openGLID)
+            if(GLESStateVariables::currentDiffuseTextureMat2ID3 != m_openGLID)
             {
                 //BR_INFO("%s", "bind DIFFUSE_TEXTURE_MAT_2");
                 glActiveTexture(GL_TEXTURE3);
-                glBindTexture(GL_TEXTURE_2D, *m_openGLID);
-                GLESStateVariables::currentDiffuseTextureMat2ID3 = *m_openGLID;
+                glBindTexture(GL_TEXTURE_2D, m_openGLID);
+                GLESStateVariables::currentDiffuseTextureMat2ID3 = m_openGLID;
             }
         }
         else if(m_type == TextureType::SPECULAR_TEXTURE_MAT_2)
         {
-            if(GLESStateVariables::currentSpecularTextureMat2ID4 != *m_openGLID)
+            if(GLESStateVariables::currentSpecularTextureMat2ID4 != m_openGLID)
             {
                 //BR_INFO("%s", "bind SPECULAR_TEXTURE_MAT_2");
                 glActiveTexture(GL_TEXTURE4);
-                glBindTexture(GL_TEXTURE_2D, *m_openGLID);
-                GLESStateVariables::currentSpecularTextureMat2ID4 = *m_openGLID;
+                glBindTexture(GL_TEXTURE_2D, m_openGLID);
+                GLESStateVariables::currentSpecularTextureMat2ID4 = m_openGLID;
             }
         }
         else if(m_type == TextureType::NORMAL_MAP_TEXTURE_MAT_2)
         {
-            if(GLESStateVariables::currentNormalMapTextureMat2ID5 != *m_openGLID)
+            if(GLESStateVariables::currentNormalMapTextureMat2ID5 != m_openGLID)
             {
                 //BR_INFO("%s", "bind NORMAL_MAP_TEXTURE_MAT_2");
                 glActiveTexture(GL_TEXTURE5);
-                glBindTexture(GL_TEXTURE_2D, *m_openGLID);
-                GLESStateVariables::currentNormalMapTextureMat2ID5 = *m_openGLID;
+                glBindTexture(GL_TEXTURE_2D, m_openGLID);
+                GLESStateVariables::currentNormalMapTextureMat2ID5 = m_openGLID;
             }
         }
         else if(m_type == TextureType::BLEND_TEXTURE_MAT_2)
         {
-            if(GLESStateVariables::currentBlendTextureMat2ID6 != *m_openGLID)
+            if(GLESStateVariables::currentBlendTextureMat2ID6 != m_openGLID)
             {
                 //BR_INFO("%s", "bind BLEND_TEXTURE_MAT_2");
                 glActiveTexture(GL_TEXTURE6);
-                glBindTexture(GL_TEXTURE_2D, *m_openGLID);
-                GLESStateVariables::currentBlendTextureMat2ID6 = *m_openGLID;
+                glBindTexture(GL_TEXTURE_2D, m_openGLID);
+                GLESStateVariables::currentBlendTextureMat2ID6 = m_openGLID;
             }
         }
     }
@@ -169,7 +465,7 @@ namespace Beryll
         // This object can unbind only his own texture.
         if(m_type == TextureType::DIFFUSE_TEXTURE_MAT_1)
         {
-            if(GLESStateVariables::currentDiffuseTextureMat1ID0 == *m_openGLID)
+            if(GLESStateVariables::currentDiffuseTextureMat1ID0 == m_openGLID)
             {
                 glActiveTexture(GL_TEXTURE0);
                 glBindTexture(GL_TEXTURE_2D, 0);
@@ -178,7 +474,7 @@ namespace Beryll
         }
         else if(m_type == TextureType::SPECULAR_TEXTURE_MAT_1)
         {
-            if(GLESStateVariables::currentSpecularTextureMat1ID1 == *m_openGLID)
+            if(GLESStateVariables::currentSpecularTextureMat1ID1 == m_openGLID)
             {
                 glActiveTexture(GL_TEXTURE1);
                 glBindTexture(GL_TEXTURE_2D, 0);
@@ -187,7 +483,7 @@ namespace Beryll
         }
         else if(m_type == TextureType::NORMAL_MAP_TEXTURE_MAT_1)
         {
-            if(GLESStateVariables::currentNormalMapTextureMat1ID2 == *m_openGLID)
+            if(GLESStateVariables::currentNormalMapTextureMat1ID2 == m_openGLID)
             {
                 glActiveTexture(GL_TEXTURE2);
                 glBindTexture(GL_TEXTURE_2D, 0);
@@ -196,7 +492,7 @@ namespace Beryll
         }
         else if(m_type == TextureType::DIFFUSE_TEXTURE_MAT_2)
         {
-            if(GLESStateVariables::currentDiffuseTextureMat2ID3 == *m_openGLID)
+            if(GLESStateVariables::currentDiffuseTextureMat2ID3 == m_openGLID)
             {
                 glActiveTexture(GL_TEXTURE3);
                 glBindTexture(GL_TEXTURE_2D, 0);
@@ -205,7 +501,7 @@ namespace Beryll
         }
         else if(m_type == TextureType::SPECULAR_TEXTURE_MAT_2)
         {
-            if(GLESStateVariables::currentSpecularTextureMat2ID4 == *m_openGLID)
+            if(GLESStateVariables::currentSpecularTextureMat2ID4 == m_openGLID)
             {
                 glActiveTexture(GL_TEXTURE4);
                 glBindTexture(GL_TEXTURE_2D, 0);
@@ -214,7 +510,7 @@ namespace Beryll
         }
         else if(m_type == TextureType::NORMAL_MAP_TEXTURE_MAT_2)
         {
-            if(GLESStateVariables::currentNormalMapTextureMat2ID5 == *m_openGLID)
+            if(GLESStateVariables::currentNormalMapTextureMat2ID5 == m_openGLID)
             {
                 glActiveTexture(GL_TEXTURE5);
                 glBindTexture(GL_TEXTURE_2D, 0);
@@ -223,7 +519,7 @@ namespace Beryll
         }
         else if(m_type == TextureType::BLEND_TEXTURE_MAT_2)
         {
-            if(GLESStateVariables::currentBlendTextureMat2ID6 == *m_openGLID)
+            if(GLESStateVariables::currentBlendTextureMat2ID6 == m_openGLID)
             {
                 glActiveTexture(GL_TEXTURE6);
                 glBindTexture(GL_TEXTURE_2D, 0);
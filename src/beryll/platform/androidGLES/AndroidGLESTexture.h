@@ -4,10 +4,16 @@
 #include "CppHeaders.h"
 
 #include "beryll/renderer/Texture.h"
+#include "beryll/utils/MipChain.h"
+#include "beryll/utils/KTXFile.h"
 
 namespace Beryll
 {
-    // This texture is loaded from file .png or .jpg.
+    // This texture is loaded from file .png, .jpg, .ktx or .ktx2 (ETC2/ASTC/RGBA8 with mip levels).
+    // Mip levels of .png/.jpg are generated on CPU. beryll_cook --texture-mips stores them offline in .ktx2.
+    // If .ktx2/.ktx file with same name exists next to .png/.jpg it is loaded instead.
+    // Compressed formats which GPU does not support are decoded on CPU (ETC2) or replaced by .png/.jpg with same name (ASTC).
+    // Loading has two steps: decode() on CPU (any thread) to staging memory and upload() on GL thread.
     class AndroidGLESTexture : public Texture
     {
     public:
@@ -16,7 +22,7 @@ namespace Beryll
 
         void bind() override;
         void unBind() override;
-        uint32_t getID() override { return *m_openGLID; }
+        uint32_t getID() override { return m_openGLID; }
         int getWidth() override { return m_width; }
         int getHeight() override { return m_height; }
 
@@ -28,18 +34,60 @@ namespace Beryll
          */
         AndroidGLESTexture(const char* path, TextureType type);
 
-        // keep textures in static map in subclasses for reuse them
-        // key = m_ID
-        // value = m_openGLID
-        static std::map<const std::string, std::shared_ptr<uint32_t>> m_textures;
+        // Decode many textures in parallel on worker threads. Only upload to GPU is done on calling (GL) thread.
+        // Next constructor calls with same paths take textures from AssetRegistry.
+        static void preload(const std::vector<std::pair<std::string, TextureType>>& textures);
 
-        const std::string m_ID; // ID in static map = texture path
+        // Shared by all objects with same m_ID. Cached in AssetRegistry (key = m_ID) for reuse.
+        // Deleted from GPU when registry evicts it and no object uses it.
+        struct GPUTexture
+        {
+            ~GPUTexture();
+
+            uint32_t openGLID = 0;
+            int width = 0;
+            int height = 0;
+        };
+
+        const std::string m_ID; // ID in AssetRegistry = texture path
                                 // if many objects load same texture, texture ID will same for all of them
 
-        std::shared_ptr<uint32_t> m_openGLID; // ID in OpenGL
-                                              // will copied across all objects with same m_ID
+        std::shared_ptr<const GPUTexture> m_GPUTexture;
+        uint32_t m_openGLID = 0; // ID in OpenGL. Copy of m_GPUTexture->openGLID
         int m_width = 0;
         int m_height = 0;
         void unBindNotVirtual(); // Can be called in destructor.
+
+        // Decoded texture before upload. Levels point inside file buffer or in CPU generated/decoded levels.
+        struct TextureStaging
+        {
+            std::string ID;
+            TextureType type = TextureType::UNKNOWN;
+            bool decoded = false; // False if no file with format supported by device.
+            int width = 0;
+            int height = 0;
+            BeryllUtils::TextureFileData file; // .ktx/.ktx2 with format supported by GPU.
+            std::vector<BeryllUtils::MipLevel> levels; // .png/.jpg or .ktx/.ktx2 decoded on CPU.
+            uint32_t levelsInternalFormat = 0;
+            uint32_t levelsFormat = 0; // GL_RED, GL_RGB or GL_RGBA. Same channels as levels.
+        };
+
+        // Dont call graphics API. Can be called from worker threads.
+        static void decode(TextureStaging& staging);
+        static bool decodeKTX(const std::string& path, TextureStaging& staging); // False if format can not be used on this device.
+        // File::exists() opens file (APK asset on Android). Results of probes for .ktx2/.ktx/.png/.jpg are cached.
+        // Asset files do not change while app runs. Any thread.
+        static bool getIsFileExists(const std::string& path);
+        static std::unordered_map<std::string, bool> m_fileExistsCache;
+        static std::mutex m_fileExistsCacheMutex;
+        static bool decodeImage(const std::string& path, TextureStaging& staging); // Mip levels are generated on CPU. False on read/decode error.
+        // GL thread. Creates texture and adds it to AssetRegistry.
+        static std::shared_ptr<const GPUTexture> upload(const TextureStaging& staging);
+        static constexpr float m_alphaTestReference = 0.5f; // For alpha coverage of diffuse textures mip levels.
+
+        static void querySupportedCompressedFormats(); // GL thread. Before getIsCompressedFormatSupported() calls.
+        static bool getIsCompressedFormatSupported(uint32_t glInternalFormat);
+        static std::vector<int> m_supportedCompressedFormats;
+        static bool m_supportedCompressedFormatsQueried;
     };
 }
@@ -43,26 +43,26 @@ namespace Beryll
 
     void AndroidGLESVertexArray::draw()
     {
-        glDrawElements(GL_TRIANGLES, m_indexBuffer->getCount(), GL_UNSIGNED_INT, nullptr);
+        const uint32_t indexType = m_indexBuffer->getIndexType() == IndexType::UNSIGNED_SHORT ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        glDrawElements(GL_TRIANGLES, m_indexBuffer->getCount(), indexType, reinterpret_cast<void*>(m_indexBuffer->getOffsetBytes()));
     }
 
     void AndroidGLESVertexArray::addVertexBuffer(const std::shared_ptr<VertexBuffer>& vertBuff)
     {
+        if(vertBuff->getIsInterleaved())
+        {
+            addInterleavedVertexBuffer(vertBuff);
+            return;
+        }
+
         BR_ASSERT((vertBuff->getAttribSize() != VertexAttribSize::UNKNOWN &&
                    vertBuff->getAttribType() != VertexAttribType::UNKNOWN), "%s", "Unknown vertex buffer data type or size.");
 
         int size = 0;
         uint32_t type = 0;
-        int stride = 0;
-
-        if(vertBuff->getAttribSize() == VertexAttribSize::ONE) { size = 1; }
-        else if(vertBuff->getAttribSize() == VertexAttribSize::TWO) { size = 2; }
-        else if(vertBuff->getAttribSize() == VertexAttribSize::THREE) { size = 3; }
-        else if(vertBuff->getAttribSize() == VertexAttribSize::FOUR) { size = 4; }
-        else if(vertBuff->getAttribSize() == VertexAttribSize::MATRIX4x4) { size = 16; }
-
-        if(vertBuff->getAttribType() == VertexAttribType::FLOAT) { type = GL_FLOAT; stride = sizeof(float) * size; }
-        else if(vertBuff->getAttribType() == VertexAttribType::INT) { type = GL_INT; stride = sizeof(int) * size; }
+        uint8_t normalized = GL_FALSE;
+        getAttribFormat(vertBuff->getAttribType(), vertBuff->getAttribSize(), size, type, normalized);
+        const int stride = getVertexAttribBytes(vertBuff->getAttribType(), vertBuff->getAttribSize());
 
         bind();
         vertBuff->bind();
@@ -93,7 +93,7 @@ namespace Beryll
         else
         {
             glEnableVertexAttribArray(m_indexNumber);
-            glVertexAttribPointer(m_indexNumber, size, type, GL_FALSE, stride, (void*)0);
+            glVertexAttribPointer(m_indexNumber, size, type, normalized, stride, (void*)0);
             ++m_indexNumber;
         }
 
@@ -103,6 +103,49 @@ namespace Beryll
         m_vertBuffers.push_back(vertBuff);
     }
 
+    void AndroidGLESVertexArray::addInterleavedVertexBuffer(const std::shared_ptr<VertexBuffer>& vertBuff)
+    {
+        bind();
+        vertBuff->bind();
+
+        // One layout(location = ...) for every attribute. Offsets inside one vertex of stride bytes.
+        for(const VertexAttribute& attribute : vertBuff->getAttributes())
+        {
+            BR_ASSERT((attribute.size != VertexAttribSize::MATRIX4x4), "%s", "Matrix can not be attribute of interleaved vertex buffer.");
+
+            int size = 0;
+            uint32_t type = 0;
+            uint8_t normalized = GL_FALSE;
+            getAttribFormat(attribute.type, attribute.size, size, type, normalized);
+
+            glEnableVertexAttribArray(m_indexNumber);
+            glVertexAttribPointer(m_indexNumber, size, type, normalized, vertBuff->getStride(),
+                                  reinterpret_cast<void*>(vertBuff->getOffsetBytes() + attribute.offset));
+            ++m_indexNumber;
+        }
+
+        vertBuff->unBind();
+        unBind();
+
+        m_vertBuffers.push_back(vertBuff);
+    }
+
+    void AndroidGLESVertexArray::getAttribFormat(VertexAttribType attribType, VertexAttribSize attribSize,
+                                                 int& size, uint32_t& type, uint8_t& normalized)
+    {
+        if(attribSize == VertexAttribSize::ONE) { size = 1; }
+        else if(attribSize == VertexAttribSize::TWO) { size = 2; }
+        else if(attribSize == VertexAttribSize::THREE) { size = 3; }
+        else if(attribSize == VertexAttribSize::FOUR) { size = 4; }
+        else if(attribSize == VertexAttribSize::MATRIX4x4) { size = 16; }
+
+        normalized = GL_FALSE;
+        if(attribType == VertexAttribType::FLOAT) { type = GL_FLOAT; }
+        else if(attribType == VertexAttribType::INT) { type = GL_INT; }
+        else if(attribType == VertexAttribType::HALF_FLOAT) { type = GL_HALF_FLOAT; }
+        else if(attribType == VertexAttribType::SHORT_NORMALIZED) { type = GL_SHORT; normalized = GL_TRUE; }
+    }
+
     void AndroidGLESVertexArray::setIndexBuffer(const std::shared_ptr<IndexBuffer>& indexBuff)
     {
         bind();
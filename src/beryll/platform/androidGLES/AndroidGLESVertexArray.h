@@ -20,6 +20,9 @@ namespace Beryll
         friend class Renderer;
         AndroidGLESVertexArray();
 
+        void addInterleavedVertexBuffer(const std::shared_ptr<VertexBuffer>& vertBuff);
+        static void getAttribFormat(VertexAttribType attribType, VertexAttribSize attribSize, int& size, uint32_t& type, uint8_t& normalized);
+
         uint32_t m_VAO = 0;
         uint32_t m_indexNumber = 0;
     };
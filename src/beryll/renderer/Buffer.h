@@ -12,7 +12,46 @@ namespace Beryll
 
     enum class VertexAttribType
     {
-        UNKNOWN, FLOAT, INT
+        UNKNOWN, FLOAT, INT,
+        HALF_FLOAT, // 16 bit float. Shader gets float.
+        SHORT_NORMALIZED // int16_t. Shader gets float in range -1...1.
+    };
+
+    enum class IndexType
+    {
+        UNSIGNED_INT, UNSIGNED_SHORT // 16 bit indices for meshes with less than 65536 vertices.
+    };
+
+    inline uint32_t getVertexAttribBytes(VertexAttribType type, VertexAttribSize size)
+    {
+        uint32_t componentBytes = 0;
+        if(type == VertexAttribType::FLOAT || type == VertexAttribType::INT) { componentBytes = 4; }
+        else if(type == VertexAttribType::HALF_FLOAT || type == VertexAttribType::SHORT_NORMALIZED) { componentBytes = 2; }
+
+        uint32_t components = 0;
+        if(size == VertexAttribSize::ONE) { components = 1; }
+        else if(size == VertexAttribSize::TWO) { components = 2; }
+        else if(size == VertexAttribSize::THREE) { components = 3; }
+        else if(size == VertexAttribSize::FOUR) { components = 4; }
+        else if(size == VertexAttribSize::MATRIX4x4) { components = 16; }
+
+        return componentBytes * components;
+    }
+
+    // One attribute stream of mesh (not interleaved). Input for interleaved vertex buffer.
+    struct VertexStream
+    {
+        const void* data = nullptr; // vertexCount elements without padding.
+        VertexAttribType type = VertexAttribType::UNKNOWN;
+        VertexAttribSize size = VertexAttribSize::UNKNOWN;
+    };
+
+    // Attribute inside interleaved vertex.
+    struct VertexAttribute
+    {
+        VertexAttribType type = VertexAttribType::UNKNOWN;
+        VertexAttribSize size = VertexAttribSize::UNKNOWN;
+        uint32_t offset = 0; // From start of vertex.
     };
 
     class VertexBuffer
@@ -32,9 +71,20 @@ namespace Beryll
         VertexAttribType getAttribType() { return m_vertAttribType; }
         VertexAttribSize getAttribSize() { return m_vertAttribSize; }
 
+        // Interleaved buffer has many attributes (one layout(location = ...) for each). Not interleaved has one: type + size.
+        bool getIsInterleaved() { return !m_attributes.empty(); }
+        const std::vector<VertexAttribute>& getAttributes() { return m_attributes; }
+        uint32_t getStride() { return m_stride; }
+        // Of first vertex inside buffer bound by bind(). Not 0 if buffer is part of shared buffer.
+        uint64_t getOffsetBytes() { return m_offsetBytes; }
+
     protected:
         VertexAttribType m_vertAttribType = VertexAttribType::UNKNOWN;
         VertexAttribSize m_vertAttribSize = VertexAttribSize::UNKNOWN;
+
+        std::vector<VertexAttribute> m_attributes; // Only for interleaved buffer.
+        uint32_t m_stride = 0; // Only for interleaved buffer.
+        uint64_t m_offsetBytes = 0;
     };
 
     // Dynamic index buffer can be achieved by changing m_count inside setCount(uint32_t count).
@@ -48,8 +98,13 @@ namespace Beryll
 
         uint32_t getCount() { return m_count; }
         virtual void setCount(uint32_t count) = 0;
+        IndexType getIndexType() { return m_indexType; }
+        // Of first index inside buffer bound by bind(). Not 0 if buffer is part of shared buffer.
+        uint64_t getOffsetBytes() { return m_offsetBytes; }
 
     protected:
         uint32_t m_count = 0;
+        IndexType m_indexType = IndexType::UNSIGNED_INT;
+        uint64_t m_offsetBytes = 0;
     };
 }
@@ -94,6 +94,34 @@ namespace Beryll
             return true;
         }
 
+        // Same as getIsSeeObject() for object with size. True if any part of sphere is inside view angle.
+        static bool getIsSeeSphere(const glm::vec3& center, float radius, float fovMultiplier = 1.0f, float maxViewDistance = m_objectsViewDistance)
+        {
+            const float distance = glm::distance(m_cameraPos, center);
+            if(distance - radius > maxViewDistance) { return false; }
+            if(distance <= radius) { return true; } // Camera inside sphere.
+
+            float maxAngle = 0.0f;
+            if(Window::getInstance()->currentDisplayOrientation == SDL_ORIENTATION_LANDSCAPE ||
+               Window::getInstance()->currentDisplayOrientation == SDL_ORIENTATION_LANDSCAPE_FLIPPED)
+            {
+                maxAngle = m_fovRadians * fovMultiplier;
+            }
+            else if(Window::getInstance()->currentDisplayOrientation == SDL_ORIENTATION_PORTRAIT ||
+                    Window::getInstance()->currentDisplayOrientation == SDL_ORIENTATION_PORTRAIT_FLIPPED)
+            {
+                maxAngle = m_halfFovRadians * fovMultiplier;
+            }
+            else
+            {
+                return false;
+            }
+
+            // Angle between direction to sphere center and direction to sphere edge.
+            const float sphereAngle = std::asin(radius / distance);
+            return BeryllUtils::Common::getAngleInRadians(m_cameraDirectionXYZ, glm::normalize(center - m_cameraPos)) - sphereAngle <= maxAngle;
+        }
+
         static float getDistanceToObject(const glm::vec3& objectPos) // Check distance between camera and object.
         {
             return glm::distance(m_cameraPos, objectPos);
@@ -115,6 +143,7 @@ namespace Beryll
         static void setObjectsViewDistance(const float viewDistance) { m_objectsViewDistance = viewDistance; }
 
         static float getObjectsViewDistance() { return m_objectsViewDistance; }
+        static float getFovRadians() { return m_fovRadians; }
         static float getProjectionFarClipPlane() { return m_projFarClipPlane; }
         static const glm::vec3& getCameraFrontDirectionXYZ() { return m_cameraDirectionXYZ; }
         static const glm::vec3& getCameraFrontDirectionXZ() { return m_cameraDirectionXZ; }
@@ -4,6 +4,8 @@
 #include "beryll/gameObjects/BaseSimpleObject.h"
 #include "beryll/gameObjects/BaseAnimatedObject.h"
 
+#include <cstring>
+
 #if defined(ANDROID)
     #include <GLES3/gl32.h>
     #include <GLES3/gl3ext.h>
@@ -76,6 +78,80 @@ namespace Beryll
         return std::shared_ptr<VertexBuffer>(new AndroidGLESStaticVertexBuffer(data));
 #elif defined(APPLE)
 
+#else
+        BR_ASSERT(false, "%s", "Can not create VertexBuffer. Unknown platform.");
+        return nullptr;
+#endif
+    }
+
+    std::shared_ptr<VertexBuffer> Renderer::createStaticVertexBuffer(const glm::vec2* data, uint32_t count)
+    {
+#if defined(ANDROID)
+        return std::shared_ptr<VertexBuffer>(new AndroidGLESStaticVertexBuffer(data, count));
+#elif defined(APPLE)
+
+#else
+        BR_ASSERT(false, "%s", "Can not create VertexBuffer. Unknown platform.");
+        return nullptr;
+#endif
+    }
+
+    std::shared_ptr<VertexBuffer> Renderer::createStaticVertexBuffer(const glm::vec3* data, uint32_t count)
+    {
+#if defined(ANDROID)
+        return std::shared_ptr<VertexBuffer>(new AndroidGLESStaticVertexBuffer(data, count));
+#elif defined(APPLE)
+
+#else
+        BR_ASSERT(false, "%s", "Can not create VertexBuffer. Unknown platform.");
+        return nullptr;
+#endif
+    }
+
+    std::shared_ptr<VertexBuffer> Renderer::createStaticVertexBuffer(const void* data, uint32_t count, VertexAttribType type, VertexAttribSize size)
+    {
+#if defined(ANDROID)
+        return std::shared_ptr<VertexBuffer>(new AndroidGLESStaticVertexBuffer(data, count, type, size));
+#elif defined(APPLE)
+
+#else
+        BR_ASSERT(false, "%s", "Can not create VertexBuffer. Unknown platform.");
+        return nullptr;
+#endif
+    }
+
+    std::shared_ptr<VertexBuffer> Renderer::createInterleavedVertexBuffer(const std::vector<VertexStream>& streams, uint32_t vertexCount)
+    {
+        std::vector<VertexAttribute> attributes;
+        std::vector<uint32_t> elementBytes;
+        uint32_t stride = 0;
+        for(const VertexStream& stream : streams)
+        {
+            const uint32_t bytes = getVertexAttribBytes(stream.type, stream.size);
+            BR_ASSERT((stream.data != nullptr && bytes != 0), "%s", "Wrong vertex stream for interleaved buffer.");
+
+            attributes.push_back({stream.type, stream.size, stride});
+            elementBytes.push_back(bytes);
+            stride += (bytes + 3u) & ~3u; // Attributes aligned to 4 bytes.
+        }
+
+        std::vector<char> vertices(size_t(vertexCount) * stride, 0);
+        for(size_t i = 0; i < streams.size(); ++i)
+        {
+            const char* src = static_cast<const char*>(streams[i].data);
+            char* dst = vertices.data() + attributes[i].offset;
+            for(uint32_t v = 0; v < vertexCount; ++v)
+            {
+                std::memcpy(dst, src, elementBytes[i]);
+                src += elementBytes[i];
+                dst += stride;
+            }
+        }
+
+#if defined(ANDROID)
+        return std::shared_ptr<VertexBuffer>(new AndroidGLESInterleavedVertexBuffer(vertices.data(), vertexCount, stride, attributes));
+#elif defined(APPLE)
+
 #else
         BR_ASSERT(false, "%s", "Can not create VertexBuffer. Unknown platform.");
         return nullptr;
@@ -100,6 +176,59 @@ namespace Beryll
         return std::shared_ptr<IndexBuffer>(new AndroidGLESStaticIndexBuffer(indices));
 #elif defined(APPLE)
 
+#else
+        BR_ASSERT(false, "%s", "Can not create IndexBuffer. Unknown platform.");
+        return nullptr;
+#endif
+    }
+
+    std::shared_ptr<IndexBuffer> Renderer::createStaticIndexBuffer(const uint32_t* indices, uint32_t count)
+    {
+#if defined(ANDROID)
+        return std::shared_ptr<IndexBuffer>(new AndroidGLESStaticIndexBuffer(indices, count));
+#elif defined(APPLE)
+
+#else
+        BR_ASSERT(false, "%s", "Can not create IndexBuffer. Unknown platform.");
+        return nullptr;
+#endif
+    }
+
+    std::shared_ptr<IndexBuffer> Renderer::createStaticIndexBuffer(const std::vector<uint16_t>& indices)
+    {
+        return createStaticIndexBuffer(indices.data(), indices.size());
+    }
+
+    std::shared_ptr<IndexBuffer> Renderer::createStaticIndexBuffer(const uint16_t* indices, uint32_t count)
+    {
+#if defined(ANDROID)
+        return std::shared_ptr<IndexBuffer>(new AndroidGLESStaticIndexBuffer(indices, count));
+#elif defined(APPLE)
+
+#else
+        BR_ASSERT(false, "%s", "Can not create IndexBuffer. Unknown platform.");
+        return nullptr;
+#endif
+    }
+
+    std::shared_ptr<IndexBuffer> Renderer::createSharedIndexBuffer(const uint32_t* indices, uint32_t count)
+    {
+#if defined(ANDROID)
+        return std::shared_ptr<IndexBuffer>(new AndroidGLESSharedIndexBuffer(indices, count));
+#elif defined(APPLE)
+
+#else
+        BR_ASSERT(false, "%s", "Can not create IndexBuffer. Unknown platform.");
+        return nullptr;
+#endif
+    }
+
+    std::shared_ptr<IndexBuffer> Renderer::createSharedIndexBuffer(const uint16_t* indices, uint32_t count)
+    {
+#if defined(ANDROID)
+        return std::shared_ptr<IndexBuffer>(new AndroidGLESSharedIndexBuffer(indices, count));
+#elif defined(APPLE)
+
 #else
         BR_ASSERT(false, "%s", "Can not create IndexBuffer. Unknown platform.");
         return nullptr;
@@ -142,6 +271,17 @@ namespace Beryll
 #endif
     }
 
+    void Renderer::preloadTextures(const std::vector<std::pair<std::string, TextureType>>& textures)
+    {
+#if defined(ANDROID)
+        AndroidGLESTexture::preload(textures);
+#elif defined(APPLE)
+
+#else
+        BR_ASSERT(false, "%s", "Can not preload textures. Unknown platform.");
+#endif
+    }
+
     std::unique_ptr<ShadowMap> Renderer::createShadowMap(int width, int height)
     {
 #if defined(ANDROID)
@@ -173,7 +313,8 @@ namespace Beryll
         if(shader)
         {
             shader->bind();
-            shader->setMatrix4x4Float("MVPMatrix", Beryll::Camera::getViewProjection() * modelMatrix);
+            // Compact positions are decoded by MVPMatrix.
+            shader->setMatrix4x4Float("MVPMatrix", Beryll::Camera::getViewProjection() * modelMatrix * simpleObj->getPositionDecodeMatrix());
 
             simpleObj->useInternalShader = false;
             simpleObj->draw();
@@ -191,20 +332,9 @@ namespace Beryll
     {
         if(shader)
         {
-            static std::string boneMatrixNameInShader;
-            static uint32_t boneCount = 0;
-
             shader->bind();
             shader->setMatrix4x4Float("MVPMatrix", Beryll::Camera::getViewProjection() * modelMatrix);
-
-            boneCount = animObj->getBoneCount();
-            for(int i = 0; i < boneCount; ++i)
-            {
-                boneMatrixNameInShader = "bonesMatrices[";
-                boneMatrixNameInShader += std::to_string(i);
-                boneMatrixNameInShader += "]";
-                shader->setMatrix4x4Float(boneMatrixNameInShader.c_str(), animObj->getBoneMatrices()[i].finalWorldTransform);
-            }
+            shader->setMatrix4x4FloatArray("bonesMatrices", animObj->getBoneMatrices().data(), animObj->getBoneCount());
 
             animObj->useInternalShader = false;
             animObj->draw();
@@ -28,10 +28,25 @@ namespace Beryll
         static std::shared_ptr<VertexBuffer> createStaticVertexBuffer(const std::vector<glm::vec4>& data);
         static std::shared_ptr<VertexBuffer> createStaticVertexBuffer(const std::vector<glm::ivec4>& data);
         static std::shared_ptr<VertexBuffer> createStaticVertexBuffer(const std::vector<glm::mat4>& data);
+        // From memory of loaded file without copy to std::vector. Memory can be freed after call.
+        static std::shared_ptr<VertexBuffer> createStaticVertexBuffer(const glm::vec2* data, uint32_t count);
+        static std::shared_ptr<VertexBuffer> createStaticVertexBuffer(const glm::vec3* data, uint32_t count);
+        // Compact formats (see BeryllUtils::VertexQuantization). count of vertices.
+        static std::shared_ptr<VertexBuffer> createStaticVertexBuffer(const void* data, uint32_t count, VertexAttribType type, VertexAttribSize size);
+
+        // All streams (vertexCount elements each) interleaved in one buffer. layout(location = ...) of attributes in order of streams.
+        // Buffer is part of big buffer shared with other meshes.
+        static std::shared_ptr<VertexBuffer> createInterleavedVertexBuffer(const std::vector<VertexStream>& streams, uint32_t vertexCount);
 
         static std::shared_ptr<VertexBuffer> createDynamicVertexBuffer(VertexAttribType type, VertexAttribSize size, uint32_t maxSizeBytes);
 
         static std::shared_ptr<IndexBuffer> createStaticIndexBuffer(const std::vector<uint32_t>& indices);
+        static std::shared_ptr<IndexBuffer> createStaticIndexBuffer(const uint32_t* indices, uint32_t count);
+        static std::shared_ptr<IndexBuffer> createStaticIndexBuffer(const std::vector<uint16_t>& indices);
+        static std::shared_ptr<IndexBuffer> createStaticIndexBuffer(const uint16_t* indices, uint32_t count);
+        // Part of big index buffer shared with other meshes.
+        static std::shared_ptr<IndexBuffer> createSharedIndexBuffer(const uint32_t* indices, uint32_t count);
+        static std::shared_ptr<IndexBuffer> createSharedIndexBuffer(const uint16_t* indices, uint32_t count);
         // If you wand dynamic index buffer: create static index buffer with max possible indices
         //                                   and change count by setCount(uint32_t count) every frame.
 
@@ -39,6 +54,9 @@ namespace Beryll
 
         static std::shared_ptr<Shader> createShader(const char* vertexPath, const char* fragmentPath);
         static std::unique_ptr<Texture> createTexture(const char* path, TextureType type);
+        // Decode textures in parallel on worker threads and upload them to GPU. Call on loading screen before createTexture()
+        // with same paths. createTexture() will take them from cache. Must be called from thread with graphics context.
+        static void preloadTextures(const std::vector<std::pair<std::string, TextureType>>& textures);
         static std::unique_ptr<ShadowMap> createShadowMap(int width, int height);
 
         static std::unique_ptr<SkyBox> createSkyBox(const char* folderPath);
@@ -46,6 +64,7 @@ namespace Beryll
         // These 2 methods will set BaseSimpleObject and BaseAnimatedObject specific uniform variables
         // which shader must have to draw them.
         // If shader has some extra uniform variables they should be set before this methods call.
+        // MVPMatrix includes decode of compact positions (SceneObject::getPositionDecodeMatrix()).
         static void drawObject(const std::shared_ptr<Beryll::BaseSimpleObject>& obj,
                                const glm::mat4& modelMatrix,
                                const std::shared_ptr<Shader>& shader = nullptr);
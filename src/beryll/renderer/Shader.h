@@ -27,6 +27,8 @@ namespace Beryll
         virtual void setMatrix4x4Float(const char* name, const glm::mat4& value) = 0;
         virtual void setMatrix4x4Float(const char* name, const aiMatrix4x4& value) = 0; // for assimp matrix
         virtual void setMatrix3x3Float(const char* name, const glm::mat3& value) = 0;
+        // Whole uniform array in one call. name without index: "bonesMatrices".
+        virtual void setMatrix4x4FloatArray(const char* name, const glm::mat4* values, const uint32_t count) = 0;
 
         // Material 1.
         virtual void activateDiffuseTextureMat1() = 0;
@@ -35,10 +35,9 @@ namespace Beryll
         }
 
     protected:
-        // Keep textures in static map in subclasses for reuse them.
-        // Key = texturePath.
-        // Value = textureID.
-        // Check in subclass existing texture.
+        // Subclasses keep textures in AssetRegistry for reuse. Key = texturePath.
+        // Texture stays in GPU memory after last object which used it is destroyed.
+        // It is freed when registry evicts it (memory budget exceeded) or by AssetRegistry::purgeUnreferenced().
 
         TextureType m_type = TextureType::UNKNOWN;
     };
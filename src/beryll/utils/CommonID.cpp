@@ -0,0 +1,7 @@
+#include "CommonUtils.h"
+
+namespace BeryllUtils
+{
+    // Separate from CommonUtils.cpp which needs renderer. Physics and host tools generate IDs without it.
+    int Common::m_id = 0;
+}
@@ -1,87 +1,37 @@
 #include "CommonUtils.h"
 #include "beryll/renderer/Renderer.h"
-#include "beryll/utils/File.h"
+#include "beryll/utils/FileView.h"
 #include "beryll/utils/Matrix.h"
 
 namespace BeryllUtils
 {
-    int Common::m_id = 0;
-
     Beryll::Material1 Common::loadMaterial1(aiMaterial* material, const std::string& filePath)
     {
-        BR_ASSERT((filePath.find_last_of('/') != std::string::npos), "Texture + model must be in folder: %s", filePath.c_str());
-
-        Beryll::Material1 mat1;
-        std::string texturePath;
+        const std::string diffusePath = getMaterialTexturePath(material, aiTextureType_DIFFUSE, filePath);
+        const std::string specularPath = getMaterialTexturePath(material, aiTextureType_SPECULAR, filePath);
+        const std::string normalMapPath = getMaterialTexturePath(material, aiTextureType_NORMALS, filePath);
 
-        if(material->GetTextureCount(aiTextureType_DIFFUSE) > 0)
-        {
-            aiString textName;
-            material->GetTexture(aiTextureType_DIFFUSE, 0, &textName);
+        return loadMaterial1(diffusePath, specularPath, normalMapPath);
+    }
 
-            std::string textName2 = textName.C_Str();
-            for(int g = static_cast<int>(textName2.size()) - 1; g >= 0; --g)
-            {
-                if(textName2[g] == '/' || textName2[g] == '\\')
-                {
-                    textName2 = textName2.substr(g + 1);
-                    break;
-                }
-            }
-            texturePath = filePath.substr(0, filePath.find_last_of('/'));
-            texturePath += '/';
-            texturePath += textName2;
-            BR_INFO("Diffuse texture here: %s", texturePath.c_str());
+    Beryll::Material1 Common::loadMaterial1(const std::string& diffusePath, const std::string& specularPath, const std::string& normalMapPath)
+    {
+        BR_ASSERT((!diffusePath.empty()), "%s", "Material1 must have at least one diffuse texture.");
 
-            mat1.diffTexture = Beryll::Renderer::createTexture(texturePath.c_str(), Beryll::TextureType::DIFFUSE_TEXTURE_MAT_1);
-        }
-        else
-        {
-            BR_ASSERT(false, "%s", "Material1 must have at least one diffuse texture.");
-        }
+        Beryll::Material1 mat1;
+        BR_INFO("Diffuse texture here: %s", diffusePath.c_str());
+        mat1.diffTexture = Beryll::Renderer::createTexture(diffusePath.c_str(), Beryll::TextureType::DIFFUSE_TEXTURE_MAT_1);
 
-        if(material->GetTextureCount(aiTextureType_SPECULAR) > 0)
+        if(!specularPath.empty())
         {
-            aiString textName;
-            material->GetTexture(aiTextureType_SPECULAR, 0, &textName);
-
-            std::string textName2 = textName.C_Str();
-            for(int g = static_cast<int>(textName2.size()) - 1; g >= 0; --g)
-            {
-                if(textName2[g] == '/' || textName2[g] == '\\')
-                {
-                    textName2 = textName2.substr(g + 1);
-                    break;
-                }
-            }
-            texturePath = filePath.substr(0, filePath.find_last_of('/'));
-            texturePath += '/';
-            texturePath += textName2;
-            BR_INFO("Specular texture here: %s", texturePath.c_str());
-
-            mat1.specTexture = Beryll::Renderer::createTexture(texturePath.c_str(), Beryll::TextureType::SPECULAR_TEXTURE_MAT_1);
+            BR_INFO("Specular texture here: %s", specularPath.c_str());
+            mat1.specTexture = Beryll::Renderer::createTexture(specularPath.c_str(), Beryll::TextureType::SPECULAR_TEXTURE_MAT_1);
         }
 
-        if(material->GetTextureCount(aiTextureType_NORMALS) > 0)
+        if(!normalMapPath.empty())
         {
-            aiString textName;
-            material->GetTexture(aiTextureType_NORMALS, 0, &textName);
-
-            std::string textName2 = textName.C_Str();
-            for(int g = static_cast<int>(textName2.size()) - 1; g >= 0; --g)
-            {
-                if(textName2[g] == '/' || textName2[g] == '\\')
-                {
-                    textName2 = textName2.substr(g + 1);
-                    break;
-                }
-            }
-            texturePath = filePath.substr(0, filePath.find_last_of('/'));
-            texturePath += '/';
-            texturePath += textName2;
-            BR_INFO("Normal map texture here: %s", texturePath.c_str());
-
-            mat1.normalMapTexture = Beryll::Renderer::createTexture(texturePath.c_str(), Beryll::TextureType::NORMAL_MAP_TEXTURE_MAT_1);
+            BR_INFO("Normal map texture here: %s", normalMapPath.c_str());
+            mat1.normalMapTexture = Beryll::Renderer::createTexture(normalMapPath.c_str(), Beryll::TextureType::NORMAL_MAP_TEXTURE_MAT_1);
         }
 
         return mat1;
@@ -115,14 +65,15 @@ namespace BeryllUtils
         const std::string fileExtension = path.substr(lastDotPos + 1);
         BR_ASSERT((fileExtension == "fbx"), "%s", "File extension must be fbx or dae.");
 
-        uint32_t bufferSize = 0;
-        char* buffer = BeryllUtils::File::readToBuffer(filePath, &bufferSize);
+        FileView file;
+        const bool opened = file.open(filePath);
+        BR_ASSERT(opened, "File reading error: %s", filePath);
 
         Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFileFromMemory(buffer, bufferSize,
+        const aiScene* scene = importer.ReadFileFromMemory(file.getData(), file.getSize(),
                                                            aiProcess_JoinIdenticalVertices,
                                                            fileExtension.c_str());
-        delete[] buffer;
+        file.close();
         if(!scene || !scene->mRootNode || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE)
         {
             BR_ASSERT(false, "Scene loading error for file: %s", filePath);
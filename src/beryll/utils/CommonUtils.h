@@ -187,6 +187,33 @@ namespace BeryllUtils
         // use glm::rotation
 
         static Beryll::Material1 loadMaterial1(aiMaterial* material, const std::string& filePath);
+        static Beryll::Material1 loadMaterial1(const std::string& diffusePath, const std::string& specularPath, const std::string& normalMapPath);
+        // Texture expected in same folder as model file. Empty if material does not have texture of this type.
+        static std::string getMaterialTexturePath(const aiMaterial* material, aiTextureType type, const std::string& filePath)
+        {
+            if(material->GetTextureCount(type) == 0)
+                return std::string();
+
+            BR_ASSERT((filePath.find_last_of('/') != std::string::npos), "Texture + model must be in folder: %s", filePath.c_str());
+
+            aiString textName;
+            material->GetTexture(type, 0, &textName);
+
+            std::string textName2 = textName.C_Str();
+            for(int g = static_cast<int>(textName2.size()) - 1; g >= 0; --g)
+            {
+                if(textName2[g] == '/' || textName2[g] == '\\')
+                {
+                    textName2 = textName2.substr(g + 1);
+                    break;
+                }
+            }
+
+            std::string texturePath = filePath.substr(0, filePath.find_last_of('/'));
+            texturePath += '/';
+            texturePath += textName2;
+            return texturePath;
+        }
         static std::optional<Beryll::Material2> loadMaterial2(const std::string& diffusePath, const std::string& specularPath,
                                                               const std::string& normalMapPath, const std::string& blendTexturePath);
 
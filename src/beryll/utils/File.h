@@ -4,6 +4,7 @@
 #include "CppHeaders.h"
 
 #include "beryll/core/Log.h"
+#include "PackFile.h"
 
 namespace BeryllUtils
 {
@@ -13,10 +14,22 @@ namespace BeryllUtils
         File() = delete;
         ~File() = delete;
 
+        // Copy of whole file. For read only loading use FileView (memory mapped, no copy).
         // This fn() call new[] !!! You must call delete[] for free buffer.
         // Returns buffer + '\0'. size will contains number of bytes without '\0'.
         static char* readToBuffer(const char* filepath, uint32_t* size = nullptr)
         {
+            FileView packed;
+            if(PackFile::open(filepath, packed))
+            {
+                const uint32_t packedSize = static_cast<uint32_t>(packed.getSize());
+                char* res = new char[packedSize + 1];
+                std::copy_n(packed.getData(), packedSize, res);
+                res[packedSize] = '\0';
+                if(size) { *size = packedSize; }
+                return res;
+            }
+
             SDL_IOStream *rw = SDL_IOFromFile(filepath, "rb"); // Read binary.
             BR_ASSERT((rw != nullptr), "File reading error: %s", filepath);
 
@@ -46,5 +59,18 @@ namespace BeryllUtils
 
             return res;
         }
+
+        static bool exists(const char* filepath)
+        {
+            if(PackFile::contains(filepath))
+                return true;
+
+            SDL_IOStream *rw = SDL_IOFromFile(filepath, "rb");
+            if(rw == nullptr)
+                return false;
+
+            SDL_CloseIO(rw);
+            return true;
+        }
     };
 }
@@ -0,0 +1,212 @@
+#include "FileView.h"
+#include "PackFile.h"
+#include "LibsHeaders.h"
+#include "beryll/core/Log.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+#if defined(ANDROID)
+    #include <jni.h>
+    #include <android/asset_manager.h>
+    #include <android/asset_manager_jni.h>
+#endif
+
+namespace BeryllUtils
+{
+#if defined(ANDROID)
+    namespace
+    {
+        // Same assets SDL_IOFromFile() reads. Created once, can be used from any thread.
+        AAssetManager* getAssetManager()
+        {
+            static AAssetManager* assetManager = nullptr;
+            static std::once_flag created;
+            std::call_once(created, []()
+            {
+                JNIEnv* env = static_cast<JNIEnv*>(SDL_GetAndroidJNIEnv());
+                jobject activity = static_cast<jobject>(SDL_GetAndroidActivity());
+                if(!env || !activity)
+                    return;
+
+                jclass activityClass = env->GetObjectClass(activity);
+                jmethodID getAssets = env->GetMethodID(activityClass, "getAssets", "()Landroid/content/res/AssetManager;");
+                jobject assets = env->CallObjectMethod(activity, getAssets);
+                if(assets)
+                {
+                    // Java object must stay alive while native manager is used.
+                    assetManager = AAssetManager_fromJava(env, env->NewGlobalRef(assets));
+                    env->DeleteLocalRef(assets);
+                }
+                env->DeleteLocalRef(activityClass);
+                env->DeleteLocalRef(activity);
+            });
+            return assetManager;
+        }
+    }
+#endif
+
+    FileView::~FileView()
+    {
+        close();
+    }
+
+    FileView::FileView(FileView&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    FileView& FileView::operator=(FileView&& other) noexcept
+    {
+        if(this != &other)
+        {
+            close();
+
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_mapBase = other.m_mapBase;
+            m_mapSize = other.m_mapSize;
+            m_buffer = std::move(other.m_buffer);
+
+            other.m_data = nullptr;
+            other.m_size = 0;
+            other.m_mapBase = nullptr;
+            other.m_mapSize = 0;
+        }
+        return *this;
+    }
+
+    bool FileView::open(const std::string& filePath)
+    {
+        close();
+
+        if(PackFile::open(filePath, *this))
+            return true;
+
+#if defined(ANDROID)
+        if(!filePath.empty() && filePath[0] != '/')
+        {
+            // Asset inside APK. Only not compressed entries have file descriptor.
+            AAssetManager* assetManager = getAssetManager();
+            AAsset* asset = assetManager ? AAssetManager_open(assetManager, filePath.c_str(), AASSET_MODE_RANDOM) : nullptr;
+            if(asset)
+            {
+                off64_t start = 0;
+                off64_t length = 0;
+                const int fileDescriptor = AAsset_openFileDescriptor64(asset, &start, &length);
+                AAsset_close(asset);
+
+                if(fileDescriptor >= 0)
+                {
+                    const bool mapped = length > 0 && map(fileDescriptor, static_cast<uint64_t>(start), static_cast<uint64_t>(length));
+                    ::close(fileDescriptor); // Mapping stays valid.
+                    if(mapped)
+                        return true;
+                }
+            }
+
+            return read(filePath.c_str());
+        }
+#endif
+
+        if(openPath(filePath.c_str()))
+            return true;
+
+        return read(filePath.c_str());
+    }
+
+    void FileView::close()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        if(m_mapBase)
+            munmap(m_mapBase, m_mapSize);
+#endif
+
+        m_data = nullptr;
+        m_size = 0;
+        m_mapBase = nullptr;
+        m_mapSize = 0;
+        m_buffer.reset();
+    }
+
+    bool FileView::map(int fileDescriptor, uint64_t offset, uint64_t size)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        // Offset of mapping must be aligned to page size. APK entries are aligned only to 4 bytes.
+        const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        const uint64_t alignedOffset = offset & ~(pageSize - 1);
+        const uint64_t mapSize = size + (offset - alignedOffset);
+
+        void* mapBase = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fileDescriptor, static_cast<off_t>(alignedOffset));
+        if(mapBase == MAP_FAILED)
+            return false;
+
+        // Loaders read files from start to end.
+        madvise(mapBase, mapSize, MADV_WILLNEED);
+
+        m_mapBase = mapBase;
+        m_mapSize = mapSize;
+        m_data = static_cast<const char*>(mapBase) + (offset - alignedOffset);
+        m_size = size;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool FileView::openPath(const char* filePath)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        const int fileDescriptor = ::open(filePath, O_RDONLY);
+        if(fileDescriptor < 0)
+            return false;
+
+        struct stat fileStat{};
+        const bool mapped = fstat(fileDescriptor, &fileStat) == 0 && fileStat.st_size > 0 &&
+                            map(fileDescriptor, 0, static_cast<uint64_t>(fileStat.st_size));
+        ::close(fileDescriptor);
+        return mapped;
+#else
+        return false;
+#endif
+    }
+
+    bool FileView::read(const char* filePath)
+    {
+        SDL_IOStream* rw = SDL_IOFromFile(filePath, "rb");
+        if(rw == nullptr)
+            return false;
+
+        const Sint64 size = SDL_GetIOSize(rw);
+        if(size <= 0)
+        {
+            SDL_CloseIO(rw);
+            return false;
+        }
+
+        std::unique_ptr<char[]> buffer(new char[size]);
+        uint64_t readTotal = 0;
+        size_t readBytes = 1;
+        while(readTotal < static_cast<uint64_t>(size) && readBytes != 0)
+        {
+            readBytes = SDL_ReadIO(rw, buffer.get() + readTotal, static_cast<size_t>(size - readTotal));
+            readTotal += readBytes;
+        }
+        SDL_CloseIO(rw);
+
+        if(readTotal != static_cast<uint64_t>(size))
+        {
+            BR_ERROR("File read error: %s", filePath);
+            return false;
+        }
+
+        m_buffer = std::move(buffer);
+        m_data = m_buffer.get();
+        m_size = static_cast<uint64_t>(size);
+        return true;
+    }
+}
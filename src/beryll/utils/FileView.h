@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CppHeaders.h"
+
+namespace BeryllUtils
+{
+    // Read only view of whole file without copy to heap.
+    // Files in mounted packs (PackFile) are found first.
+    // Memory mapped where possible:
+    // - Android: assets stored uncompressed in APK (file descriptor of APK + offset). Absolute paths (internal storage) as file.
+    // - Linux/Apple: file by path.
+    // Otherwise (compressed APK entry, bundle paths, mmap failed) file is read to buffer by SDL.
+    // Data is NOT null terminated. Data lives until close() or destruction of view.
+    class FileView final
+    {
+    public:
+        FileView() = default;
+        ~FileView();
+
+        FileView(const FileView&) = delete;
+        FileView& operator=(const FileView&) = delete;
+        FileView(FileView&& other) noexcept;
+        FileView& operator=(FileView&& other) noexcept;
+
+        // Returns false if file does not exist or is empty.
+        bool open(const std::string& filePath);
+        void close();
+
+        const char* getData() const { return m_data; }
+        uint64_t getSize() const { return m_size; }
+        bool getIsOpen() const { return m_data != nullptr; }
+        bool getIsMapped() const { return m_mapBase != nullptr; }
+
+    private:
+        friend class PackFile; // Sets views into mapped pack or decompressed buffer.
+
+        bool map(int fileDescriptor, uint64_t offset, uint64_t size);
+        bool openPath(const char* filePath);
+        bool read(const char* filePath); // Fallback.
+
+        const char* m_data = nullptr;
+        uint64_t m_size = 0;
+
+        void* m_mapBase = nullptr; // Page aligned. m_data can be after it.
+        uint64_t m_mapSize = 0;
+        std::unique_ptr<char[]> m_buffer; // If not mapped.
+    };
+}
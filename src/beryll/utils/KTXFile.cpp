@@ -0,0 +1,691 @@
+#include "KTXFile.h"
+#include "beryll/core/Log.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace BeryllUtils
+{
+    namespace
+    {
+        constexpr unsigned char KTX1Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+        constexpr unsigned char KTX2Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+        constexpr uint32_t KTX1Endianness = 0x04030201;
+
+        struct KTX1Header
+        {
+            uint32_t endianness;
+            uint32_t glType;
+            uint32_t glTypeSize;
+            uint32_t glFormat;
+            uint32_t glInternalFormat;
+            uint32_t glBaseInternalFormat;
+            uint32_t pixelWidth;
+            uint32_t pixelHeight;
+            uint32_t pixelDepth;
+            uint32_t numberOfArrayElements;
+            uint32_t numberOfFaces;
+            uint32_t numberOfMipmapLevels;
+            uint32_t bytesOfKeyValueData;
+        };
+        static_assert(sizeof(KTX1Header) == 52, "KTX1Header must match file layout.");
+
+        struct KTX2Header
+        {
+            uint32_t vkFormat;
+            uint32_t typeSize;
+            uint32_t pixelWidth;
+            uint32_t pixelHeight;
+            uint32_t pixelDepth;
+            uint32_t layerCount;
+            uint32_t faceCount;
+            uint32_t levelCount;
+            uint32_t supercompressionScheme;
+            uint32_t dfdByteOffset;
+            uint32_t dfdByteLength;
+            uint32_t kvdByteOffset;
+            uint32_t kvdByteLength;
+            uint32_t sgdByteOffset[2]; // uint64 in file. Header after identifier is not 8 bytes aligned.
+            uint32_t sgdByteLength[2];
+        };
+        static_assert(sizeof(KTX2Header) == 68, "KTX2Header must match file layout.");
+
+        struct KTX2LevelIndex
+        {
+            uint64_t byteOffset;
+            uint64_t byteLength;
+            uint64_t uncompressedByteLength;
+        };
+
+        // VkFormat values.
+        constexpr uint32_t vkFormatETC2RGB8 = 147; // RGB8, RGB8A1, RGBA8 follow each other. Every format has UNORM then sRGB value.
+        constexpr uint32_t vkFormatASTC4x4 = 157; // UNORM and sRGB of 14 block sizes follow each other.
+        constexpr uint32_t vkFormatR8 = 9;
+        constexpr uint32_t vkFormatSR8 = 15;
+        constexpr uint32_t vkFormatRGB8 = 23;
+        constexpr uint32_t vkFormatSRGB8 = 29;
+        constexpr uint32_t vkFormatRGBA8 = 37;
+        constexpr uint32_t vkFormatSRGBA8 = 43;
+
+        // Not compressed data.
+        constexpr uint32_t GLTypeUnsignedByte = 0x1401;
+        constexpr uint32_t GLFormatRed = 0x1903;
+        constexpr uint32_t GLFormatRGB = 0x1907;
+        constexpr uint32_t GLFormatRGBA = 0x1908;
+
+        constexpr int ETCModifiers[8][4] = {{2, 8, -2, -8}, {5, 17, -5, -17}, {9, 29, -9, -29}, {13, 42, -13, -42},
+                                            {18, 60, -18, -60}, {24, 80, -24, -80}, {33, 106, -33, -106}, {47, 183, -47, -183}};
+        constexpr int ETCDistances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+        constexpr int EACModifiers[16][8] = {{-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+                                             {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+                                             {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+                                             {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+                                             {-2, -6, -8, -10, 1, 5, 7, 9}, {-2, -5, -8, -10, 1, 4, 7, 9},
+                                             {-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+                                             {-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9},
+                                             {-4, -6, -8, -9, 3, 5, 7, 8}, {-3, -5, -7, -9, 2, 4, 6, 8}};
+
+        int extend4To8(const int value) { return (value << 4) | value; }
+        int extend5To8(const int value) { return (value << 3) | (value >> 2); }
+        int extend6To8(const int value) { return (value << 2) | (value >> 4); }
+        int extend7To8(const int value) { return (value << 1) | (value >> 6); }
+        unsigned char clampTo8(const int value) { return static_cast<unsigned char>(std::clamp(value, 0, 255)); }
+
+        void setPixel(unsigned char* pixels, const int x, const int y, const int r, const int g, const int b, const int a)
+        {
+            unsigned char* pixel = pixels + (y * 4 + x) * 4;
+            pixel[0] = clampTo8(r);
+            pixel[1] = clampTo8(g);
+            pixel[2] = clampTo8(b);
+            pixel[3] = clampTo8(a);
+        }
+    }
+
+    bool KTXFile::isKTXFile(const std::string& path)
+    {
+        const size_t lastDotPos = path.find_last_of('.');
+        if(lastDotPos == std::string::npos)
+            return false;
+
+        const std::string extension = path.substr(lastDotPos);
+        return extension == ".ktx" || extension == ".ktx2";
+    }
+
+    bool KTXFile::load(const std::string& filePath, TextureFileData& texture)
+    {
+        if(!texture.file.open(filePath))
+        {
+            BR_ERROR("File reading error: %s", filePath.c_str());
+            return false;
+        }
+
+        if(!parse(texture.file.getData(), texture.file.getSize(), texture))
+        {
+            BR_ERROR("Not supported or damaged KTX file: %s", filePath.c_str());
+            texture.file.close();
+            return false;
+        }
+
+        return true;
+    }
+
+    bool KTXFile::parse(const char* buffer, uint64_t size, TextureFileData& texture)
+    {
+        texture.levels.clear();
+
+        if(!buffer || size < sizeof(KTX1Identifier))
+            return false;
+
+        if(std::memcmp(buffer, KTX1Identifier, sizeof(KTX1Identifier)) == 0)
+            return parseKTX1(buffer, size, texture);
+        else if(std::memcmp(buffer, KTX2Identifier, sizeof(KTX2Identifier)) == 0)
+            return parseKTX2(buffer, size, texture);
+
+        return false;
+    }
+
+    bool KTXFile::parseKTX1(const char* buffer, uint64_t size, TextureFileData& texture)
+    {
+        if(size < sizeof(KTX1Identifier) + sizeof(KTX1Header))
+            return false;
+
+        KTX1Header header;
+        std::memcpy(&header, buffer + sizeof(KTX1Identifier), sizeof(KTX1Header));
+
+        // Only 2D, not array, not cube map, same endianness as device.
+        // Compressed (glType = 0) or RGBA8 (rows of RGBA8 are always aligned to 4 bytes as KTX 1 requires).
+        if(header.endianness != KTX1Endianness || header.pixelWidth == 0 || header.pixelHeight == 0 ||
+           header.pixelDepth > 1 || header.numberOfArrayElements > 1 || header.numberOfFaces != 1)
+            return false;
+        if(header.glType != 0 && (header.glType != GLTypeUnsignedByte || header.glFormat != GLFormatRGBA))
+            return false;
+
+        if(!setFormatFromGL(header.glInternalFormat, texture) || (header.glType != 0 && texture.format != TextureFileFormat::RGBA8))
+            return false;
+
+        texture.width = header.pixelWidth;
+        texture.height = header.pixelHeight;
+
+        const uint32_t levelCount = std::max(header.numberOfMipmapLevels, 1u);
+        uint64_t offset = sizeof(KTX1Identifier) + sizeof(KTX1Header) + uint64_t(header.bytesOfKeyValueData);
+        for(uint32_t i = 0; i < levelCount; ++i)
+        {
+            uint32_t imageSize = 0;
+            if(offset + sizeof(imageSize) > size)
+                return false;
+            std::memcpy(&imageSize, buffer + offset, sizeof(imageSize));
+            offset += sizeof(imageSize);
+
+            TextureFileData::Level level;
+            level.width = std::max(texture.width >> i, 1u);
+            level.height = std::max(texture.height >> i, 1u);
+            level.size = imageSize;
+            if(imageSize != getLevelSize(texture, level.width, level.height) || offset + imageSize > size)
+                return false;
+
+            level.data = reinterpret_cast<const unsigned char*>(buffer + offset);
+            texture.levels.push_back(level);
+
+            offset += (uint64_t(imageSize) + 3) & ~uint64_t(3); // mipPadding.
+        }
+
+        return true;
+    }
+
+    bool KTXFile::parseKTX2(const char* buffer, uint64_t size, TextureFileData& texture)
+    {
+        if(size < sizeof(KTX2Identifier) + sizeof(KTX2Header))
+            return false;
+
+        KTX2Header header;
+        std::memcpy(&header, buffer + sizeof(KTX2Identifier), sizeof(KTX2Header));
+
+        // Supercompressed (BasisLZ, Zstandard) data is not supported.
+        if(header.supercompressionScheme != 0 || header.pixelWidth == 0 || header.pixelHeight == 0 ||
+           header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1)
+            return false;
+
+        if(!setFormatFromVulkan(header.vkFormat, texture))
+            return false;
+
+        texture.width = header.pixelWidth;
+        texture.height = header.pixelHeight;
+
+        const uint32_t levelCount = std::max(header.levelCount, 1u);
+        const uint64_t levelIndexOffset = sizeof(KTX2Identifier) + sizeof(KTX2Header);
+        if(levelIndexOffset + uint64_t(sizeof(KTX2LevelIndex)) * levelCount > size)
+            return false;
+
+        for(uint32_t i = 0; i < levelCount; ++i)
+        {
+            KTX2LevelIndex index;
+            std::memcpy(&index, buffer + levelIndexOffset + sizeof(KTX2LevelIndex) * i, sizeof(KTX2LevelIndex));
+
+            TextureFileData::Level level;
+            level.width = std::max(texture.width >> i, 1u);
+            level.height = std::max(texture.height >> i, 1u);
+            level.size = getLevelSize(texture, level.width, level.height);
+            if(index.byteLength != level.size || index.byteOffset + index.byteLength > size)
+                return false;
+
+            level.data = reinterpret_cast<const unsigned char*>(buffer + index.byteOffset);
+            texture.levels.push_back(level);
+        }
+
+        return true;
+    }
+
+    bool KTXFile::setFormatFromGL(uint32_t glInternalFormat, TextureFileData& texture)
+    {
+        texture.glInternalFormat = glInternalFormat;
+        texture.glFormat = 0;
+        texture.blockWidth = 4;
+        texture.blockHeight = 4;
+        texture.blockBytes = 16;
+
+        switch(glInternalFormat)
+        {
+            case GLFormatETC2RGB8:
+            case GLFormatETC2SRGB8:
+                texture.format = TextureFileFormat::ETC2_RGB8;
+                texture.isSRGB = glInternalFormat == GLFormatETC2SRGB8;
+                texture.blockBytes = 8;
+                return true;
+            case GLFormatETC2RGB8A1:
+            case GLFormatETC2SRGB8A1:
+                texture.format = TextureFileFormat::ETC2_RGB8A1;
+                texture.isSRGB = glInternalFormat == GLFormatETC2SRGB8A1;
+                texture.blockBytes = 8;
+                return true;
+            case GLFormatETC2RGBA8:
+            case GLFormatETC2SRGB8A8:
+                texture.format = TextureFileFormat::ETC2_RGBA8;
+                texture.isSRGB = glInternalFormat == GLFormatETC2SRGB8A8;
+                return true;
+            case GLFormatR8:
+            case GLFormatSR8:
+                texture.format = TextureFileFormat::R8;
+                texture.isSRGB = glInternalFormat == GLFormatSR8;
+                texture.glFormat = GLFormatRed;
+                texture.blockWidth = 1;
+                texture.blockHeight = 1;
+                texture.blockBytes = 1;
+                return true;
+            case GLFormatRGB8:
+            case GLFormatSRGB8:
+                texture.format = TextureFileFormat::RGB8;
+                texture.isSRGB = glInternalFormat == GLFormatSRGB8;
+                texture.glFormat = GLFormatRGB;
+                texture.blockWidth = 1;
+                texture.blockHeight = 1;
+                texture.blockBytes = 3;
+                return true;
+            case GLFormatRGBA8:
+            case GLFormatSRGB8A8:
+                texture.format = TextureFileFormat::RGBA8;
+                texture.isSRGB = glInternalFormat == GLFormatSRGB8A8;
+                texture.glFormat = GLFormatRGBA;
+                texture.blockWidth = 1;
+                texture.blockHeight = 1;
+                texture.blockBytes = 4;
+                return true;
+            default:
+                break;
+        }
+
+        for(uint32_t i = 0; i < m_ASTCBlockSizes.size(); ++i)
+        {
+            if(glInternalFormat == GLFormatASTC4x4 + i || glInternalFormat == GLFormatSRGBASTC4x4 + i)
+            {
+                texture.format = TextureFileFormat::ASTC;
+                texture.isSRGB = glInternalFormat == GLFormatSRGBASTC4x4 + i;
+                texture.blockWidth = m_ASTCBlockSizes[i][0];
+                texture.blockHeight = m_ASTCBlockSizes[i][1];
+                return true;
+            }
+        }
+
+        texture.format = TextureFileFormat::UNKNOWN;
+        return false;
+    }
+
+    bool KTXFile::setFormatFromVulkan(uint32_t vkFormat, TextureFileData& texture)
+    {
+        if(vkFormat >= vkFormatETC2RGB8 && vkFormat < vkFormatETC2RGB8 + 6)
+        {
+            // Vulkan and GL ETC2 formats are in same order.
+            return setFormatFromGL(GLFormatETC2RGB8 + (vkFormat - vkFormatETC2RGB8), texture);
+        }
+
+        if(vkFormat == vkFormatR8 || vkFormat == vkFormatSR8)
+            return setFormatFromGL(vkFormat == vkFormatSR8 ? GLFormatSR8 : GLFormatR8, texture);
+        if(vkFormat == vkFormatRGB8 || vkFormat == vkFormatSRGB8)
+            return setFormatFromGL(vkFormat == vkFormatSRGB8 ? GLFormatSRGB8 : GLFormatRGB8, texture);
+        if(vkFormat == vkFormatRGBA8 || vkFormat == vkFormatSRGBA8)
+            return setFormatFromGL(vkFormat == vkFormatSRGBA8 ? GLFormatSRGB8A8 : GLFormatRGBA8, texture);
+
+        if(vkFormat >= vkFormatASTC4x4 && vkFormat < vkFormatASTC4x4 + m_ASTCBlockSizes.size() * 2)
+        {
+            const uint32_t blockSizeIndex = (vkFormat - vkFormatASTC4x4) / 2;
+            const bool isSRGB = (vkFormat - vkFormatASTC4x4) % 2 == 1;
+            return setFormatFromGL((isSRGB ? GLFormatSRGBASTC4x4 : GLFormatASTC4x4) + blockSizeIndex, texture);
+        }
+
+        texture.format = TextureFileFormat::UNKNOWN;
+        return false;
+    }
+
+    uint32_t KTXFile::getLevelSize(const TextureFileData& texture, uint32_t width, uint32_t height)
+    {
+        const uint32_t blocksX = (width + texture.blockWidth - 1) / texture.blockWidth;
+        const uint32_t blocksY = (height + texture.blockHeight - 1) / texture.blockHeight;
+        return blocksX * blocksY * texture.blockBytes;
+    }
+
+    bool KTXFile::getIsCompressed(TextureFileFormat format)
+    {
+        return format != TextureFileFormat::R8 && format != TextureFileFormat::RGB8 && format != TextureFileFormat::RGBA8;
+    }
+
+    bool KTXFile::canDecode(TextureFileFormat format)
+    {
+        return format == TextureFileFormat::ETC2_RGB8 || format == TextureFileFormat::ETC2_RGB8A1 || format == TextureFileFormat::ETC2_RGBA8 ||
+               !getIsCompressed(format);
+    }
+
+    bool KTXFile::decodeLevel(const TextureFileData& texture, uint32_t level, std::vector<unsigned char>& rgba)
+    {
+        if(!canDecode(texture.format) || level >= texture.levels.size())
+            return false;
+
+        const TextureFileData::Level& lev = texture.levels[level];
+        if(texture.format == TextureFileFormat::RGBA8)
+        {
+            rgba.assign(lev.data, lev.data + lev.size);
+            return true;
+        }
+
+        if(!getIsCompressed(texture.format))
+        {
+            const uint32_t channels = texture.blockBytes;
+            const size_t pixelCount = size_t(lev.width) * lev.height;
+            rgba.assign(pixelCount * 4, 0);
+            for(size_t i = 0; i < pixelCount; ++i)
+            {
+                std::memcpy(&rgba[i * 4], lev.data + i * channels, channels);
+                rgba[i * 4 + 3] = 255;
+            }
+            return true;
+        }
+
+        rgba.resize(size_t(lev.width) * lev.height * 4);
+
+        const uint32_t blocksX = (lev.width + 3) / 4;
+        const uint32_t blocksY = (lev.height + 3) / 4;
+        unsigned char blockPixels[16 * 4];
+
+        const unsigned char* block = lev.data;
+        for(uint32_t by = 0; by < blocksY; ++by)
+        {
+            for(uint32_t bx = 0; bx < blocksX; ++bx)
+            {
+                if(texture.format == TextureFileFormat::ETC2_RGBA8)
+                {
+                    decodeETC2ColorBlock(block + 8, false, blockPixels);
+                    decodeEACAlphaBlock(block, blockPixels);
+                }
+                else
+                {
+                    decodeETC2ColorBlock(block, texture.format == TextureFileFormat::ETC2_RGB8A1, blockPixels);
+                }
+                block += texture.blockBytes;
+
+                // Blocks on right and bottom edges can be outside of level.
+                const uint32_t copyWidth = std::min(4u, lev.width - bx * 4);
+                const uint32_t copyHeight = std::min(4u, lev.height - by * 4);
+                for(uint32_t y = 0; y < copyHeight; ++y)
+                {
+                    std::memcpy(rgba.data() + ((size_t(by) * 4 + y) * lev.width + bx * 4) * 4, blockPixels + y * 4 * 4, copyWidth * 4);
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool KTXFile::writeKTX2(const std::vector<MipLevel>& levels, bool isSRGB, const std::string& outPath)
+    {
+        if(levels.empty() || levels[0].width == 0 || levels[0].height == 0)
+            return false;
+
+        const uint32_t channels = levels[0].channels;
+        if(channels != 1 && channels != 3 && channels != 4)
+        {
+            BR_ERROR("Wrong channels count %d for: %s", int(channels), outPath.c_str());
+            return false;
+        }
+
+        for(size_t i = 0; i < levels.size(); ++i)
+        {
+            if(levels[i].width != std::max(levels[0].width >> i, 1u) || levels[i].height != std::max(levels[0].height >> i, 1u) ||
+               levels[i].channels != channels || levels[i].pixels.size() != size_t(levels[i].width) * levels[i].height * channels)
+            {
+                BR_ERROR("Wrong mip level %d for: %s", int(i), outPath.c_str());
+                return false;
+            }
+        }
+
+        // Data format descriptor. One sample per channel.
+        const uint32_t samplesCount = channels;
+        const uint32_t DFDBlockSize = 24 + 16 * samplesCount;
+        std::vector<uint32_t> DFD;
+        DFD.push_back(4 + DFDBlockSize); // Total size.
+        DFD.push_back(0); // Vendor Khronos, descriptor type basic.
+        DFD.push_back(2 | (DFDBlockSize << 16)); // Version 2, block size.
+        DFD.push_back(1 | (1 << 8) | ((isSRGB ? 2u : 1u) << 16)); // Model RGBSDA, primaries BT709, transfer sRGB or linear, straight alpha.
+        DFD.push_back(0); // Texel block dimensions 1x1x1x1.
+        DFD.push_back(channels); // Bytes plane 0.
+        DFD.push_back(0);
+        for(uint32_t c = 0; c < samplesCount; ++c)
+        {
+            const uint32_t channel = c == 3 ? 15 : c; // R, G, B, alpha.
+            const uint32_t linearFlag = (c == 3 && isSRGB) ? 0x10 : 0; // Alpha is not sRGB.
+            DFD.push_back((c * 8) | (7 << 16) | ((channel | linearFlag) << 24)); // Bit offset, bit length - 1, channel.
+            DFD.push_back(0); // Sample position.
+            DFD.push_back(0); // Lower.
+            DFD.push_back(255); // Upper.
+        }
+
+        const uint32_t levelCount = static_cast<uint32_t>(levels.size());
+        const uint64_t DFDOffset = sizeof(KTX2Identifier) + sizeof(KTX2Header) + uint64_t(sizeof(KTX2LevelIndex)) * levelCount;
+
+        KTX2Header header{};
+        if(channels == 1)
+            header.vkFormat = isSRGB ? vkFormatSR8 : vkFormatR8;
+        else if(channels == 3)
+            header.vkFormat = isSRGB ? vkFormatSRGB8 : vkFormatRGB8;
+        else
+            header.vkFormat = isSRGB ? vkFormatSRGBA8 : vkFormatRGBA8;
+        header.typeSize = 1;
+        header.pixelWidth = levels[0].width;
+        header.pixelHeight = levels[0].height;
+        header.faceCount = 1;
+        header.levelCount = levelCount;
+        header.dfdByteOffset = static_cast<uint32_t>(DFDOffset);
+        header.dfdByteLength = static_cast<uint32_t>(DFD.size() * sizeof(uint32_t));
+
+        // Smallest level first in file. Levels start at multiple of least common multiple of texel size and 4.
+        const uint64_t levelAlignment = channels == 3 ? 12 : 4;
+        std::vector<KTX2LevelIndex> index(levelCount);
+        std::vector<uint64_t> paddings(levelCount);
+        uint64_t offset = DFDOffset + header.dfdByteLength;
+        for(int i = static_cast<int>(levelCount) - 1; i >= 0; --i)
+        {
+            paddings[i] = (levelAlignment - offset % levelAlignment) % levelAlignment;
+            offset += paddings[i];
+            index[i].byteOffset = offset;
+            index[i].byteLength = levels[i].pixels.size();
+            index[i].uncompressedByteLength = levels[i].pixels.size();
+            offset += levels[i].pixels.size();
+        }
+
+        std::ofstream file(outPath, std::ios::binary | std::ios::trunc);
+        if(!file)
+        {
+            BR_ERROR("Can not open file for writing: %s", outPath.c_str());
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(KTX2Identifier), sizeof(KTX2Identifier));
+        file.write(reinterpret_cast<const char*>(&header), sizeof(KTX2Header));
+        file.write(reinterpret_cast<const char*>(index.data()), sizeof(KTX2LevelIndex) * index.size());
+        file.write(reinterpret_cast<const char*>(DFD.data()), DFD.size() * sizeof(uint32_t));
+        const char padding[12] = {};
+        for(int i = static_cast<int>(levelCount) - 1; i >= 0; --i)
+        {
+            file.write(padding, static_cast<std::streamsize>(paddings[i]));
+            file.write(reinterpret_cast<const char*>(levels[i].pixels.data()), levels[i].pixels.size());
+        }
+
+        if(!file)
+        {
+            BR_ERROR("Writing error: %s", outPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    void KTXFile::decodeETC2ColorBlock(const unsigned char* block, bool punchThroughAlpha, unsigned char* pixels)
+    {
+        // Block is big endian 64 bits. Low 32 bits are pixel indices: most significant bits then least significant bits.
+        // Pixels in indices are ordered by columns.
+        const uint32_t indices = (uint32_t(block[4]) << 24) | (uint32_t(block[5]) << 16) | (uint32_t(block[6]) << 8) | uint32_t(block[7]);
+        const auto getIndex = [indices](const int x, const int y) -> int
+        {
+            const int i = x * 4 + y;
+            return int(((indices >> (16 + i)) & 1) << 1) | int((indices >> i) & 1);
+        };
+
+        // For punch through alpha formats this bit is opaque flag and differential mode is always used.
+        const bool bit33 = block[3] & 2;
+        const bool opaque = !punchThroughAlpha || bit33;
+        const bool differential = punchThroughAlpha || bit33;
+
+        int base1[3];
+        int base2[3];
+        if(differential)
+        {
+            int base[3];
+            int delta[3];
+            for(int c = 0; c < 3; ++c)
+            {
+                base[c] = block[c] >> 3;
+                delta[c] = (int(block[c] & 7) ^ 4) - 4; // Signed 3 bits.
+            }
+
+            const auto isOverflow = [&](const int c) { return base[c] + delta[c] < 0 || base[c] + delta[c] > 31; };
+            if(isOverflow(0))
+            {
+                // T mode.
+                const int color1[3] = {extend4To8(((block[0] >> 1) & 0x0C) | (block[0] & 3)), extend4To8(block[1] >> 4), extend4To8(block[1] & 0x0F)};
+                const int color2[3] = {extend4To8(block[2] >> 4), extend4To8(block[2] & 0x0F), extend4To8(block[3] >> 4)};
+                const int distance = ETCDistances[((block[3] >> 1) & 6) | (block[3] & 1)];
+                const int paint[4][3] = {{color1[0], color1[1], color1[2]},
+                                         {color2[0] + distance, color2[1] + distance, color2[2] + distance},
+                                         {color2[0], color2[1], color2[2]},
+                                         {color2[0] - distance, color2[1] - distance, color2[2] - distance}};
+
+                for(int y = 0; y < 4; ++y)
+                {
+                    for(int x = 0; x < 4; ++x)
+                    {
+                        const int index = getIndex(x, y);
+                        if(!opaque && index == 2)
+                            setPixel(pixels, x, y, 0, 0, 0, 0);
+                        else
+                            setPixel(pixels, x, y, paint[index][0], paint[index][1], paint[index][2], 255);
+                    }
+                }
+                return;
+            }
+            else if(isOverflow(1))
+            {
+                // H mode.
+                const int color1[3] = {extend4To8((block[0] >> 3) & 0x0F),
+                                       extend4To8(((block[0] & 7) << 1) | ((block[1] >> 4) & 1)),
+                                       extend4To8((block[1] & 8) | ((block[1] & 3) << 1) | (block[2] >> 7))};
+                const int color2[3] = {extend4To8((block[2] >> 3) & 0x0F),
+                                       extend4To8(((block[2] & 7) << 1) | (block[3] >> 7)),
+                                       extend4To8((block[3] >> 3) & 0x0F)};
+                const bool order = ((color1[0] << 16) | (color1[1] << 8) | color1[2]) >= ((color2[0] << 16) | (color2[1] << 8) | color2[2]);
+                const int distance = ETCDistances[(block[3] & 4) | ((block[3] & 1) << 1) | (order ? 1 : 0)];
+                const int paint[4][3] = {{color1[0] + distance, color1[1] + distance, color1[2] + distance},
+                                         {color1[0] - distance, color1[1] - distance, color1[2] - distance},
+                                         {color2[0] + distance, color2[1] + distance, color2[2] + distance},
+                                         {color2[0] - distance, color2[1] - distance, color2[2] - distance}};
+
+                for(int y = 0; y < 4; ++y)
+                {
+                    for(int x = 0; x < 4; ++x)
+                    {
+                        const int index = getIndex(x, y);
+                        if(!opaque && index == 2)
+                            setPixel(pixels, x, y, 0, 0, 0, 0);
+                        else
+                            setPixel(pixels, x, y, paint[index][0], paint[index][1], paint[index][2], 255);
+                    }
+                }
+                return;
+            }
+            else if(isOverflow(2))
+            {
+                // Planar mode. Always opaque.
+                const int origin[3] = {extend6To8((block[0] >> 1) & 0x3F),
+                                       extend7To8(((block[0] & 1) << 6) | ((block[1] >> 1) & 0x3F)),
+                                       extend6To8(((block[1] & 1) << 5) | (block[2] & 0x18) | ((block[2] & 3) << 1) | (block[3] >> 7))};
+                const int horizontal[3] = {extend6To8(((block[3] >> 1) & 0x3E) | (block[3] & 1)),
+                                           extend7To8(block[4] >> 1),
+                                           extend6To8(((block[4] & 1) << 5) | (block[5] >> 3))};
+                const int vertical[3] = {extend6To8(((block[5] & 7) << 3) | (block[6] >> 5)),
+                                         extend7To8(((block[6] & 0x1F) << 2) | (block[7] >> 6)),
+                                         extend6To8(block[7] & 0x3F)};
+
+                for(int y = 0; y < 4; ++y)
+                {
+                    for(int x = 0; x < 4; ++x)
+                    {
+                        int color[3];
+                        for(int c = 0; c < 3; ++c)
+                        {
+                            color[c] = (x * (horizontal[c] - origin[c]) + y * (vertical[c] - origin[c]) + 4 * origin[c] + 2) >> 2;
+                        }
+                        setPixel(pixels, x, y, color[0], color[1], color[2], 255);
+                    }
+                }
+                return;
+            }
+
+            for(int c = 0; c < 3; ++c)
+            {
+                base1[c] = extend5To8(base[c]);
+                base2[c] = extend5To8(base[c] + delta[c]);
+            }
+        }
+        else
+        {
+            // Individual mode.
+            for(int c = 0; c < 3; ++c)
+            {
+                base1[c] = extend4To8(block[c] >> 4);
+                base2[c] = extend4To8(block[c] & 0x0F);
+            }
+        }
+
+        const int table1 = (block[3] >> 5) & 7;
+        const int table2 = (block[3] >> 2) & 7;
+        const bool flip = block[3] & 1; // false = two 2x4 sub blocks side by side, true = two 4x2 sub blocks one above other.
+
+        for(int y = 0; y < 4; ++y)
+        {
+            for(int x = 0; x < 4; ++x)
+            {
+                const bool secondSubBlock = flip ? y >= 2 : x >= 2;
+                const int* base = secondSubBlock ? base2 : base1;
+                const int index = getIndex(x, y);
+
+                if(!opaque && index == 2)
+                {
+                    setPixel(pixels, x, y, 0, 0, 0, 0);
+                    continue;
+                }
+
+                // Not opaque blocks use modifier 0 instead of small modifiers.
+                const int modifier = (!opaque && index == 0) ? 0 : ETCModifiers[secondSubBlock ? table2 : table1][index];
+                setPixel(pixels, x, y, base[0] + modifier, base[1] + modifier, base[2] + modifier, 255);
+            }
+        }
+    }
+
+    void KTXFile::decodeEACAlphaBlock(const unsigned char* block, unsigned char* pixels)
+    {
+        const int base = block[0];
+        const int multiplier = block[1] >> 4;
+        const int* modifiers = EACModifiers[block[1] & 0x0F];
+
+        // 16 indices of 3 bits, big endian, ordered by columns.
+        uint64_t indices = 0;
+        for(int i = 2; i < 8; ++i)
+        {
+            indices = (indices << 8) | block[i];
+        }
+
+        for(int i = 0; i < 16; ++i)
+        {
+            const int index = int((indices >> (45 - 3 * i)) & 7);
+            const int x = i / 4;
+            const int y = i % 4;
+            pixels[(y * 4 + x) * 4 + 3] = clampTo8(base + modifiers[index] * multiplier);
+        }
+    }
+}
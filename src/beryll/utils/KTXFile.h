@@ -0,0 +1,102 @@
+#pragma once
+
+#include "CppHeaders.h"
+#include "MipChain.h"
+#include "FileView.h"
+
+namespace BeryllUtils
+{
+    enum class TextureFileFormat
+    {
+        UNKNOWN,
+        ETC2_RGB8, // 4x4 blocks, 8 bytes.
+        ETC2_RGB8A1, // 4x4 blocks, 8 bytes. Punch through alpha.
+        ETC2_RGBA8, // 4x4 blocks, 16 bytes. EAC alpha + ETC2 color.
+        ASTC, // Block size in TextureFileData. 16 bytes per block.
+        // Not compressed. Mip levels created offline by MipChain.
+        R8,
+        RGB8,
+        RGBA8
+    };
+
+    // Texture loaded from .ktx/.ktx2 file. Mip levels are stored in file and point inside file view (mapped file).
+    struct TextureFileData
+    {
+        struct Level
+        {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            const unsigned char* data = nullptr;
+            uint32_t size = 0;
+        };
+
+        TextureFileFormat format = TextureFileFormat::UNKNOWN;
+        uint32_t glInternalFormat = 0; // GL_COMPRESSED_* for glCompressedTexImage2D(). GL_R8, GL_RGB8, GL_RGBA8 or sRGB variant for not compressed.
+        uint32_t glFormat = 0; // GL_RED, GL_RGB or GL_RGBA for glTexImage2D() of not compressed formats. 0 for compressed.
+        bool isSRGB = false;
+        uint32_t blockWidth = 0;
+        uint32_t blockHeight = 0;
+        uint32_t blockBytes = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<Level> levels; // Level 0 = full size.
+
+        FileView file;
+    };
+
+    // Parser of KTX 1 and KTX 2 files with ETC2, ASTC, R8, RGB8 or RGBA8 data (2D, one face, one layer, no supercompression).
+    // KTX 1 supports only RGBA8 of not compressed formats (rows of other formats are padded to 4 bytes).
+    // Does not use graphics API. Formats which GPU does not support can be decoded on CPU to RGBA8.
+    class KTXFile
+    {
+    public:
+        KTXFile() = delete;
+        ~KTXFile() = delete;
+
+        static bool isKTXFile(const std::string& path); // By extension .ktx or .ktx2.
+
+        // Returns false if file can not be read or format is not supported.
+        static bool load(const std::string& filePath, TextureFileData& texture);
+        // Levels will point inside buffer. Buffer must live while levels are used.
+        static bool parse(const char* buffer, uint64_t size, TextureFileData& texture);
+
+        static bool getIsCompressed(TextureFileFormat format);
+        // ETC2 and not compressed formats. ASTC is not decoded on CPU.
+        static bool canDecode(TextureFileFormat format);
+        // Decode one level to RGBA8 pixels (width * height * 4 bytes, rows from top). Missing channels are 0, alpha 255 (same as GPU sampling).
+        static bool decodeLevel(const TextureFileData& texture, uint32_t level, std::vector<unsigned char>& rgba);
+
+        // KTX 2 file with R8, RGB8 or RGBA8 levels (VK_FORMAT_R8_UNORM, R8G8B8_UNORM, R8G8B8A8_UNORM or _SRGB).
+        // All levels must have same channels count (1, 3 or 4). Uses std::ofstream (not SDL) so can be used from offline tools.
+        static bool writeKTX2(const std::vector<MipLevel>& levels, bool isSRGB, const std::string& outPath);
+
+        // GL_COMPRESSED_* values (same in all GL headers). Checked against GL_COMPRESSED_TEXTURE_FORMATS list.
+        static constexpr uint32_t GLFormatETC2RGB8 = 0x9274;
+        static constexpr uint32_t GLFormatETC2SRGB8 = 0x9275;
+        static constexpr uint32_t GLFormatETC2RGB8A1 = 0x9276;
+        static constexpr uint32_t GLFormatETC2SRGB8A1 = 0x9277;
+        static constexpr uint32_t GLFormatETC2RGBA8 = 0x9278;
+        static constexpr uint32_t GLFormatETC2SRGB8A8 = 0x9279;
+        static constexpr uint32_t GLFormatASTC4x4 = 0x93B0; // 14 block sizes follow in same order as m_ASTCBlockSizes.
+        static constexpr uint32_t GLFormatSRGBASTC4x4 = 0x93D0;
+        static constexpr uint32_t GLFormatR8 = 0x8229;
+        static constexpr uint32_t GLFormatSR8 = 0x8FBD; // GL_EXT_texture_sRGB_R8.
+        static constexpr uint32_t GLFormatRGB8 = 0x8051;
+        static constexpr uint32_t GLFormatSRGB8 = 0x8C41;
+        static constexpr uint32_t GLFormatRGBA8 = 0x8058;
+        static constexpr uint32_t GLFormatSRGB8A8 = 0x8C43;
+
+    private:
+        static bool parseKTX1(const char* buffer, uint64_t size, TextureFileData& texture);
+        static bool parseKTX2(const char* buffer, uint64_t size, TextureFileData& texture);
+        static bool setFormatFromGL(uint32_t glInternalFormat, TextureFileData& texture);
+        static bool setFormatFromVulkan(uint32_t vkFormat, TextureFileData& texture);
+        static uint32_t getLevelSize(const TextureFileData& texture, uint32_t width, uint32_t height);
+
+        static void decodeETC2ColorBlock(const unsigned char* block, bool punchThroughAlpha, unsigned char* pixels);
+        static void decodeEACAlphaBlock(const unsigned char* block, unsigned char* pixels);
+
+        static constexpr std::array<std::array<uint32_t, 2>, 14> m_ASTCBlockSizes{{{4, 4}, {5, 4}, {5, 5}, {6, 5}, {6, 6}, {8, 5}, {8, 6},
+                                                                                  {8, 8}, {10, 5}, {10, 6}, {10, 8}, {10, 10}, {12, 10}, {12, 12}}};
+    };
+}
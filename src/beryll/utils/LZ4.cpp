@@ -0,0 +1,173 @@
+#include "LZ4.h"
+
+#include <cstring>
+
+namespace BeryllUtils
+{
+    namespace
+    {
+        uint32_t read32(const unsigned char* p)
+        {
+            uint32_t value = 0;
+            std::memcpy(&value, p, sizeof(uint32_t));
+            return value;
+        }
+
+        // Length >= 15 is stored as 15 in token + bytes of 255 + rest.
+        bool writeLength(uint32_t length, unsigned char*& op, const unsigned char* opEnd)
+        {
+            for(; length >= 255; length -= 255)
+            {
+                if(op >= opEnd) { return false; }
+                *op++ = 255;
+            }
+            if(op >= opEnd) { return false; }
+            *op++ = static_cast<unsigned char>(length);
+            return true;
+        }
+
+        bool writeSequence(const unsigned char* literals, uint32_t literalLength, uint32_t offset, uint32_t matchLength,
+                           unsigned char*& op, const unsigned char* opEnd)
+        {
+            if(op >= opEnd) { return false; }
+            unsigned char* token = op++;
+            *token = static_cast<unsigned char>(std::min(literalLength, 15u) << 4);
+            if(literalLength >= 15 && !writeLength(literalLength - 15, op, opEnd))
+                return false;
+
+            if(static_cast<uint32_t>(opEnd - op) < literalLength) { return false; }
+            if(literalLength > 0)
+                std::memcpy(op, literals, literalLength);
+            op += literalLength;
+
+            if(matchLength == 0)
+                return true; // Last sequence. Only literals.
+
+            if(opEnd - op < 2) { return false; }
+            *op++ = static_cast<unsigned char>(offset & 0xFF);
+            *op++ = static_cast<unsigned char>(offset >> 8);
+
+            const uint32_t length = matchLength - 4;
+            *token |= static_cast<unsigned char>(std::min(length, 15u));
+            return length < 15 || writeLength(length - 15, op, opEnd);
+        }
+    }
+
+    uint32_t LZ4::compress(const char* src, uint32_t srcSize, char* dst, uint32_t dstCapacity)
+    {
+        const unsigned char* const input = reinterpret_cast<const unsigned char*>(src);
+        unsigned char* op = reinterpret_cast<unsigned char*>(dst);
+        const unsigned char* const opEnd = op + dstCapacity;
+
+        uint32_t anchor = 0; // Start of not written literals.
+        if(srcSize > m_matchFindLimit)
+        {
+            std::vector<int32_t> hashTable(size_t(1) << m_hashBits, -1); // Last position of 4 bytes with same hash.
+            const uint32_t matchLimit = srcSize - m_lastLiterals;
+            const uint32_t positionLimit = srcSize - m_matchFindLimit;
+
+            uint32_t ip = 0;
+            while(ip < positionLimit)
+            {
+                const uint32_t sequence = read32(input + ip);
+                const uint32_t hash = (sequence * 2654435761u) >> (32 - m_hashBits);
+                const int32_t ref = hashTable[hash];
+                hashTable[hash] = static_cast<int32_t>(ip);
+
+                if(ref < 0 || ip - ref > m_maxOffset || read32(input + ref) != sequence)
+                {
+                    // Step grows in long runs of literals. Incompressible data is skipped faster.
+                    ip += 1 + ((ip - anchor) >> 6);
+                    continue;
+                }
+
+                uint32_t matchLength = m_minMatch;
+                while(ip + matchLength < matchLimit && input[ref + matchLength] == input[ip + matchLength])
+                {
+                    ++matchLength;
+                }
+
+                if(!writeSequence(input + anchor, ip - anchor, ip - ref, matchLength, op, opEnd))
+                    return 0;
+
+                ip += matchLength;
+                anchor = ip;
+            }
+        }
+
+        if(!writeSequence(input + anchor, srcSize - anchor, 0, 0, op, opEnd))
+            return 0;
+
+        return static_cast<uint32_t>(op - reinterpret_cast<unsigned char*>(dst));
+    }
+
+    int64_t LZ4::decompress(const char* src, uint32_t srcSize, char* dst, uint32_t dstSize)
+    {
+        const unsigned char* ip = reinterpret_cast<const unsigned char*>(src);
+        const unsigned char* const ipEnd = ip + srcSize;
+        unsigned char* const output = reinterpret_cast<unsigned char*>(dst);
+        unsigned char* op = output;
+        unsigned char* const opEnd = op + dstSize;
+
+        while(ip < ipEnd)
+        {
+            const uint32_t token = *ip++;
+
+            size_t literalLength = token >> 4;
+            if(literalLength == 15)
+            {
+                uint32_t value = 255;
+                while(value == 255)
+                {
+                    if(ip >= ipEnd) { return -1; }
+                    value = *ip++;
+                    literalLength += value;
+                }
+            }
+
+            if(static_cast<size_t>(ipEnd - ip) < literalLength || static_cast<size_t>(opEnd - op) < literalLength) { return -1; }
+            std::memcpy(op, ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+
+            if(ip == ipEnd)
+                break; // Last sequence.
+
+            if(ipEnd - ip < 2) { return -1; }
+            const size_t offset = ip[0] | (ip[1] << 8);
+            ip += 2;
+            if(offset == 0 || offset > static_cast<size_t>(op - output)) { return -1; }
+
+            size_t matchLength = token & 15;
+            if(matchLength == 15)
+            {
+                uint32_t value = 255;
+                while(value == 255)
+                {
+                    if(ip >= ipEnd) { return -1; }
+                    value = *ip++;
+                    matchLength += value;
+                }
+            }
+            matchLength += m_minMatch;
+
+            if(static_cast<size_t>(opEnd - op) < matchLength) { return -1; }
+            const unsigned char* match = op - offset;
+            if(offset >= matchLength)
+            {
+                std::memcpy(op, match, matchLength);
+                op += matchLength;
+            }
+            else
+            {
+                // Overlapped copy repeats last offset bytes.
+                for(size_t i = 0; i < matchLength; ++i)
+                {
+                    *op++ = *match++;
+                }
+            }
+        }
+
+        return static_cast<int64_t>(op - output);
+    }
+}
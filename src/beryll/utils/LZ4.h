@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CppHeaders.h"
+
+namespace BeryllUtils
+{
+    // LZ4 block format (compatible with reference LZ4 block API, without frame header).
+    // Compression is simple greedy matching. Used offline by pack writer where speed is not critical.
+    // Decompression is fast and checks all bounds. Damaged data returns error instead of reading/writing out of buffers.
+    class LZ4
+    {
+    public:
+        LZ4() = delete;
+        ~LZ4() = delete;
+
+        // Max size of compressed data for srcSize bytes (incompressible data grows a bit).
+        static uint32_t getCompressBound(uint32_t srcSize) { return srcSize + srcSize / 255 + 16; }
+
+        // Returns compressed size or 0 if dst is too small.
+        static uint32_t compress(const char* src, uint32_t srcSize, char* dst, uint32_t dstCapacity);
+        // Returns number of decompressed bytes or -1 if data is damaged or dst is too small.
+        static int64_t decompress(const char* src, uint32_t srcSize, char* dst, uint32_t dstSize);
+
+    private:
+        static constexpr uint32_t m_minMatch = 4;
+        static constexpr uint32_t m_lastLiterals = 5; // Last bytes of block are always literals.
+        static constexpr uint32_t m_matchFindLimit = 12; // Last match must start before it.
+        static constexpr uint32_t m_maxOffset = 65535;
+        static constexpr uint32_t m_hashBits = 12;
+    };
+}
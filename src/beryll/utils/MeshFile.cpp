@@ -0,0 +1,429 @@
+#include "MeshFile.h"
+#include "CommonUtils.h"
+#include "Matrix.h"
+#include "File.h"
+#include "beryll/core/Log.h"
+
+#include <fstream>
+#include <cstring>
+
+namespace BeryllUtils
+{
+    namespace
+    {
+        std::string getFileName(const std::string& path)
+        {
+            const size_t slashPos = path.find_last_of("/\\");
+            return slashPos == std::string::npos ? path : path.substr(slashPos + 1);
+        }
+
+        std::string getExtension(const std::string& path)
+        {
+            const size_t lastDotPos = path.find_last_of('.');
+            BR_ASSERT(lastDotPos != std::string::npos, "File does not have extension: %s", path.c_str());
+            return lastDotPos == std::string::npos ? std::string() : path.substr(lastDotPos + 1);
+        }
+
+        bool copyName(char* dest, const std::string& src, const uint32_t maxLength)
+        {
+            if(src.size() >= maxLength)
+                return false;
+
+            std::memcpy(dest, src.c_str(), src.size() + 1);
+            return true;
+        }
+
+        uint64_t alignOffset(const uint64_t offset, const uint64_t alignment)
+        {
+            return (offset + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    LoadedModel MeshFile::loadModel(const std::string& filePath)
+    {
+        LoadedModel model;
+
+        const std::string fileExtension = getExtension(filePath);
+        if(fileExtension == extension)
+        {
+            const bool opened = model.file.open(filePath);
+            BR_ASSERT(opened, "File reading error: %s", filePath.c_str());
+
+            if(!opened || model.file.getSize() > std::numeric_limits<uint32_t>::max() ||
+               !parseMeshFile(model.file.getData(), static_cast<uint32_t>(model.file.getSize()), filePath, model.meshes))
+            {
+                BR_ASSERT(false, "Mesh file loading error: %s", filePath.c_str());
+                model.meshes.clear();
+            }
+
+            return model;
+        }
+
+        BR_ASSERT((fileExtension == "fbx" || fileExtension == "dae"), "%s", "File extension must be fbx, dae or bmesh.");
+
+        // Cooked file (beryll_cook) with same name is preferred. Same as .ktx2 for .png textures.
+        const std::string cookedPath = filePath.substr(0, filePath.size() - fileExtension.size()) + std::string(extension);
+        if(File::exists(cookedPath.c_str()))
+        {
+            BR_INFO("Load cooked model: %s", cookedPath.c_str());
+            return loadModel(cookedPath);
+        }
+
+        FileView file;
+        const bool opened = file.open(filePath);
+        BR_ASSERT(opened, "File reading error: %s", filePath.c_str());
+
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFileFromMemory(file.getData(), file.getSize(), assimpFlags, fileExtension.c_str());
+        file.close();
+        if(!scene || !scene->mRootNode || scene->mFlags == AI_SCENE_FLAGS_INCOMPLETE)
+        {
+            BR_ASSERT(false, "Scene loading error for file: %s", filePath.c_str());
+            return model;
+        }
+
+        model.meshesData = extractMeshes(scene, filePath);
+        // Views are created after all data is extracted. Vector will not reallocate anymore.
+        model.meshes.reserve(model.meshesData.size());
+        for(const MeshData& data : model.meshesData)
+        {
+            model.meshes.push_back(getView(data));
+        }
+
+        return model;
+    }
+
+    std::vector<MeshData> MeshFile::extractMeshes(const aiScene* scene, const std::string& modelPath)
+    {
+        std::vector<MeshData> meshes;
+        meshes.reserve(scene->mNumMeshes);
+
+        for(int i = 0; i < scene->mNumMeshes; ++i)
+        {
+            meshes.push_back(extractMesh(scene, scene->mMeshes[i], modelPath));
+        }
+
+        return meshes;
+    }
+
+    MeshData MeshFile::extractMesh(const aiScene* scene, const aiMesh* mesh, const std::string& modelPath)
+    {
+        MeshData data;
+        data.name = mesh->mName.C_Str();
+        data.isCollision = data.name.find("Collision") != std::string::npos;
+
+        const aiNode* node = Common::findAinodeForAimesh(scene, scene->mRootNode, mesh->mName);
+        if(node)
+        {
+            data.hasNodeTransforms = true;
+            data.nodeTransforms = Matrix::aiToGlm(node->mTransformation);
+        }
+
+        data.boundsMin = glm::vec3{std::numeric_limits<float>::max()};
+        data.boundsMax = glm::vec3{std::numeric_limits<float>::lowest()};
+        data.vertices.reserve(mesh->mNumVertices);
+        for(int i = 0; i < mesh->mNumVertices; ++i)
+        {
+            data.vertices.emplace_back(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+            data.boundsMin = glm::min(data.boundsMin, data.vertices.back());
+            data.boundsMax = glm::max(data.boundsMax, data.vertices.back());
+        }
+
+        data.indices.reserve(mesh->mNumFaces * 3);
+        for(int i = 0; i < mesh->mNumFaces; ++i) // Every face MUST be a triangle !!!!
+        {
+            data.indices.emplace_back(mesh->mFaces[i].mIndices[0]);
+            data.indices.emplace_back(mesh->mFaces[i].mIndices[1]);
+            data.indices.emplace_back(mesh->mFaces[i].mIndices[2]);
+        }
+
+        if(data.isCollision)
+            return data;
+
+        data.normals.reserve(mesh->mNumVertices);
+        data.tangents.reserve(mesh->mNumVertices);
+        data.textureCoords.reserve(mesh->mNumVertices);
+
+        float UVSmallestX = std::numeric_limits<float>::max();
+        float UVBiggestX = std::numeric_limits<float>::min();
+        float UVSmallestY = std::numeric_limits<float>::max();
+        float UVBiggestY = std::numeric_limits<float>::min();
+
+        for(int i = 0; i < mesh->mNumVertices; ++i)
+        {
+            if(mesh->mNormals)
+                data.normals.emplace_back(glm::normalize(glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z)));
+            else
+                data.normals.emplace_back(0.0f, 0.0f, 0.0f);
+
+            if(mesh->mTangents)
+                data.tangents.emplace_back(glm::normalize(glm::vec3(mesh->mTangents[i].x, mesh->mTangents[i].y, mesh->mTangents[i].z)));
+            else
+                data.tangents.emplace_back(0.0f, 0.0f, 0.0f);
+
+            // Use only first set of texture coordinates.
+            if(mesh->mTextureCoords[0])
+            {
+                data.textureCoords.emplace_back(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+
+                UVSmallestX = std::min(UVSmallestX, mesh->mTextureCoords[0][i].x);
+                UVBiggestX = std::max(UVBiggestX, mesh->mTextureCoords[0][i].x);
+                UVSmallestY = std::min(UVSmallestY, mesh->mTextureCoords[0][i].y);
+                UVBiggestY = std::max(UVBiggestY, mesh->mTextureCoords[0][i].y);
+            }
+            else
+            {
+                data.textureCoords.emplace_back(0.0f, 0.0f);
+            }
+        }
+
+        float UVXRange = glm::distance(UVSmallestX, UVBiggestX);
+        float UVYRange = glm::distance(UVSmallestY, UVBiggestY);
+        if(UVXRange < UVYRange)
+        {
+            data.addToUVCoords = std::abs(UVSmallestY);
+            data.UVCoordsMultiplier = 1.0f / UVYRange;
+        }
+        else
+        {
+            data.addToUVCoords = std::abs(UVSmallestX);
+            data.UVCoordsMultiplier = 1.0f / UVXRange;
+        }
+
+        if(mesh->mMaterialIndex >= 0)
+        {
+            const aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
+            data.diffuseTexturePath = Common::getMaterialTexturePath(material, aiTextureType_DIFFUSE, modelPath);
+            data.specularTexturePath = Common::getMaterialTexturePath(material, aiTextureType_SPECULAR, modelPath);
+            data.normalMapTexturePath = Common::getMaterialTexturePath(material, aiTextureType_NORMALS, modelPath);
+        }
+
+        return data;
+    }
+
+    MeshView MeshFile::getView(const MeshData& data)
+    {
+        MeshView view;
+        view.name = data.name;
+        view.isCollision = data.isCollision;
+        view.hasNodeTransforms = data.hasNodeTransforms;
+        view.nodeTransforms = data.nodeTransforms;
+        view.boundsMin = data.boundsMin;
+        view.boundsMax = data.boundsMax;
+        view.addToUVCoords = data.addToUVCoords;
+        view.UVCoordsMultiplier = data.UVCoordsMultiplier;
+        view.diffuseTexturePath = data.diffuseTexturePath;
+        view.specularTexturePath = data.specularTexturePath;
+        view.normalMapTexturePath = data.normalMapTexturePath;
+
+        view.vertexCount = static_cast<uint32_t>(data.vertices.size());
+        view.indexCount = static_cast<uint32_t>(data.indices.size());
+        view.vertices = data.vertices.data();
+        view.indices = data.indices.data();
+        view.collisionBvh = data.collisionBvh.empty() ? nullptr : data.collisionBvh.data();
+        view.collisionBvhSize = static_cast<uint32_t>(data.collisionBvh.size());
+        if(!data.isCollision)
+        {
+            view.normals = data.normals.data();
+            view.tangents = data.tangents.data();
+            view.textureCoords = data.textureCoords.data();
+        }
+
+        return view;
+    }
+
+    bool MeshFile::writeMeshFile(const std::vector<MeshData>& meshes, const std::string& outPath)
+    {
+        FileHeader header;
+        header.magic = magic;
+        header.version = version;
+        header.meshCount = static_cast<uint32_t>(meshes.size());
+        header.meshRecordSize = sizeof(MeshRecord);
+
+        std::vector<MeshRecord> records(meshes.size());
+        uint64_t offset = sizeof(FileHeader) + sizeof(MeshRecord) * meshes.size();
+
+        // Assign stream offsets.
+        const auto addStream = [&offset](const size_t bytes) -> uint64_t
+        {
+            if(bytes == 0)
+                return 0;
+
+            offset = alignOffset(offset, m_streamAlignment);
+            const uint64_t streamOffset = offset;
+            offset += bytes;
+            return streamOffset;
+        };
+
+        for(int i = 0; i < meshes.size(); ++i)
+        {
+            const MeshData& mesh = meshes[i];
+            MeshRecord& record = records[i];
+
+            if(!copyName(record.name, mesh.name, m_maxNameLength) ||
+               !copyName(record.diffuseTexture, getFileName(mesh.diffuseTexturePath), m_maxNameLength) ||
+               !copyName(record.specularTexture, getFileName(mesh.specularTexturePath), m_maxNameLength) ||
+               !copyName(record.normalMapTexture, getFileName(mesh.normalMapTexturePath), m_maxNameLength))
+            {
+                BR_ERROR("Mesh or texture name is longer than %d: %s", m_maxNameLength - 1, mesh.name.c_str());
+                return false;
+            }
+
+            std::memcpy(record.nodeTransforms, glm::value_ptr(mesh.nodeTransforms), sizeof(record.nodeTransforms));
+            std::memcpy(record.boundsMin, glm::value_ptr(mesh.boundsMin), sizeof(record.boundsMin));
+            std::memcpy(record.boundsMax, glm::value_ptr(mesh.boundsMax), sizeof(record.boundsMax));
+            record.addToUVCoords = mesh.addToUVCoords;
+            record.UVCoordsMultiplier = mesh.UVCoordsMultiplier;
+            if(mesh.isCollision)
+                record.flags |= m_flagIsCollision;
+            if(mesh.hasNodeTransforms)
+                record.flags |= m_flagHasNodeTransforms;
+
+            record.vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+            record.indexCount = static_cast<uint32_t>(mesh.indices.size());
+            record.verticesOffset = addStream(mesh.vertices.size() * sizeof(glm::vec3));
+            record.normalsOffset = addStream(mesh.normals.size() * sizeof(glm::vec3));
+            record.tangentsOffset = addStream(mesh.tangents.size() * sizeof(glm::vec3));
+            record.textureCoordsOffset = addStream(mesh.textureCoords.size() * sizeof(glm::vec2));
+            record.indicesOffset = addStream(mesh.indices.size() * sizeof(uint32_t));
+            record.collisionBvhSize = static_cast<uint32_t>(mesh.collisionBvh.size());
+            record.collisionBvhOffset = addStream(mesh.collisionBvh.size());
+        }
+        header.fileSize = offset;
+
+        std::ofstream file(outPath, std::ios::binary | std::ios::trunc);
+        if(!file)
+        {
+            BR_ERROR("Can not open file for writing: %s", outPath.c_str());
+            return false;
+        }
+
+        uint64_t written = 0;
+        const auto write = [&file, &written](const void* data, const uint64_t bytes, const uint64_t atOffset)
+        {
+            static constexpr char zeros[m_streamAlignment]{};
+            if(atOffset > written)
+                file.write(zeros, static_cast<std::streamsize>(atOffset - written)); // Alignment padding.
+
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            written = atOffset + bytes;
+        };
+
+        write(&header, sizeof(FileHeader), 0);
+        write(records.data(), sizeof(MeshRecord) * records.size(), sizeof(FileHeader));
+        for(int i = 0; i < meshes.size(); ++i)
+        {
+            const MeshData& mesh = meshes[i];
+            const MeshRecord& record = records[i];
+
+            // Same order as offsets were assigned.
+            if(record.verticesOffset)
+                write(mesh.vertices.data(), mesh.vertices.size() * sizeof(glm::vec3), record.verticesOffset);
+            if(record.normalsOffset)
+                write(mesh.normals.data(), mesh.normals.size() * sizeof(glm::vec3), record.normalsOffset);
+            if(record.tangentsOffset)
+                write(mesh.tangents.data(), mesh.tangents.size() * sizeof(glm::vec3), record.tangentsOffset);
+            if(record.textureCoordsOffset)
+                write(mesh.textureCoords.data(), mesh.textureCoords.size() * sizeof(glm::vec2), record.textureCoordsOffset);
+            if(record.indicesOffset)
+                write(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t), record.indicesOffset);
+            if(record.collisionBvhOffset)
+                write(mesh.collisionBvh.data(), mesh.collisionBvh.size(), record.collisionBvhOffset);
+        }
+
+        if(!file)
+        {
+            BR_ERROR("Writing error: %s", outPath.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    bool MeshFile::parseMeshFile(const char* buffer, uint32_t size, const std::string& filePath, std::vector<MeshView>& meshes)
+    {
+        if(size < sizeof(FileHeader))
+            return false;
+
+        FileHeader header;
+        std::memcpy(&header, buffer, sizeof(FileHeader));
+        if(header.magic != magic || header.meshRecordSize != sizeof(MeshRecord) || header.fileSize != size)
+        {
+            BR_ERROR("Not a mesh file or file is damaged: %s", filePath.c_str());
+            return false;
+        }
+        if(header.version != version)
+        {
+            BR_ERROR("Mesh file version: %d, expected: %d. Cook it again: %s", header.version, version, filePath.c_str());
+            return false;
+        }
+        if(sizeof(FileHeader) + uint64_t(sizeof(MeshRecord)) * header.meshCount > size)
+            return false;
+
+        const std::string folder = filePath.find_last_of('/') == std::string::npos ? std::string() :
+                                   filePath.substr(0, filePath.find_last_of('/') + 1);
+        const auto getTexturePath = [&folder](const char* name) -> std::string
+        {
+            return name[0] == '\0' ? std::string() : folder + name;
+        };
+        const auto isStreamValid = [size](const uint64_t offset, const uint64_t bytes) -> bool
+        {
+            return offset % m_streamAlignment == 0 && offset + bytes <= size;
+        };
+
+        meshes.clear();
+        meshes.reserve(header.meshCount);
+        for(uint32_t i = 0; i < header.meshCount; ++i)
+        {
+            MeshRecord record;
+            std::memcpy(&record, buffer + sizeof(FileHeader) + sizeof(MeshRecord) * i, sizeof(MeshRecord));
+
+            MeshView& view = meshes.emplace_back();
+            view.name = record.name;
+            view.isCollision = record.flags & m_flagIsCollision;
+            view.hasNodeTransforms = record.flags & m_flagHasNodeTransforms;
+            view.nodeTransforms = glm::make_mat4(record.nodeTransforms);
+            view.boundsMin = glm::make_vec3(record.boundsMin);
+            view.boundsMax = glm::make_vec3(record.boundsMax);
+            view.addToUVCoords = record.addToUVCoords;
+            view.UVCoordsMultiplier = record.UVCoordsMultiplier;
+            view.diffuseTexturePath = getTexturePath(record.diffuseTexture);
+            view.specularTexturePath = getTexturePath(record.specularTexture);
+            view.normalMapTexturePath = getTexturePath(record.normalMapTexture);
+            view.vertexCount = record.vertexCount;
+            view.indexCount = record.indexCount;
+
+            // Streams are used in place. Buffer must live until data is uploaded to GPU.
+            const uint64_t vec3Bytes = uint64_t(record.vertexCount) * sizeof(glm::vec3);
+            if(!isStreamValid(record.verticesOffset, vec3Bytes) ||
+               !isStreamValid(record.indicesOffset, uint64_t(record.indexCount) * sizeof(uint32_t)))
+                return false;
+
+            view.vertices = reinterpret_cast<const glm::vec3*>(buffer + record.verticesOffset);
+            view.indices = reinterpret_cast<const uint32_t*>(buffer + record.indicesOffset);
+
+            if(record.collisionBvhOffset)
+            {
+                if(!view.isCollision || !isStreamValid(record.collisionBvhOffset, record.collisionBvhSize))
+                    return false;
+
+                view.collisionBvh = buffer + record.collisionBvhOffset;
+                view.collisionBvhSize = record.collisionBvhSize;
+            }
+
+            if(!view.isCollision)
+            {
+                if(!isStreamValid(record.normalsOffset, vec3Bytes) ||
+                   !isStreamValid(record.tangentsOffset, vec3Bytes) ||
+                   !isStreamValid(record.textureCoordsOffset, uint64_t(record.vertexCount) * sizeof(glm::vec2)))
+                    return false;
+
+                view.normals = reinterpret_cast<const glm::vec3*>(buffer + record.normalsOffset);
+                view.tangents = reinterpret_cast<const glm::vec3*>(buffer + record.tangentsOffset);
+                view.textureCoords = reinterpret_cast<const glm::vec2*>(buffer + record.textureCoordsOffset);
+            }
+        }
+
+        return true;
+    }
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "LibsHeaders.h"
+#include "CppHeaders.h"
+
+#include "FileView.h"
+
+namespace BeryllUtils
+{
+    // Mesh extracted from aiMesh. Owns data.
+    struct MeshData
+    {
+        std::string name;
+        bool isCollision = false; // Mesh name contains "Collision". Only vertices + indices are extracted.
+        bool hasNodeTransforms = false;
+        glm::mat4 nodeTransforms{1.0f};
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+        float addToUVCoords = 0.0f;
+        float UVCoordsMultiplier = 1.0f;
+        std::string diffuseTexturePath; // Empty if material does not have texture.
+        std::string specularTexturePath;
+        std::string normalMapTexturePath;
+
+        std::vector<glm::vec3> vertices;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec3> tangents;
+        std::vector<glm::vec2> textureCoords;
+        std::vector<uint32_t> indices;
+        std::vector<char> collisionBvh; // Cooked BVH of concave collision mesh (Physics::serializeConcaveMeshBvh()). Empty if not cooked.
+    };
+
+    // Mesh ready for upload to GPU. Streams point to MeshData or inside loaded mesh file.
+    struct MeshView
+    {
+        std::string name;
+        bool isCollision = false;
+        bool hasNodeTransforms = false;
+        glm::mat4 nodeTransforms{1.0f};
+        glm::vec3 boundsMin{0.0f};
+        glm::vec3 boundsMax{0.0f};
+        float addToUVCoords = 0.0f;
+        float UVCoordsMultiplier = 1.0f;
+        std::string diffuseTexturePath;
+        std::string specularTexturePath;
+        std::string normalMapTexturePath;
+
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        const glm::vec3* vertices = nullptr;
+        const glm::vec3* normals = nullptr; // nullptr for collision mesh.
+        const glm::vec3* tangents = nullptr;
+        const glm::vec2* textureCoords = nullptr;
+        const uint32_t* indices = nullptr;
+        const char* collisionBvh = nullptr;
+        uint32_t collisionBvhSize = 0;
+    };
+
+    // All meshes of one model file and memory which views point to.
+    struct LoadedModel
+    {
+        std::vector<MeshView> meshes;
+
+        const MeshView* findMesh(const std::string& name) const
+        {
+            for(const MeshView& mesh : meshes)
+            {
+                if(mesh.name == name)
+                    return &mesh;
+            }
+            return nullptr;
+        }
+
+        FileView file; // Mesh file. Views point inside it.
+        std::vector<MeshData> meshesData; // Loaded from .fbx/.dae.
+    };
+
+    // Engine mesh file (.bmesh). Created offline from .fbx/.dae with same processing as runtime Assimp loading.
+    // Loaded with one read and no parsing. Vertex streams are handed directly to Renderer.
+    // Layout (little endian):
+    // FileHeader
+    // MeshRecord[meshCount]
+    // Streams of all meshes. Each stream starts at offset aligned to 16 bytes.
+    class MeshFile
+    {
+    public:
+        MeshFile() = delete;
+        ~MeshFile() = delete;
+
+        static constexpr uint32_t magic = 0x534D5242; // "BRMS"
+        static constexpr uint32_t version = 2; // Increase when layout changes. Older files must be cooked again.
+        static constexpr std::string_view extension = "bmesh";
+
+        // Same post processing flags must be used for all Assimp loading of models.
+        static constexpr unsigned int assimpFlags = aiProcess_Triangulate | aiProcess_FlipUVs |
+                                                    aiProcess_JoinIdenticalVertices | aiProcess_CalcTangentSpace;
+
+        // .bmesh loaded directly. For .fbx/.dae .bmesh with same name is loaded if exists.
+        // Otherwise .fbx/.dae imported by Assimp and converted in memory (slow).
+        static LoadedModel loadModel(const std::string& filePath);
+
+        // modelPath is used to find textures (must be in same folder as model).
+        static std::vector<MeshData> extractMeshes(const aiScene* scene, const std::string& modelPath);
+        static MeshData extractMesh(const aiScene* scene, const aiMesh* mesh, const std::string& modelPath);
+        static MeshView getView(const MeshData& data);
+
+        // Texture paths are stored as file names. At load they are resolved to folder of mesh file.
+        // Uses std::ofstream (not SDL) so can be used from offline tools. Returns false on error.
+        static bool writeMeshFile(const std::vector<MeshData>& meshes, const std::string& outPath);
+
+    private:
+        static bool parseMeshFile(const char* buffer, uint32_t size, const std::string& filePath, std::vector<MeshView>& meshes);
+
+        struct FileHeader
+        {
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            uint32_t meshCount = 0;
+            uint32_t meshRecordSize = 0;
+            uint64_t fileSize = 0;
+            uint64_t reserved = 0;
+        };
+
+        static constexpr uint32_t m_maxNameLength = 128; // Including '\0'.
+
+        struct MeshRecord
+        {
+            char name[m_maxNameLength]{};
+            char diffuseTexture[m_maxNameLength]{};
+            char specularTexture[m_maxNameLength]{};
+            char normalMapTexture[m_maxNameLength]{};
+            float nodeTransforms[16]{};
+            float boundsMin[3]{};
+            float boundsMax[3]{};
+            float addToUVCoords = 0.0f;
+            float UVCoordsMultiplier = 1.0f;
+            uint32_t flags = 0;
+            uint32_t vertexCount = 0;
+            uint32_t indexCount = 0;
+            uint32_t collisionBvhSize = 0;
+            // From file start. 0 if stream does not exist.
+            uint64_t verticesOffset = 0;
+            uint64_t normalsOffset = 0;
+            uint64_t tangentsOffset = 0;
+            uint64_t textureCoordsOffset = 0;
+            uint64_t indicesOffset = 0;
+            uint64_t collisionBvhOffset = 0;
+        };
+
+        static constexpr uint32_t m_flagIsCollision = 1;
+        static constexpr uint32_t m_flagHasNodeTransforms = 1 << 1;
+        static constexpr uint64_t m_streamAlignment = 16;
+    };
+}
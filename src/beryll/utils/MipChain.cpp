@@ -0,0 +1,242 @@
+#include "MipChain.h"
+#include "beryll/core/Log.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace BeryllUtils
+{
+    uint32_t MipChain::getLevelCount(uint32_t width, uint32_t height)
+    {
+        uint32_t count = 1;
+        uint32_t size = std::max(width, height);
+        while(size > 1)
+        {
+            size >>= 1;
+            ++count;
+        }
+        return count;
+    }
+
+    std::vector<MipLevel> MipChain::generate(const unsigned char* pixels, uint32_t width, uint32_t height, uint32_t channels, const MipSettings& settings)
+    {
+        BR_ASSERT((pixels != nullptr && width > 0 && height > 0), "%s", "Wrong image for mip chain.");
+        BR_ASSERT((channels == 1 || channels == 3 || channels == 4), "Wrong channels count for mip chain: %d", channels);
+        BR_ASSERT((!settings.isNormalMap || channels >= 3), "%s", "Normal map must have 3 or 4 channels.");
+
+        const uint32_t levelCount = getLevelCount(width, height);
+        std::vector<MipLevel> levels(levelCount);
+
+        levels[0].width = width;
+        levels[0].height = height;
+        levels[0].channels = channels;
+        levels[0].pixels.assign(pixels, pixels + size_t(width) * height * channels);
+
+        const bool hasAlpha = channels == 4;
+        const uint32_t colorChannels = hasAlpha ? 3 : channels;
+        const bool isNormalMap = settings.isNormalMap && channels >= 3;
+
+        // Previous level in linear space. Normals in -1...1 range.
+        std::array<float, 256> toLinear{};
+        for(int i = 0; i < 256; ++i)
+        {
+            const float value = static_cast<float>(i) / 255.0f;
+            if(isNormalMap)
+                toLinear[i] = value * 2.0f - 1.0f;
+            else if(settings.isSRGB)
+                toLinear[i] = SRGBToLinear(value);
+            else
+                toLinear[i] = value;
+        }
+
+        std::vector<float> source(size_t(width) * height * channels);
+        for(size_t i = 0; i < source.size(); ++i)
+        {
+            source[i] = (hasAlpha && i % 4 == 3) ? static_cast<float>(pixels[i]) / 255.0f : toLinear[pixels[i]];
+        }
+
+        const float coverage = hasAlpha && settings.alphaCoverageReference > 0.0f ?
+                               calculateAlphaCoverage(levels[0], settings.alphaCoverageReference) : 0.0f;
+
+        std::vector<float> destination;
+        uint32_t sourceWidth = width;
+        uint32_t sourceHeight = height;
+        for(uint32_t i = 1; i < levelCount; ++i)
+        {
+            MipLevel& level = levels[i];
+            level.width = std::max(sourceWidth >> 1, 1u);
+            level.height = std::max(sourceHeight >> 1, 1u);
+            level.channels = channels;
+            level.pixels.resize(size_t(level.width) * level.height * channels);
+            destination.resize(size_t(level.width) * level.height * channels);
+
+            for(uint32_t y = 0; y < level.height; ++y)
+            {
+                // Side with size 1 stays 1. Other sides take 2 pixels.
+                const uint32_t y0 = std::min(y * 2, sourceHeight - 1);
+                const uint32_t y1 = std::min(y * 2 + 1, sourceHeight - 1);
+                for(uint32_t x = 0; x < level.width; ++x)
+                {
+                    const uint32_t x0 = std::min(x * 2, sourceWidth - 1);
+                    const uint32_t x1 = std::min(x * 2 + 1, sourceWidth - 1);
+                    const float* samples[4] = {&source[(size_t(y0) * sourceWidth + x0) * channels], &source[(size_t(y0) * sourceWidth + x1) * channels],
+                                               &source[(size_t(y1) * sourceWidth + x0) * channels], &source[(size_t(y1) * sourceWidth + x1) * channels]};
+
+                    float color[3] = {0.0f, 0.0f, 0.0f};
+                    float alphaSum = 0.0f;
+                    float weightSum = 0.0f;
+                    for(const float* sample : samples)
+                    {
+                        // Normals are not weighted by alpha. Alpha of normal map is not coverage.
+                        const float weight = (hasAlpha && !isNormalMap) ? sample[3] : 1.0f;
+                        for(uint32_t c = 0; c < colorChannels; ++c)
+                        {
+                            color[c] += sample[c] * weight;
+                        }
+                        if(hasAlpha)
+                            alphaSum += sample[3];
+                        weightSum += weight;
+                    }
+
+                    float* result = &destination[(size_t(y) * level.width + x) * channels];
+                    for(uint32_t c = 0; c < colorChannels; ++c)
+                    {
+                        // Fully transparent. Keep color without weights.
+                        result[c] = weightSum > 0.0f ? color[c] / weightSum
+                                                     : (samples[0][c] + samples[1][c] + samples[2][c] + samples[3][c]) * 0.25f;
+                    }
+                    if(hasAlpha)
+                        result[3] = alphaSum * 0.25f;
+
+                    if(isNormalMap)
+                    {
+                        const float length = std::sqrt(result[0] * result[0] + result[1] * result[1] + result[2] * result[2]);
+                        if(length > 0.00001f)
+                        {
+                            result[0] /= length;
+                            result[1] /= length;
+                            result[2] /= length;
+                        }
+                    }
+                }
+            }
+
+            for(size_t p = 0; p < destination.size(); ++p)
+            {
+                float value = destination[p];
+                if(!hasAlpha || p % 4 != 3)
+                {
+                    if(isNormalMap)
+                        value = value * 0.5f + 0.5f;
+                    else if(settings.isSRGB)
+                        value = linearToSRGB(value);
+                }
+                level.pixels[p] = static_cast<unsigned char>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+            }
+
+            // Next level is filtered from not scaled alpha. Scale errors do not accumulate.
+            if(coverage > 0.0f)
+                scaleAlphaToCoverage(level, settings.alphaCoverageReference, coverage);
+
+            source.swap(destination);
+            sourceWidth = level.width;
+            sourceHeight = level.height;
+        }
+
+        return levels;
+    }
+
+    float MipChain::calculateAlphaCoverage(const MipLevel& level, float reference, float scale)
+    {
+        const size_t pixelCount = size_t(level.width) * level.height;
+        if(pixelCount == 0 || level.channels != 4)
+            return 0.0f;
+
+        size_t covered = 0;
+        for(size_t i = 0; i < pixelCount; ++i)
+        {
+            if(static_cast<float>(level.pixels[i * 4 + 3]) / 255.0f * scale > reference)
+                ++covered;
+        }
+
+        return static_cast<float>(covered) / static_cast<float>(pixelCount);
+    }
+
+    uint32_t MipChain::getChannelsToKeep(const unsigned char* rgba, size_t pixelCount, bool isOneBytePerPixel, bool isNormalMap)
+    {
+        bool hasAlpha = false;
+        bool isGray = isOneBytePerPixel && !isNormalMap;
+        for(size_t i = 0; i < pixelCount; ++i)
+        {
+            const unsigned char* pixel = rgba + i * 4;
+            hasAlpha = hasAlpha || pixel[3] != 255;
+            isGray = isGray && pixel[0] == pixel[1] && pixel[0] == pixel[2];
+        }
+
+        if(hasAlpha)
+            return 4;
+
+        return isGray ? 1 : 3;
+    }
+
+    std::vector<unsigned char> MipChain::packChannels(const unsigned char* rgba, size_t pixelCount, uint32_t channels)
+    {
+        std::vector<unsigned char> packed(pixelCount * channels);
+        for(size_t i = 0; i < pixelCount; ++i)
+        {
+            std::memcpy(&packed[i * channels], rgba + i * 4, channels);
+        }
+
+        return packed;
+    }
+
+    void MipChain::scaleAlphaToCoverage(MipLevel& level, float reference, float coverage)
+    {
+        if(level.channels != 4)
+            return;
+
+        // Coverage grows with scale. Binary search of scale which gives coverage of level 0.
+        // Small levels can not match exactly. Closest is used.
+        float minScale = 0.0f;
+        float maxScale = 4.0f;
+        float scale = 1.0f;
+        float bestScale = 1.0f;
+        float bestError = std::numeric_limits<float>::max();
+        for(int i = 0; i < 12; ++i)
+        {
+            const float currentCoverage = calculateAlphaCoverage(level, reference, scale);
+            const float error = std::abs(currentCoverage - coverage);
+            if(error < bestError)
+            {
+                bestError = error;
+                bestScale = scale;
+            }
+
+            if(currentCoverage < coverage)
+                minScale = scale;
+            else if(currentCoverage > coverage)
+                maxScale = scale;
+            else
+                break;
+
+            scale = (minScale + maxScale) * 0.5f;
+        }
+        scale = bestScale;
+
+        for(size_t i = 3; i < level.pixels.size(); i += 4)
+        {
+            level.pixels[i] = static_cast<unsigned char>(std::min(static_cast<float>(level.pixels[i]) * scale + 0.5f, 255.0f));
+        }
+    }
+
+    float MipChain::SRGBToLinear(float value)
+    {
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float MipChain::linearToSRGB(float value)
+    {
+        value = std::clamp(value, 0.0f, 1.0f);
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+}
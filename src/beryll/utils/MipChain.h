@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CppHeaders.h"
+
+namespace BeryllUtils
+{
+    // One level of 8 bit image. Rows from top, without padding.
+    struct MipLevel
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t channels = 4; // 1 (R), 3 (RGB) or 4 (RGBA).
+        std::vector<unsigned char> pixels;
+    };
+
+    struct MipSettings
+    {
+        bool isSRGB = true; // Colors are averaged in linear space. Should be true for color (diffuse) textures.
+        bool isNormalMap = false; // Normals are averaged and normalized. isSRGB is ignored. Needs 3 or 4 channels.
+        // Alpha tested textures become transparent in small levels when alpha is averaged. Only for 4 channels.
+        // If > 0 alpha of every level is scaled to keep same part of pixels with alpha > reference as in level 0.
+        float alphaCoverageReference = 0.0f;
+    };
+
+    // Generates full mip chain (down to 1x1) on CPU. Does not use graphics API so can be used
+    // on any thread at load time or offline in beryll_cook.
+    // Every level is 2x2 box filter of previous level. Colors are weighted by alpha so transparent pixels do not darken edges.
+    // Levels keep channel layout of source image.
+    class MipChain
+    {
+    public:
+        MipChain() = delete;
+        ~MipChain() = delete;
+
+        static uint32_t getLevelCount(uint32_t width, uint32_t height);
+
+        // Level 0 is copy of pixels.
+        static std::vector<MipLevel> generate(const unsigned char* pixels, uint32_t width, uint32_t height, uint32_t channels, const MipSettings& settings);
+
+        // Part of pixels (0...1) which pass alpha test with alpha multiplied by scale. Level must have 4 channels.
+        static float calculateAlphaCoverage(const MipLevel& level, float reference, float scale = 1.0f);
+
+        // Smallest channel layout of image decoded to RGBA8 without loss. Same on device and in beryll_cook.
+        // 4 if any alpha < 255. 1 if source had one byte per pixel (gray or palette) and all pixels are gray. Otherwise 3.
+        static uint32_t getChannelsToKeep(const unsigned char* rgba, size_t pixelCount, bool isOneBytePerPixel, bool isNormalMap);
+        // First channels of every RGBA8 pixel.
+        static std::vector<unsigned char> packChannels(const unsigned char* rgba, size_t pixelCount, uint32_t channels);
+
+    private:
+        static void scaleAlphaToCoverage(MipLevel& level, float reference, float coverage);
+
+        static float SRGBToLinear(float value);
+        static float linearToSRGB(float value);
+    };
+}
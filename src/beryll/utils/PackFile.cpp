@@ -0,0 +1,332 @@
+#include "PackFile.h"
+#include "LZ4.h"
+#include "beryll/core/Log.h"
+#include "beryll/async/AsyncRun.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace BeryllUtils
+{
+    std::vector<PackFile::MountedPack> PackFile::m_packs;
+    std::thread::id PackFile::m_mainThreadID;
+
+    namespace
+    {
+        struct BlockJob
+        {
+            const char* src = nullptr;
+            uint32_t srcSize = 0;
+            bool isStored = false;
+            char* dst = nullptr;
+            uint32_t dstSize = 0;
+            bool decompressed = false;
+        };
+
+        void decompressBlock(BlockJob& job)
+        {
+            if(job.isStored)
+            {
+                job.decompressed = job.srcSize == job.dstSize;
+                if(job.decompressed)
+                    std::memcpy(job.dst, job.src, job.dstSize);
+            }
+            else
+            {
+                job.decompressed = LZ4::decompress(job.src, job.srcSize, job.dst, job.dstSize) == job.dstSize;
+            }
+        }
+
+        bool writePadding(std::ofstream& file, uint64_t alignment)
+        {
+            static const char zeros[PackFile::dataAlignment]{};
+            const uint64_t position = static_cast<uint64_t>(file.tellp());
+            const uint64_t padding = (alignment - position % alignment) % alignment;
+            return static_cast<bool>(file.write(zeros, static_cast<std::streamsize>(padding)));
+        }
+    }
+
+    bool PackFile::mount(const std::string& packPath)
+    {
+        m_mainThreadID = std::this_thread::get_id();
+
+        MountedPack pack;
+        pack.path = packPath;
+        if(!pack.file.open(packPath))
+        {
+            BR_ERROR("Pack file reading error: %s", packPath.c_str());
+            return false;
+        }
+
+        const char* data = pack.file.getData();
+        const uint64_t size = pack.file.getSize();
+
+        Header header;
+        if(size < sizeof(Header))
+            return false;
+        std::memcpy(&header, data, sizeof(Header));
+
+        if(header.magic != magic || header.version != version || header.blockSize != blockSize)
+        {
+            BR_ERROR("Not supported pack file version: %s", packPath.c_str());
+            return false;
+        }
+
+        // Checked once here. Entries are trusted later.
+        if(header.entriesOffset % alignof(Entry) != 0 || header.entriesOffset > size ||
+           uint64_t(header.entryCount) * sizeof(Entry) > size - header.entriesOffset || header.namesOffset > size)
+        {
+            BR_ERROR("Damaged pack file: %s", packPath.c_str());
+            return false;
+        }
+
+        pack.entries = reinterpret_cast<const Entry*>(data + header.entriesOffset);
+        pack.entryCount = header.entryCount;
+        pack.names = data + header.namesOffset;
+        pack.namesSize = size - header.namesOffset;
+
+        for(uint32_t i = 0; i < pack.entryCount; ++i)
+        {
+            const Entry& entry = pack.entries[i];
+            const uint64_t expectedBlocks = (entry.size + blockSize - 1) / blockSize;
+            if(entry.offset > size || entry.storedSize > size - entry.offset ||
+               uint64_t(entry.nameOffset) + entry.nameLength > pack.namesSize ||
+               (entry.blockCount == 0 && entry.storedSize != entry.size) ||
+               (entry.blockCount != 0 && (entry.blockCount != expectedBlocks || uint64_t(entry.blockCount) * sizeof(uint32_t) > entry.storedSize)))
+            {
+                BR_ERROR("Damaged pack file: %s", packPath.c_str());
+                return false;
+            }
+        }
+
+        BR_INFO("Pack mounted: %s, files: %d, mapped: %d", packPath.c_str(), pack.entryCount, static_cast<int>(pack.file.getIsMapped()));
+        m_packs.push_back(std::move(pack));
+        return true;
+    }
+
+    void PackFile::unmountAll()
+    {
+        m_packs.clear();
+    }
+
+    bool PackFile::contains(const std::string& filePath)
+    {
+        for(const MountedPack& pack : m_packs)
+        {
+            if(findEntry(pack, filePath))
+                return true;
+        }
+        return false;
+    }
+
+    bool PackFile::open(const std::string& filePath, FileView& view)
+    {
+        for(auto it = m_packs.rbegin(); it != m_packs.rend(); ++it)
+        {
+            const Entry* entry = findEntry(*it, filePath);
+            if(!entry)
+                continue;
+
+            view.close();
+            if(entry->blockCount == 0)
+            {
+                // Points into mapped pack. No copy.
+                view.m_data = it->file.getData() + entry->offset;
+                view.m_size = entry->size;
+                return true;
+            }
+
+            std::unique_ptr<char[]> buffer(new char[std::max<uint64_t>(entry->size, 1)]);
+            if(!decompressEntry(*it, *entry, buffer.get()))
+            {
+                BR_ERROR("Damaged file %s in pack %s", filePath.c_str(), it->path.c_str());
+                return false;
+            }
+
+            view.m_buffer = std::move(buffer);
+            view.m_data = view.m_buffer.get();
+            view.m_size = entry->size;
+            return true;
+        }
+
+        return false;
+    }
+
+    uint64_t PackFile::hashPath(const std::string& path)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for(const char c : path)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    const PackFile::Entry* PackFile::findEntry(const MountedPack& pack, const std::string& filePath)
+    {
+        const uint64_t hash = hashPath(filePath);
+        const Entry* end = pack.entries + pack.entryCount;
+        const Entry* entry = std::lower_bound(pack.entries, end, hash, [](const Entry& e, uint64_t h) { return e.pathHash < h; });
+
+        // Same hash of different paths is possible. Compare names.
+        for(; entry != end && entry->pathHash == hash; ++entry)
+        {
+            if(entry->nameLength == filePath.size() && std::memcmp(pack.names + entry->nameOffset, filePath.data(), filePath.size()) == 0)
+                return entry;
+        }
+        return nullptr;
+    }
+
+    bool PackFile::decompressEntry(const MountedPack& pack, const Entry& entry, char* dst)
+    {
+        const char* const entryData = pack.file.getData() + entry.offset;
+        const char* src = entryData + entry.blockCount * sizeof(uint32_t);
+        const char* const srcEnd = entryData + entry.storedSize;
+
+        std::vector<BlockJob> jobs(entry.blockCount);
+        for(uint32_t i = 0; i < entry.blockCount; ++i)
+        {
+            uint32_t storedBlockSize = 0;
+            std::memcpy(&storedBlockSize, entryData + i * sizeof(uint32_t), sizeof(uint32_t));
+
+            BlockJob& job = jobs[i];
+            job.isStored = (storedBlockSize & storedBlockFlag) != 0;
+            job.srcSize = storedBlockSize & ~storedBlockFlag;
+            job.src = src;
+            job.dst = dst + uint64_t(i) * blockSize;
+            job.dstSize = static_cast<uint32_t>(std::min<uint64_t>(blockSize, entry.size - uint64_t(i) * blockSize));
+
+            if(job.srcSize > static_cast<uint64_t>(srcEnd - src))
+                return false;
+            src += job.srcSize;
+        }
+
+        // Loading threads (texture preload) already run in parallel with each other and must not start AsyncRun inside AsyncRun.
+        if(jobs.size() > 1 && Beryll::AsyncRun::m_numThreads > 1 && std::this_thread::get_id() == m_mainThreadID)
+        {
+            Beryll::AsyncRun::Run(jobs, std::function<void(std::vector<BlockJob>&, int, int)>(
+                [](std::vector<BlockJob>& v, int begin, int end) -> void // -> void = return type.
+                {
+                    for(int i = begin; i < end; ++i)
+                    {
+                        decompressBlock(v[i]);
+                    }
+                }));
+        }
+        else
+        {
+            for(BlockJob& job : jobs)
+            {
+                decompressBlock(job);
+            }
+        }
+
+        return std::all_of(jobs.begin(), jobs.end(), [](const BlockJob& job) { return job.decompressed; });
+    }
+
+    bool PackFile::writePack(const std::vector<std::pair<std::string, std::string>>& files, const std::string& outPath, float minCompressionRatio)
+    {
+        std::ofstream file(outPath, std::ios::binary | std::ios::trunc);
+        if(!file)
+            return false;
+
+        Header header;
+        header.magic = magic;
+        header.version = version;
+        header.blockSize = blockSize;
+        header.entryCount = static_cast<uint32_t>(files.size());
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header)); // Rewritten at end with offsets.
+
+        std::vector<Entry> entries;
+        entries.reserve(files.size());
+        std::string names;
+
+        std::vector<char> data;
+        std::vector<char> compressed;
+        std::vector<uint32_t> blockSizes;
+        std::vector<char> blockBuffer(LZ4::getCompressBound(blockSize));
+        for(const std::pair<std::string, std::string>& input : files)
+        {
+            std::ifstream inputFile(input.second, std::ios::binary | std::ios::ate);
+            if(!inputFile)
+                return false;
+            data.resize(static_cast<size_t>(inputFile.tellg()));
+            inputFile.seekg(0);
+            if(!data.empty() && !inputFile.read(data.data(), static_cast<std::streamsize>(data.size())))
+                return false;
+
+            Entry entry;
+            entry.pathHash = hashPath(input.first);
+            entry.size = data.size();
+            entry.nameOffset = static_cast<uint32_t>(names.size());
+            entry.nameLength = static_cast<uint32_t>(input.first.size());
+            names += input.first;
+
+            // Blocks which LZ4 can not make smaller are stored as is.
+            const uint32_t blockCount = static_cast<uint32_t>((data.size() + blockSize - 1) / blockSize);
+            blockSizes.assign(blockCount, 0);
+            compressed.clear();
+            for(uint32_t i = 0; i < blockCount; ++i)
+            {
+                const char* block = data.data() + uint64_t(i) * blockSize;
+                const uint32_t size = static_cast<uint32_t>(std::min<uint64_t>(blockSize, data.size() - uint64_t(i) * blockSize));
+                const uint32_t compressedSize = LZ4::compress(block, size, blockBuffer.data(), static_cast<uint32_t>(blockBuffer.size()));
+                if(compressedSize == 0 || compressedSize >= size)
+                {
+                    blockSizes[i] = size | storedBlockFlag;
+                    compressed.insert(compressed.end(), block, block + size);
+                }
+                else
+                {
+                    blockSizes[i] = compressedSize;
+                    compressed.insert(compressed.end(), blockBuffer.data(), blockBuffer.data() + compressedSize);
+                }
+            }
+
+            const uint64_t compressedEntrySize = blockCount * sizeof(uint32_t) + compressed.size();
+            const bool compress = !data.empty() && compressedEntrySize < static_cast<uint64_t>(static_cast<double>(data.size()) * minCompressionRatio);
+
+            if(!writePadding(file, dataAlignment))
+                return false;
+            entry.offset = static_cast<uint64_t>(file.tellp());
+            if(compress)
+            {
+                entry.blockCount = blockCount;
+                entry.storedSize = compressedEntrySize;
+                file.write(reinterpret_cast<const char*>(blockSizes.data()), static_cast<std::streamsize>(blockSizes.size() * sizeof(uint32_t)));
+                file.write(compressed.data(), static_cast<std::streamsize>(compressed.size()));
+            }
+            else
+            {
+                entry.storedSize = data.size();
+                file.write(data.data(), static_cast<std::streamsize>(data.size()));
+            }
+
+            entries.push_back(entry);
+        }
+
+        // Same path two times can not be found in pack.
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.pathHash < b.pathHash; });
+        for(size_t i = 1; i < entries.size(); ++i)
+        {
+            const Entry& a = entries[i - 1];
+            const Entry& b = entries[i];
+            if(a.pathHash == b.pathHash && a.nameLength == b.nameLength &&
+               names.compare(a.nameOffset, a.nameLength, names, b.nameOffset, b.nameLength) == 0)
+                return false;
+        }
+
+        if(!writePadding(file, dataAlignment))
+            return false;
+        header.entriesOffset = static_cast<uint64_t>(file.tellp());
+        file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+        header.namesOffset = static_cast<uint64_t>(file.tellp());
+        file.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+        return static_cast<bool>(file);
+    }
+}
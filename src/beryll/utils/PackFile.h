@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CppHeaders.h"
+#include "FileView.h"
+
+namespace BeryllUtils
+{
+    // Many assets in one file (.bpak). Pack is memory mapped once, files are found by hash of path without opening
+    // separate files (on Android without separate APK lookup for every asset).
+    // FileView::open() and File utils look into mounted packs first, then into file system/APK.
+    // Layout (little endian):
+    // Header
+    // Data of entries. Each entry starts at offset aligned to dataAlignment.
+    //   Stored entry: file bytes. View points directly into mapped pack.
+    //   Compressed entry: uint32_t compressed size of every block, then blocks. Every block = blockSize bytes of file
+    //                     (last can be smaller) compressed by LZ4. Blocks can be decompressed in parallel.
+    // Entry[entryCount] sorted by pathHash.
+    // Names of entries (not null terminated).
+    // Pack should be stored not compressed in APK (build.gradle: androidResources { noCompress 'bpak' }).
+    // Otherwise it can not be mapped and is read to memory.
+    class PackFile
+    {
+    public:
+        PackFile() = delete;
+        ~PackFile() = delete;
+
+        static constexpr uint32_t magic = 0x4B415042; // "BPAK"
+        static constexpr uint32_t version = 1;
+        static constexpr std::string_view extension = "bpak";
+        static constexpr uint32_t blockSize = 64 * 1024;
+        static constexpr uint32_t dataAlignment = 16; // Same as streams in .bmesh files.
+        static constexpr uint32_t storedBlockFlag = 0x80000000; // In block size. Block is not compressed (compression did not help).
+
+        // Call on main thread before loading assets. Packs mounted later are searched first.
+        static bool mount(const std::string& packPath);
+        // Views opened from packs must be closed before.
+        static void unmountAll();
+
+        static bool contains(const std::string& filePath);
+        // False if file is not in mounted packs. Can be called from any thread.
+        // Blocks of big compressed files are decompressed in parallel if called from main thread.
+        static bool open(const std::string& filePath, FileView& view);
+
+        // FNV-1a 64 of path with '/' separators.
+        static uint64_t hashPath(const std::string& path);
+
+        // files - pairs of path inside pack and path of file on disk.
+        // Entry is compressed if it becomes smaller than minCompressionRatio of original size.
+        // Uses std::ifstream/std::ofstream (not SDL) so can be used from offline tools. Returns false on error.
+        static bool writePack(const std::vector<std::pair<std::string, std::string>>& files, const std::string& outPath,
+                              float minCompressionRatio = 0.9f);
+
+    private:
+        struct Header
+        {
+            uint32_t magic = 0;
+            uint32_t version = 0;
+            uint32_t entryCount = 0;
+            uint32_t blockSize = 0;
+            uint64_t entriesOffset = 0;
+            uint64_t namesOffset = 0;
+        };
+
+        struct Entry
+        {
+            uint64_t pathHash = 0;
+            uint64_t offset = 0;
+            uint64_t size = 0; // Of file.
+            uint64_t storedSize = 0; // In pack. Including block sizes.
+            uint32_t nameOffset = 0; // From namesOffset.
+            uint32_t nameLength = 0;
+            uint32_t blockCount = 0; // 0 if entry is stored not compressed.
+            uint32_t padding = 0;
+        };
+
+        static_assert(sizeof(Header) == 32, "Header layout changed.");
+        static_assert(sizeof(Entry) == 48, "Entry layout changed.");
+
+        struct MountedPack
+        {
+            std::string path;
+            FileView file;
+            const Entry* entries = nullptr;
+            uint32_t entryCount = 0;
+            const char* names = nullptr;
+            uint64_t namesSize = 0;
+        };
+
+        static const Entry* findEntry(const MountedPack& pack, const std::string& filePath);
+        static bool decompressEntry(const MountedPack& pack, const Entry& entry, char* dst);
+
+        static std::vector<MountedPack> m_packs;
+        static std::thread::id m_mainThreadID;
+    };
+}
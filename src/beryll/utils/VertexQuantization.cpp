@@ -0,0 +1,146 @@
+#include "VertexQuantization.h"
+#include "beryll/core/Log.h"
+
+#include "glm/gtc/packing.hpp"
+
+namespace BeryllUtils
+{
+    namespace
+    {
+        constexpr float snorm16Max = 32767.0f;
+
+        // Same as GL conversion of normalized signed attribute.
+        float snorm16ToFloat(int16_t value)
+        {
+            return std::max(static_cast<float>(value) / snorm16Max, -1.0f);
+        }
+
+        glm::vec2 signNotZero(const glm::vec2& v)
+        {
+            return glm::vec2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+        }
+    }
+
+    uint16_t VertexQuantization::floatToHalf(float value)
+    {
+        return glm::packHalf1x16(value);
+    }
+
+    float VertexQuantization::halfToFloat(uint16_t value)
+    {
+        return glm::unpackHalf1x16(value);
+    }
+
+    glm::i16vec2 VertexQuantization::encodeOctahedral(const glm::vec3& direction)
+    {
+        // Project to octahedron, fold lower half over diagonals.
+        glm::vec2 encoded = glm::vec2(direction) / (std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z));
+        if(direction.z < 0.0f)
+            encoded = (1.0f - glm::abs(glm::vec2(encoded.y, encoded.x))) * signNotZero(encoded);
+
+        // Rounding to nearest is not always most precise. Check all 4 neighbours.
+        const glm::vec2 scaled = glm::clamp(encoded, -1.0f, 1.0f) * snorm16Max;
+        const glm::vec2 low = glm::floor(scaled);
+        glm::i16vec2 best{0};
+        float bestDot = -2.0f;
+        for(int i = 0; i < 4; ++i)
+        {
+            const glm::i16vec2 candidate(static_cast<int16_t>(std::min(low.x + float(i & 1), snorm16Max)),
+                                         static_cast<int16_t>(std::min(low.y + float(i >> 1), snorm16Max)));
+            const float dot = glm::dot(decodeOctahedral(candidate), direction);
+            if(dot > bestDot)
+            {
+                bestDot = dot;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    glm::vec3 VertexQuantization::decodeOctahedral(const glm::i16vec2& encoded)
+    {
+        const glm::vec2 e(snorm16ToFloat(encoded.x), snorm16ToFloat(encoded.y));
+        glm::vec3 direction(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+        if(direction.z < 0.0f)
+        {
+            const glm::vec2 folded = (1.0f - glm::abs(glm::vec2(direction.y, direction.x))) * signNotZero(glm::vec2(direction));
+            direction.x = folded.x;
+            direction.y = folded.y;
+        }
+        return glm::normalize(direction);
+    }
+
+    std::vector<glm::u16vec4> VertexQuantization::encodePositions(const glm::vec3* positions, uint32_t count, VertexFormat format,
+                                                                  glm::vec3& scale, glm::vec3& bias)
+    {
+        BR_ASSERT((format != VertexFormat::FLOAT), "%s", "Positions in FLOAT format are not encoded.");
+
+        glm::vec3 boundsMin{std::numeric_limits<float>::max()};
+        glm::vec3 boundsMax{std::numeric_limits<float>::lowest()};
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            boundsMin = glm::min(boundsMin, positions[i]);
+            boundsMax = glm::max(boundsMax, positions[i]);
+        }
+        if(count == 0)
+            boundsMin = boundsMax = glm::vec3(0.0f);
+
+        bias = (boundsMin + boundsMax) * 0.5f;
+        scale = glm::max((boundsMax - boundsMin) * 0.5f, glm::vec3(std::numeric_limits<float>::min())); // Flat mesh.
+
+        std::vector<glm::u16vec4> encoded(count);
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            const glm::vec3 normalized = glm::clamp((positions[i] - bias) / scale, -1.0f, 1.0f);
+            for(int k = 0; k < 3; ++k)
+            {
+                encoded[i][k] = format == VertexFormat::COMPACT_HALF ? floatToHalf(normalized[k]) : glm::packSnorm1x16(normalized[k]);
+            }
+            encoded[i].w = format == VertexFormat::COMPACT_HALF ? floatToHalf(1.0f) : glm::packSnorm1x16(1.0f); // Same as vec4(position, 1.0).
+        }
+        return encoded;
+    }
+
+    glm::vec3 VertexQuantization::decodePosition(const glm::u16vec4& encoded, VertexFormat format, const glm::vec3& scale, const glm::vec3& bias)
+    {
+        glm::vec3 normalized;
+        for(int k = 0; k < 3; ++k)
+        {
+            normalized[k] = format == VertexFormat::COMPACT_HALF ? halfToFloat(encoded[k]) : snorm16ToFloat(static_cast<int16_t>(encoded[k]));
+        }
+        return normalized * scale + bias;
+    }
+
+    std::vector<glm::i16vec2> VertexQuantization::encodeDirections(const glm::vec3* directions, uint32_t count)
+    {
+        std::vector<glm::i16vec2> encoded(count);
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            // Zero vectors (broken tangents) are encoded as any direction.
+            const float length = glm::length(directions[i]);
+            encoded[i] = encodeOctahedral(length > 0.0f ? directions[i] / length : glm::vec3(0.0f, 0.0f, 1.0f));
+        }
+        return encoded;
+    }
+
+    std::vector<glm::u16vec2> VertexQuantization::encodeTextureCoords(const glm::vec2* textureCoords, uint32_t count)
+    {
+        std::vector<glm::u16vec2> encoded(count);
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            encoded[i] = glm::u16vec2(floatToHalf(textureCoords[i].x), floatToHalf(textureCoords[i].y));
+        }
+        return encoded;
+    }
+
+    std::vector<uint16_t> VertexQuantization::encodeIndices16(const uint32_t* indices, uint32_t count)
+    {
+        std::vector<uint16_t> encoded(count);
+        for(uint32_t i = 0; i < count; ++i)
+        {
+            BR_ASSERT((indices[i] <= std::numeric_limits<uint16_t>::max()), "Index %d does not fit to 16 bit.", indices[i]);
+            encoded[i] = static_cast<uint16_t>(indices[i]);
+        }
+        return encoded;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "LibsHeaders.h"
+#include "CppHeaders.h"
+
+#include "glm/gtc/type_precision.hpp"
+
+namespace BeryllUtils
+{
+    // Format of vertex buffers created from MeshView. Bytes per vertex are given with tangents.
+    enum class VertexFormat
+    {
+        FLOAT, // vec3 positions, normals, tangents. vec2 UVs. 44 bytes.
+        // Positions: 4 x snorm16 (w = 1) decoded as xyz * positionScale + positionBias.
+        // Normals, tangents: octahedral 2 x snorm16. UVs: 2 x half float. 20 bytes.
+        COMPACT_SNORM16,
+        COMPACT_HALF // Same as COMPACT_SNORM16 but positions are 4 x half float. Less precise for big meshes.
+    };
+
+    // Encoding of vertex streams to compact formats on CPU. GPU decodes same way (see docs/requirements/Shaders.txt).
+    // Decode functions are CPU reference of shader code.
+    class VertexQuantization
+    {
+    public:
+        VertexQuantization() = delete;
+        ~VertexQuantization() = delete;
+
+        static uint16_t floatToHalf(float value);
+        static float halfToFloat(uint16_t value);
+
+        // direction must be normalized. Encoded value with smallest angle error is selected.
+        static glm::i16vec2 encodeOctahedral(const glm::vec3& direction);
+        static glm::vec3 decodeOctahedral(const glm::i16vec2& encoded);
+
+        // Positions are mapped to -1...1 inside bounds: stored = (position - bias) / scale.
+        // scale and bias are calculated from positions and returned for shader.
+        static std::vector<glm::u16vec4> encodePositions(const glm::vec3* positions, uint32_t count, VertexFormat format,
+                                                         glm::vec3& scale, glm::vec3& bias);
+        static glm::vec3 decodePosition(const glm::u16vec4& encoded, VertexFormat format, const glm::vec3& scale, const glm::vec3& bias);
+
+        static std::vector<glm::i16vec2> encodeDirections(const glm::vec3* directions, uint32_t count);
+        static std::vector<glm::u16vec2> encodeTextureCoords(const glm::vec2* textureCoords, uint32_t count);
+
+        // Index buffer can be 16 bit if all indices < 65536.
+        static bool getCanUseIndices16(uint32_t vertexCount) { return vertexCount <= std::numeric_limits<uint16_t>::max() + 1u; }
+        static std::vector<uint16_t> encodeIndices16(const uint32_t* indices, uint32_t count);
+    };
+}
@@ -0,0 +1,627 @@
+// Offline asset cooker.
+// Walks assets folder and writes runtime ready assets to output folder with same folder structure:
+// .fbx/.dae static models  -> .bmesh (graphics + collision meshes, see BeryllUtils::MeshFile)
+//                              Concave collision meshes get BVH serialized by Physics. Runtime does not build it.
+// .fbx/.dae animated models -> copied (skinned meshes are still loaded by Assimp at runtime)
+// .png/.jpg textures       -> with --texture-mips: .ktx2 with full mip chain (see BeryllUtils::MipChain), otherwise copied.
+//                              Same result as runtime mip generation in AndroidGLESTexture: mip settings from material slot
+//                              which uses texture in models (diffuse, specular, normal map), source channels kept (R8, RGB8, RGBA8).
+//                              Textures not used by models (UI, material 2 and blend textures set by game code) or used
+//                              in different slots are copied. Runtime generates their mips with type given by game code.
+// other files (sounds, shaders, ...) -> copied
+// Incremental: content hash of every source file is stored in manifest inside output folder.
+// Asset is cooked again only if hash, cooker version or mesh file version changed or output is missing.
+// Assets are cooked in parallel. Time of every cooked asset is printed.
+// With --pack all files of output folder are written to one pack (see BeryllUtils::PackFile) with LZ4 compressed entries.
+//
+// Usage: beryll_cook <assetsDir> <outDir> [-j threadsCount] [--force] [--texture-mips] [--pack packPath.bpak]
+
+#include "beryll/utils/MeshFile.h"
+#include "beryll/utils/CommonUtils.h"
+#include "beryll/utils/KTXFile.h"
+#include "beryll/utils/MipChain.h"
+#include "beryll/utils/PackFile.h"
+#include "beryll/physics/Physics.h"
+
+#include <filesystem>
+#include <fstream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Increase when cooking of any asset type changes. All assets will be cooked again.
+    constexpr uint32_t cookerVersion = 4;
+    constexpr const char* manifestFileName = ".beryll_cook_manifest";
+    constexpr const char* textureUsagesFileName = ".beryll_cook_texture_usages"; // Of up to date models which are not parsed again.
+    constexpr float alphaTestReference = 0.5f; // Same as runtime mip generation in AndroidGLESTexture.
+
+    enum class AssetType
+    {
+        MODEL,
+        TEXTURE,
+        COPY
+    };
+
+    // Material slot which uses texture in models. Runtime chooses mip settings by TextureType of slot.
+    enum class TextureUsage
+    {
+        UNKNOWN, // Not used by models.
+        DIFFUSE,
+        SPECULAR,
+        NORMAL_MAP,
+        MIXED // Different slots in different models. Runtime uses slot of first load.
+    };
+
+    enum class CookResult
+    {
+        COOKED,
+        SKIPPED,
+        FAILED
+    };
+
+    struct Asset
+    {
+        fs::path sourcePath;
+        std::string relativePath; // With '/' separators. Key in manifest.
+        AssetType type = AssetType::COPY;
+        std::string cookedExtension; // Of cooked file if asset type can be cooked. Even if it is copied with current options.
+        std::vector<std::pair<std::string, TextureUsage>> textureUsages; // Of model. Relative texture path and slot.
+        TextureUsage textureUsage = TextureUsage::UNKNOWN; // Of texture. From all models.
+
+        uint64_t hash = 0;
+        fs::path outPath;
+        CookResult result = CookResult::SKIPPED;
+        float timeMilliSec = 0.0f;
+        std::string message;
+    };
+
+    // FNV-1a 64.
+    uint64_t hashBytes(const char* data, size_t size, uint64_t hash = 14695981039346656037ull)
+    {
+        for(size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool readFile(const fs::path& path, std::vector<char>& data)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if(!file)
+            return false;
+
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        return data.empty() || file.read(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::string toLower(std::string str)
+    {
+        std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return std::tolower(c); });
+        return str;
+    }
+
+    std::map<std::string, uint64_t> loadManifest(const fs::path& path)
+    {
+        std::map<std::string, uint64_t> manifest;
+
+        std::ifstream file(path);
+        std::string line;
+        while(std::getline(file, line))
+        {
+            // Line format: hash(hex) relativePath
+            const size_t spacePos = line.find(' ');
+            if(spacePos == std::string::npos)
+                continue;
+
+            manifest[line.substr(spacePos + 1)] = std::stoull(line.substr(0, spacePos), nullptr, 16);
+        }
+
+        return manifest;
+    }
+
+    bool saveManifest(const fs::path& path, const std::vector<Asset>& assets)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        for(const Asset& asset : assets)
+        {
+            if(asset.result != CookResult::FAILED)
+                file << std::hex << asset.hash << ' ' << asset.relativePath << '\n';
+        }
+
+        return static_cast<bool>(file);
+    }
+
+    // Line format: usage(number) modelRelativePath<tab>textureRelativePath
+    bool loadTextureUsages(const fs::path& path, std::map<std::string, std::vector<std::pair<std::string, TextureUsage>>>& usages)
+    {
+        std::ifstream file(path);
+        if(!file)
+            return false;
+
+        std::string line;
+        while(std::getline(file, line))
+        {
+            const size_t spacePos = line.find(' ');
+            const size_t tabPos = line.find('\t');
+            if(spacePos == std::string::npos || tabPos == std::string::npos || tabPos < spacePos)
+                continue;
+
+            const TextureUsage usage = static_cast<TextureUsage>(std::stoul(line.substr(0, spacePos)));
+            usages[line.substr(spacePos + 1, tabPos - spacePos - 1)].emplace_back(line.substr(tabPos + 1), usage);
+        }
+
+        return true;
+    }
+
+    bool saveTextureUsages(const fs::path& path, const std::vector<Asset>& assets)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        for(const Asset& asset : assets)
+        {
+            if(asset.result == CookResult::FAILED)
+                continue;
+
+            for(const std::pair<std::string, TextureUsage>& usage : asset.textureUsages)
+            {
+                file << static_cast<uint32_t>(usage.second) << ' ' << asset.relativePath << '\t' << usage.first << '\n';
+            }
+        }
+
+        return static_cast<bool>(file);
+    }
+
+    // Same texture paths as runtime: file name from material in folder of model (see Common::getMaterialTexturePath()).
+    // Animated models too. Their textures are loaded by BaseAnimatedObject with same slots.
+    void collectTextureUsages(const aiScene* scene, Asset& asset)
+    {
+        asset.textureUsages.clear();
+
+        const std::string modelPath = asset.sourcePath.generic_string();
+        const fs::path modelFolder = fs::path(asset.relativePath).parent_path();
+        const std::pair<aiTextureType, TextureUsage> slots[3] = {{aiTextureType_DIFFUSE, TextureUsage::DIFFUSE},
+                                                                 {aiTextureType_SPECULAR, TextureUsage::SPECULAR},
+                                                                 {aiTextureType_NORMALS, TextureUsage::NORMAL_MAP}};
+        for(unsigned int i = 0; i < scene->mNumMeshes; ++i)
+        {
+            const aiMaterial* material = scene->mMaterials[scene->mMeshes[i]->mMaterialIndex];
+            for(const std::pair<aiTextureType, TextureUsage>& slot : slots)
+            {
+                const std::string texturePath = BeryllUtils::Common::getMaterialTexturePath(material, slot.first, modelPath);
+                if(texturePath.empty())
+                    continue;
+
+                const std::pair<std::string, TextureUsage> usage((modelFolder / fs::path(texturePath).filename()).generic_string(), slot.second);
+                if(std::find(asset.textureUsages.begin(), asset.textureUsages.end(), usage) == asset.textureUsages.end())
+                    asset.textureUsages.push_back(usage);
+            }
+        }
+    }
+
+    // isAnimated = true if model must be copied as is.
+    bool cookModel(Asset& asset, bool& isAnimated)
+    {
+        Assimp::Importer importer; // One per thread. Importer is not thread safe but separate importers are.
+        const aiScene* scene = importer.ReadFile(asset.sourcePath.string(), BeryllUtils::MeshFile::assimpFlags);
+        if(!scene || !scene->mRootNode || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE))
+        {
+            asset.message = importer.GetErrorString();
+            return false;
+        }
+
+        collectTextureUsages(scene, asset);
+
+        isAnimated = scene->HasAnimations();
+        for(unsigned int i = 0; i < scene->mNumMeshes && !isAnimated; ++i)
+        {
+            isAnimated = scene->mMeshes[i]->HasBones();
+        }
+
+        if(isAnimated)
+        {
+            asset.message = "animated, copied";
+            return true;
+        }
+
+        // Textures are resolved relative to model path. Must have '/' separators.
+        const std::string modelPath = asset.sourcePath.generic_string();
+        std::vector<BeryllUtils::MeshData> meshes = BeryllUtils::MeshFile::extractMeshes(scene, modelPath);
+        if(meshes.empty())
+        {
+            asset.message = "no meshes";
+            return false;
+        }
+
+        size_t vertexCount = 0;
+        int bvhCount = 0;
+        for(BeryllUtils::MeshData& mesh : meshes)
+        {
+            vertexCount += mesh.vertices.size();
+
+            // Same shape as Physics builds for this mesh name.
+            if(mesh.isCollision && mesh.name.find("CollisionConcaveMesh") != std::string::npos && !mesh.indices.empty())
+            {
+                mesh.collisionBvh = Beryll::Physics::serializeConcaveMeshBvh(mesh.vertices, mesh.indices);
+                if(mesh.collisionBvh.empty())
+                {
+                    asset.message = "BVH serialization failed: " + mesh.name;
+                    return false;
+                }
+                ++bvhCount;
+            }
+        }
+        asset.message = std::to_string(meshes.size()) + " meshes, " + std::to_string(vertexCount) + " vertices";
+        if(bvhCount > 0)
+            asset.message += ", " + std::to_string(bvhCount) + " BVH";
+
+        asset.outPath.replace_extension(BeryllUtils::MeshFile::extension);
+        if(!BeryllUtils::MeshFile::writeMeshFile(meshes, asset.outPath.string()))
+        {
+            asset.message = "mesh file writing error";
+            return false;
+        }
+
+        return true;
+    }
+
+    // isCopied = true if texture must be copied as is.
+    bool cookTexture(Asset& asset, const std::vector<char>& data, bool& isCopied)
+    {
+        if(asset.textureUsage == TextureUsage::UNKNOWN || asset.textureUsage == TextureUsage::MIXED)
+        {
+            isCopied = true;
+            asset.message = asset.textureUsage == TextureUsage::UNKNOWN ? "not used by models, copied" : "used in different material slots, copied";
+            return true;
+        }
+
+        // Same decoding and conversion to RGBA as at runtime in AndroidGLESTexture.
+        SDL_Surface* loadedSurface = IMG_Load_IO(SDL_IOFromConstMem(data.data(), data.size()), true);
+        if(!loadedSurface)
+        {
+            asset.message = SDL_GetError();
+            return false;
+        }
+
+        const bool isOneBytePerPixel = SDL_BYTESPERPIXEL(loadedSurface->format) == 1;
+        SDL_Surface* surface = SDL_ConvertSurface(loadedSurface, SDL_PIXELFORMAT_RGBA32);
+        SDL_DestroySurface(loadedSurface);
+        if(!surface || surface->pitch != surface->w * 4)
+        {
+            asset.message = "conversion to RGBA failed";
+            SDL_DestroySurface(surface);
+            return false;
+        }
+
+        const int width = surface->w;
+        const int height = surface->h;
+        const unsigned char* pixels = static_cast<const unsigned char*>(surface->pixels);
+        const size_t pixelCount = size_t(width) * height;
+
+        // Same channels and settings as AndroidGLESTexture::decodeImage() for TextureType of slot.
+        const bool isNormalMap = asset.textureUsage == TextureUsage::NORMAL_MAP;
+        const uint32_t channels = BeryllUtils::MipChain::getChannelsToKeep(pixels, pixelCount, isOneBytePerPixel, isNormalMap);
+
+        BeryllUtils::MipSettings settings;
+        if(isNormalMap)
+        {
+            settings.isNormalMap = true;
+        }
+        else if(asset.textureUsage == TextureUsage::DIFFUSE)
+        {
+            settings.isSRGB = true;
+            settings.alphaCoverageReference = channels == 4 ? alphaTestReference : 0.0f;
+        }
+        else
+        {
+            settings.isSRGB = false;
+        }
+
+        std::vector<unsigned char> packed;
+        if(channels != 4)
+        {
+            packed = BeryllUtils::MipChain::packChannels(pixels, pixelCount, channels);
+            pixels = packed.data();
+        }
+
+        const std::vector<BeryllUtils::MipLevel> levels = BeryllUtils::MipChain::generate(pixels, width, height, channels, settings);
+        SDL_DestroySurface(surface);
+
+        const char* usageNames[] = {"", "diffuse", "specular", "normal map", ""};
+        asset.message = std::to_string(width) + "x" + std::to_string(height) + ", " + usageNames[static_cast<int>(asset.textureUsage)] + ", " +
+                        std::to_string(channels) + " channels, " + std::to_string(levels.size()) + " levels";
+        if(settings.alphaCoverageReference > 0.0f)
+            asset.message += ", alpha coverage";
+
+        // Stored as UNORM like .png/.jpg are uploaded. sRGB only affects filtering.
+        asset.outPath.replace_extension(".ktx2");
+        if(!BeryllUtils::KTXFile::writeKTX2(levels, false, asset.outPath.string()))
+        {
+            asset.message = "texture file writing error";
+            return false;
+        }
+
+        return true;
+    }
+
+    void cookAsset(Asset& asset, const fs::path& outDir, const std::map<std::string, uint64_t>& manifest, bool force)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        std::vector<char> data;
+        if(!readFile(asset.sourcePath, data))
+        {
+            asset.result = CookResult::FAILED;
+            asset.message = "reading error";
+            return;
+        }
+
+        asset.hash = hashBytes(data.data(), data.size());
+        asset.hash = hashBytes(reinterpret_cast<const char*>(&cookerVersion), sizeof(cookerVersion), asset.hash);
+        asset.hash = hashBytes(reinterpret_cast<const char*>(&BeryllUtils::MeshFile::version), sizeof(uint32_t), asset.hash);
+        asset.hash = hashBytes(reinterpret_cast<const char*>(&asset.type), sizeof(AssetType), asset.hash); // Cooked again when options change.
+        asset.hash = hashBytes(reinterpret_cast<const char*>(&asset.textureUsage), sizeof(TextureUsage), asset.hash); // Or when models use texture in other slot.
+
+        asset.outPath = outDir / asset.relativePath;
+        fs::path cookedOutPath = asset.outPath;
+        if(!asset.cookedExtension.empty())
+            cookedOutPath.replace_extension(asset.cookedExtension);
+
+        std::error_code error;
+        const auto it = manifest.find(asset.relativePath);
+        if(!force && it != manifest.end() && it->second == asset.hash &&
+           (fs::exists(cookedOutPath, error) || fs::exists(asset.outPath, error)))
+        {
+            asset.result = CookResult::SKIPPED;
+            return;
+        }
+
+        fs::create_directories(asset.outPath.parent_path(), error);
+
+        bool copy = asset.type == AssetType::COPY;
+        if((asset.type == AssetType::MODEL && !cookModel(asset, copy)) ||
+           (asset.type == AssetType::TEXTURE && !cookTexture(asset, data, copy)))
+        {
+            asset.result = CookResult::FAILED;
+            return;
+        }
+
+        if(copy)
+        {
+            std::ofstream file(asset.outPath, std::ios::binary | std::ios::trunc);
+            if(!file || !file.write(data.data(), static_cast<std::streamsize>(data.size())))
+            {
+                asset.result = CookResult::FAILED;
+                asset.message = "writing error";
+                return;
+            }
+        }
+
+        // Output of other cooking mode (changed options, model became animated or texture usage changed) must not stay. Texture loader prefers .ktx2.
+        const fs::path otherOutPath = copy ? cookedOutPath : outDir / asset.relativePath;
+        if(otherOutPath != asset.outPath)
+            fs::remove(otherOutPath, error);
+
+        asset.result = CookResult::COOKED;
+        asset.timeMilliSec = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void printUsage()
+    {
+        std::cout << "Usage: beryll_cook <assetsDir> <outDir> [-j threadsCount] [--force] [--texture-mips] [--pack packPath.bpak]" << std::endl;
+    }
+
+    // All cooked files (not manifest and texture usages, not other packs). Path inside pack = path relative to outDir.
+    bool writePack(const fs::path& outDir, const fs::path& packPath)
+    {
+        std::vector<std::pair<std::string, std::string>> files;
+        uint64_t filesSize = 0;
+        for(const fs::directory_entry& entry : fs::recursive_directory_iterator(outDir))
+        {
+            if(!entry.is_regular_file() || entry.path().filename() == manifestFileName || entry.path().filename() == textureUsagesFileName ||
+               toLower(entry.path().extension().string()) == "." + std::string(BeryllUtils::PackFile::extension))
+                continue;
+
+            files.emplace_back(fs::relative(entry.path(), outDir).generic_string(), entry.path().string());
+            filesSize += entry.file_size();
+        }
+        std::sort(files.begin(), files.end());
+
+        const auto start = std::chrono::steady_clock::now();
+        if(!BeryllUtils::PackFile::writePack(files, packPath.string()))
+        {
+            std::cout << "Pack writing error: " << packPath << std::endl;
+            return false;
+        }
+
+        std::error_code error;
+        const float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Pack: " << packPath << ", files: " << files.size() << ", size: " << filesSize << " -> "
+                  << fs::file_size(packPath, error) << " bytes" << std::fixed << std::setprecision(1) << ", time: " << time << " ms." << std::endl;
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if(argc < 3)
+    {
+        printUsage();
+        return 1;
+    }
+
+    const fs::path assetsDir = argv[1];
+    const fs::path outDir = argv[2];
+    int threadsCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    bool force = false;
+    bool textureMips = false;
+    fs::path packPath;
+
+    for(int i = 3; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if(arg == "-j" && i + 1 < argc)
+            threadsCount = std::max(1, std::atoi(argv[++i]));
+        else if(arg == "--force")
+            force = true;
+        else if(arg == "--texture-mips")
+            textureMips = true;
+        else if(arg == "--pack" && i + 1 < argc)
+            packPath = argv[++i];
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::error_code error;
+    if(!fs::is_directory(assetsDir, error))
+    {
+        std::cout << "Assets folder does not exist: " << assetsDir << std::endl;
+        return 1;
+    }
+    fs::create_directories(outDir, error);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<Asset> assets;
+    for(const fs::directory_entry& entry : fs::recursive_directory_iterator(assetsDir))
+    {
+        if(!entry.is_regular_file())
+            continue;
+
+        Asset asset;
+        asset.sourcePath = entry.path();
+        asset.relativePath = fs::relative(entry.path(), assetsDir).generic_string();
+
+        const std::string extension = toLower(entry.path().extension().string());
+        if(extension == ".fbx" || extension == ".dae")
+        {
+            asset.type = AssetType::MODEL;
+            asset.cookedExtension = "." + std::string(BeryllUtils::MeshFile::extension);
+        }
+        else if(extension == ".png" || extension == ".jpg")
+        {
+            asset.type = textureMips ? AssetType::TEXTURE : AssetType::COPY;
+            asset.cookedExtension = ".ktx2";
+        }
+
+        assets.push_back(std::move(asset));
+    }
+
+    const std::map<std::string, uint64_t> manifest = loadManifest(outDir / manifestFileName);
+
+    // Texture usages of models which will be skipped. Without file all models are parsed again.
+    std::map<std::string, std::vector<std::pair<std::string, TextureUsage>>> previousTextureUsages;
+    const bool hasTextureUsages = loadTextureUsages(outDir / textureUsagesFileName, previousTextureUsages);
+    for(Asset& asset : assets)
+    {
+        if(asset.type == AssetType::MODEL)
+            asset.textureUsages = previousTextureUsages[asset.relativePath];
+    }
+
+    // Models first: textures are cooked with usage from model materials.
+    // Biggest files first in every group. Less time at end when only one thread works.
+    std::sort(assets.begin(), assets.end(), [](const Asset& a, const Asset& b)
+    {
+        if((a.type == AssetType::MODEL) != (b.type == AssetType::MODEL))
+            return a.type == AssetType::MODEL;
+
+        std::error_code e;
+        return fs::file_size(a.sourcePath, e) > fs::file_size(b.sourcePath, e);
+    });
+    const size_t modelsCount = static_cast<size_t>(std::count_if(assets.begin(), assets.end(),
+                                                                 [](const Asset& a) { return a.type == AssetType::MODEL; }));
+
+    std::atomic<size_t> nextAsset{0};
+    size_t endAsset = 0;
+    std::mutex printMutex;
+    auto worker = [&]()
+    {
+        for(size_t i = nextAsset++; i < endAsset; i = nextAsset++)
+        {
+            Asset& asset = assets[i];
+            cookAsset(asset, outDir, manifest, force || (asset.type == AssetType::MODEL && !hasTextureUsages));
+
+            if(asset.result == CookResult::SKIPPED)
+                continue;
+
+            std::scoped_lock<std::mutex> lock(printMutex);
+            if(asset.result == CookResult::COOKED)
+                std::cout << std::fixed << std::setprecision(1) << std::setw(9) << asset.timeMilliSec << " ms  " << asset.relativePath;
+            else
+                std::cout << "   FAILED     " << asset.relativePath;
+
+            if(!asset.message.empty())
+                std::cout << " (" << asset.message << ")";
+            std::cout << std::endl;
+        }
+    };
+
+    threadsCount = std::min(threadsCount, static_cast<int>(std::max<size_t>(assets.size(), 1)));
+    const auto cookRange = [&](size_t begin, size_t end)
+    {
+        nextAsset = begin;
+        endAsset = end;
+        std::vector<std::thread> threads;
+        for(int i = 1; i < threadsCount && begin + i < end; ++i)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for(std::thread& thread : threads)
+        {
+            thread.join();
+        }
+    };
+
+    cookRange(0, modelsCount);
+
+    std::map<std::string, TextureUsage> textureUsages;
+    for(size_t i = 0; i < modelsCount; ++i)
+    {
+        for(const std::pair<std::string, TextureUsage>& usage : assets[i].textureUsages)
+        {
+            auto it = textureUsages.emplace(usage.first, usage.second).first;
+            if(it->second != usage.second)
+                it->second = TextureUsage::MIXED;
+        }
+    }
+    for(size_t i = modelsCount; i < assets.size(); ++i)
+    {
+        const auto it = textureUsages.find(assets[i].relativePath);
+        if(it != textureUsages.end())
+            assets[i].textureUsage = it->second;
+    }
+
+    cookRange(modelsCount, assets.size());
+
+    std::sort(assets.begin(), assets.end(), [](const Asset& a, const Asset& b) { return a.relativePath < b.relativePath; });
+    if(!saveManifest(outDir / manifestFileName, assets))
+        std::cout << "Manifest writing error." << std::endl;
+    if(!saveTextureUsages(outDir / textureUsagesFileName, assets))
+        std::cout << "Texture usages writing error." << std::endl;
+
+    int cooked = 0;
+    int skipped = 0;
+    int failed = 0;
+    float cookTime = 0.0f;
+    for(const Asset& asset : assets)
+    {
+        if(asset.result == CookResult::COOKED) { ++cooked; cookTime += asset.timeMilliSec; }
+        else if(asset.result == CookResult::SKIPPED) { ++skipped; }
+        else { ++failed; }
+    }
+
+    const float totalTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Cooked: " << cooked << ", up to date: " << skipped << ", failed: " << failed << ". Threads: " << threadsCount
+              << std::fixed << std::setprecision(1) << ". Total time: " << totalTime << " ms (sum of assets: " << cookTime << " ms)." << std::endl;
+
+    if(failed == 0 && !packPath.empty() && !writePack(outDir, packPath))
+        return 1;
+
+    return failed == 0 ? 0 : 1;
+}
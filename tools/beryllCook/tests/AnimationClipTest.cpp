@@ -0,0 +1,139 @@
+// Baked animation clip. Sampled pose matches source keys and per frame cost does not depend on keys count.
+// Prints per frame sampling time for clips with 10...10000 keys.
+
+#include "TestCheck.h"
+
+#include "beryll/animation/AnimationClip.h"
+
+#include <chrono>
+#include <memory>
+
+namespace
+{
+    using namespace Beryll;
+
+    constexpr float ticksPerSecond = 30.0f;
+    constexpr int bonesCount = 30;
+
+    glm::vec3 getKeyPosition(int bone, uint32_t key) { return glm::vec3(static_cast<float>(bone), std::sin(static_cast<float>(key) * 0.1f), static_cast<float>(key % 7)); }
+    glm::quat getKeyRotation(int bone, uint32_t key) { return glm::angleAxis(static_cast<float>(key) * 0.05f + static_cast<float>(bone), glm::vec3(0.0f, 1.0f, 0.0f)); }
+
+    // One key per tick for every bone. Same layout as Assimp gives after import.
+    std::unique_ptr<aiAnimation> makeAnimation(uint32_t keysCount)
+    {
+        std::unique_ptr<aiAnimation> animation = std::make_unique<aiAnimation>();
+        animation->mName = aiString("Run");
+        animation->mDuration = static_cast<double>(keysCount - 1);
+        animation->mTicksPerSecond = ticksPerSecond;
+        animation->mNumChannels = bonesCount;
+        animation->mChannels = new aiNodeAnim*[bonesCount];
+        for(int b = 0; b < bonesCount; ++b)
+        {
+            aiNodeAnim* channel = new aiNodeAnim();
+            channel->mNodeName = aiString("Bone" + std::to_string(b));
+            channel->mNumPositionKeys = keysCount;
+            channel->mNumRotationKeys = keysCount;
+            channel->mNumScalingKeys = keysCount;
+            channel->mPositionKeys = new aiVectorKey[keysCount];
+            channel->mRotationKeys = new aiQuatKey[keysCount];
+            channel->mScalingKeys = new aiVectorKey[keysCount];
+            for(uint32_t k = 0; k < keysCount; ++k)
+            {
+                const glm::vec3 position = getKeyPosition(b, k);
+                const glm::quat rotation = getKeyRotation(b, k);
+                channel->mPositionKeys[k] = aiVectorKey(static_cast<double>(k), aiVector3D(position.x, position.y, position.z));
+                channel->mRotationKeys[k] = aiQuatKey(static_cast<double>(k), aiQuaternion(rotation.w, rotation.x, rotation.y, rotation.z));
+                channel->mScalingKeys[k] = aiVectorKey(static_cast<double>(k), aiVector3D(1.0f, 1.0f, 1.0f));
+            }
+            animation->mChannels[b] = channel;
+        }
+        return animation;
+    }
+
+    std::vector<std::string> makeNodeNames()
+    {
+        std::vector<std::string> nodeNames{"Armature"}; // Not animated node.
+        for(int b = 0; b < bonesCount; ++b)
+        {
+            nodeNames.push_back("Bone" + std::to_string(b));
+        }
+        return nodeNames;
+    }
+
+    void testSamplesMatchKeys(const AnimationClip& clip, uint32_t keysCount)
+    {
+        for(uint32_t k = 0; k < keysCount; k += std::max(keysCount / 50, 1u))
+        {
+            uint32_t sampleIndex = 0;
+            float blend = 0.0f;
+            clip.getSamplePosition(static_cast<float>(k), sampleIndex, blend);
+
+            for(int b = 0; b < bonesCount; ++b)
+            {
+                const glm::mat4 transform = clip.sampleNode(b + 1, sampleIndex, blend);
+                const glm::vec3 expectedPosition = getKeyPosition(b, k);
+                for(int c = 0; c < 3; ++c)
+                {
+                    BR_CHECK_NEAR(transform[3][c], expectedPosition[c], 0.0001f);
+                }
+                const glm::quat rotation = glm::quat_cast(glm::mat3(transform));
+                BR_CHECK_NEAR(std::abs(glm::dot(rotation, getKeyRotation(b, k))), 1.0f, 0.0001f);
+            }
+        }
+
+        uint32_t sampleIndex = 0;
+        float blend = 0.0f;
+        clip.getSamplePosition(0.0f, sampleIndex, blend);
+        BR_CHECK(clip.sampleNode(0, sampleIndex, blend) == glm::mat4{1.0f});
+    }
+
+    // Nanoseconds per frame. Same calls as BaseAnimatedObject: getSamplePosition() + sampleNode() for all nodes at 60 FPS playback.
+    double measureFrameTime(const AnimationClip& clip, size_t nodesCount)
+    {
+        constexpr int framesCount = 100000;
+        float checksum = 0.0f;
+
+        const auto start = std::chrono::steady_clock::now();
+        for(int frame = 0; frame < framesCount; ++frame)
+        {
+            const float animationTime = std::fmod(static_cast<float>(frame) * ticksPerSecond / 60.0f, clip.getDuration());
+            uint32_t sampleIndex = 0;
+            float blend = 0.0f;
+            clip.getSamplePosition(animationTime, sampleIndex, blend);
+            for(size_t n = 0; n < nodesCount; ++n)
+            {
+                checksum += clip.sampleNode(static_cast<int>(n), sampleIndex, blend)[3][0];
+            }
+        }
+        const double time = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        BR_CHECK(checksum == checksum); // Keep loop from being optimized out.
+        return time / framesCount;
+    }
+}
+
+int main()
+{
+    const std::vector<std::string> nodeNames = makeNodeNames();
+
+    std::vector<double> frameTimes;
+    for(const uint32_t keysCount : {10u, 100u, 1000u, 10000u})
+    {
+        const std::unique_ptr<aiAnimation> animation = makeAnimation(keysCount);
+        const auto start = std::chrono::steady_clock::now();
+        const AnimationClip clip(animation.get(), nodeNames, ticksPerSecond);
+        const double bakeTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        BR_CHECK(clip.getSampleCount() == keysCount);
+        testSamplesMatchKeys(clip, keysCount);
+
+        frameTimes.push_back(measureFrameTime(clip, nodeNames.size()));
+        std::printf("%5u keys x %d bones: bake %.2f ms, frame %.0f ns, memory %u bytes\n",
+                    keysCount, bonesCount, bakeTime, frameTimes.back(), static_cast<uint32_t>(clip.getMemorySize()));
+    }
+
+    // Direct sample index. 1000 times more keys must not be much slower. Tolerance for cache misses and timer noise.
+    BR_CHECK(frameTimes.back() < frameTimes.front() * 3.0);
+
+    return getTestResult("AnimationClipTest");
+}
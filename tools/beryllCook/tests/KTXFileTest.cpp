@@ -0,0 +1,271 @@
+// KTX 1/2 parsing and ETC2/EAC decoding on CPU (used when GPU does not support format).
+// Expected colors are calculated by hand from ETC2 specification.
+
+#include "TestCheck.h"
+
+#include "beryll/utils/KTXFile.h"
+
+#include <cstring>
+
+namespace
+{
+    using namespace BeryllUtils;
+
+    constexpr unsigned char KTX1Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+    constexpr unsigned char KTX2Identifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    void appendU32(std::vector<char>& buffer, uint32_t value)
+    {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(uint32_t));
+    }
+
+    void appendU64(std::vector<char>& buffer, uint64_t value)
+    {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(uint64_t));
+    }
+
+    std::vector<char> makeKTX1(uint32_t glInternalFormat, uint32_t width, uint32_t height, const std::vector<unsigned char>& data)
+    {
+        std::vector<char> buffer(std::begin(KTX1Identifier), std::end(KTX1Identifier));
+        for(const uint32_t value : {0x04030201u, 0u, 1u, 0u, glInternalFormat, 0u, width, height, 0u, 0u, 1u, 1u, 0u})
+        {
+            appendU32(buffer, value);
+        }
+        appendU32(buffer, static_cast<uint32_t>(data.size()));
+        buffer.insert(buffer.end(), data.begin(), data.end());
+        return buffer;
+    }
+
+    std::vector<char> makeKTX2(uint32_t vkFormat, uint32_t width, uint32_t height, const std::vector<unsigned char>& data)
+    {
+        std::vector<char> buffer(std::begin(KTX2Identifier), std::end(KTX2Identifier));
+        for(const uint32_t value : {vkFormat, 1u, width, height, 0u, 0u, 1u, 1u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u, 0u})
+        {
+            appendU32(buffer, value);
+        }
+        const uint64_t dataOffset = buffer.size() + 3 * sizeof(uint64_t);
+        appendU64(buffer, dataOffset);
+        appendU64(buffer, data.size());
+        appendU64(buffer, data.size());
+        buffer.insert(buffer.end(), data.begin(), data.end());
+        return buffer;
+    }
+
+    void checkPixel(const std::vector<unsigned char>& rgba, uint32_t width, uint32_t x, uint32_t y, int r, int g, int b, int a)
+    {
+        const unsigned char* pixel = rgba.data() + (size_t(y) * width + x) * 4;
+        BR_CHECK(pixel[0] == r);
+        BR_CHECK(pixel[1] == g);
+        BR_CHECK(pixel[2] == b);
+        BR_CHECK(pixel[3] == a);
+    }
+
+    void testETC2RGB8()
+    {
+        // Two blocks. 8x4 pixels.
+        const std::vector<unsigned char> blocks{
+            // Individual mode, flip = 0 (left/right subblocks). R 8/2, G 4/4, B 2/8. Tables 0 and 1. All indices 00 (+a).
+            0x82, 0x44, 0x28, (0 << 5) | (1 << 2), 0x00, 0x00, 0x00, 0x00,
+            // Differential mode, flip = 1 (top/bottom subblocks). R 16 + 1, G 8 - 1, B 4 + 0. Tables 2 and 0. All indices 11 (-b).
+            (16 << 3) | 1, (8 << 3) | 7, (4 << 3) | 0, (2 << 5) | (0 << 2) | 2 | 1, 0xFF, 0xFF, 0xFF, 0xFF};
+
+        const std::vector<char> file = makeKTX1(KTXFile::GLFormatETC2RGB8, 8, 4, blocks);
+        TextureFileData texture;
+        BR_CHECK(KTXFile::parse(file.data(), file.size(), texture));
+        BR_CHECK(texture.format == TextureFileFormat::ETC2_RGB8);
+        BR_CHECK(texture.width == 8 && texture.height == 4);
+        BR_CHECK(texture.levels.size() == 1 && texture.levels[0].size == blocks.size());
+
+        std::vector<unsigned char> rgba;
+        BR_CHECK(KTXFile::decodeLevel(texture, 0, rgba));
+        BR_CHECK(rgba.size() == 8 * 4 * 4);
+        if(rgba.size() != 8 * 4 * 4)
+            return;
+
+        // 4 bit colors extended by repeating: 0x8 -> 0x88.
+        checkPixel(rgba, 8, 0, 0, 136 + 2, 68 + 2, 34 + 2, 255);
+        checkPixel(rgba, 8, 1, 3, 136 + 2, 68 + 2, 34 + 2, 255);
+        checkPixel(rgba, 8, 2, 0, 34 + 5, 68 + 5, 136 + 5, 255);
+        checkPixel(rgba, 8, 3, 3, 34 + 5, 68 + 5, 136 + 5, 255);
+
+        // 5 bit colors extended: 16 -> 132, 17 -> 140, 8 -> 66, 7 -> 57, 4 -> 33.
+        checkPixel(rgba, 8, 4, 0, 132 - 29, 66 - 29, 33 - 29, 255);
+        checkPixel(rgba, 8, 7, 1, 132 - 29, 66 - 29, 33 - 29, 255);
+        checkPixel(rgba, 8, 4, 2, 140 - 8, 57 - 8, 33 - 8, 255);
+        checkPixel(rgba, 8, 7, 3, 140 - 8, 57 - 8, 33 - 8, 255);
+    }
+
+    void testETC2RGBA8()
+    {
+        // EAC alpha: base 128, multiplier 1, table 0. Indices 100 (+2) for all pixels. Then color: individual mode, all indices 00.
+        const std::vector<unsigned char> block{
+            128, (1 << 4) | 0, 0x92, 0x49, 0x24, 0x92, 0x49, 0x24,
+            0x82, 0x44, 0x28, (0 << 5) | (1 << 2), 0x00, 0x00, 0x00, 0x00};
+
+        constexpr uint32_t vkFormatETC2RGBA8 = 151;
+        const std::vector<char> file = makeKTX2(vkFormatETC2RGBA8, 4, 4, block);
+        TextureFileData texture;
+        BR_CHECK(KTXFile::parse(file.data(), file.size(), texture));
+        BR_CHECK(texture.format == TextureFileFormat::ETC2_RGBA8);
+        BR_CHECK(texture.glInternalFormat == KTXFile::GLFormatETC2RGBA8);
+        BR_CHECK(!texture.isSRGB);
+
+        std::vector<unsigned char> rgba;
+        BR_CHECK(KTXFile::decodeLevel(texture, 0, rgba));
+        BR_CHECK(rgba.size() == 4 * 4 * 4);
+        if(rgba.size() != 4 * 4 * 4)
+            return;
+
+        checkPixel(rgba, 4, 0, 0, 138, 70, 36, 130);
+        checkPixel(rgba, 4, 3, 3, 39, 73, 141, 130);
+    }
+
+    void testNotSupportedAndDamaged()
+    {
+        const std::vector<unsigned char> block(8, 0);
+        TextureFileData texture;
+
+        // Level size does not match format.
+        const std::vector<char> wrongSize = makeKTX1(KTXFile::GLFormatETC2RGB8, 8, 8, block);
+        BR_CHECK(!KTXFile::parse(wrongSize.data(), wrongSize.size(), texture));
+
+        // Truncated file.
+        const std::vector<char> file = makeKTX2(147, 4, 4, block);
+        BR_CHECK(KTXFile::parse(file.data(), file.size(), texture));
+        BR_CHECK(!KTXFile::parse(file.data(), file.size() - 1, texture));
+
+        // Not KTX.
+        const char png[16] = {'\x89', 'P', 'N', 'G'};
+        BR_CHECK(!KTXFile::parse(png, sizeof(png), texture));
+
+        // ASTC is parsed but not decoded on CPU.
+        const std::vector<unsigned char> astcBlock(16, 0);
+        const std::vector<char> astc = makeKTX1(KTXFile::GLFormatASTC4x4, 4, 4, astcBlock);
+        BR_CHECK(KTXFile::parse(astc.data(), astc.size(), texture));
+        BR_CHECK(texture.format == TextureFileFormat::ASTC && !KTXFile::canDecode(texture.format));
+        std::vector<unsigned char> rgba;
+        BR_CHECK(!KTXFile::decodeLevel(texture, 0, rgba));
+    }
+
+    void testWriteKTX2()
+    {
+        std::vector<MipLevel> levels(2);
+        levels[0].width = 2;
+        levels[0].height = 2;
+        levels[0].pixels = {255, 0, 0, 255,  0, 255, 0, 255,  0, 0, 255, 255,  255, 255, 255, 0};
+        levels[1].width = 1;
+        levels[1].height = 1;
+        levels[1].pixels = {128, 128, 128, 192};
+
+        const std::string path = "KTXFileTest.ktx2";
+        BR_CHECK(KTXFile::writeKTX2(levels, true, path));
+
+        TextureFileData texture;
+        BR_CHECK(KTXFile::load(path, texture));
+        BR_CHECK(texture.format == TextureFileFormat::RGBA8);
+        BR_CHECK(texture.isSRGB && texture.glInternalFormat == KTXFile::GLFormatSRGB8A8);
+        BR_CHECK(texture.levels.size() == 2);
+
+        std::vector<unsigned char> rgba;
+        for(uint32_t i = 0; i < texture.levels.size() && i < levels.size(); ++i)
+        {
+            BR_CHECK(KTXFile::decodeLevel(texture, i, rgba));
+            BR_CHECK(rgba == levels[i].pixels);
+        }
+
+        texture.file.close();
+        std::remove(path.c_str());
+    }
+
+    void testWriteKTX2R8AndRGB8()
+    {
+        // 3x3 levels. Level sizes are not multiple of 4. Channel layout of source is kept.
+        for(const uint32_t channels : {1u, 3u})
+        {
+            std::vector<MipLevel> levels(2);
+            levels[0].width = 3;
+            levels[0].height = 3;
+            levels[1].width = 1;
+            levels[1].height = 1;
+            for(MipLevel& level : levels)
+            {
+                level.channels = channels;
+                for(uint32_t i = 0; i < level.width * level.height * channels; ++i)
+                {
+                    level.pixels.push_back(static_cast<unsigned char>(10 + i * 7 + level.width));
+                }
+            }
+
+            const std::string path = "KTXFileTest_channels.ktx2";
+            BR_CHECK(KTXFile::writeKTX2(levels, channels == 3, path));
+
+            TextureFileData texture;
+            BR_CHECK(KTXFile::load(path, texture));
+            BR_CHECK(texture.format == (channels == 1 ? TextureFileFormat::R8 : TextureFileFormat::RGB8));
+            BR_CHECK(!KTXFile::getIsCompressed(texture.format));
+            BR_CHECK(texture.glInternalFormat == (channels == 1 ? KTXFile::GLFormatR8 : KTXFile::GLFormatSRGB8));
+            BR_CHECK(texture.isSRGB == (channels == 3));
+            BR_CHECK(texture.levels.size() == 2);
+
+            for(uint32_t i = 0; i < texture.levels.size() && i < levels.size(); ++i)
+            {
+                const TextureFileData::Level& level = texture.levels[i];
+                BR_CHECK(level.size == levels[i].pixels.size());
+                BR_CHECK(std::memcmp(level.data, levels[i].pixels.data(), levels[i].pixels.size()) == 0);
+                // Level data starts at multiple of texel size and 4.
+                BR_CHECK((level.data - reinterpret_cast<const unsigned char*>(texture.file.getData())) % (channels == 3 ? 12 : 4) == 0);
+            }
+
+            // CPU decode gives same values as GPU sampling: missing channels 0, alpha 255.
+            std::vector<unsigned char> rgba;
+            BR_CHECK(KTXFile::decodeLevel(texture, 0, rgba));
+            BR_CHECK(rgba.size() == 3 * 3 * 4);
+            if(rgba.size() == 3 * 3 * 4)
+            {
+                const std::vector<unsigned char>& pixels = levels[0].pixels;
+                if(channels == 1)
+                    checkPixel(rgba, 3, 2, 1, pixels[5], 0, 0, 255);
+                else
+                    checkPixel(rgba, 3, 2, 1, pixels[15], pixels[16], pixels[17], 255);
+            }
+
+            texture.file.close();
+            std::remove(path.c_str());
+        }
+
+        // Levels with different channels.
+        std::vector<MipLevel> mixed(2);
+        mixed[0].width = 2;
+        mixed[0].height = 1;
+        mixed[0].channels = 3;
+        mixed[0].pixels.resize(6);
+        mixed[1].width = 1;
+        mixed[1].height = 1;
+        mixed[1].channels = 4;
+        mixed[1].pixels.resize(4);
+        BR_CHECK(!KTXFile::writeKTX2(mixed, false, "KTXFileTest_mixed.ktx2"));
+
+        // KTX 1 rows of RGB8 are padded. Not supported even with data format of RGBA8.
+        const std::vector<unsigned char> rgb(12, 0);
+        std::vector<char> ktx1 = makeKTX1(KTXFile::GLFormatRGB8, 2, 2, rgb);
+        const uint32_t glType = 0x1401; // GL_UNSIGNED_BYTE.
+        const uint32_t glFormat = 0x1908; // GL_RGBA.
+        std::memcpy(ktx1.data() + 12 + 4, &glType, sizeof(glType));
+        std::memcpy(ktx1.data() + 12 + 12, &glFormat, sizeof(glFormat));
+        TextureFileData texture;
+        BR_CHECK(!KTXFile::parse(ktx1.data(), ktx1.size(), texture));
+    }
+}
+
+int main()
+{
+    testETC2RGB8();
+    testETC2RGBA8();
+    testNotSupportedAndDamaged();
+    testWriteKTX2();
+    testWriteKTX2R8AndRGB8();
+
+    return getTestResult("KTXFileTest");
+}
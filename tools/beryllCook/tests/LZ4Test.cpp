@@ -0,0 +1,119 @@
+// LZ4 block codec used by pack files. Round trip and damaged data.
+
+#include "TestCheck.h"
+
+#include "beryll/utils/LZ4.h"
+
+#include <random>
+
+namespace
+{
+    using namespace BeryllUtils;
+
+    std::vector<char> compress(const std::vector<char>& data)
+    {
+        std::vector<char> compressed(LZ4::getCompressBound(static_cast<uint32_t>(data.size())));
+        const uint32_t size = LZ4::compress(data.data(), static_cast<uint32_t>(data.size()), compressed.data(), static_cast<uint32_t>(compressed.size()));
+        BR_CHECK(size > 0);
+        compressed.resize(size);
+        return compressed;
+    }
+
+    void checkRoundTrip(const std::vector<char>& data)
+    {
+        const std::vector<char> compressed = compress(data);
+        BR_CHECK(compressed.size() <= LZ4::getCompressBound(static_cast<uint32_t>(data.size())));
+
+        std::vector<char> decompressed(data.size());
+        BR_CHECK(LZ4::decompress(compressed.data(), static_cast<uint32_t>(compressed.size()),
+                                 decompressed.data(), static_cast<uint32_t>(decompressed.size())) == static_cast<int64_t>(data.size()));
+        BR_CHECK(decompressed == data);
+    }
+
+    std::vector<char> makeRandom(size_t size, uint32_t seed)
+    {
+        std::mt19937 generator(seed);
+        std::vector<char> data(size);
+        for(char& c : data)
+        {
+            c = static_cast<char>(generator() & 0xFF);
+        }
+        return data;
+    }
+
+    std::vector<char> makeRepetitive(size_t size)
+    {
+        const std::string text = "vertex 1.0 0.5 -2.25 normal 0 1 0 ";
+        std::vector<char> data(size);
+        for(size_t i = 0; i < size; ++i)
+        {
+            data[i] = text[i % text.size()];
+        }
+        return data;
+    }
+
+    void testRoundTrip()
+    {
+        checkRoundTrip({});
+        checkRoundTrip({'a'});
+        checkRoundTrip(makeRandom(12, 1)); // Shorter than minimal block with matches.
+        checkRoundTrip(makeRandom(1000, 2));
+        checkRoundTrip(makeRandom(200 * 1024, 3));
+        checkRoundTrip(makeRepetitive(1000));
+        checkRoundTrip(std::vector<char>(100000, 'z')); // Long match lengths.
+
+        // Bigger than max offset (64 KB). Matches must not reference too far back.
+        std::vector<char> farRepeat = makeRandom(70 * 1024, 4);
+        const std::vector<char> head(farRepeat.begin(), farRepeat.begin() + 4096);
+        farRepeat.insert(farRepeat.end(), head.begin(), head.end());
+        checkRoundTrip(farRepeat);
+
+        const std::vector<char> repetitive = makeRepetitive(300 * 1024);
+        checkRoundTrip(repetitive);
+        BR_CHECK(compress(repetitive).size() < repetitive.size() / 20);
+    }
+
+    void testReferenceBlock()
+    {
+        // Written by hand from LZ4 block format: literal 'a', match offset 1 length 8 (overlapped copy), 5 last literals.
+        const std::vector<char> block{0x14, 'a', 0x01, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a'};
+        std::vector<char> decompressed(14);
+        BR_CHECK(LZ4::decompress(block.data(), static_cast<uint32_t>(block.size()), decompressed.data(), 14) == 14);
+        BR_CHECK(decompressed == std::vector<char>(14, 'a'));
+    }
+
+    void testDamaged()
+    {
+        const std::vector<char> data = makeRepetitive(5000);
+        const std::vector<char> compressed = compress(data);
+        std::vector<char> decompressed(data.size());
+
+        // Truncated.
+        BR_CHECK(LZ4::decompress(compressed.data(), static_cast<uint32_t>(compressed.size() - 1),
+                                 decompressed.data(), static_cast<uint32_t>(decompressed.size())) == -1);
+        // Output buffer too small.
+        BR_CHECK(LZ4::decompress(compressed.data(), static_cast<uint32_t>(compressed.size()),
+                                 decompressed.data(), static_cast<uint32_t>(decompressed.size() - 1)) == -1);
+        // Offset before start of output.
+        const std::vector<char> badOffset{0x10, 'a', 0x02, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a'};
+        BR_CHECK(LZ4::decompress(badOffset.data(), static_cast<uint32_t>(badOffset.size()),
+                                 decompressed.data(), static_cast<uint32_t>(decompressed.size())) == -1);
+        // Zero offset.
+        const std::vector<char> zeroOffset{0x10, 'a', 0x00, 0x00, 0x50, 'a', 'a', 'a', 'a', 'a'};
+        BR_CHECK(LZ4::decompress(zeroOffset.data(), static_cast<uint32_t>(zeroOffset.size()),
+                                 decompressed.data(), static_cast<uint32_t>(decompressed.size())) == -1);
+
+        // Destination too small for compression.
+        std::vector<char> small(8);
+        BR_CHECK(LZ4::compress(data.data(), static_cast<uint32_t>(data.size()), small.data(), static_cast<uint32_t>(small.size())) == 0);
+    }
+}
+
+int main()
+{
+    testRoundTrip();
+    testReferenceBlock();
+    testDamaged();
+
+    return getTestResult("LZ4Test");
+}
@@ -0,0 +1,176 @@
+// Mip levels generated on CPU (AndroidGLESTexture for .png/.jpg and beryllCook for .ktx2).
+
+#include "TestCheck.h"
+
+#include "beryll/utils/MipChain.h"
+
+#include <cmath>
+
+namespace
+{
+    using namespace BeryllUtils;
+
+    void testLevelSizes()
+    {
+        const std::vector<unsigned char> pixels(5 * 3, 100);
+        MipSettings settings;
+        const std::vector<MipLevel> levels = MipChain::generate(pixels.data(), 5, 3, 1, settings);
+
+        BR_CHECK(MipChain::getLevelCount(5, 3) == 3);
+        BR_CHECK(levels.size() == 3);
+        if(levels.size() != 3)
+            return;
+
+        BR_CHECK(levels[0].width == 5 && levels[0].height == 3 && levels[0].pixels == pixels);
+        BR_CHECK(levels[1].width == 2 && levels[1].height == 1 && levels[1].pixels.size() == 2);
+        BR_CHECK(levels[2].width == 1 && levels[2].height == 1 && levels[2].pixels.size() == 1);
+        for(const MipLevel& level : levels)
+        {
+            BR_CHECK(level.channels == 1);
+            for(const unsigned char value : level.pixels)
+            {
+                BR_CHECK(value == 100);
+            }
+        }
+    }
+
+    void testSRGBAveraging()
+    {
+        // Black and white. Average of light is 0.5 in linear space, 188 in sRGB.
+        const std::vector<unsigned char> rgba{0, 0, 0, 255,  255, 255, 255, 255};
+        MipSettings settings;
+        settings.isSRGB = true;
+        std::vector<MipLevel> levels = MipChain::generate(rgba.data(), 2, 1, 4, settings);
+        BR_CHECK(levels.size() == 2);
+        BR_CHECK(levels.back().pixels == std::vector<unsigned char>({188, 188, 188, 255}));
+
+        const std::vector<unsigned char> rgb{0, 0, 0,  255, 255, 255};
+        levels = MipChain::generate(rgb.data(), 2, 1, 3, settings);
+        BR_CHECK(levels.back().channels == 3);
+        BR_CHECK(levels.back().pixels == std::vector<unsigned char>({188, 188, 188}));
+
+        // Linear data (masks) is averaged as is.
+        const std::vector<unsigned char> gray{0, 255, 255, 0};
+        settings.isSRGB = false;
+        levels = MipChain::generate(gray.data(), 2, 2, 1, settings);
+        BR_CHECK(levels.back().pixels == std::vector<unsigned char>({128}));
+    }
+
+    void testTransparentPixelsDoNotDarken()
+    {
+        // Red opaque and black transparent. Color of result is red, not dark red.
+        const std::vector<unsigned char> rgba{255, 0, 0, 255,  0, 0, 0, 0};
+        MipSettings settings;
+        settings.isSRGB = true;
+        const std::vector<MipLevel> levels = MipChain::generate(rgba.data(), 2, 1, 4, settings);
+        BR_CHECK(levels.back().pixels == std::vector<unsigned char>({255, 0, 0, 128}));
+    }
+
+    void testNormalRenormalization()
+    {
+        // +X and +Y. Average has length 0.707 and must be normalized back to 1.
+        const std::vector<unsigned char> normals{255, 128, 128, 255,  128, 255, 128, 255};
+        MipSettings settings;
+        settings.isNormalMap = true;
+        settings.isSRGB = true; // Ignored for normal maps.
+
+        for(const uint32_t channels : {3u, 4u})
+        {
+            std::vector<unsigned char> pixels;
+            for(size_t i = 0; i < normals.size(); i += 4)
+            {
+                pixels.insert(pixels.end(), normals.begin() + i, normals.begin() + i + channels);
+            }
+
+            const std::vector<MipLevel> levels = MipChain::generate(pixels.data(), 2, 1, channels, settings);
+            BR_CHECK(levels.size() == 2);
+            const std::vector<unsigned char>& result = levels.back().pixels;
+            BR_CHECK(result.size() == channels);
+            if(result.size() != channels)
+                continue;
+
+            float normal[3];
+            for(int k = 0; k < 3; ++k)
+            {
+                normal[k] = static_cast<float>(result[k]) / 255.0f * 2.0f - 1.0f;
+            }
+            BR_CHECK_NEAR(std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]), 1.0f, 0.01f);
+            BR_CHECK_NEAR(normal[0], 0.7071f, 0.01f);
+            BR_CHECK_NEAR(normal[1], 0.7071f, 0.01f);
+            BR_CHECK_NEAR(normal[2], 0.0f, 0.01f);
+        }
+    }
+
+    void testAlphaCoverage()
+    {
+        // One visible pixel in every 2x2 block like leaves or fence. Coverage 0.25.
+        // Alpha of visible pixels is 160...223. Different in every block.
+        constexpr uint32_t size = 16;
+        std::vector<unsigned char> rgba(size * size * 4, 255);
+        for(uint32_t y = 0; y < size; ++y)
+        {
+            for(uint32_t x = 0; x < size; ++x)
+            {
+                const uint32_t block = (y / 2) * (size / 2) + x / 2;
+                rgba[(y * size + x) * 4 + 3] = x % 2 == 0 && y % 2 == 0 ? static_cast<unsigned char>(160 + block) : 0;
+            }
+        }
+
+        MipSettings settings;
+        settings.isSRGB = true;
+        const std::vector<MipLevel> averaged = MipChain::generate(rgba.data(), size, size, 4, settings);
+        settings.alphaCoverageReference = 0.5f;
+        const std::vector<MipLevel> preserved = MipChain::generate(rgba.data(), size, size, 4, settings);
+
+        BR_CHECK(averaged.size() == 5 && preserved.size() == 5);
+        if(averaged.size() != 5 || preserved.size() != 5)
+            return;
+
+        const float coverage = MipChain::calculateAlphaCoverage(preserved[0], 0.5f);
+        BR_CHECK_NEAR(coverage, 0.25f, 0.001f);
+
+        // Averaged alpha 40...56 fails alpha test. Leaves disappear at distance.
+        BR_CHECK_NEAR(MipChain::calculateAlphaCoverage(averaged[1], 0.5f), 0.0f, 0.001f);
+        // Scaled alpha passes test in about same part of pixels as level 0. Alpha is rounded to 8 bit.
+        BR_CHECK_NEAR(MipChain::calculateAlphaCoverage(preserved[1], 0.5f), coverage, 0.1f);
+        for(const MipLevel& level : preserved)
+        {
+            BR_CHECK_NEAR(MipChain::calculateAlphaCoverage(level, 0.5f), coverage, 0.25f);
+        }
+
+        // Without alpha channel coverage is not calculated.
+        const std::vector<unsigned char> rgb(size * size * 3, 255);
+        const std::vector<MipLevel> opaque = MipChain::generate(rgb.data(), size, size, 3, settings);
+        BR_CHECK(MipChain::calculateAlphaCoverage(opaque[0], 0.5f) == 0.0f);
+        BR_CHECK(opaque.back().pixels == std::vector<unsigned char>({255, 255, 255}));
+    }
+
+    void testChannelsToKeep()
+    {
+        const std::vector<unsigned char> gray{10, 10, 10, 255,  200, 200, 200, 255};
+        const std::vector<unsigned char> color{10, 20, 30, 255,  200, 200, 200, 255};
+        const std::vector<unsigned char> transparent{10, 10, 10, 255,  200, 200, 200, 254};
+
+        // Gray only for one byte per pixel sources. RGB images with gray pixels stay RGB.
+        BR_CHECK(MipChain::getChannelsToKeep(gray.data(), 2, true, false) == 1);
+        BR_CHECK(MipChain::getChannelsToKeep(gray.data(), 2, false, false) == 3);
+        BR_CHECK(MipChain::getChannelsToKeep(gray.data(), 2, true, true) == 3); // Normal map needs 3 channels.
+        BR_CHECK(MipChain::getChannelsToKeep(color.data(), 2, true, false) == 3);
+        BR_CHECK(MipChain::getChannelsToKeep(transparent.data(), 2, true, false) == 4);
+
+        BR_CHECK(MipChain::packChannels(color.data(), 2, 1) == std::vector<unsigned char>({10, 200}));
+        BR_CHECK(MipChain::packChannels(color.data(), 2, 3) == std::vector<unsigned char>({10, 20, 30, 200, 200, 200}));
+    }
+}
+
+int main()
+{
+    testLevelSizes();
+    testSRGBAveraging();
+    testTransparentPixelsDoNotDarken();
+    testNormalRenormalization();
+    testAlphaCoverage();
+    testChannelsToKeep();
+
+    return getTestResult("MipChainTest");
+}
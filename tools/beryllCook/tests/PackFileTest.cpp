@@ -0,0 +1,187 @@
+// Pack file written by beryllCook and read by engine: writePack() -> mount() -> FileView::open().
+
+#include "TestCheck.h"
+
+#include "beryll/utils/PackFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <random>
+
+namespace
+{
+    using namespace BeryllUtils;
+
+    // Header and entry layout of pack. See PackFile.h.
+    constexpr size_t headerEntriesOffset = 16;
+    constexpr size_t entrySize = 48;
+    constexpr size_t entryOffsetField = 8;
+    constexpr size_t entryBlockCountField = 40;
+
+    void writeFile(const std::string& path, const std::vector<char>& data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::vector<char> readFile(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        std::vector<char> data(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(data.data(), static_cast<std::streamsize>(data.size()));
+        return data;
+    }
+
+    template<typename T>
+    T readValue(const std::vector<char>& data, size_t offset)
+    {
+        T value{};
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        return value;
+    }
+
+    bool getIsSame(const FileView& view, const std::vector<char>& data)
+    {
+        return view.getSize() == data.size() && (data.empty() || std::memcmp(view.getData(), data.data(), data.size()) == 0);
+    }
+
+    struct TestFiles
+    {
+        std::vector<char> random; // Stored. LZ4 can not make it smaller.
+        std::vector<char> text; // Compressed. Several blocks.
+        std::vector<char> empty;
+    };
+
+    TestFiles makeFiles()
+    {
+        TestFiles files;
+        std::mt19937 generator(7);
+        files.random.resize(100 * 1024);
+        for(char& c : files.random)
+        {
+            c = static_cast<char>(generator() & 0xFF);
+        }
+
+        const std::string line = "material diffuse textures/ground.png specular textures/ground_spec.png\n";
+        while(files.text.size() < 3 * PackFile::blockSize + 1000)
+        {
+            files.text.insert(files.text.end(), line.begin(), line.end());
+        }
+
+        writeFile("PackFileTest_random.bin", files.random);
+        writeFile("PackFileTest_text.txt", files.text);
+        writeFile("PackFileTest_empty.txt", files.empty);
+        return files;
+    }
+
+    bool writeTestPack(const std::string& packPath)
+    {
+        return PackFile::writePack({{"models/random.bin", "PackFileTest_random.bin"},
+                                    {"models/text.txt", "PackFileTest_text.txt"},
+                                    {"empty.txt", "PackFileTest_empty.txt"}}, packPath);
+    }
+
+    void testRoundTrip(const TestFiles& files)
+    {
+        const std::string packPath = "PackFileTest.bpak";
+        BR_CHECK(writeTestPack(packPath));
+        BR_CHECK(PackFile::mount(packPath));
+
+        BR_CHECK(PackFile::contains("models/random.bin"));
+        BR_CHECK(PackFile::contains("models/text.txt"));
+        BR_CHECK(!PackFile::contains("models/missing.bin"));
+        BR_CHECK(!PackFile::contains("models/random.bin2"));
+
+        {
+            FileView random;
+            BR_CHECK(random.open("models/random.bin"));
+            BR_CHECK(getIsSame(random, files.random));
+
+            FileView text;
+            BR_CHECK(text.open("models/text.txt"));
+            BR_CHECK(getIsSame(text, files.text));
+
+            FileView empty;
+            BR_CHECK(empty.open("empty.txt"));
+            BR_CHECK(empty.getSize() == 0);
+
+            // Not in pack. Read from disk.
+            FileView disk;
+            BR_CHECK(disk.open("PackFileTest_text.txt"));
+            BR_CHECK(getIsSame(disk, files.text));
+        }
+
+        PackFile::unmountAll();
+        BR_CHECK(!PackFile::contains("models/text.txt"));
+
+        // Both stored and compressed entries were written.
+        const std::vector<char> pack = readFile(packPath);
+        const uint64_t entriesOffset = readValue<uint64_t>(pack, headerEntriesOffset);
+        const uint32_t entryCount = readValue<uint32_t>(pack, 8);
+        BR_CHECK(entryCount == 3);
+        uint32_t compressedCount = 0;
+        for(uint32_t i = 0; i < entryCount; ++i)
+        {
+            if(readValue<uint32_t>(pack, entriesOffset + i * entrySize + entryBlockCountField) != 0)
+                ++compressedCount;
+        }
+        BR_CHECK(compressedCount == 1);
+        BR_CHECK(pack.size() < files.random.size() + files.text.size() / 2);
+
+        std::remove(packPath.c_str());
+    }
+
+    void testDamaged(const TestFiles& files)
+    {
+        const std::string packPath = "PackFileTest_damaged.bpak";
+        BR_CHECK(writeTestPack(packPath));
+
+        // Size of first block of compressed entry becomes 0. Block can not be decompressed.
+        std::vector<char> pack = readFile(packPath);
+        const uint64_t entriesOffset = readValue<uint64_t>(pack, headerEntriesOffset);
+        for(uint32_t i = 0; i < 3; ++i)
+        {
+            const size_t entry = entriesOffset + i * entrySize;
+            if(readValue<uint32_t>(pack, entry + entryBlockCountField) != 0)
+            {
+                const uint64_t offset = readValue<uint64_t>(pack, entry + entryOffsetField);
+                std::memset(pack.data() + offset, 0, sizeof(uint32_t));
+            }
+        }
+        writeFile(packPath, pack);
+
+        BR_CHECK(PackFile::mount(packPath));
+        FileView view;
+        BR_CHECK(!PackFile::open("models/text.txt", view));
+        // Other entries are still readable.
+        BR_CHECK(PackFile::open("models/random.bin", view));
+        BR_CHECK(getIsSame(view, files.random));
+        view.close();
+        PackFile::unmountAll();
+
+        // Not a pack.
+        BR_CHECK(!PackFile::mount("PackFileTest_text.txt"));
+        // Truncated: entries are outside of file.
+        pack.resize(pack.size() / 2);
+        writeFile(packPath, pack);
+        BR_CHECK(!PackFile::mount(packPath));
+        PackFile::unmountAll();
+
+        std::remove(packPath.c_str());
+    }
+}
+
+int main()
+{
+    const TestFiles files = makeFiles();
+    testRoundTrip(files);
+    testDamaged(files);
+
+    for(const char* path : {"PackFileTest_random.bin", "PackFileTest_text.txt", "PackFileTest_empty.txt"})
+    {
+        std::remove(path);
+    }
+
+    return getTestResult("PackFileTest");
+}
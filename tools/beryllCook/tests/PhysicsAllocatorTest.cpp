@@ -0,0 +1,202 @@
+// PhysicsAllocator under parallel allocations (Bullet tasks, AsyncRun) and spawn/despawn of physics bodies.
+// Prints timings. Checks that all blocks return and memory does not grow between spawn cycles.
+
+#include "TestCheck.h"
+
+#include "beryll/physics/Physics.h"
+#include "beryll/physics/PhysicsAllocator.h"
+#include "beryll/utils/CommonUtils.h"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <thread>
+
+namespace Beryll
+{
+    struct PhysicsTestAccess
+    {
+    public:
+        static int64_t getLiveCount()
+        {
+            int64_t count = 0;
+            for(const PhysicsAllocator::SizeClassStats& st : PhysicsAllocator::getStats())
+            {
+                count += st.liveCount;
+            }
+            return count;
+        }
+
+        static int64_t getReservedBytes()
+        {
+            int64_t bytes = 0;
+            for(const PhysicsAllocator::SizeClassStats& st : PhysicsAllocator::getStats())
+            {
+                if(st.blockSize != 0)
+                    bytes += st.reservedBytes;
+            }
+            return bytes;
+        }
+
+        // Every thread allocates blocks of all size classes (mostly small like Bullet) and frees them in random order.
+        // Some blocks are freed by other thread like shapes removed after AsyncRun task ended.
+        template<typename AllocateFunc, typename FreeFunc>
+        static double runThreads(AllocateFunc allocateFunc, FreeFunc freeFunc, bool checkContent)
+        {
+            constexpr int threadsCount = 8;
+            constexpr int iterations = 200000;
+            constexpr int liveBlocks = 256;
+
+            std::vector<std::vector<void*>> passed(threadsCount);
+            std::atomic<int> contentErrors{0};
+
+            const auto start = std::chrono::steady_clock::now();
+            std::vector<std::thread> threads;
+            for(int t = 0; t < threadsCount; ++t)
+            {
+                threads.emplace_back([&, t]()
+                {
+                    std::mt19937 generator(static_cast<uint32_t>(t + 1));
+                    std::vector<std::pair<void*, size_t>> blocks(liveBlocks, {nullptr, 0});
+                    for(int i = 0; i < iterations; ++i)
+                    {
+                        std::pair<void*, size_t>& slot = blocks[generator() % liveBlocks];
+                        if(slot.first)
+                        {
+                            if(checkContent && static_cast<unsigned char*>(slot.first)[slot.second - 1] != static_cast<unsigned char>(slot.second))
+                                ++contentErrors;
+
+                            if(i % 32 == 0)
+                                passed[t].push_back(slot.first);
+                            else
+                                freeFunc(slot.first);
+                        }
+
+                        slot.second = 8 + generator() % (i % 8 == 0 ? 4000 : 240);
+                        slot.first = allocateFunc(slot.second);
+                        std::memset(slot.first, static_cast<int>(slot.second & 0xFF), slot.second);
+                    }
+
+                    for(const std::pair<void*, size_t>& slot : blocks)
+                    {
+                        freeFunc(slot.first);
+                    }
+                });
+            }
+            for(std::thread& thread : threads)
+            {
+                thread.join();
+            }
+
+            // Freed by other threads.
+            std::vector<std::thread> freeThreads;
+            for(int t = 0; t < threadsCount; ++t)
+            {
+                freeThreads.emplace_back([&, t]()
+                {
+                    for(void* block : passed[(t + 1) % threadsCount])
+                    {
+                        freeFunc(block);
+                    }
+                });
+            }
+            for(std::thread& thread : freeThreads)
+            {
+                thread.join();
+            }
+
+            BR_CHECK(contentErrors == 0);
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        static void testThreads()
+        {
+            const int64_t liveCountBefore = getLiveCount();
+
+            const double poolTime = runThreads([](size_t size) { return PhysicsAllocator::allocate(size); },
+                                               [](void* ptr) { PhysicsAllocator::deallocate(ptr); }, true);
+            // Threads ended. Their magazines are back in pool.
+            BR_CHECK(getLiveCount() == liveCountBefore);
+
+            const int64_t reservedBytes = getReservedBytes();
+            const double secondPoolTime = runThreads([](size_t size) { return PhysicsAllocator::allocate(size); },
+                                                     [](void* ptr) { PhysicsAllocator::deallocate(ptr); }, true);
+            BR_CHECK(getLiveCount() == liveCountBefore);
+            // Blocks returned by ended threads are reused. Magazines can take blocks in other order, so pool grows by few chunks at most.
+            BR_CHECK(getReservedBytes() <= reservedBytes + reservedBytes / 20);
+
+            const double mallocTime = runThreads([](size_t size) { return std::malloc(size); },
+                                                 [](void* ptr) { std::free(ptr); }, false);
+
+            std::printf("8 threads x 200000 allocations: PhysicsAllocator %.1f ms (warm pool %.1f ms), malloc %.1f ms\n",
+                        poolTime, secondPoolTime, mallocTime);
+        }
+
+        // Same bodies as projectiles or debris: added, simulated few frames, removed.
+        static void testSpawnDespawn()
+        {
+            Physics::create();
+
+            const std::vector<glm::vec3> boxVertices{{-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f}, {0.5f, 0.5f, -0.5f},
+                                                     {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}};
+            const std::vector<uint32_t> boxIndices{0, 1, 2, 3, 4, 5, 6, 7};
+
+            constexpr int cycles = 10;
+            constexpr int bodiesCount = 2000;
+            int64_t liveCountAfterFirstCycle = 0;
+            int64_t reservedBytesAfterFirstCycle = 0;
+            double spawnTime = 0.0;
+            double simulateTime = 0.0;
+            double despawnTime = 0.0;
+            for(int cycle = 0; cycle < cycles; ++cycle)
+            {
+                auto start = std::chrono::steady_clock::now();
+                for(int i = 0; i < bodiesCount; ++i)
+                {
+                    const glm::vec3 position(static_cast<float>(i % 50) * 2.0f, static_cast<float>(i / 50) * 2.0f, 0.0f);
+                    Physics::addObject(boxVertices, boxIndices, glm::translate(glm::mat4{1.0f}, position), "DebrisCollisionBox",
+                                       BeryllUtils::Common::generateID(), 1.0f, false, CollisionFlags::DYNAMIC,
+                                       CollisionGroups::DYNAMIC_ENVIRONMENT, CollisionGroups::DYNAMIC_ENVIRONMENT);
+                }
+                spawnTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                start = std::chrono::steady_clock::now();
+                for(int frame = 0; frame < 5; ++frame)
+                {
+                    Physics::simulate();
+                }
+                simulateTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                start = std::chrono::steady_clock::now();
+                Physics::hardRemoveAllObjects();
+                despawnTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+                if(cycle == 0)
+                {
+                    liveCountAfterFirstCycle = getLiveCount();
+                    reservedBytesAfterFirstCycle = getReservedBytes();
+                }
+            }
+
+            // Nothing leaks between cycles. Pool reuses blocks of removed bodies.
+            BR_CHECK(getLiveCount() == liveCountAfterFirstCycle);
+            BR_CHECK(getReservedBytes() <= reservedBytesAfterFirstCycle + reservedBytesAfterFirstCycle / 20);
+
+            std::printf("Spawn/despawn %d bodies, average of %d cycles: add %.2f ms, simulate 5 frames %.2f ms, remove %.2f ms\n",
+                        bodiesCount, cycles, spawnTime / cycles, simulateTime / cycles, despawnTime / cycles);
+        }
+
+        static int run()
+        {
+            testThreads();
+            testSpawnDespawn();
+
+            return getTestResult("PhysicsAllocatorTest");
+        }
+    };
+}
+
+int main()
+{
+    return Beryll::PhysicsTestAccess::run();
+}
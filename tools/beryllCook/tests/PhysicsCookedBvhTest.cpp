@@ -0,0 +1,175 @@
+// BVH of concave collision mesh cooked by beryllCook: Physics::serializeConcaveMeshBvh() -> .bmesh -> Physics::addObject().
+// Cooked BVH must give same ray hits as BVH built at runtime. Not matching BVH is ignored. Prints build and load times.
+
+#include "TestCheck.h"
+
+#include "beryll/physics/Physics.h"
+#include "beryll/physics/PhysicsAllocator.h"
+#include "beryll/utils/MeshFile.h"
+#include "beryll/utils/CommonUtils.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace Beryll
+{
+    struct PhysicsTestAccess
+    {
+    public:
+        // Bumpy ground. gridSize x gridSize quads, 2 triangles per quad.
+        static void makeGround(int gridSize, std::vector<glm::vec3>& vertices, std::vector<uint32_t>& indices)
+        {
+            vertices.clear();
+            indices.clear();
+            for(int z = 0; z <= gridSize; ++z)
+            {
+                for(int x = 0; x <= gridSize; ++x)
+                {
+                    const float height = std::sin(static_cast<float>(x) * 0.3f) * std::cos(static_cast<float>(z) * 0.2f) * 2.0f;
+                    vertices.emplace_back(static_cast<float>(x), height, static_cast<float>(z));
+                }
+            }
+            for(int z = 0; z < gridSize; ++z)
+            {
+                for(int x = 0; x < gridSize; ++x)
+                {
+                    const uint32_t corner = static_cast<uint32_t>(z * (gridSize + 1) + x);
+                    const uint32_t row = static_cast<uint32_t>(gridSize + 1);
+                    indices.insert(indices.end(), {corner, corner + row, corner + 1, corner + 1, corner + row, corner + row + 1});
+                }
+            }
+        }
+
+        static btBvhTriangleMeshShape* getShape(const int ID)
+        {
+            return static_cast<btBvhTriangleMeshShape*>(Physics::m_rigidBodiesMap.at(ID)->rb->getCollisionShape());
+        }
+
+        static int addGround(const std::vector<glm::vec3>& vertices, const std::vector<uint32_t>& indices, const glm::vec3& position,
+                             const std::vector<char>& serializedBvh)
+        {
+            const int ID = BeryllUtils::Common::generateID();
+            Physics::addObject(vertices, indices, glm::translate(glm::mat4{1.0f}, position), "GroundCollisionConcaveMesh", ID, 0.0f, false,
+                               CollisionFlags::STATIC, CollisionGroups::GROUND, CollisionGroups::PLAYER_BULLET, serializedBvh);
+            return ID;
+        }
+
+        // Rays down on grid of points. Both grounds must be hit at same height.
+        static void checkSameHits(const int cookedID, const glm::vec3& cookedPosition, const int builtID, const glm::vec3& builtPosition, int gridSize)
+        {
+            int hitsCount = 0;
+            for(float z = 0.25f; z < static_cast<float>(gridSize); z += 1.37f)
+            {
+                for(float x = 0.25f; x < static_cast<float>(gridSize); x += 1.37f)
+                {
+                    const RayClosestHit cookedHit = Physics::castRayClosestHit(cookedPosition + glm::vec3(x, 10.0f, z), cookedPosition + glm::vec3(x, -10.0f, z),
+                                                                               CollisionGroups::PLAYER_BULLET, CollisionGroups::GROUND);
+                    const RayClosestHit builtHit = Physics::castRayClosestHit(builtPosition + glm::vec3(x, 10.0f, z), builtPosition + glm::vec3(x, -10.0f, z),
+                                                                              CollisionGroups::PLAYER_BULLET, CollisionGroups::GROUND);
+                    BR_CHECK(cookedHit && builtHit);
+                    if(!cookedHit || !builtHit)
+                        continue;
+
+                    BR_CHECK(cookedHit.hittedObjectID == cookedID);
+                    BR_CHECK(builtHit.hittedObjectID == builtID);
+                    BR_CHECK_NEAR(cookedHit.hitPoint.y - cookedPosition.y, builtHit.hitPoint.y - builtPosition.y, 0.0001f);
+                    ++hitsCount;
+                }
+            }
+            BR_CHECK(hitsCount > 100);
+        }
+
+        static int run()
+        {
+            constexpr int gridSize = 200;
+            std::vector<glm::vec3> vertices;
+            std::vector<uint32_t> indices;
+            makeGround(gridSize, vertices, indices);
+
+            // Cooker side.
+            auto start = std::chrono::steady_clock::now();
+            const std::vector<char> serializedBvh = Physics::serializeConcaveMeshBvh(vertices, indices);
+            const double cookTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            BR_CHECK(!serializedBvh.empty());
+
+            BeryllUtils::MeshData mesh;
+            mesh.name = "GroundCollisionConcaveMesh";
+            mesh.isCollision = true;
+            mesh.vertices = vertices;
+            mesh.indices = indices;
+            mesh.collisionBvh = serializedBvh;
+            const std::string meshFilePath = "PhysicsCookedBvhTest.bmesh";
+            BR_CHECK(BeryllUtils::MeshFile::writeMeshFile({mesh}, meshFilePath));
+
+            // Runtime side.
+            const BeryllUtils::LoadedModel model = BeryllUtils::MeshFile::loadModel(meshFilePath);
+            BR_CHECK(model.meshes.size() == 1);
+            if(model.meshes.size() != 1)
+                return getTestResult("PhysicsCookedBvhTest");
+
+            const BeryllUtils::MeshView& view = model.meshes[0];
+            BR_CHECK(view.isCollision);
+            BR_CHECK(view.collisionBvhSize == serializedBvh.size());
+            BR_CHECK(view.collisionBvh && std::memcmp(view.collisionBvh, serializedBvh.data(), serializedBvh.size()) == 0);
+            const std::vector<char> loadedBvh(view.collisionBvh, view.collisionBvh + view.collisionBvhSize);
+
+            Physics::create();
+
+            const glm::vec3 cookedPosition(0.0f);
+            const glm::vec3 builtPosition(1000.0f, 0.0f, 0.0f);
+
+            start = std::chrono::steady_clock::now();
+            const int builtID = addGround(vertices, indices, builtPosition, {});
+            const double buildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            // Batch add keeps cooked BVH in pending object until endAddBatch().
+            start = std::chrono::steady_clock::now();
+            Physics::beginAddBatch(1);
+            const int cookedID = addGround(vertices, indices, cookedPosition, loadedBvh);
+            Physics::endAddBatch();
+            const double loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            BR_CHECK(Physics::m_concaveMeshBvhs.size() == 1);
+            BR_CHECK(getShape(cookedID)->getOptimizedBvh() == Physics::m_concaveMeshBvhs[0].get());
+            BR_CHECK(getShape(builtID)->getOptimizedBvh() != nullptr);
+            checkSameHits(cookedID, cookedPosition, builtID, builtPosition, gridSize);
+
+            // BVH of other mesh (different triangle count) and BVH cooked for other platform are ignored. BVH is built.
+            std::vector<glm::vec3> smallVertices;
+            std::vector<uint32_t> smallIndices;
+            makeGround(gridSize / 2, smallVertices, smallIndices);
+            const int otherMeshID = addGround(smallVertices, smallIndices, glm::vec3(0.0f, 0.0f, 1000.0f), loadedBvh);
+
+            std::vector<char> otherPlatformBvh = loadedBvh;
+            const uint32_t otherClassSize = sizeof(btQuantizedBvh) + 8;
+            std::memcpy(otherPlatformBvh.data() + sizeof(uint32_t), &otherClassSize, sizeof(uint32_t));
+            const glm::vec3 otherPlatformPosition(-1000.0f, 0.0f, 0.0f);
+            const int otherPlatformID = addGround(vertices, indices, otherPlatformPosition, otherPlatformBvh);
+
+            // Too short.
+            const int damagedID = addGround(vertices, indices, glm::vec3(0.0f, 0.0f, -1000.0f), std::vector<char>(loadedBvh.begin(), loadedBvh.begin() + 8));
+
+            BR_CHECK(Physics::m_concaveMeshBvhs.size() == 1);
+            BR_CHECK(getShape(otherMeshID)->getOptimizedBvh() != nullptr);
+            BR_CHECK(getShape(damagedID)->getOptimizedBvh() != nullptr);
+            checkSameHits(otherPlatformID, otherPlatformPosition, builtID, builtPosition, gridSize);
+
+            Physics::hardRemoveAllObjects();
+            BR_CHECK(Physics::m_concaveMeshBvhs.empty());
+            BR_CHECK(!Physics::castRayClosestHit(glm::vec3(5.0f, 10.0f, 5.0f), glm::vec3(5.0f, -10.0f, 5.0f),
+                                                 CollisionGroups::PLAYER_BULLET, CollisionGroups::GROUND));
+
+            std::printf("Concave mesh %d triangles, BVH %d bytes: cook %.2f ms, add with BVH build %.2f ms, add with cooked BVH %.2f ms\n",
+                        int(indices.size() / 3), int(serializedBvh.size()), cookTime, buildTime, loadTime);
+
+            std::remove(meshFilePath.c_str());
+
+            return getTestResult("PhysicsCookedBvhTest");
+        }
+    };
+}
+
+int main()
+{
+    return Beryll::PhysicsTestAccess::run();
+}
@@ -0,0 +1,88 @@
+// Static concave colliders merged in one body (SimpleCollidingObject with mergeCellSize > 0)
+// must be reported with IDs of original objects by all queries.
+
+#include "TestCheck.h"
+
+#include "beryll/physics/Physics.h"
+#include "beryll/utils/CommonUtils.h"
+
+#include <chrono>
+#include <thread>
+
+namespace Beryll
+{
+    // Physics is created and simulated by GameLoop. Test plays its role.
+    struct PhysicsTestAccess
+    {
+    public:
+        static int run()
+        {
+            Physics::create();
+
+            // Two ground objects side by side. X: -10...0 and 0...10.
+            const int leftGroundID = BeryllUtils::Common::generateID();
+            const int rightGroundID = BeryllUtils::Common::generateID();
+            const std::vector<glm::vec3> groundVertices{{-10.0f, 0.0f, -10.0f}, {-10.0f, 0.0f, 10.0f}, {0.0f, 0.0f, 10.0f}, {0.0f, 0.0f, -10.0f},
+                                                        {0.0f, 0.0f, -10.0f}, {0.0f, 0.0f, 10.0f}, {10.0f, 0.0f, 10.0f}, {10.0f, 0.0f, -10.0f}};
+            const std::vector<uint32_t> groundIndices{0, 1, 2, 0, 2, 3,
+                                                      4, 5, 6, 4, 6, 7};
+            const int mergedID = Physics::addMergedStaticConcaveMesh(groundVertices, groundIndices,
+                                                                     {leftGroundID, leftGroundID, rightGroundID, rightGroundID}, false,
+                                                                     CollisionGroups::GROUND, CollisionGroups::PLAYER | CollisionGroups::JUMPPAD);
+            // Ground did not ask for collision callback. Contacts are still reported because character asked.
+            BR_CHECK((Physics::m_rigidBodiesMap.at(mergedID)->rb->getCollisionFlags() & btCollisionObject::CF_CUSTOM_MATERIAL_CALLBACK) == 0);
+
+            // Character above right ground.
+            const int characterID = BeryllUtils::Common::generateID();
+            const std::vector<glm::vec3> boxVertices{{-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f}, {0.5f, 0.5f, -0.5f},
+                                                     {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}};
+            const std::vector<uint32_t> boxIndices{0, 1, 2, 3, 4, 5, 6, 7};
+            Physics::addObject(boxVertices, boxIndices, glm::translate(glm::mat4{1.0f}, glm::vec3(5.0f, 0.6f, 0.0f)), "CharacterCollisionBox",
+                               characterID, 1.0f, true, CollisionFlags::DYNAMIC, CollisionGroups::PLAYER, CollisionGroups::GROUND);
+
+            // Trigger on left ground only.
+            const int triggerID = Physics::addTriggerBox(glm::vec3(1.0f), glm::translate(glm::mat4{1.0f}, glm::vec3(-5.0f, 0.0f, 0.0f)),
+                                                         CollisionGroups::JUMPPAD, CollisionGroups::GROUND);
+
+            bool isOnGround = false;
+            for(int i = 0; i < 120 && !isOnGround; ++i)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(16));
+                Physics::simulate();
+                isOnGround = Physics::getIsCollisionWithGroup(characterID, CollisionGroups::GROUND);
+            }
+
+            // Same queries as CharacterController.
+            BR_CHECK(isOnGround);
+            BR_CHECK(Physics::getIsCollision(characterID, rightGroundID));
+            BR_CHECK(!Physics::getIsCollision(characterID, leftGroundID));
+            BR_CHECK(!Physics::getIsCollision(characterID, mergedID));
+
+            const std::vector<int> collidingIDs = Physics::getAllCollisionsForIDWithGroup(characterID, CollisionGroups::GROUND);
+            BR_CHECK(collidingIDs.size() == 1 && collidingIDs[0] == rightGroundID);
+            BR_CHECK(Physics::getAllCollisionsForIDWithGroup(characterID, CollisionGroups::BUILDING).empty());
+
+            const std::vector<std::pair<glm::vec3, glm::vec3>> points = Physics::getAllCollisionPoints(characterID, collidingIDs);
+            BR_CHECK(!points.empty());
+            for(const std::pair<glm::vec3, glm::vec3>& point : points)
+            {
+                BR_CHECK_NEAR(std::abs(point.second.y), 1.0f, 0.01f);
+            }
+            BR_CHECK(Physics::getAllCollisionPoints(characterID, rightGroundID).size() == points.size());
+            BR_CHECK(Physics::getAllCollisionPoints(characterID, leftGroundID).empty());
+
+            const std::vector<int>& overlappingIDs = Physics::getTriggerOverlapping(triggerID);
+            BR_CHECK(overlappingIDs.size() == 1 && overlappingIDs[0] == leftGroundID);
+
+            Physics::hardRemoveAllObjects();
+            BR_CHECK(!Physics::getIsCollisionWithGroup(characterID, CollisionGroups::GROUND));
+
+            return getTestResult("PhysicsMergedMeshTest");
+        }
+    };
+}
+
+int main()
+{
+    return Beryll::PhysicsTestAccess::run();
+}
@@ -0,0 +1,147 @@
+// 20000 projectiles at 60 Hz without window. Same order as GameLoop: TimeStep, Physics, ProjectileSystem.
+// Prints ProjectileSystem::getUpdateTime(). Checks that hits are reported with IDs of hitted objects.
+
+#include "TestCheck.h"
+
+#include "beryll/physics/ProjectileSystem.h"
+#include "beryll/core/TimeStep.h"
+#include "beryll/utils/CommonUtils.h"
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+namespace Beryll
+{
+    struct PhysicsTestAccess
+    {
+    public:
+        static int run()
+        {
+            Physics::create();
+            ProjectileSystem::create();
+
+            // Ground 400 x 400 m from 40 x 40 tiles (3200 triangles).
+            const int groundID = BeryllUtils::Common::generateID();
+            std::vector<glm::vec3> groundVertices;
+            std::vector<uint32_t> groundIndices;
+            constexpr int tiles = 40;
+            constexpr float tileSize = 10.0f;
+            for(int z = 0; z <= tiles; ++z)
+            {
+                for(int x = 0; x <= tiles; ++x)
+                {
+                    groundVertices.emplace_back((static_cast<float>(x) - tiles * 0.5f) * tileSize, 0.0f, (static_cast<float>(z) - tiles * 0.5f) * tileSize);
+                }
+            }
+            for(uint32_t z = 0; z < tiles; ++z)
+            {
+                for(uint32_t x = 0; x < tiles; ++x)
+                {
+                    const uint32_t i = z * (tiles + 1) + x;
+                    groundIndices.insert(groundIndices.end(), {i, i + tiles + 1, i + tiles + 2, i, i + tiles + 2, i + 1});
+                }
+            }
+            Physics::addObject(groundVertices, groundIndices, glm::mat4{1.0f}, "GroundCollisionConcaveMesh", groundID,
+                               0.0f, false, CollisionFlags::STATIC, CollisionGroups::GROUND, CollisionGroups::PLAYER_BULLET);
+
+            // Walls around shooter.
+            const std::vector<glm::vec3> wallVertices{{-2.0f, 0.0f, -0.5f}, {2.0f, 0.0f, -0.5f}, {-2.0f, 4.0f, -0.5f}, {2.0f, 4.0f, -0.5f},
+                                                      {-2.0f, 0.0f, 0.5f}, {2.0f, 0.0f, 0.5f}, {-2.0f, 4.0f, 0.5f}, {2.0f, 4.0f, 0.5f}};
+            const std::vector<uint32_t> wallIndices{0, 1, 2, 3, 4, 5, 6, 7};
+            std::vector<int> wallIDs;
+            for(int i = 0; i < 16; ++i)
+            {
+                const float angle = static_cast<float>(i) * glm::two_pi<float>() / 16.0f;
+                const glm::mat4 transforms = glm::translate(glm::mat4{1.0f}, glm::vec3(std::cos(angle) * 30.0f, 0.0f, std::sin(angle) * 30.0f)) *
+                                             glm::rotate(glm::mat4{1.0f}, -angle + glm::half_pi<float>(), glm::vec3(0.0f, 1.0f, 0.0f));
+                wallIDs.push_back(BeryllUtils::Common::generateID());
+                Physics::addObject(wallVertices, wallIndices, transforms, "WallCollisionBox", wallIDs.back(),
+                                   0.0f, false, CollisionFlags::STATIC, CollisionGroups::BUILDING, CollisionGroups::PLAYER_BULLET);
+            }
+
+            // Shooter stands inside ray start points. Its own hits are filtered by ownerID.
+            const int shooterID = BeryllUtils::Common::generateID();
+            const std::vector<glm::vec3> shooterVertices{{-0.5f, 0.0f, -0.5f}, {0.5f, 0.0f, -0.5f}, {-0.5f, 2.0f, -0.5f}, {0.5f, 2.0f, -0.5f},
+                                                         {-0.5f, 0.0f, 0.5f}, {0.5f, 0.0f, 0.5f}, {-0.5f, 2.0f, 0.5f}, {0.5f, 2.0f, 0.5f}};
+            Physics::addObject(shooterVertices, wallIndices, glm::mat4{1.0f}, "ShooterCollisionBox", shooterID,
+                               0.0f, false, CollisionFlags::KINEMATIC, CollisionGroups::PLAYER, CollisionGroups::PLAYER_BULLET);
+
+            // Bullets (ray) and grenades (sphere sweep) in all directions.
+            std::mt19937 generator(5);
+            std::uniform_real_distribution<float> angleDistribution(0.0f, glm::two_pi<float>());
+            std::uniform_real_distribution<float> pitchDistribution(-0.1f, 0.3f);
+            constexpr int projectilesCount = 20000;
+            const CollisionGroups mask = CollisionGroups::GROUND | CollisionGroups::BUILDING | CollisionGroups::PLAYER;
+            int spawnedCount = 0;
+            const auto spawn = [&]()
+            {
+                const bool isGrenade = spawnedCount++ % 10 == 0;
+                const float yaw = angleDistribution(generator);
+                const float pitch = pitchDistribution(generator);
+                const glm::vec3 direction(std::cos(yaw) * std::cos(pitch), std::sin(pitch), std::sin(yaw) * std::cos(pitch));
+                return ProjectileSystem::spawn(glm::vec3(0.0f, 1.0f, 0.0f), direction * (isGrenade ? 20.0f : 200.0f), glm::vec3(0.0f, -9.81f, 0.0f),
+                                               5.0f, isGrenade ? 0.1f : 0.0f, shooterID, CollisionGroups::PLAYER_BULLET, mask);
+            };
+
+            TimeStep::fixateTime();
+            auto frameStart = std::chrono::steady_clock::now();
+            constexpr auto frameTime = std::chrono::microseconds(16667);
+            constexpr int framesCount = 180;
+            float updateTimeSum = 0.0f;
+            float updateTimeMax = 0.0f;
+            int groundHits = 0;
+            int wallHits = 0;
+            int wrongHits = 0;
+            for(int frame = 0; frame < framesCount; ++frame)
+            {
+                while(ProjectileSystem::getActiveCount() < projectilesCount)
+                {
+                    spawn();
+                }
+                BR_CHECK(spawn() == -1); // Max count is 20000.
+
+                frameStart += frameTime;
+                std::this_thread::sleep_until(frameStart);
+                TimeStep::fixateTime();
+                Physics::simulate();
+                ProjectileSystem::update();
+
+                // First frame includes AsyncRun threads start. Not counted.
+                if(frame > 0)
+                {
+                    updateTimeSum += ProjectileSystem::getUpdateTime();
+                    updateTimeMax = std::max(updateTimeMax, ProjectileSystem::getUpdateTime());
+                }
+
+                for(const ProjectileHit& hit : ProjectileSystem::getHits())
+                {
+                    if(hit.hittedObjectID == groundID && hit.hittedCollGroup == CollisionGroups::GROUND)
+                        ++groundHits;
+                    else if(std::find(wallIDs.begin(), wallIDs.end(), hit.hittedObjectID) != wallIDs.end())
+                        ++wallHits;
+                    else
+                        ++wrongHits;
+                }
+            }
+
+            BR_CHECK(groundHits > 0);
+            BR_CHECK(wallHits > 0);
+            BR_CHECK(wrongHits == 0); // Shooter never hits itself.
+
+            std::printf("%d projectiles at 60 Hz, %d frames: update %.2f ms average, %.2f ms max. Hits: ground %d, walls %d\n",
+                        projectilesCount, framesCount, updateTimeSum / static_cast<float>(framesCount - 1), updateTimeMax, groundHits, wallHits);
+
+            ProjectileSystem::removeAll();
+            BR_CHECK(ProjectileSystem::getActiveCount() == 0);
+            Physics::hardRemoveAllObjects();
+
+            return getTestResult("ProjectileSystemTest");
+        }
+    };
+}
+
+int main()
+{
+    return Beryll::PhysicsTestAccess::run();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal checks for host tests. Test executable returns number of failed checks (0 = passed).
+inline int& getFailedChecksCount()
+{
+    static int failedChecksCount = 0;
+    return failedChecksCount;
+}
+
+#define BR_CHECK(condition) \
+    do \
+    { \
+        if(!(condition)) \
+        { \
+            std::printf("%s:%d check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++getFailedChecksCount(); \
+        } \
+    } while(false)
+
+#define BR_CHECK_NEAR(a, b, epsilon) \
+    do \
+    { \
+        const double checkA = static_cast<double>(a); \
+        const double checkB = static_cast<double>(b); \
+        if(!(checkA - checkB <= (epsilon) && checkB - checkA <= (epsilon))) \
+        { \
+            std::printf("%s:%d check failed: %s = %f, %s = %f\n", __FILE__, __LINE__, #a, checkA, #b, checkB); \
+            ++getFailedChecksCount(); \
+        } \
+    } while(false)
+
+inline int getTestResult(const char* testName)
+{
+    std::printf("%s: %s\n", testName, getFailedChecksCount() == 0 ? "passed" : "FAILED");
+    return getFailedChecksCount();
+}
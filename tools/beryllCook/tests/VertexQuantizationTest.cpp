@@ -0,0 +1,136 @@
+// Compact vertex formats. Encoded on CPU, decode functions are CPU reference of shader code.
+
+#include "TestCheck.h"
+
+#include "beryll/utils/VertexQuantization.h"
+
+#include <cmath>
+
+namespace
+{
+    using namespace BeryllUtils;
+
+    // Directions covering all octants, poles and octahedron edges (z < 0 folding).
+    std::vector<glm::vec3> makeDirections()
+    {
+        std::vector<glm::vec3> directions{{1.0f, 0.0f, 0.0f}, {-1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, -1.0f, 0.0f},
+                                          {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, -1.0f}, {1.0f, 1.0f, 0.0f}, {-1.0f, 0.0f, -1.0f}};
+        for(int i = 0; i < 200; ++i)
+        {
+            // Fibonacci sphere.
+            const float z = 1.0f - (static_cast<float>(i) + 0.5f) / 100.0f;
+            const float radius = std::sqrt(std::max(1.0f - z * z, 0.0f));
+            const float angle = static_cast<float>(i) * 2.39996323f;
+            directions.emplace_back(radius * std::cos(angle), radius * std::sin(angle), z);
+        }
+        for(glm::vec3& direction : directions)
+        {
+            direction = glm::normalize(direction);
+        }
+        return directions;
+    }
+
+    void testOctahedral()
+    {
+        const std::vector<glm::vec3> directions = makeDirections();
+        float maxAngle = 0.0f;
+        for(const glm::vec3& direction : directions)
+        {
+            const glm::vec3 decoded = VertexQuantization::decodeOctahedral(VertexQuantization::encodeOctahedral(direction));
+            BR_CHECK_NEAR(glm::length(decoded), 1.0f, 0.0001f);
+            maxAngle = std::max(maxAngle, std::acos(std::min(glm::dot(decoded, direction), 1.0f)));
+        }
+        // 2 x 16 bit octahedral precision is about 0.005 degree.
+        BR_CHECK(maxAngle < 0.0002f);
+
+        // Normals and tangents of mesh. Not normalized and zero vectors are accepted.
+        std::vector<glm::vec3> meshDirections(directions.begin(), directions.begin() + 10);
+        meshDirections[1] *= 3.0f;
+        meshDirections[2] = glm::vec3(0.0f);
+        const std::vector<glm::i16vec2> encoded = VertexQuantization::encodeDirections(meshDirections.data(), static_cast<uint32_t>(meshDirections.size()));
+        BR_CHECK(encoded.size() == meshDirections.size());
+        for(size_t i = 0; i < encoded.size() && i < meshDirections.size(); ++i)
+        {
+            const glm::vec3 decoded = VertexQuantization::decodeOctahedral(encoded[i]);
+            const glm::vec3 expected = i == 2 ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::normalize(meshDirections[i]);
+            BR_CHECK(glm::dot(decoded, expected) > 0.99999f);
+        }
+    }
+
+    void testPositions()
+    {
+        // Bounds: x -50...150, y 2...2 (flat), z -0.5...0.25.
+        const std::vector<glm::vec3> positions{{-50.0f, 2.0f, 0.0f}, {150.0f, 2.0f, -0.5f}, {12.345f, 2.0f, 0.25f}, {0.001f, 2.0f, 0.1f}};
+
+        for(const VertexFormat format : {VertexFormat::COMPACT_SNORM16, VertexFormat::COMPACT_HALF})
+        {
+            glm::vec3 scale;
+            glm::vec3 bias;
+            const std::vector<glm::u16vec4> encoded = VertexQuantization::encodePositions(positions.data(), static_cast<uint32_t>(positions.size()),
+                                                                                            format, scale, bias);
+            BR_CHECK(encoded.size() == positions.size());
+            BR_CHECK_NEAR(scale.x, 100.0f, 0.0001f);
+            BR_CHECK_NEAR(bias.x, 50.0f, 0.0001f);
+            BR_CHECK_NEAR(bias.y, 2.0f, 0.0001f);
+            BR_CHECK(scale.y > 0.0f);
+            BR_CHECK_NEAR(scale.z, 0.375f, 0.0001f);
+            BR_CHECK_NEAR(bias.z, -0.125f, 0.0001f);
+
+            // Step of snorm16 is 1 / 32767 of half size. Half float has 11 bits of mantissa.
+            const glm::vec3 tolerance = scale * (format == VertexFormat::COMPACT_SNORM16 ? 1.0f / 32767.0f : 1.0f / 1024.0f);
+            for(size_t i = 0; i < encoded.size() && i < positions.size(); ++i)
+            {
+                const glm::vec3 decoded = VertexQuantization::decodePosition(encoded[i], format, scale, bias);
+                for(int k = 0; k < 3; ++k)
+                {
+                    BR_CHECK_NEAR(decoded[k], positions[i][k], tolerance[k]);
+                }
+
+                // w = 1 for shaders which use vec4 position.
+                const float w = format == VertexFormat::COMPACT_HALF ? VertexQuantization::halfToFloat(encoded[i].w)
+                                                                       : static_cast<float>(static_cast<int16_t>(encoded[i].w)) / 32767.0f;
+                BR_CHECK(w == 1.0f);
+            }
+        }
+    }
+
+    void testTextureCoords()
+    {
+        const std::vector<glm::vec2> textureCoords{{0.0f, 1.0f}, {0.5f, 0.25f}, {0.123f, 0.987f}, {-2.5f, 7.75f}, {1.0f / 3.0f, 2.0f / 3.0f}};
+        const std::vector<glm::u16vec2> encoded = VertexQuantization::encodeTextureCoords(textureCoords.data(), static_cast<uint32_t>(textureCoords.size()));
+        BR_CHECK(encoded.size() == textureCoords.size());
+        for(size_t i = 0; i < encoded.size() && i < textureCoords.size(); ++i)
+        {
+            for(int k = 0; k < 2; ++k)
+            {
+                // Relative precision of half float.
+                const float value = textureCoords[i][k];
+                BR_CHECK_NEAR(VertexQuantization::halfToFloat(encoded[i][k]), value, std::max(std::abs(value), 1.0f / 1024.0f) / 2048.0f);
+            }
+        }
+
+        // Exactly representable values.
+        BR_CHECK(VertexQuantization::halfToFloat(encoded[0].x) == 0.0f && VertexQuantization::halfToFloat(encoded[0].y) == 1.0f);
+        BR_CHECK(VertexQuantization::halfToFloat(encoded[1].x) == 0.5f && VertexQuantization::halfToFloat(encoded[1].y) == 0.25f);
+    }
+
+    void testIndices()
+    {
+        BR_CHECK(VertexQuantization::getCanUseIndices16(65536));
+        BR_CHECK(!VertexQuantization::getCanUseIndices16(65537));
+
+        const std::vector<uint32_t> indices{0, 1, 2, 65535, 40000};
+        const std::vector<uint16_t> encoded = VertexQuantization::encodeIndices16(indices.data(), static_cast<uint32_t>(indices.size()));
+        BR_CHECK(encoded == std::vector<uint16_t>({0, 1, 2, 65535, 40000}));
+    }
+}
+
+int main()
+{
+    testOctahedral();
+    testPositions();
+    testTextureCoords();
+    testIndices();
+
+    return getTestResult("VertexQuantizationTest");
+}